@@ -53,10 +53,12 @@ LOCAL_SRC_FILES := \
     Frustum.cpp \
     Game.cpp \
     Gamepad.cpp \
+    GlyphAtlas.cpp \
     HeightField.cpp \
     HorizontalLayout.cpp \
     Image.cpp \
     ImageControl.cpp \
+    JobScheduler.cpp \
     Joint.cpp \
     JoystickControl.cpp \
     Label.cpp \
@@ -94,6 +96,7 @@ LOCAL_SRC_FILES := \
     Plane.cpp \
     Platform.cpp \
     PlatformAndroid.cpp \
+    Profiler.cpp \
     ProgressBar.cpp \
     Properties.cpp \
     Quaternion.cpp \
@@ -101,8 +104,10 @@ LOCAL_SRC_FILES := \
     Ray.cpp \
     Rectangle.cpp \
     Ref.cpp \
+    RenderQueue.cpp \
     RenderState.cpp \
     RenderTarget.cpp \
+    ResourceLoader.cpp \
     Scene.cpp \
     SceneLoader.cpp \
     ScreenDisplayer.cpp \
@@ -116,6 +121,7 @@ LOCAL_SRC_FILES := \
     SocialPlayer.cpp \
     SocialScore.cpp \
     SocialSessionListener.cpp \
+    SpatialIndex.cpp \
     Sprite.cpp \
     SpriteBatch.cpp \
     Technique.cpp \
@@ -127,7 +133,9 @@ LOCAL_SRC_FILES := \
     Theme.cpp \
     ThemeStyle.cpp \
     TileSet.cpp \
+    TimeScheduler.cpp \
     Transform.cpp \
+    TransformHierarchy.cpp \
     Vector2.cpp \
     Vector3.cpp \
     Vector4.cpp \
@@ -229,6 +237,7 @@ LOCAL_SRC_FILES := \
     lua/lua_Plane.cpp \
     lua/lua_Platform.cpp \
     lua/lua_ProgressBar.cpp \
+    lua/lua_Profiler.cpp \
     lua/lua_Properties.cpp \
     lua/lua_Quaternion.cpp \
     lua/lua_RadioButton.cpp \
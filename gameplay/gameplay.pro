@@ -50,10 +50,12 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/Game.cpp \
     src/Game.inl \
     src/Gamepad.cpp \
+    src/GlyphAtlas.cpp \
     src/HeightField.cpp \
     src/Image.cpp \
     src/Image.inl \
     src/ImageControl.cpp \
+    src/JobScheduler.cpp \
     src/Joint.cpp \
     src/JoystickControl.cpp \
     src/Label.cpp \
@@ -65,6 +67,7 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/MathUtil.cpp \
     src/MathUtil.inl \
     src/MathUtilNeon.inl \
+    src/MathUtilSSE.inl \
     src/Matrix.cpp \
     src/Matrix.inl \
     src/Mesh.cpp \
@@ -98,6 +101,7 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/Plane.cpp \
     src/Plane.inl \
     src/Platform.cpp \
+    src/Profiler.cpp \
     src/Properties.cpp \
     src/Quaternion.cpp \
     src/Quaternion.inl \
@@ -106,8 +110,10 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/Ray.inl \
     src/Rectangle.cpp \
     src/Ref.cpp \
+    src/RenderQueue.cpp \
     src/RenderState.cpp \
     src/RenderTarget.cpp \
+    src/ResourceLoader.cpp \
     src/Scene.cpp \
     src/SceneLoader.cpp \
     src/ScreenDisplayer.cpp \
@@ -116,6 +122,7 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/ScriptController.inl \
     src/ScriptTarget.cpp \
     src/Slider.cpp \
+    src/SpatialIndex.cpp \
     src/Sprite.cpp \
     src/SpriteBatch.cpp \
     src/Technique.cpp \
@@ -127,7 +134,9 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/Theme.cpp \
     src/ThemeStyle.cpp \
     src/TileSet.cpp \
+    src/TimeScheduler.cpp \
     src/Transform.cpp \
+    src/TransformHierarchy.cpp \
     src/Vector2.cpp \
     src/Vector2.inl \
     src/Vector3.cpp \
@@ -227,6 +236,7 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/lua/lua_PhysicsVehicleWheel.cpp \
     src/lua/lua_Plane.cpp \
     src/lua/lua_Platform.cpp \
+    src/lua/lua_Profiler.cpp \
     src/lua/lua_Properties.cpp \
     src/lua/lua_Quaternion.cpp \
     src/lua/lua_RadioButton.cpp \
@@ -311,9 +321,11 @@ HEADERS += src/AbsoluteLayout.h \
     src/Gamepad.h \
     src/gameplay.h \
     src/Gesture.h \
+    src/GlyphAtlas.h \
     src/HeightField.h \
     src/Image.h \
     src/ImageControl.h \
+    src/JobScheduler.h \
     src/Joint.h \
     src/JoystickControl.h \
     src/Keyboard.h \
@@ -350,14 +362,17 @@ HEADERS += src/AbsoluteLayout.h \
     src/PhysicsVehicleWheel.h \
     src/Plane.h \
     src/Platform.h \
+    src/Profiler.h \
     src/Properties.h \
     src/Quaternion.h \
     src/RadioButton.h \
     src/Ray.h \
     src/Rectangle.h \
     src/Ref.h \
+    src/RenderQueue.h \
     src/RenderState.h \
     src/RenderTarget.h \
+    src/ResourceLoader.h \
     src/Scene.h \
     src/SceneLoader.h \
     src/ScreenDisplayer.h \
@@ -365,6 +380,7 @@ HEADERS += src/AbsoluteLayout.h \
     src/ScriptController.h \
     src/ScriptTarget.h \
     src/Slider.h \
+    src/SpatialIndex.h \
     src/Sprite.h \
     src/SpriteBatch.h \
     src/Stream.h \
@@ -378,8 +394,10 @@ HEADERS += src/AbsoluteLayout.h \
     src/ThemeStyle.h \
     src/TileSet.h \
     src/TimeListener.h \
+    src/TimeScheduler.h \
     src/Touch.h \
     src/Transform.h \
+    src/TransformHierarchy.h \
     src/Vector2.h \
     src/Vector3.h \
     src/Vector4.h \
@@ -478,6 +496,7 @@ HEADERS += src/AbsoluteLayout.h \
     src/lua/lua_PhysicsVehicleWheel.h \
     src/lua/lua_Plane.h \
     src/lua/lua_Platform.h \
+    src/lua/lua_Profiler.h \
     src/lua/lua_Properties.h \
     src/lua/lua_Quaternion.h \
     src/lua/lua_RadioButton.h \
@@ -6,7 +6,7 @@ namespace gameplay
 {
 
 AIAgent::AIAgent()
-    : _stateMachine(NULL), _node(NULL), _enabled(true), _listener(NULL), _next(NULL)
+    : _stateMachine(NULL), _node(NULL), _enabled(true), _concurrent(false), _listener(NULL), _next(NULL)
 {
     _stateMachine = new AIStateMachine(this);
 }
@@ -54,6 +54,16 @@ void AIAgent::setEnabled(bool enabled)
     _enabled = enabled;
 }
 
+void AIAgent::setConcurrent(bool concurrent)
+{
+    _concurrent = concurrent;
+}
+
+bool AIAgent::isConcurrent() const
+{
+    return _concurrent;
+}
+
 void AIAgent::setListener(Listener* listener)
 {
     _listener = listener;
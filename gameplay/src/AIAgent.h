@@ -111,6 +111,27 @@ public:
      */
     void setEnabled(bool enabled);
 
+    /**
+     * Sets whether the state machine of this AIAgent may be updated concurrently
+     * with the state machines of other concurrent agents.
+     *
+     * Only mark agents whose states do not touch anything shared with other
+     * agents, such as other nodes or game data, and that do not add or remove
+     * agents from their update. Messages sent while concurrent agents update are
+     * routed once all of them have been updated. Agents are updated serially by default.
+     *
+     * @param concurrent true if the agent may be updated concurrently, false otherwise.
+     */
+    void setConcurrent(bool concurrent);
+
+    /**
+     * Determines whether the state machine of this AIAgent may be updated
+     * concurrently with other agents.
+     *
+     * @return true if the agent may be updated concurrently, false otherwise.
+     */
+    bool isConcurrent() const;
+
     /**
      * Sets an event listener for this AIAgent.
      *
@@ -164,6 +185,7 @@ private:
     AIStateMachine* _stateMachine;
     Node* _node;
     bool _enabled;
+    bool _concurrent;
     Listener* _listener;
     AIAgent* _next;
 
@@ -2,11 +2,14 @@
 #include "AIController.h"
 #include "Game.h"
 
+// Number of concurrent agents updated by each job.
+#define AI_CONCURRENT_GRAIN_SIZE 32
+
 namespace gameplay
 {
 
 AIController::AIController()
-    : _paused(false), _firstMessage(NULL), _firstAgent(NULL)
+    : _paused(false), _messageOrder(0), _firstAgent(NULL), _updatingConcurrently(false)
 {
 }
 
@@ -29,16 +32,21 @@ void AIController::finalize()
         SAFE_RELEASE(temp);
     }
     _firstAgent = NULL;
+    _agentIndex.clear();
+    _concurrentAgents.clear();
 
     // Remove all messages
-    AIMessage* message = _firstMessage;
-    while (message)
+    for (size_t i = 0, count = _messages.size(); i < count; ++i)
+    {
+        AIMessage::destroy(_messages[i].message);
+    }
+    _messages.clear();
+    for (size_t i = 0, count = _deferredMessages.size(); i < count; ++i)
     {
-        AIMessage* temp = message;
-        message = message->_next;
-        AIMessage::destroy(temp);
+        AIMessage::destroy(_deferredMessages[i].message);
     }
-    _firstMessage = NULL;
+    _deferredMessages.clear();
+    AIMessage::clearPool();
 }
 
 void AIController::pause()
@@ -53,86 +61,138 @@ void AIController::resume()
 
 void AIController::sendMessage(AIMessage* message, float delay)
 {
+    GP_ASSERT(message);
+
+    if (_updatingConcurrently)
+    {
+        // Agents are updating on several threads; send once they are all done.
+        DeferredMessage deferred = { message, delay };
+        std::lock_guard<std::mutex> lock(_deferredMessagesMutex);
+        _deferredMessages.push_back(deferred);
+        return;
+    }
+
     if (delay <= 0)
     {
         // Send instantly
-        if (message->getReceiver() == NULL || strlen(message->getReceiver()) == 0)
-        {
-            // Broadcast message to all agents
-            AIAgent* agent = _firstAgent;
-            while (agent)
-            {
-                if (agent->processMessage(message))
-                    break; // message consumed by this agent - stop bubbling
-                agent = agent->_next;
-            }
-        }
-        else
-        {
-            // Single recipient
-            AIAgent* agent = findAgent(message->getReceiver());
-            if (agent)
-            {
-                agent->processMessage(message);
-            }
-            else
-            {
-                GP_WARN("Failed to locate AIAgent for message recipient: %s", message->getReceiver());
-            }
-        }
-
-        // Delete the message, since it is finished being processed
-        AIMessage::destroy(message);
+        deliverMessage(message);
     }
     else
     {
         // Queue for later delivery
-        if (_firstMessage)
-            message->_next = _firstMessage;
-        _firstMessage = message;
+        message->_deliveryTime = Game::getGameTime() + delay;
+        ScheduledMessage scheduled = { message->_deliveryTime, _messageOrder++, message };
+        _messages.push_back(scheduled);
+        std::push_heap(_messages.begin(), _messages.end(), isDeliveredLater);
     }
 }
 
-void AIController::update(float elapsedTime)
+void AIController::deliverMessage(AIMessage* message)
 {
-    if (_paused)
-        return;
-
-    static Game* game = Game::getInstance();
-
-    // Send all pending messages that have expired
-    AIMessage* prevMsg = NULL;
-    AIMessage* msg = _firstMessage;
-    while (msg)
+    if (message->getReceiver() == NULL || strlen(message->getReceiver()) == 0)
+    {
+        // Broadcast message to all agents
+        AIAgent* agent = _firstAgent;
+        while (agent)
+        {
+            if (agent->processMessage(message))
+                break; // message consumed by this agent - stop bubbling
+            agent = agent->_next;
+        }
+    }
+    else
     {
-        // If the message delivery time has expired, send it (this also deletes it)
-        if (msg->getDeliveryTime() >= game->getGameTime())
+        // Single recipient
+        AIAgent* agent = findAgent(message->getReceiver());
+        if (agent)
         {
-            // Link the message out of our list
-            if (prevMsg)
-                prevMsg->_next = msg->_next;
-
-            AIMessage* temp = msg;
-            msg = msg->_next;
-            temp->_next = NULL;
-            sendMessage(temp);
+            agent->processMessage(message);
         }
         else
         {
-            prevMsg = msg;
-            msg = msg->_next;
+            GP_WARN("Failed to locate AIAgent for message recipient: %s", message->getReceiver());
         }
     }
 
-    // Update all enabled agents
+    // Delete the message, since it is finished being processed
+    AIMessage::destroy(message);
+}
+
+void AIController::update(float elapsedTime)
+{
+    if (_paused)
+        return;
+
+    // Send all pending messages that are due, earliest first
+    double time = Game::getGameTime();
+    while (!_messages.empty() && _messages.front().deliveryTime <= time)
+    {
+        AIMessage* message = _messages.front().message;
+        std::pop_heap(_messages.begin(), _messages.end(), isDeliveredLater);
+        _messages.pop_back();
+        sendMessage(message);
+    }
+
+    // Update all enabled agents, leaving concurrent ones for the job scheduler
+    _concurrentAgents.clear();
     AIAgent* agent = _firstAgent;
     while (agent)
     {
         if (agent->isEnabled())
-            agent->update(elapsedTime);
+        {
+            if (agent->isConcurrent())
+                _concurrentAgents.push_back(agent);
+            else
+                agent->update(elapsedTime);
+        }
 
         agent = agent->_next;
     }
+
+    if (!_concurrentAgents.empty())
+        updateConcurrentAgents(elapsedTime);
+}
+
+void AIController::updateConcurrentAgents(float elapsedTime)
+{
+    JobScheduler* scheduler = Game::getInstance()->getJobScheduler();
+    if (scheduler && _concurrentAgents.size() > 1)
+    {
+        _updatingConcurrently = true;
+        scheduler->parallelFor((unsigned int)_concurrentAgents.size(), AI_CONCURRENT_GRAIN_SIZE, [this, elapsedTime](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                _concurrentAgents[i]->update(elapsedTime);
+            }
+        }, "AIController::update");
+        _updatingConcurrently = false;
+
+        // Send the messages of the concurrent agents. Their order depends on
+        // the threads, but each agent's own messages stay in order.
+        std::vector<DeferredMessage> deferred;
+        deferred.swap(_deferredMessages);
+        for (size_t i = 0, count = deferred.size(); i < count; ++i)
+        {
+            sendMessage(deferred[i].message, deferred[i].delay);
+        }
+    }
+    else
+    {
+        for (size_t i = 0, count = _concurrentAgents.size(); i < count; ++i)
+        {
+            _concurrentAgents[i]->update(elapsedTime);
+        }
+    }
+}
+
+bool AIController::isDeliveredLater(const ScheduledMessage& a, const ScheduledMessage& b)
+{
+    if (a.deliveryTime != b.deliveryTime)
+        return a.deliveryTime > b.deliveryTime;
+
+    // Wrap-safe comparison of the send order.
+    return (int)(a.order - b.order) > 0;
 }
 
 void AIController::addAgent(AIAgent* agent)
@@ -143,6 +203,9 @@ void AIController::addAgent(AIAgent* agent)
         agent->_next = _firstAgent;
 
     _firstAgent = agent;
+
+    // The agent is now first in the list, so it wins lookups by its ID.
+    _agentIndex[agent->getId()] = agent;
 }
 
 void AIController::removeAgent(AIAgent* agent)
@@ -160,6 +223,7 @@ void AIController::removeAgent(AIAgent* agent)
                 _firstAgent = agent->_next;
 
             agent->_next = NULL;
+            unindexAgent(agent, agent->getId());
             agent->release();
             break;
         }
@@ -169,20 +233,56 @@ void AIController::removeAgent(AIAgent* agent)
     }
 }
 
-AIAgent* AIController::findAgent(const char* id) const
+void AIController::renameAgent(AIAgent* agent, const char* oldId)
 {
-    GP_ASSERT(id);
+    GP_ASSERT(agent);
+    GP_ASSERT(oldId);
 
-    AIAgent* agent = _firstAgent;
-    while (agent)
+    const char* id = agent->getId();
+    if (strcmp(id, oldId) == 0)
+        return;
+
+    unindexAgent(agent, oldId);
+
+    // The first agent in the list with the new ID wins, as with findAgent before indexing.
+    AIAgent* itr = _firstAgent;
+    while (itr)
     {
-        if (strcmp(id, agent->getId()) == 0)
-            return agent;
+        if (strcmp(id, itr->getId()) == 0)
+        {
+            _agentIndex[id] = itr;
+            break;
+        }
+        itr = itr->_next;
+    }
+}
 
-        agent = agent->_next;
+void AIController::unindexAgent(AIAgent* agent, const char* id)
+{
+    std::unordered_map<std::string, AIAgent*>::iterator entry = _agentIndex.find(id);
+    if (entry == _agentIndex.end() || entry->second != agent)
+        return;
+
+    // Hand the ID over to the next agent that has it, if any.
+    AIAgent* itr = _firstAgent;
+    while (itr)
+    {
+        if (itr != agent && strcmp(id, itr->getId()) == 0)
+        {
+            entry->second = itr;
+            return;
+        }
+        itr = itr->_next;
     }
+    _agentIndex.erase(entry);
+}
+
+AIAgent* AIController::findAgent(const char* id) const
+{
+    GP_ASSERT(id);
 
-    return NULL;
+    std::unordered_map<std::string, AIAgent*>::const_iterator entry = _agentIndex.find(id);
+    return entry != _agentIndex.end() ? entry->second : NULL;
 }
 
 }
@@ -11,6 +11,10 @@ namespace gameplay
  * Defines and facilitates the state machine execution and message passing
  * between AI objects in the game. This class is generally not interfaced
  * with directly.
+ *
+ * Delayed messages are kept in a queue ordered by delivery time, so each
+ * update only looks at the messages that are due. Messages due at the same
+ * time are delivered in the order they were sent. Agents are indexed by ID.
  */
 class AIController
 {
@@ -96,9 +100,59 @@ private:
 
     void removeAgent(AIAgent* agent);
 
+    /**
+     * Updates the index of an agent whose node changed its ID.
+     */
+    void renameAgent(AIAgent* agent, const char* oldId);
+
+    /**
+     * Removes an agent from the index, handing its ID over to the next agent with the same ID.
+     */
+    void unindexAgent(AIAgent* agent, const char* id);
+
+    /**
+     * Delivers a message to its recipients and destroys it.
+     */
+    void deliverMessage(AIMessage* message);
+
+    /**
+     * Updates the agents that may run concurrently, spread over the job scheduler.
+     */
+    void updateConcurrentAgents(float elapsedTime);
+
+    /**
+     * A delayed message.
+     */
+    struct ScheduledMessage
+    {
+        double deliveryTime;
+        unsigned int order;             // Keeps messages due at the same time in the order they were sent.
+        AIMessage* message;
+    };
+
+    /**
+     * Orders the message heap so that the earliest delivery time is at the front.
+     */
+    static bool isDeliveredLater(const ScheduledMessage& a, const ScheduledMessage& b);
+
+    /**
+     * A message sent while concurrent agents update.
+     */
+    struct DeferredMessage
+    {
+        AIMessage* message;
+        float delay;
+    };
+
     bool _paused;
-    AIMessage* _firstMessage;
+    std::vector<ScheduledMessage> _messages;             // Heap of delayed messages, the next one due first.
+    unsigned int _messageOrder;
     AIAgent* _firstAgent;
+    std::unordered_map<std::string, AIAgent*> _agentIndex; // The first agent in the list with each ID.
+    std::vector<AIAgent*> _concurrentAgents;
+    bool _updatingConcurrently;
+    std::vector<DeferredMessage> _deferredMessages;
+    std::mutex _deferredMessagesMutex;
 
 };
 
@@ -1,11 +1,18 @@
 #include "Base.h"
 #include "AIMessage.h"
 
+// The largest number of destroyed messages kept for reuse.
+#define AI_MESSAGE_POOL_SIZE 1024
+
 namespace gameplay
 {
 
+AIMessage* AIMessage::_pool = NULL;
+unsigned int AIMessage::_poolSize = 0;
+std::mutex AIMessage::_poolMutex;
+
 AIMessage::AIMessage()
-    : _id(0), _deliveryTime(0), _parameters(NULL), _parameterCount(0), _messageType(MESSAGE_TYPE_CUSTOM), _next(NULL)
+    : _id(0), _deliveryTime(0), _parameters(NULL), _parameterCount(0), _parameterCapacity(0), _messageType(MESSAGE_TYPE_CUSTOM), _next(NULL)
 {
 }
 
@@ -16,19 +23,69 @@ AIMessage::~AIMessage()
 
 AIMessage* AIMessage::create(unsigned int id, const char* sender, const char* receiver, unsigned int parameterCount)
 {
-    AIMessage* message = new AIMessage();
+    AIMessage* message = NULL;
+    {
+        std::unique_lock<std::mutex> lock(_poolMutex);
+        if (_pool)
+        {
+            message = _pool;
+            _pool = message->_next;
+            --_poolSize;
+        }
+    }
+    if (!message)
+        message = new AIMessage();
+
     message->_id = id;
-    message->_sender = sender;
-    message->_receiver = receiver;
+    message->_sender = sender ? sender : "";
+    message->_receiver = receiver ? receiver : "";
+    message->_deliveryTime = 0;
+    message->_messageType = MESSAGE_TYPE_CUSTOM;
+    message->_next = NULL;
     message->_parameterCount = parameterCount;
-    if (parameterCount > 0)
+    if (parameterCount > message->_parameterCapacity)
+    {
+        SAFE_DELETE_ARRAY(message->_parameters);
         message->_parameters = new AIMessage::Parameter[parameterCount];
+        message->_parameterCapacity = parameterCount;
+    }
     return message;
 }
 
 void AIMessage::destroy(AIMessage* message)
 {
-    SAFE_DELETE(message);
+    if (!message)
+        return;
+
+    // Parameters are cleared now so that pooled messages do not hold on to strings.
+    for (unsigned int i = 0; i < message->_parameterCount; ++i)
+    {
+        message->clearParameter(i);
+    }
+
+    std::unique_lock<std::mutex> lock(_poolMutex);
+    if (_poolSize < AI_MESSAGE_POOL_SIZE)
+    {
+        message->_next = _pool;
+        _pool = message;
+        ++_poolSize;
+    }
+    else
+    {
+        SAFE_DELETE(message);
+    }
+}
+
+void AIMessage::clearPool()
+{
+    std::unique_lock<std::mutex> lock(_poolMutex);
+    while (_pool)
+    {
+        AIMessage* message = _pool;
+        _pool = message->_next;
+        SAFE_DELETE(message);
+    }
+    _poolSize = 0;
 }
 
 unsigned int AIMessage::getId() const
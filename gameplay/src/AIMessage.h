@@ -37,6 +37,9 @@ public:
     /**
      * Creates a new message.
      *
+     * Messages are recycled once destroyed, so creating messages does not
+     * allocate memory in the steady state.
+     *
      * Once a message is constructed and populated with data, it can be routed to its
      * intended recipient(s) by calling AIController::sendMessage(AIMessage*). The
      * AIController will then handle scheduling and delivery of the message and it will
@@ -267,14 +270,23 @@ private:
 
     void clearParameter(unsigned int index);
 
+    /**
+     * Frees the destroyed messages kept for reuse.
+     */
+    static void clearPool();
+
     unsigned int _id;
     std::string _sender;
     std::string _receiver;
     double _deliveryTime;
     Parameter* _parameters;
     unsigned int _parameterCount;
+    unsigned int _parameterCapacity;
     MessageType _messageType;
     AIMessage* _next;
+    static AIMessage* _pool;            // Destroyed messages kept for reuse, linked by _next.
+    static unsigned int _poolSize;
+    static std::mutex _poolMutex;
 
 };
 
@@ -399,6 +399,49 @@ Animation::Channel* Animation::createChannel(AnimationTarget* target, int proper
     return channel;
 }
 
+Animation::Channel* Animation::createChannel(AnimationTarget* target, int propertyId, unsigned int keyCount, float* keyTimes, const unsigned short* keys, unsigned int keyStride, const float* ranges)
+{
+    GP_ASSERT(target);
+    GP_ASSERT(keyTimes);
+    GP_ASSERT(keys);
+    GP_ASSERT(ranges);
+
+    unsigned int propertyComponentCount = target->getAnimationPropertyComponentCount(propertyId);
+    GP_ASSERT(propertyComponentCount > 0);
+
+    float lowest = keyTimes[0];
+    float duration = keyTimes[keyCount-1] - lowest;
+
+    float* normalizedKeyTimes = new float[keyCount];
+    normalizedKeyTimes[0] = 0.0f;
+    for (unsigned int i = 1; i < keyCount - 1; i++)
+    {
+        normalizedKeyTimes[i] = (float) (keyTimes[i] - lowest) / (float) duration;
+    }
+    if (keyCount > 1)
+        normalizedKeyTimes[keyCount - 1] = 1.0f;
+
+    Curve* curve = Curve::createQuantized(keyCount, propertyComponentCount, keyStride, normalizedKeyTimes, keys, ranges);
+    GP_ASSERT(curve);
+    if (target->_targetType == AnimationTarget::TRANSFORM)
+        setTransformRotationOffset(curve, propertyId);
+
+    SAFE_DELETE_ARRAY(normalizedKeyTimes);
+
+    // A rotation takes three quantized values instead of four.
+    if (keyStride != propertyComponentCount - (curve->_quaternionOffset ? 1 : 0))
+    {
+        GP_ERROR("Quantized keys of animation '%s' do not match the target property %d.", _id.c_str(), propertyId);
+        curve->release();
+        return NULL;
+    }
+
+    Channel* channel = new Channel(this, target, propertyId, curve, duration);
+    curve->release();
+    addChannel(channel);
+    return channel;
+}
+
 void Animation::addChannel(Channel* channel)
 {
     GP_ASSERT(channel);
@@ -202,6 +202,13 @@ private:
      */
     Channel* createChannel(AnimationTarget* target, int propertyId, unsigned int keyCount, float* keyTimes, float* keyValues, float* keyInValue, float* keyOutValue, unsigned int type);
 
+    /**
+     * Creates a channel within this animation from quantized keys.
+     *
+     * @see Curve::createQuantized
+     */
+    Channel* createChannel(AnimationTarget* target, int propertyId, unsigned int keyCount, float* keyTimes, const unsigned short* keys, unsigned int keyStride, const float* ranges);
+
     /**
      * Adds a channel to the animation.
      */
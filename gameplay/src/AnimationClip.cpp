@@ -12,7 +12,9 @@
 #include "AnimationClip.h"
 #include "Animation.h"
 #include "AnimationTarget.h"
+#include "AnimationController.h"
 #include "Game.h"
+#include "Node.h"
 #include "Quaternion.h"
 #include "ScriptController.h"
 
@@ -25,7 +27,7 @@ AnimationClip::AnimationClip(const char* id, Animation* animation, float startTi
     : _id(id), _animation(animation), _startTime(startTime), _endTime(endTime), _duration(_endTime - _startTime), 
       _stateBits(0x00), _repeatCount(1.0f), _loopBlendTime(0), _activeDuration(_duration * _repeatCount), _speed(1.0f), _timeStarted(0), 
       _elapsedTime(0), _crossFadeToClip(NULL), _crossFadeOutElapsed(0), _crossFadeOutDuration(0), _blendWeight(1.0f),
-      _beginListeners(NULL), _endListeners(NULL), _listeners(NULL), _listenerItr(NULL)
+      _layer(0), _blendMode(BLEND_OVERRIDE), _beginListeners(NULL), _endListeners(NULL), _listeners(NULL), _listenerItr(NULL)
 {
     GP_REGISTER_SCRIPT_EVENTS();
 
@@ -38,6 +40,8 @@ AnimationClip::AnimationClip(const char* id, Animation* animation, float startTi
         GP_ASSERT(_animation->_channels[i]->getCurve());
         _values.push_back(new AnimationValue(_animation->_channels[i]->getCurve()->getComponentCount()));
     }
+    _cursors.resize(_values.size());
+    _poseSlots.resize(_values.size(), 0);
 }
 
 AnimationClip::~AnimationClip()
@@ -187,6 +191,63 @@ float AnimationClip::getBlendWeight() const
     return _blendWeight;
 }
 
+void AnimationClip::setLayer(unsigned int layer)
+{
+    if (_layer != layer)
+    {
+        _layer = layer;
+        GP_ASSERT(_animation && _animation->_controller);
+        _animation->_controller->_layersChanged = true;
+    }
+}
+
+unsigned int AnimationClip::getLayer() const
+{
+    return _layer;
+}
+
+void AnimationClip::setBlendMode(BlendMode mode)
+{
+    _blendMode = mode;
+    _references.clear();
+}
+
+AnimationClip::BlendMode AnimationClip::getBlendMode() const
+{
+    return _blendMode;
+}
+
+void AnimationClip::setNodeMask(Node* node, float weight)
+{
+    GP_ASSERT(node);
+    GP_ASSERT(_animation);
+
+    size_t channelCount = _animation->_channels.size();
+    if (_channelWeights.empty())
+        _channelWeights.resize(channelCount, 1.0f);
+
+    for (size_t i = 0; i < channelCount; i++)
+    {
+        AnimationTarget* target = _animation->_channels[i]->_target;
+        if (target->_targetType != AnimationTarget::TRANSFORM)
+            continue;
+
+        for (Node* n = dynamic_cast<Node*>(static_cast<Transform*>(target)); n; n = n->getParent())
+        {
+            if (n == node)
+            {
+                _channelWeights[i] = weight;
+                break;
+            }
+        }
+    }
+}
+
+void AnimationClip::clearNodeMask()
+{
+    _channelWeights.clear();
+}
+
 void AnimationClip::setLoopBlendTime(float loopBlendTime)
 {
     if (loopBlendTime < 0.0f)
@@ -572,10 +633,16 @@ bool AnimationClip::update(float elapsedTime)
     Animation::Channel* channel = NULL;
     AnimationValue* value = NULL;
     AnimationTarget* target = NULL;
+    AnimationController* controller = _animation->_controller;
+    GP_ASSERT(controller);
     size_t channelCount = _animation->_channels.size();
     float percentageStart = (float)_startTime / (float)_animation->_duration;
     float percentageEnd = (float)_endTime / (float)_animation->_duration;
     float percentageBlend = (float)_loopBlendTime / (float)_animation->_duration;
+    bool additive = _blendMode == BLEND_ADDITIVE;
+    if (additive && _references.empty())
+        computeReferences(percentageStart, percentageEnd);
+    size_t referenceOffset = 0;
     for (size_t i = 0; i < channelCount; i++)
     {
         channel = _animation->_channels[i];
@@ -585,12 +652,23 @@ bool AnimationClip::update(float elapsedTime)
         value = _values[i];
         GP_ASSERT(value);
 
-        // Evaluate the point on Curve
+        // Evaluate the point on Curve, continuing from where the last update left off.
         GP_ASSERT(channel->getCurve());
-        channel->getCurve()->evaluate(percentComplete, percentageStart, percentageEnd, percentageBlend, value->_value);
+        channel->getCurve()->evaluate(percentComplete, percentageStart, percentageEnd, percentageBlend, value->_value, &_cursors[i]);
+
+        float weight = _channelWeights.empty() ? _blendWeight : _blendWeight * _channelWeights[i];
+        const float* reference = additive ? &_references[referenceOffset] : NULL;
+        referenceOffset += value->_componentCount;
+
+        // Transforms are blended into their pose, which the controller writes once all clips are updated.
+        if (target->_targetType == AnimationTarget::TRANSFORM &&
+            controller->samplePose(static_cast<Transform*>(target), channel->_propertyId, value->_value, reference, weight, _layer, &_poseSlots[i]))
+        {
+            continue;
+        }
 
         // Set the animation value on the target property.
-        target->setAnimationPropertyValue(channel->_propertyId, value, _blendWeight);
+        target->setAnimationPropertyValue(channel->_propertyId, value, weight);
     }
 
     // When ended. Probably should move to it's own method so we can call it when the clip is ended early.
@@ -703,7 +781,26 @@ AnimationClip* AnimationClip::clone(Animation* animation) const
             *newClip->_values[i] = *_values[i];
         }
     }
+    newClip->_cursors.resize(size);
+    newClip->_layer = _layer;
+    newClip->_blendMode = _blendMode;
+    newClip->_channelWeights = _channelWeights;
     return newClip;
 }
 
+void AnimationClip::computeReferences(float percentageStart, float percentageEnd)
+{
+    GP_ASSERT(_animation);
+
+    _references.clear();
+    for (size_t i = 0, count = _animation->_channels.size(); i < count; i++)
+    {
+        Curve* curve = _animation->_channels[i]->getCurve();
+        GP_ASSERT(curve);
+        size_t offset = _references.size();
+        _references.resize(offset + curve->getComponentCount());
+        curve->evaluate(0.0f, percentageStart, percentageEnd, 0.0f, &_references[offset]);
+    }
+}
+
 }
@@ -21,6 +21,7 @@ namespace gameplay
 
 class Animation;
 class AnimationValue;
+class Node;
 
 /**
  * Defines the runtime session of an Animation to be played.
@@ -43,6 +44,23 @@ public:
      */
     static const unsigned int REPEAT_INDEFINITE = 0;
 
+    /**
+     * Defines how the clip combines with the clips of lower layers.
+     */
+    enum BlendMode
+    {
+        /**
+         * The clip replaces the pose of the lower layers, by its blend weight.
+         */
+        BLEND_OVERRIDE,
+
+        /**
+         * The clip adds its motion since its first frame to the pose of the lower layers,
+         * scaled by its blend weight. Only transforms are animated additively.
+         */
+        BLEND_ADDITIVE
+    };
+
     /**
      * Defines an animation event listener.
      */
@@ -209,6 +227,54 @@ public:
      */
     float getBlendWeight() const;
 
+    /**
+     * Sets the layer of the AnimationClip.
+     *
+     * Transforms are blended layer by layer, lowest first, so clips in higher
+     * layers are applied over the clips in lower layers. Clips are in layer 0 by default.
+     *
+     * @param layer The layer of the clip.
+     */
+    void setLayer(unsigned int layer);
+
+    /**
+     * Gets the layer of the AnimationClip.
+     *
+     * @return The layer of the clip.
+     */
+    unsigned int getLayer() const;
+
+    /**
+     * Sets how the AnimationClip combines with the clips of lower layers.
+     *
+     * @param mode The blend mode. The default is BLEND_OVERRIDE.
+     */
+    void setBlendMode(BlendMode mode);
+
+    /**
+     * Gets how the AnimationClip combines with the clips of lower layers.
+     *
+     * @return The blend mode.
+     */
+    BlendMode getBlendMode() const;
+
+    /**
+     * Scales the blend weight of the AnimationClip on a node and all of its descendants.
+     *
+     * Masks let a clip animate part of a skeleton, such as the upper body,
+     * while other clips animate the rest. A mask applies to the nodes the clip
+     * animates at the time of the call, replacing earlier masks on them.
+     *
+     * @param node The node, typically a joint.
+     * @param weight The weight of the clip on the node, between 0 and 1.
+     */
+    void setNodeMask(Node* node, float weight);
+
+    /**
+     * Removes all node masks of the AnimationClip.
+     */
+    void clearNodeMask();
+
     /**
      * Sets the time (in seconds) to append to the clip's active duration
      * to use for blending the end points of the clip when looping.
@@ -404,6 +470,11 @@ private:
      */
     AnimationClip* clone(Animation* animation) const;
 
+    /**
+     * Evaluates the first frame of every channel, which additive clips are relative to.
+     */
+    void computeReferences(float percentageStart, float percentageEnd);
+
     std::string _id;                                    // AnimationClip ID.
     Animation* _animation;                              // The Animation this clip is created from.
     float _startTime;                                   // Start time of the clip.
@@ -421,6 +492,12 @@ private:
     float _crossFadeOutDuration;                        // The duration of the cross fade.
     float _blendWeight;                                 // The clip's blendweight.
     std::vector<AnimationValue*> _values;               // AnimationValue holder.
+    std::vector<Curve::Cursor> _cursors;                // Where each channel's curve was last evaluated.
+    unsigned int _layer;                                // The layer the clip is blended in.
+    BlendMode _blendMode;                               // How the clip combines with lower layers.
+    std::vector<float> _channelWeights;                 // The mask weight of each channel, empty without masks.
+    std::vector<float> _references;                     // The first frame of each channel, for additive clips.
+    std::vector<unsigned int> _poseSlots;               // The pose each channel was last sampled into.
     std::vector<Listener*>* _beginListeners;            // Collection of begin listeners on the clip.
     std::vector<Listener*>* _endListeners;              // Collection of end listeners on the clip.
     std::list<ListenerEvent*>* _listeners;              // Ordered collection of listeners on the clip.
@@ -2,13 +2,78 @@
 #include "AnimationController.h"
 #include "Game.h"
 #include "Curve.h"
+#include "Transform.h"
+
+// The floats of a pose animated by each part of a transform.
+#define ANIMATION_POSE_SCALE        0x007
+#define ANIMATION_POSE_ROTATION     0x078
+#define ANIMATION_POSE_TRANSLATION  0x380
+#define ANIMATION_POSE_ROTATION_INDEX 3
 
 namespace gameplay
 {
 
+/**
+ * Spreads the value of a transform property over the floats of a pose.
+ *
+ * @return A mask of the pose floats the property animates, or 0 if it is not part of the pose.
+ */
+static unsigned int expandTransformValue(int propertyId, const float* value, float* pose)
+{
+    switch (propertyId)
+    {
+    case Transform::ANIMATE_SCALE_UNIT:
+        pose[0] = pose[1] = pose[2] = value[0];
+        return ANIMATION_POSE_SCALE;
+    case Transform::ANIMATE_SCALE:
+        memcpy(pose, value, sizeof(float) * 3);
+        return ANIMATION_POSE_SCALE;
+    case Transform::ANIMATE_SCALE_X:
+        pose[0] = value[0];
+        return 0x001;
+    case Transform::ANIMATE_SCALE_Y:
+        pose[1] = value[0];
+        return 0x002;
+    case Transform::ANIMATE_SCALE_Z:
+        pose[2] = value[0];
+        return 0x004;
+    case Transform::ANIMATE_ROTATE:
+        memcpy(pose + 3, value, sizeof(float) * 4);
+        return ANIMATION_POSE_ROTATION;
+    case Transform::ANIMATE_TRANSLATE:
+        memcpy(pose + 7, value, sizeof(float) * 3);
+        return ANIMATION_POSE_TRANSLATION;
+    case Transform::ANIMATE_TRANSLATE_X:
+        pose[7] = value[0];
+        return 0x080;
+    case Transform::ANIMATE_TRANSLATE_Y:
+        pose[8] = value[0];
+        return 0x100;
+    case Transform::ANIMATE_TRANSLATE_Z:
+        pose[9] = value[0];
+        return 0x200;
+    case Transform::ANIMATE_ROTATE_TRANSLATE:
+        memcpy(pose + 3, value, sizeof(float) * 7);
+        return ANIMATION_POSE_ROTATION | ANIMATION_POSE_TRANSLATION;
+    case Transform::ANIMATE_SCALE_ROTATE:
+        memcpy(pose, value, sizeof(float) * 7);
+        return ANIMATION_POSE_SCALE | ANIMATION_POSE_ROTATION;
+    case Transform::ANIMATE_SCALE_TRANSLATE:
+        memcpy(pose, value, sizeof(float) * 3);
+        memcpy(pose + 7, value + 3, sizeof(float) * 3);
+        return ANIMATION_POSE_SCALE | ANIMATION_POSE_TRANSLATION;
+    case Transform::ANIMATE_SCALE_ROTATE_TRANSLATE:
+        memcpy(pose, value, sizeof(float) * 10);
+        return ANIMATION_POSE_SCALE | ANIMATION_POSE_ROTATION | ANIMATION_POSE_TRANSLATION;
+    default:
+        return 0;
+    }
+}
+
 AnimationController::AnimationController()
-    : _state(STOPPED)
+    : _state(STOPPED), _layersChanged(false), _update(0)
 {
+    resetStatistics();
 }
 
 AnimationController::~AnimationController()
@@ -27,6 +92,18 @@ void AnimationController::stopAllAnimations()
     }
 }
 
+const AnimationController::Statistics& AnimationController::getStatistics() const
+{
+    return _statistics;
+}
+
+void AnimationController::resetStatistics()
+{
+    _statistics.clipUpdates = 0;
+    _statistics.poseSamples = 0;
+    _statistics.transformWrites = 0;
+}
+
 AnimationController::State AnimationController::getState() const
 {
     return _state;
@@ -46,6 +123,9 @@ void AnimationController::finalize()
         SAFE_RELEASE(clip);
     }
     _runningClips.clear();
+    _poses.clear();
+    _poseSlots.clear();
+    _sampledPoses.clear();
     _state = STOPPED;
 }
 
@@ -72,6 +152,7 @@ void AnimationController::schedule(AnimationClip* clip)
     GP_ASSERT(clip);
     clip->addRef();
     _runningClips.push_back(clip);
+    _layersChanged = true;
 }
 
 void AnimationController::unschedule(AnimationClip* clip)
@@ -97,9 +178,19 @@ void AnimationController::update(float elapsedTime)
 {
     if (_state != RUNNING)
         return;
+
+    GP_PROFILE_SCOPE("AnimationController::update");
     
     Transform::suspendTransformChanged();
 
+    // Lower layers are sampled first. The sort is stable, so clips of a layer keep their order.
+    if (_layersChanged)
+    {
+        _runningClips.sort([](const AnimationClip* a, const AnimationClip* b) { return a->_layer < b->_layer; });
+        _layersChanged = false;
+    }
+    ++_update;
+
     // Loop through running clips and call update() on them.
     std::list<AnimationClip*>::iterator clipIter = _runningClips.begin();
     while (clipIter != _runningClips.end())
@@ -114,8 +205,9 @@ void AnimationController::update(float elapsedTime)
             clip->setClipStateBit(AnimationClip::CLIP_IS_PLAYING_BIT);
             _runningClips.push_back(clip);
             clipIter = _runningClips.erase(clipIter);
+            _layersChanged = true;
         }
-        else if (clip->update(elapsedTime))
+        else if (++_statistics.clipUpdates, clip->update(elapsedTime))
         {
             clip->release();
             clipIter = _runningClips.erase(clipIter);
@@ -127,10 +219,226 @@ void AnimationController::update(float elapsedTime)
         clip->release();
     }
 
+    writePoses();
+    prunePoses();
+
     Transform::resumeTransformChanged();
 
     if (_runningClips.empty())
         _state = IDLE;
 }
 
+bool AnimationController::samplePose(Transform* transform, int propertyId, const float* value, const float* reference, float weight, unsigned int layer, unsigned int* slot)
+{
+    GP_ASSERT(transform && value && slot);
+
+    float values[POSE_SIZE];
+    unsigned int mask = expandTransformValue(propertyId, value, values);
+    if (mask == 0)
+        return false;
+
+    ++_statistics.poseSamples;
+    if (weight <= 0.0f)
+        return true;
+
+    Pose& pose = getPose(transform, layer, slot);
+    if (pose.layer != layer)
+    {
+        flushLayer(pose);
+        pose.layer = layer;
+    }
+
+    if (reference)
+    {
+        // Additive samples apply their motion since the reference to the pose blended so far.
+        float references[POSE_SIZE];
+        expandTransformValue(propertyId, reference, references);
+        flushLayer(pose);
+        for (unsigned int i = 0; i < POSE_SIZE; ++i)
+        {
+            if ((mask & (1 << i)) && !(ANIMATION_POSE_ROTATION & (1 << i)))
+                pose.base[i] += (values[i] - references[i]) * weight;
+        }
+        if (mask & ANIMATION_POSE_ROTATION)
+        {
+            const float* r = references + ANIMATION_POSE_ROTATION_INDEX;
+            const float* v = values + ANIMATION_POSE_ROTATION_INDEX;
+            Quaternion delta;
+            Quaternion::multiply(Quaternion(-r[0], -r[1], -r[2], r[3]), Quaternion(v[0], v[1], v[2], v[3]), &delta);
+            Quaternion::slerp(Quaternion::identity(), delta, weight, &delta);
+            float* b = pose.base + ANIMATION_POSE_ROTATION_INDEX;
+            Quaternion rotation(b[0], b[1], b[2], b[3]);
+            rotation.multiply(delta);
+            rotation.normalize();
+            b[0] = rotation.x;
+            b[1] = rotation.y;
+            b[2] = rotation.z;
+            b[3] = rotation.w;
+        }
+        return true;
+    }
+
+    for (unsigned int i = 0; i < POSE_SIZE; ++i)
+    {
+        if ((mask & (1 << i)) && !(ANIMATION_POSE_ROTATION & (1 << i)))
+        {
+            pose.sum[i] += values[i] * weight;
+            pose.weight[i] += weight;
+        }
+    }
+    if (mask & ANIMATION_POSE_ROTATION)
+    {
+        // Sum rotations on the same hemisphere, since q and -q are the same rotation.
+        const unsigned int r = ANIMATION_POSE_ROTATION_INDEX;
+        const float* near = pose.weight[r] > 0.0f ? pose.sum + r : pose.base + r;
+        float sign = near[0] * values[r] + near[1] * values[r + 1] + near[2] * values[r + 2] + near[3] * values[r + 3] < 0.0f ? -weight : weight;
+        for (unsigned int i = r; i < r + 4; ++i)
+        {
+            pose.sum[i] += values[i] * sign;
+            pose.weight[i] += weight;
+        }
+    }
+    return true;
+}
+
+AnimationController::Pose& AnimationController::getPose(Transform* transform, unsigned int layer, unsigned int* slot)
+{
+    unsigned int index = *slot;
+    bool added = false;
+    if (index >= _poses.size() || _poses[index].transform != transform)
+    {
+        std::unordered_map<Transform*, unsigned int>::const_iterator itr = _poseSlots.find(transform);
+        if (itr != _poseSlots.end())
+        {
+            index = itr->second;
+        }
+        else
+        {
+            index = (unsigned int)_poses.size();
+            _poses.resize(_poses.size() + 1);
+            _poses[index].transform = transform;
+            _poseSlots[transform] = index;
+            added = true;
+        }
+        *slot = index;
+    }
+
+    Pose& pose = _poses[index];
+    if (added || pose.update != _update)
+    {
+        // Layers blend over the pose the transform had before the update.
+        const Vector3& scale = transform->getScale();
+        const Quaternion& rotation = transform->getRotation();
+        const Vector3& translation = transform->getTranslation();
+        pose.base[0] = scale.x;
+        pose.base[1] = scale.y;
+        pose.base[2] = scale.z;
+        pose.base[3] = rotation.x;
+        pose.base[4] = rotation.y;
+        pose.base[5] = rotation.z;
+        pose.base[6] = rotation.w;
+        pose.base[7] = translation.x;
+        pose.base[8] = translation.y;
+        pose.base[9] = translation.z;
+        memset(pose.sum, 0, sizeof(pose.sum));
+        memset(pose.weight, 0, sizeof(pose.weight));
+        pose.update = _update;
+        pose.layer = layer;
+        _sampledPoses.push_back(index);
+    }
+    return pose;
+}
+
+void AnimationController::flushLayer(Pose& pose)
+{
+    for (unsigned int i = 0; i < POSE_SIZE; ++i)
+    {
+        if (pose.weight[i] > 0.0f && !(ANIMATION_POSE_ROTATION & (1 << i)))
+        {
+            pose.base[i] = Curve::lerp(std::min(pose.weight[i], 1.0f), pose.base[i], pose.sum[i] / pose.weight[i]);
+            pose.sum[i] = 0.0f;
+            pose.weight[i] = 0.0f;
+        }
+    }
+
+    const unsigned int r = ANIMATION_POSE_ROTATION_INDEX;
+    if (pose.weight[r] > 0.0f)
+    {
+        Quaternion sum(pose.sum[r], pose.sum[r + 1], pose.sum[r + 2], pose.sum[r + 3]);
+        sum.normalize();
+        float* b = pose.base + r;
+        Quaternion rotation(b[0], b[1], b[2], b[3]);
+        Quaternion::slerp(rotation, sum, std::min(pose.weight[r], 1.0f), &rotation);
+        b[0] = rotation.x;
+        b[1] = rotation.y;
+        b[2] = rotation.z;
+        b[3] = rotation.w;
+        memset(pose.sum + r, 0, sizeof(float) * 4);
+        memset(pose.weight + r, 0, sizeof(float) * 4);
+    }
+}
+
+void AnimationController::writePoses()
+{
+    for (size_t i = 0, count = _sampledPoses.size(); i < count; ++i)
+    {
+        Pose& pose = _poses[_sampledPoses[i]];
+        flushLayer(pose);
+
+        // Transforms that did not move are not notified.
+        Vector3 scale(pose.base[0], pose.base[1], pose.base[2]);
+        Quaternion rotation(pose.base[3], pose.base[4], pose.base[5], pose.base[6]);
+        Vector3 translation(pose.base[7], pose.base[8], pose.base[9]);
+        Transform* transform = pose.transform;
+        if (scale != transform->getScale() || rotation != transform->getRotation() || translation != transform->getTranslation())
+        {
+            transform->set(scale, rotation, translation);
+            ++_statistics.transformWrites;
+        }
+    }
+    _sampledPoses.clear();
+}
+
+void AnimationController::prunePoses()
+{
+    // Transforms that are no longer animated may be destroyed at any time, so their
+    // poses are not kept past the update they were last sampled in.
+    size_t kept = 0;
+    for (size_t i = 0, count = _poses.size(); i < count; ++i)
+    {
+        if (_poses[i].update != _update)
+        {
+            _poseSlots.erase(_poses[i].transform);
+            continue;
+        }
+        if (kept != i)
+        {
+            _poses[kept] = _poses[i];
+            _poseSlots[_poses[kept].transform] = (unsigned int)kept;
+        }
+        ++kept;
+    }
+    _poses.resize(kept);
+}
+
+void AnimationController::removePose(Transform* transform)
+{
+    std::unordered_map<Transform*, unsigned int>::iterator itr = _poseSlots.find(transform);
+    if (itr == _poseSlots.end())
+        return;
+
+    // Move the last pose into the slot of the removed one.
+    unsigned int index = itr->second;
+    unsigned int last = (unsigned int)_poses.size() - 1;
+    _poseSlots.erase(itr);
+    _sampledPoses.erase(std::remove(_sampledPoses.begin(), _sampledPoses.end(), index), _sampledPoses.end());
+    if (index != last)
+    {
+        _poses[index] = _poses[last];
+        _poseSlots[_poses[index].transform] = index;
+        std::replace(_sampledPoses.begin(), _sampledPoses.end(), last, index);
+    }
+    _poses.pop_back();
+}
+
 }
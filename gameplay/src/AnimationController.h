@@ -9,8 +9,25 @@
 namespace gameplay
 {
 
+class Transform;
+
 /**
  * Defines a class for controlling game animation.
+ *
+ * Clips that animate transforms do not write them directly. Each clip samples
+ * its channels into the pose of the transforms it animates, and once all clips
+ * are updated the blended pose of every animated transform is written to it
+ * in a single change.
+ *
+ * Clips are blended by layer, lowest first. Within a layer the samples of all
+ * clips are averaged by their blend weights, and the result replaces the pose
+ * of the lower layers by the total weight of the layer, up to 1. Additive clips
+ * add their motion to the pose blended so far, and node masks scale the weight
+ * of a clip on parts of a hierarchy.
+ *
+ * @see AnimationClip::setLayer
+ * @see AnimationClip::setBlendMode
+ * @see AnimationClip::setNodeMask
  */
 class AnimationController
 {
@@ -18,16 +35,69 @@ class AnimationController
     friend class Animation;
     friend class AnimationClip;
     friend class SceneLoader;
+    friend class Transform;
 
 public:
 
+    /**
+     * Counters of the work done by the controller.
+     */
+    struct Statistics
+    {
+        /**
+         * The number of clip updates.
+         */
+        unsigned int clipUpdates;
+
+        /**
+         * The number of transform channels sampled into poses.
+         */
+        unsigned int poseSamples;
+
+        /**
+         * The number of blended poses written to transforms.
+         */
+        unsigned int transformWrites;
+    };
+
     /** 
      * Stops all AnimationClips currently playing on the AnimationController.
      */
     void stopAllAnimations();
+
+    /**
+     * Gets the counters accumulated since the last call to resetStatistics().
+     *
+     * @return The statistics.
+     * @script{ignore}
+     */
+    const Statistics& getStatistics() const;
+
+    /**
+     * Resets all counters to zero.
+     */
+    void resetStatistics();
        
 private:
 
+    /**
+     * The number of floats in a pose: scale, rotation and translation.
+     */
+    static const unsigned int POSE_SIZE = 10;
+
+    /**
+     * The pose of a transform being blended during an update.
+     */
+    struct Pose
+    {
+        Transform* transform;
+        unsigned int update;            // The update the pose was last sampled in.
+        unsigned int layer;             // The layer being accumulated.
+        float base[POSE_SIZE];          // The pose blended from the lower layers.
+        float sum[POSE_SIZE];           // The weighted sum of the samples of the current layer.
+        float weight[POSE_SIZE];        // The total weight of the samples of the current layer.
+    };
+
     /**
      * The states that the AnimationController may be in.
      */
@@ -95,9 +165,55 @@ private:
      * Callback for when the controller receives a frame update event.
      */
     void update(float elapsedTime);
-    
+
+    /**
+     * Blends the value of a transform channel into the pose of the transform.
+     *
+     * @param transform The animated transform.
+     * @param propertyId The animated property.
+     * @param value The value of the property.
+     * @param reference The value the motion of an additive clip is relative to, or NULL for other clips.
+     * @param weight The blend weight of the value.
+     * @param layer The layer of the clip.
+     * @param slot The pose slot the channel used last, updated when the pose moves.
+     *
+     * @return True if the value was blended, false if the property is not part of a pose.
+     */
+    bool samplePose(Transform* transform, int propertyId, const float* value, const float* reference, float weight, unsigned int layer, unsigned int* slot);
+
+    /**
+     * Gets the pose of a transform for the current update.
+     */
+    Pose& getPose(Transform* transform, unsigned int layer, unsigned int* slot);
+
+    /**
+     * Blends the samples of the current layer of a pose into the pose of the lower layers.
+     */
+    void flushLayer(Pose& pose);
+
+    /**
+     * Writes the poses sampled during the current update to their transforms.
+     */
+    void writePoses();
+
+    /**
+     * Forgets the poses that were not sampled during the current update.
+     */
+    void prunePoses();
+
+    /**
+     * Forgets the pose of a transform that is being destroyed.
+     */
+    void removePose(Transform* transform);
+
     State _state;                                 // The current state of the AnimationController.
     std::list<AnimationClip*> _runningClips;      // A list of running AnimationClips.
+    bool _layersChanged;                          // Whether the running clips need to be sorted by layer.
+    std::vector<Pose> _poses;                     // The poses of the animated transforms.
+    std::unordered_map<Transform*, unsigned int> _poseSlots; // The pose of each animated transform.
+    std::vector<unsigned int> _sampledPoses;      // The poses sampled during the current update.
+    unsigned int _update;                         // The number of updates, to tell poses of earlier updates apart.
+    Statistics _statistics;
 };
 
 }
@@ -35,6 +35,7 @@
 #include <map>
 #include <unordered_map>
 #include <queue>
+#include <deque>
 #include <algorithm>
 #include <limits>
 #include <functional>
@@ -42,8 +43,11 @@
 #include <typeinfo>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <chrono>
 #include "Logger.h"
+#include "Profiler.h"
 
 // Bring common functions from C into global namespace
 using std::memcpy;
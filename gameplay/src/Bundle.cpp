@@ -40,13 +40,21 @@
 #define BUNDLE_VERSION_MAJOR_FONT_FORMAT  1
 #define BUNDLE_VERSION_MINOR_FONT_FORMAT  5
 
+#define BUNDLE_VERSION_MAJOR_ANIMATION_COMPRESSION  1
+#define BUNDLE_VERSION_MINOR_ANIMATION_COMPRESSION  6
+
+// Compression of animation channel keys
+#define BUNDLE_ANIMATION_COMPRESSION_NONE       0
+#define BUNDLE_ANIMATION_COMPRESSION_QUANTIZED  1
+
 namespace gameplay
 {
 
 static std::vector<Bundle*> __bundleCache;
 
 Bundle::Bundle(const char* path) :
-    _path(path), _referenceCount(0), _references(NULL), _stream(NULL), _trackedNodes(NULL)
+    _path(path), _referenceCount(0), _references(NULL), _stream(NULL), _data(NULL), _dataLength(0), _dataPosition(0),
+    _dataMapped(false), _cached(false), _trackedNodes(NULL)
 {
 }
 
@@ -54,11 +62,15 @@ Bundle::~Bundle()
 {
     clearLoadSession();
 
-    // Remove this Bundle from the cache.
-    std::vector<Bundle*>::iterator itr = std::find(__bundleCache.begin(), __bundleCache.end(), this);
-    if (itr != __bundleCache.end())
+    // Remove this Bundle from the cache. Bundles opened on loader threads are only
+    // cached on the main thread, so uncached ones never touch the cache.
+    if (_cached)
     {
-        __bundleCache.erase(itr);
+        std::vector<Bundle*>::iterator itr = std::find(__bundleCache.begin(), __bundleCache.end(), this);
+        if (itr != __bundleCache.end())
+        {
+            __bundleCache.erase(itr);
+        }
     }
 
     SAFE_DELETE_ARRAY(_references);
@@ -67,6 +79,15 @@ Bundle::~Bundle()
     {
         SAFE_DELETE(_stream);
     }
+
+    if (_dataMapped)
+    {
+        FileSystem::unmapFile((const char*)_data, _dataLength);
+    }
+    else
+    {
+        SAFE_DELETE_ARRAY(_data);
+    }
 }
 
 unsigned int Bundle::getVersionMajor() const
@@ -84,7 +105,7 @@ bool Bundle::readArray(unsigned int* length, T** ptr)
 {
     GP_ASSERT(length);
     GP_ASSERT(ptr);
-    GP_ASSERT(_stream);
+    GP_ASSERT(_stream || _data);
 
     if (!read(length))
     {
@@ -94,7 +115,7 @@ bool Bundle::readArray(unsigned int* length, T** ptr)
     if (*length > 0)
     {
         *ptr = new T[*length];
-        if (_stream->read(*ptr, sizeof(T), *length) != *length)
+        if (readData(*ptr, sizeof(T), *length) != *length)
         {
             GP_ERROR("Failed to read an array of data from bundle (into an array).");
             SAFE_DELETE_ARRAY(*ptr);
@@ -108,7 +129,7 @@ template <class T>
 bool Bundle::readArray(unsigned int* length, std::vector<T>* values)
 {
     GP_ASSERT(length);
-    GP_ASSERT(_stream);
+    GP_ASSERT(_stream || _data);
 
     if (!read(length))
     {
@@ -118,7 +139,7 @@ bool Bundle::readArray(unsigned int* length, std::vector<T>* values)
     if (*length > 0 && values)
     {
         values->resize(*length);
-        if (_stream->read(&(*values)[0], sizeof(T), *length) != *length)
+        if (readData(&(*values)[0], sizeof(T), *length) != *length)
         {
             GP_ERROR("Failed to read an array of data from bundle (into a std::vector).");
             return false;
@@ -131,7 +152,7 @@ template <class T>
 bool Bundle::readArray(unsigned int* length, std::vector<T>* values, unsigned int readSize)
 {
     GP_ASSERT(length);
-    GP_ASSERT(_stream);
+    GP_ASSERT(_stream || _data);
     GP_ASSERT(sizeof(T) >= readSize);
 
     if (!read(length))
@@ -142,7 +163,7 @@ bool Bundle::readArray(unsigned int* length, std::vector<T>* values, unsigned in
     if (*length > 0 && values)
     {
         values->resize(*length);
-        if (_stream->read(&(*values)[0], readSize, *length) != *length)
+        if (readData(&(*values)[0], readSize, *length) != *length)
         {
             GP_ERROR("Failed to read an array of data from bundle (into a std::vector with a specified single element read size).");
             return false;
@@ -151,131 +172,285 @@ bool Bundle::readArray(unsigned int* length, std::vector<T>* values, unsigned in
     return true;
 }
 
-static std::string readString(Stream* stream)
+Bundle* Bundle::create(const char* path, bool memoryMapped)
 {
-    GP_ASSERT(stream);
-
-    unsigned int length;
-    if (stream->read(&length, 4, 1) != 1)
-    {
-        GP_ERROR("Failed to read the length of a string from a bundle.");
-        return std::string();
-    }
+    GP_ASSERT(path);
 
-    // Sanity check to detect if string length is far too big.
-    GP_ASSERT(length < BUNDLE_MAX_STRING_LENGTH);
+    Bundle* bundle = findCached(path, memoryMapped);
+    if (bundle)
+        return bundle;
 
-    std::string str;
-    if (length > 0)
+    bundle = open(path, memoryMapped);
+    if (bundle)
     {
-        str.resize(length);
-        if (stream->read(&str[0], 1, length) != length)
-        {
-            GP_ERROR("Failed to read string from bundle.");
-            return std::string();
-        }
+        bundle->_cached = true;
+        __bundleCache.push_back(bundle);
     }
-    return str;
+    return bundle;
 }
 
-Bundle* Bundle::create(const char* path)
+Bundle* Bundle::findCached(const char* path, bool memoryMapped)
 {
-    GP_ASSERT(path);
-
-    // Search the cache for this bundle.
+    // A bundle held in memory serves both kinds of requests, but a stream-backed
+    // one does not satisfy a request for a mapped load.
     for (size_t i = 0, count = __bundleCache.size(); i < count; ++i)
     {
         Bundle* p = __bundleCache[i];
         GP_ASSERT(p);
-        if (p->_path == path)
+        if (p->_path == path && (!memoryMapped || p->_data))
         {
             // Found a match
             p->addRef();
             return p;
         }
     }
+    return NULL;
+}
+
+Bundle* Bundle::cache(Bundle* bundle)
+{
+    GP_ASSERT(bundle && !bundle->_cached);
+
+    Bundle* cached = findCached(bundle->_path.c_str(), bundle->_data != NULL);
+    if (cached)
+    {
+        SAFE_RELEASE(bundle);
+        return cached;
+    }
+
+    bundle->_cached = true;
+    __bundleCache.push_back(bundle);
+    return bundle;
+}
 
-    // Open the bundle.
-    Stream* stream = FileSystem::open(path);
-    if (!stream)
+Bundle* Bundle::open(const char* path, bool memoryMapped)
+{
+    GP_ASSERT(path);
+
+    Bundle* bundle = new Bundle(path);
+    if (memoryMapped)
     {
+        size_t length = 0;
+        const char* data = FileSystem::mapFile(path, &length);
+        if (data)
+        {
+            bundle->_dataMapped = true;
+        }
+        else
+        {
+            // The file does not live on the local file system (assets, packages),
+            // so read its contents into memory once instead.
+            std::unique_ptr<Stream> stream(FileSystem::open(path));
+            if (stream.get())
+            {
+                length = stream->length();
+                char* buffer = new char[length];
+                if (length == 0 || stream->read(buffer, 1, length) != length)
+                {
+                    SAFE_DELETE_ARRAY(buffer);
+                }
+                data = buffer;
+            }
+        }
+        bundle->_data = (const unsigned char*)data;
+        bundle->_dataLength = data ? length : 0;
+    }
+    else
+    {
+        bundle->_stream = FileSystem::open(path);
+    }
+    if (!bundle->_stream && !bundle->_data)
+    {
+        SAFE_RELEASE(bundle);
         GP_WARN("Failed to open file '%s'.", path);
         return NULL;
     }
 
     // Read the GPB header info.
     char sig[9];
-    if (stream->read(sig, 1, 9) != 9 || memcmp(sig, "\xABGPB\xBB\r\n\x1A\n", 9) != 0)
+    if (bundle->readData(sig, 1, 9) != 9 || memcmp(sig, "\xABGPB\xBB\r\n\x1A\n", 9) != 0)
     {
-        SAFE_DELETE(stream);
+        SAFE_RELEASE(bundle);
         GP_WARN("Invalid GPB header for bundle '%s'.", path);
         return NULL;
     }
 
     // Read version.
-    unsigned char version[2];
-    if (stream->read(version, 1, 2) != 2)
+    unsigned char* version = bundle->_version;
+    if (bundle->readData(version, 1, 2) != 2)
     {
-        SAFE_DELETE(stream);
+        SAFE_RELEASE(bundle);
         GP_WARN("Failed to read GPB version for bundle '%s'.", path);
         return NULL;
     }
     // Check for the minimal 
     if (version[0] != BUNDLE_VERSION_MAJOR_REQUIRED || version[1] < BUNDLE_VERSION_MINOR_REQUIRED)
     {
-        SAFE_DELETE(stream);
         GP_WARN("Unsupported version (%d.%d) for bundle '%s' (expected %d.%d).", (int)version[0], (int)version[1], path, BUNDLE_VERSION_MAJOR_REQUIRED, BUNDLE_VERSION_MINOR_REQUIRED);
+        SAFE_RELEASE(bundle);
         return NULL;
     }
 
     // Read ref table.
     unsigned int refCount;
-    if (stream->read(&refCount, 4, 1) != 1)
+    if (bundle->readData(&refCount, 4, 1) != 1)
     {
-        SAFE_DELETE(stream);
+        SAFE_RELEASE(bundle);
         GP_WARN("Failed to read ref table for bundle '%s'.", path);
         return NULL;
     }
 
     // Read all refs.
     Reference* refs = new Reference[refCount];
+    bundle->_referenceCount = refCount;
+    bundle->_references = refs;
     for (unsigned int i = 0; i < refCount; ++i)
     {
-        if ((refs[i].id = readString(stream)).empty() ||
-            stream->read(&refs[i].type, 4, 1) != 1 ||
-            stream->read(&refs[i].offset, 4, 1) != 1)
+        if ((refs[i].id = bundle->readString()).empty() ||
+            bundle->readData(&refs[i].type, 4, 1) != 1 ||
+            bundle->readData(&refs[i].offset, 4, 1) != 1)
         {
-            SAFE_DELETE(stream);
+            SAFE_RELEASE(bundle);
             GP_WARN("Failed to read ref number %d for bundle '%s'.", i, path);
-            SAFE_DELETE_ARRAY(refs);
             return NULL;
         }
     }
+    bundle->buildReferenceIndex();
 
-    // Keep file open for faster reading later.
-    Bundle* bundle = new Bundle(path);
-    bundle->_version[0] = version[0];
-    bundle->_version[1] = version[1];
-    bundle->_referenceCount = refCount;
-    bundle->_references = refs;
-    bundle->_stream = stream;
-
+    // Keep file open (or mapped) for faster reading later.
     return bundle;
 }
 
-Bundle::Reference* Bundle::find(const char* id) const
+void Bundle::buildReferenceIndex()
 {
-    GP_ASSERT(id);
-    GP_ASSERT(_references);
+    _referenceIndex.clear();
+    _offsetIndex.clear();
+    _referenceIndex.reserve(_referenceCount);
+    _offsetIndex.reserve(_referenceCount);
 
-    // Search the ref table for the given id (case-sensitive).
+    // insert() keeps the first entry for duplicate keys, which preserves
+    // the first-match semantics of a linear scan over the reference table.
     for (unsigned int i = 0; i < _referenceCount; ++i)
     {
-        if (_references[i].id == id)
+        Reference* ref = &_references[i];
+        _referenceIndex.insert(std::make_pair(ref->id, ref));
+        if (ref->offset > 0 && ref->id.length() > 0)
         {
-            // Found a match
-            return &_references[i];
+            _offsetIndex.insert(std::make_pair(ref->offset, ref));
+        }
+    }
+}
+
+size_t Bundle::readData(void* ptr, size_t size, size_t count)
+{
+    if (_data)
+    {
+        // Only whole elements are read, the same as fread().
+        GP_ASSERT(size > 0);
+        size_t available = (_dataLength - _dataPosition) / size;
+        if (count > available)
+            count = available;
+
+        size_t byteCount = size * count;
+        memcpy(ptr, _data + _dataPosition, byteCount);
+        _dataPosition += byteCount;
+        return count;
+    }
+
+    GP_ASSERT(_stream);
+    return _stream->read(ptr, size, count);
+}
+
+bool Bundle::seek(long int offset, int origin)
+{
+    if (_data)
+    {
+        long int base;
+        switch (origin)
+        {
+        case SEEK_SET:
+            base = 0;
+            break;
+        case SEEK_CUR:
+            base = (long int)_dataPosition;
+            break;
+        case SEEK_END:
+            base = (long int)_dataLength;
+            break;
+        default:
+            return false;
         }
+
+        long int target = base + offset;
+        if (target < 0 || (size_t)target > _dataLength)
+            return false;
+
+        _dataPosition = (size_t)target;
+        return true;
+    }
+
+    GP_ASSERT(_stream);
+    return _stream->seek(offset, origin);
+}
+
+long int Bundle::position() const
+{
+    if (_data)
+        return (long int)_dataPosition;
+
+    GP_ASSERT(_stream);
+    return _stream->position();
+}
+
+std::string Bundle::readString()
+{
+    unsigned int length;
+    if (readData(&length, 4, 1) != 1)
+    {
+        GP_ERROR("Failed to read the length of a string from a bundle.");
+        return std::string();
+    }
+
+    // Sanity check to detect if string length is far too big.
+    GP_ASSERT(length < BUNDLE_MAX_STRING_LENGTH);
+
+    std::string str;
+    if (length > 0)
+    {
+        if (_data)
+        {
+            // Construct the string straight from the mapped contents.
+            if (_dataLength - _dataPosition < length)
+            {
+                GP_ERROR("Failed to read string from bundle.");
+                return std::string();
+            }
+            str.assign((const char*)_data + _dataPosition, length);
+            _dataPosition += length;
+        }
+        else
+        {
+            str.resize(length);
+            if (readData(&str[0], 1, length) != length)
+            {
+                GP_ERROR("Failed to read string from bundle.");
+                return std::string();
+            }
+        }
+    }
+    return str;
+}
+
+Bundle::Reference* Bundle::find(const char* id) const
+{
+    GP_ASSERT(id);
+    GP_ASSERT(_references);
+
+    // Look up the given id in the hashed ref table (case-sensitive).
+    std::unordered_map<std::string, Reference*>::const_iterator itr = _referenceIndex.find(id);
+    if (itr != _referenceIndex.end())
+    {
+        return itr->second;
     }
 
     return NULL;
@@ -292,22 +467,20 @@ void Bundle::clearLoadSession()
 
 const char* Bundle::getIdFromOffset() const
 {
-    GP_ASSERT(_stream);
-    return getIdFromOffset((unsigned int) _stream->position());
+    GP_ASSERT(_stream || _data);
+    return getIdFromOffset((unsigned int) position());
 }
 
 const char* Bundle::getIdFromOffset(unsigned int offset) const
 {
-    // Search the ref table for the given offset.
+    // Look up the given offset in the hashed ref table.
     if (offset > 0)
     {
         GP_ASSERT(_references);
-        for (unsigned int i = 0; i < _referenceCount; ++i)
+        std::unordered_map<unsigned int, Reference*>::const_iterator itr = _offsetIndex.find(offset);
+        if (itr != _offsetIndex.end())
         {
-            if (_references[i].offset == offset && _references[i].id.length() > 0)
-            {
-                return _references[i].id.c_str();
-            }
+            return itr->second->id.c_str();
         }
     }
     return NULL;
@@ -347,8 +520,8 @@ Bundle::Reference* Bundle::seekTo(const char* id, unsigned int type)
     }
 
     // Seek to the offset of this object.
-    GP_ASSERT(_stream);
-    if (_stream->seek(ref->offset, SEEK_SET) == false)
+    GP_ASSERT(_stream || _data);
+    if (seek(ref->offset, SEEK_SET) == false)
     {
         GP_ERROR("Failed to seek to object '%s' in bundle '%s'.", id, _path.c_str());
         return NULL;
@@ -360,7 +533,7 @@ Bundle::Reference* Bundle::seekTo(const char* id, unsigned int type)
 Bundle::Reference* Bundle::seekToFirstType(unsigned int type)
 {
     GP_ASSERT(_references);
-    GP_ASSERT(_stream);
+    GP_ASSERT(_stream || _data);
 
     for (unsigned int i = 0; i < _referenceCount; ++i)
     {
@@ -368,7 +541,7 @@ Bundle::Reference* Bundle::seekToFirstType(unsigned int type)
         if (ref->type == type)
         {
             // Found a match.
-            if (_stream->seek(ref->offset, SEEK_SET) == false)
+            if (seek(ref->offset, SEEK_SET) == false)
             {
                 GP_ERROR("Failed to seek to object '%s' in bundle '%s'.", ref->id.c_str(), _path.c_str());
                 return NULL;
@@ -381,22 +554,22 @@ Bundle::Reference* Bundle::seekToFirstType(unsigned int type)
 
 bool Bundle::read(unsigned int* ptr)
 {
-    return _stream->read(ptr, sizeof(unsigned int), 1) == 1;
+    return readData(ptr, sizeof(unsigned int), 1) == 1;
 }
 
 bool Bundle::read(unsigned char* ptr)
 {
-    return _stream->read(ptr, sizeof(unsigned char), 1) == 1;
+    return readData(ptr, sizeof(unsigned char), 1) == 1;
 }
 
 bool Bundle::read(float* ptr)
 {
-    return _stream->read(ptr, sizeof(float), 1) == 1;
+    return readData(ptr, sizeof(float), 1) == 1;
 }
 
 bool Bundle::readMatrix(float* m)
 {
-    return _stream->read(m, sizeof(float), 16) == 16;
+    return readData(m, sizeof(float), 16) == 16;
 }
 
 Scene* Bundle::loadScene(const char* id)
@@ -447,7 +620,7 @@ Scene* Bundle::loadScene(const char* id)
         }
     }
     // Read active camera.
-    std::string xref = readString(_stream);
+    std::string xref = readString();
     if (xref.length() > 1 && xref[0] == '#') // TODO: Handle full xrefs
     {
         Node* node = scene->findNode(xref.c_str() + 1, true);
@@ -481,14 +654,14 @@ Scene* Bundle::loadScene(const char* id)
 
     // Parse animations.
     GP_ASSERT(_references);
-    GP_ASSERT(_stream);
+    GP_ASSERT(_stream || _data);
     for (unsigned int i = 0; i < _referenceCount; ++i)
     {
         Reference* ref = &_references[i];
         if (ref->type == BUNDLE_TYPE_ANIMATIONS)
         {
             // Found a match.
-            if (_stream->seek(ref->offset, SEEK_SET) == false)
+            if (seek(ref->offset, SEEK_SET) == false)
             {
                 GP_ERROR("Failed to seek to object '%s' in bundle '%s'.", ref->id.c_str(), _path.c_str());
                 return NULL;
@@ -511,7 +684,7 @@ Node* Bundle::loadNode(const char* id, Scene* sceneContext)
 {
     GP_ASSERT(id);
     GP_ASSERT(_references);
-    GP_ASSERT(_stream);
+    GP_ASSERT(_stream || _data);
 
     clearLoadSession();
 
@@ -527,7 +700,7 @@ Node* Bundle::loadNode(const char* id, Scene* sceneContext)
         Reference* ref = &_references[i];
         if (ref->type == BUNDLE_TYPE_ANIMATIONS)
         {
-            if (_stream->seek(ref->offset, SEEK_SET) == false)
+            if (seek(ref->offset, SEEK_SET) == false)
             {
                 GP_ERROR("Failed to seek to object '%s' in bundle '%s'.", ref->id.c_str(), _path.c_str());
                 SAFE_DELETE(_trackedNodes);
@@ -545,7 +718,7 @@ Node* Bundle::loadNode(const char* id, Scene* sceneContext)
 
             for (unsigned int j = 0; j < animationCount; j++)
             {
-                const std::string id = readString(_stream);
+                const std::string id = readString();
 
                 // Read the number of animation channels in this animation.
                 unsigned int animationChannelCount;
@@ -560,7 +733,7 @@ Node* Bundle::loadNode(const char* id, Scene* sceneContext)
                 for (unsigned int k = 0; k < animationChannelCount; k++)
                 {
                     // Read target id.
-                    std::string targetId = readString(_stream);
+                    std::string targetId = readString();
                     if (targetId.empty())
                     {
                         GP_ERROR("Failed to read target id for animation '%s'.", id.c_str());
@@ -655,7 +828,7 @@ bool Bundle::skipNode()
 {
     const char* id = getIdFromOffset();
     GP_ASSERT(id);
-    GP_ASSERT(_stream);
+    GP_ASSERT(_stream || _data);
 
     // Skip the node's type.
     unsigned int nodeType;
@@ -666,12 +839,12 @@ bool Bundle::skipNode()
     }
 
     // Skip over the node's transform and parent ID.
-    if (_stream->seek(sizeof(float) * 16, SEEK_CUR) == false)
+    if (seek(sizeof(float) * 16, SEEK_CUR) == false)
     {
         GP_ERROR("Failed to skip over node transform for node '%s'.", id);
         return false;
     }
-    readString(_stream);
+    readString();
 
     // Skip over the node's children.
     unsigned int childrenCount;
@@ -704,7 +877,7 @@ Node* Bundle::readNode(Scene* sceneContext, Node* nodeContext)
 {
     const char* id = getIdFromOffset();
     GP_ASSERT(id);
-    GP_ASSERT(_stream);
+    GP_ASSERT(_stream || _data);
 
     // If we are tracking nodes and it's not in the set yet, add it.
     if (_trackedNodes)
@@ -756,7 +929,7 @@ Node* Bundle::readNode(Scene* sceneContext, Node* nodeContext)
 
     // Read transform.
     float transform[16];
-    if (_stream->read(transform, sizeof(float), 16) != 16)
+    if (readData(transform, sizeof(float), 16) != 16)
     {
         GP_ERROR("Failed to read transform for node '%s'.", id);
         SAFE_RELEASE(node);
@@ -765,7 +938,7 @@ Node* Bundle::readNode(Scene* sceneContext, Node* nodeContext)
     setTransform(transform, node);
 
     // Skip the parent ID.
-    readString(_stream);
+    readString();
 
     // Read children.
     unsigned int childrenCount;
@@ -982,7 +1155,7 @@ Light* Bundle::readLight()
 
 Model* Bundle::readModel(const char* nodeId)
 {
-    std::string xref = readString(_stream);
+    std::string xref = readString();
     if (xref.length() > 1 && xref[0] == '#') // TODO: Handle full xrefs
     {
         Mesh* mesh = loadMesh(xref.c_str() + 1, nodeId);
@@ -1017,7 +1190,7 @@ Model* Bundle::readModel(const char* nodeId)
             {
                 for (unsigned int i = 0; i < materialCount; ++i)
                 {
-                    std::string materialName = readString(_stream);
+                    std::string materialName = readString();
                     std::string materialPath = getMaterialPath();
                     if (materialPath.length() > 0)
                     {
@@ -1078,7 +1251,7 @@ MeshSkin* Bundle::readMeshSkin()
     // Read joint xref strings for all joints in the list.
     for (unsigned int i = 0; i < jointCount; i++)
     {
-        skinData->joints.push_back(readString(_stream));
+        skinData->joints.push_back(readString());
     }
 
     // Read bind poses.
@@ -1115,7 +1288,7 @@ MeshSkin* Bundle::readMeshSkin()
 
 void Bundle::resolveJointReferences(Scene* sceneContext, Node* nodeContext)
 {
-    GP_ASSERT(_stream);
+    GP_ASSERT(_stream || _data);
 
     for (size_t i = 0, skinCount = _meshSkins.size(); i < skinCount; ++i)
     {
@@ -1187,12 +1360,12 @@ void Bundle::resolveJointReferences(Scene* sceneContext, Node* nodeContext)
                         seekTo(nodeId.c_str(), ref->type);
 
                         // Skip over the node type (1 unsigned int) and transform (16 floats) and read the parent id.
-                        if (_stream->seek(sizeof(unsigned int) + sizeof(float)*16, SEEK_CUR) == false)
+                        if (seek(sizeof(unsigned int) + sizeof(float)*16, SEEK_CUR) == false)
                         {
                             GP_ERROR("Failed to skip over node type and transform for node '%s' in bundle '%s'.", nodeId.c_str(), _path.c_str());
                             return;
                         }
-                        std::string parentID = readString(_stream);
+                        std::string parentID = readString();
 
                         if (!parentID.empty())
                             nodeId = parentID;
@@ -1228,7 +1401,7 @@ void Bundle::resolveJointReferences(Scene* sceneContext, Node* nodeContext)
 
 void Bundle::readAnimation(Scene* scene)
 {
-    const std::string animationId = readString(_stream);
+    const std::string animationId = readString();
 
     // Read the number of animation channels in this animation.
     unsigned int animationChannelCount;
@@ -1266,7 +1439,7 @@ Animation* Bundle::readAnimationChannel(Scene* scene, Animation* animation, cons
     GP_ASSERT(animationId);
 
     // Read target id.
-    std::string targetId = readString(_stream);
+    std::string targetId = readString();
     if (targetId.empty())
     {
         GP_ERROR("Failed to read target id for animation '%s'.", animationId);
@@ -1349,7 +1522,65 @@ Animation* Bundle::readAnimationChannelData(Animation* animation, const char* id
         return NULL;
     }
 
-    if (targetAttribute > 0)
+    // Read quantized keys, which replace the key values.
+    unsigned int compression = BUNDLE_ANIMATION_COMPRESSION_NONE;
+    std::vector<float> ranges;
+    std::vector<unsigned short> keys;
+    if (getVersionMajor() >= BUNDLE_VERSION_MAJOR_ANIMATION_COMPRESSION && getVersionMinor() >= BUNDLE_VERSION_MINOR_ANIMATION_COMPRESSION)
+    {
+        if (!read(&compression))
+        {
+            GP_ERROR("Failed to read the compression for animation '%s'.", id);
+            return NULL;
+        }
+        if (compression == BUNDLE_ANIMATION_COMPRESSION_QUANTIZED)
+        {
+            unsigned int rangesCount;
+            unsigned int keysCount;
+            if (!readArray(&rangesCount, &ranges) || !readArray(&keysCount, &keys))
+            {
+                GP_ERROR("Failed to read the quantized keys for animation '%s'.", id);
+                return NULL;
+            }
+            if (keyTimesCount == 0 || keysCount % keyTimesCount != 0)
+            {
+                GP_ERROR("Invalid quantized keys for animation '%s'.", id);
+                return NULL;
+            }
+        }
+        else if (compression != BUNDLE_ANIMATION_COMPRESSION_NONE)
+        {
+            GP_ERROR("Unsupported compression %u for animation '%s'.", compression, id);
+            return NULL;
+        }
+    }
+
+    if (targetAttribute > 0 && compression == BUNDLE_ANIMATION_COMPRESSION_QUANTIZED)
+    {
+        GP_ASSERT(target);
+        if (ranges.size() != target->getAnimationPropertyComponentCount(targetAttribute) * 2)
+        {
+            GP_ERROR("Invalid quantized key ranges for animation '%s'.", id);
+            return NULL;
+        }
+        unsigned int keyStride = (unsigned int)keys.size() / keyTimesCount;
+        if (animation == NULL)
+        {
+            // Like the animations created by targets, the new animation is held by its channels.
+            animation = new Animation(id);
+            if (!animation->createChannel(target, targetAttribute, keyTimesCount, &keyTimes[0], &keys[0], keyStride, &ranges[0]))
+            {
+                SAFE_RELEASE(animation);
+                return NULL;
+            }
+            animation->release();
+        }
+        else
+        {
+            animation->createChannel(target, targetAttribute, keyTimesCount, &keyTimes[0], &keys[0], keyStride, &ranges[0]);
+        }
+    }
+    else if (targetAttribute > 0)
     {
         GP_ASSERT(target);
         GP_ASSERT(keyTimes.size() > 0 && values.size() > 0);
@@ -1374,12 +1605,12 @@ Mesh* Bundle::loadMesh(const char* id)
 
 Mesh* Bundle::loadMesh(const char* id, const char* nodeId)
 {
-    GP_ASSERT(_stream);
+    GP_ASSERT(_stream || _data);
     GP_ASSERT(id);
 
     // Save the file position.
-    long position = _stream->position();
-    if (position == -1L)
+    long savedPosition = position();
+    if (savedPosition == -1L)
     {
         GP_ERROR("Failed to save the current file position before loading mesh '%s'.", id);
         return NULL;
@@ -1438,7 +1669,7 @@ Mesh* Bundle::loadMesh(const char* id, const char* nodeId)
     SAFE_DELETE(meshData);
 
     // Restore file pointer.
-    if (_stream->seek(position, SEEK_SET) == false)
+    if (seek(savedPosition, SEEK_SET) == false)
     {
         GP_ERROR("Failed to restore file pointer after loading mesh '%s'.", id);
         return NULL;
@@ -1451,7 +1682,7 @@ Bundle::MeshData* Bundle::readMeshData()
 {
     // Read vertex format/elements.
     unsigned int vertexElementCount;
-    if (_stream->read(&vertexElementCount, 4, 1) != 1)
+    if (readData(&vertexElementCount, 4, 1) != 1)
     {
         GP_ERROR("Failed to load vertex element count.");
         return NULL;
@@ -1466,13 +1697,13 @@ Bundle::MeshData* Bundle::readMeshData()
     for (unsigned int i = 0; i < vertexElementCount; ++i)
     {
         unsigned int vUsage, vSize;
-        if (_stream->read(&vUsage, 4, 1) != 1)
+        if (readData(&vUsage, 4, 1) != 1)
         {
             GP_ERROR("Failed to load vertex usage.");
             SAFE_DELETE_ARRAY(vertexElements);
             return NULL;
         }
-        if (_stream->read(&vSize, 4, 1) != 1)
+        if (readData(&vSize, 4, 1) != 1)
         {
             GP_ERROR("Failed to load vertex size.");
             SAFE_DELETE_ARRAY(vertexElements);
@@ -1488,7 +1719,7 @@ Bundle::MeshData* Bundle::readMeshData()
 
     // Read vertex data.
     unsigned int vertexByteCount;
-    if (_stream->read(&vertexByteCount, 4, 1) != 1)
+    if (readData(&vertexByteCount, 4, 1) != 1)
     {
         GP_ERROR("Failed to load vertex byte count.");
         SAFE_DELETE(meshData);
@@ -1504,7 +1735,7 @@ Bundle::MeshData* Bundle::readMeshData()
     GP_ASSERT(meshData->vertexFormat.getVertexSize());
     meshData->vertexCount = vertexByteCount / meshData->vertexFormat.getVertexSize();
     meshData->vertexData = new unsigned char[vertexByteCount];
-    if (_stream->read(meshData->vertexData, 1, vertexByteCount) != vertexByteCount)
+    if (readData(meshData->vertexData, 1, vertexByteCount) != vertexByteCount)
     {
         GP_ERROR("Failed to load vertex data.");
         SAFE_DELETE(meshData);
@@ -1512,13 +1743,13 @@ Bundle::MeshData* Bundle::readMeshData()
     }
 
     // Read mesh bounds (bounding box and bounding sphere).
-    if (_stream->read(&meshData->boundingBox.min.x, 4, 3) != 3 || _stream->read(&meshData->boundingBox.max.x, 4, 3) != 3)
+    if (readData(&meshData->boundingBox.min.x, 4, 3) != 3 || readData(&meshData->boundingBox.max.x, 4, 3) != 3)
     {
         GP_ERROR("Failed to load mesh bounding box.");
         SAFE_DELETE(meshData);
         return NULL;
     }
-    if (_stream->read(&meshData->boundingSphere.center.x, 4, 3) != 3 || _stream->read(&meshData->boundingSphere.radius, 4, 1) != 1)
+    if (readData(&meshData->boundingSphere.center.x, 4, 3) != 3 || readData(&meshData->boundingSphere.radius, 4, 1) != 1)
     {
         GP_ERROR("Failed to load mesh bounding sphere.");
         SAFE_DELETE(meshData);
@@ -1527,7 +1758,7 @@ Bundle::MeshData* Bundle::readMeshData()
 
     // Read mesh parts.
     unsigned int meshPartCount;
-    if (_stream->read(&meshPartCount, 4, 1) != 1)
+    if (readData(&meshPartCount, 4, 1) != 1)
     {
         GP_ERROR("Failed to load mesh part count.");
         SAFE_DELETE(meshData);
@@ -1537,19 +1768,19 @@ Bundle::MeshData* Bundle::readMeshData()
     {
         // Read primitive type, index format and index count.
         unsigned int pType, iFormat, iByteCount;
-        if (_stream->read(&pType, 4, 1) != 1)
+        if (readData(&pType, 4, 1) != 1)
         {
             GP_ERROR("Failed to load primitive type for mesh part with index %d.", i);
             SAFE_DELETE(meshData);
             return NULL;
         }
-        if (_stream->read(&iFormat, 4, 1) != 1)
+        if (readData(&iFormat, 4, 1) != 1)
         {
             GP_ERROR("Failed to load index format for mesh part with index %d.", i);
             SAFE_DELETE(meshData);
             return NULL;
         }
-        if (_stream->read(&iByteCount, 4, 1) != 1)
+        if (readData(&iByteCount, 4, 1) != 1)
         {
             GP_ERROR("Failed to load index byte count for mesh part with index %d.", i);
             SAFE_DELETE(meshData);
@@ -1583,7 +1814,7 @@ Bundle::MeshData* Bundle::readMeshData()
         partData->indexCount = iByteCount / indexSize;
 
         partData->indexData = new unsigned char[iByteCount];
-        if (_stream->read(partData->indexData, 1, iByteCount) != iByteCount)
+        if (readData(partData->indexData, 1, iByteCount) != iByteCount)
         {
             GP_ERROR("Failed to read index data for mesh part with index %d.", i);
             SAFE_DELETE(meshData);
@@ -1644,7 +1875,7 @@ Bundle::MeshData* Bundle::readMeshData(const char* url)
 Font* Bundle::loadFont(const char* id)
 {
     GP_ASSERT(id);
-    GP_ASSERT(_stream);
+    GP_ASSERT(_stream || _data);
 
     // Seek to the specified font.
     Reference* ref = seekTo(id, BUNDLE_TYPE_FONT);
@@ -1655,7 +1886,7 @@ Font* Bundle::loadFont(const char* id)
     }
 
     // Read font family.
-    std::string family = readString(_stream);
+    std::string family = readString();
     if (family.empty())
     {
         GP_ERROR("Failed to read font family for font '%s'.", id);
@@ -1664,7 +1895,7 @@ Font* Bundle::loadFont(const char* id)
 
     // Read font style
     unsigned int style;
-    if (_stream->read(&style, 4, 1) != 1)
+    if (readData(&style, 4, 1) != 1)
     {
         GP_ERROR("Failed to read style for font '%s'.", id);
         return NULL;
@@ -1674,7 +1905,7 @@ Font* Bundle::loadFont(const char* id)
     unsigned int fontSizeCount = 1;
     if (getVersionMajor() >= 1 && getVersionMinor() >= 4)
     {
-        if (_stream->read(&fontSizeCount, 4, 1) != 1)
+        if (readData(&fontSizeCount, 4, 1) != 1)
         {
             GP_ERROR("Failed to read font size count for font '%s'.", id);
             return NULL;
@@ -1687,18 +1918,18 @@ Font* Bundle::loadFont(const char* id)
     {
         // Read font size
         unsigned int size;
-        if (_stream->read(&size, 4, 1) != 1)
+        if (readData(&size, 4, 1) != 1)
         {
             GP_ERROR("Failed to read size for font '%s'.", id);
             return NULL;
         }
 
         // Read character set.
-        std::string charset = readString(_stream);
+        std::string charset = readString();
 
         // Read font glyphs.
         unsigned int glyphCount;
-        if (_stream->read(&glyphCount, 4, 1) != 1)
+        if (readData(&glyphCount, 4, 1) != 1)
         {
             GP_ERROR("Failed to read glyph count for font '%s'.", id);
             return NULL;
@@ -1712,13 +1943,13 @@ Font* Bundle::loadFont(const char* id)
         Font::Glyph* glyphs = new Font::Glyph[glyphCount];
         for (unsigned j = 0; j < glyphCount; j++)
         {
-            if (_stream->read(&glyphs[j].code, 4, 1) != 1)
+            if (readData(&glyphs[j].code, 4, 1) != 1)
             {
                 GP_ERROR("Failed to read glyph #%d code for font '%s'.", j, id);
                 SAFE_DELETE_ARRAY(glyphs);
                 return NULL;
             }
-            if (_stream->read(&glyphs[j].width, 4, 1) != 1)
+            if (readData(&glyphs[j].width, 4, 1) != 1)
             {
                 GP_ERROR("Failed to read glyph #%d width for font '%s'.", j, id);
                 SAFE_DELETE_ARRAY(glyphs);
@@ -1726,13 +1957,13 @@ Font* Bundle::loadFont(const char* id)
             }
             if (getVersionMajor() >= 1 && getVersionMinor() >= 5)
             {
-                if (_stream->read(&glyphs[j].bearingX, 4, 1) != 1)
+                if (readData(&glyphs[j].bearingX, 4, 1) != 1)
                 {
                     GP_ERROR("Failed to read glyph #%d bearingX for font '%s'.", j, id);
                     SAFE_DELETE_ARRAY(glyphs);
                     return NULL;
                 }
-                if (_stream->read(&glyphs[j].advance, 4, 1) != 1)
+                if (readData(&glyphs[j].advance, 4, 1) != 1)
                 {
                     GP_ERROR("Failed to read glyph #%d advance for font '%s'.", j, id);
                     SAFE_DELETE_ARRAY(glyphs);
@@ -1745,7 +1976,7 @@ Font* Bundle::loadFont(const char* id)
                 glyphs[j].bearingX = 0;
                 glyphs[j].advance = glyphs[j].code == ' ' ? size >> 1 : glyphs[j].width;
             }
-            if (_stream->read(&glyphs[j].uvs, 4, 4) != 4)
+            if (readData(&glyphs[j].uvs, 4, 4) != 4)
             {
                 GP_ERROR("Failed to read glyph #%d uvs for font '%s'.", j, id);
                 SAFE_DELETE_ARRAY(glyphs);
@@ -1755,19 +1986,19 @@ Font* Bundle::loadFont(const char* id)
 
         // Read texture attributes.
         unsigned int width, height, textureByteCount;
-        if (_stream->read(&width, 4, 1) != 1)
+        if (readData(&width, 4, 1) != 1)
         {
             GP_ERROR("Failed to read texture width for font '%s'.", id);
             SAFE_DELETE_ARRAY(glyphs);
             return NULL;
         }
-        if (_stream->read(&height, 4, 1) != 1)
+        if (readData(&height, 4, 1) != 1)
         {
             GP_ERROR("Failed to read texture height for font '%s'.", id);
             SAFE_DELETE_ARRAY(glyphs);
             return NULL;
         }
-        if (_stream->read(&textureByteCount, 4, 1) != 1)
+        if (readData(&textureByteCount, 4, 1) != 1)
         {
             GP_ERROR("Failed to read texture byte count for font '%s'.", id);
             SAFE_DELETE_ARRAY(glyphs);
@@ -1783,7 +2014,7 @@ Font* Bundle::loadFont(const char* id)
 
         // Read texture data.
         unsigned char* textureData = new unsigned char[textureByteCount];
-        if (_stream->read(textureData, 1, textureByteCount) != textureByteCount)
+        if (readData(textureData, 1, textureByteCount) != textureByteCount)
         {
             GP_ERROR("Failed to read texture data for font '%s'.", id);
             SAFE_DELETE_ARRAY(glyphs);
@@ -1796,7 +2027,7 @@ Font* Bundle::loadFont(const char* id)
         // In bundle version 1.3 we added a format field
         if (getVersionMajor() >= 1 && getVersionMinor() >= 3)
         {
-            if (_stream->read(&format, 4, 1) != 1)
+            if (readData(&format, 4, 1) != 1)
             {
                 GP_ERROR("Failed to font format'%u'.", format);
                 SAFE_DELETE_ARRAY(glyphs);
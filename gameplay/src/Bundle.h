@@ -18,6 +18,7 @@ class Bundle : public Ref
 {
     friend class PhysicsController;
     friend class SceneLoader;
+    friend class ResourceLoader;
 
 public:
 
@@ -30,11 +31,23 @@ public:
      * release() method must be called. Note that calling release() does
      * NOT free any actual game objects created/returned from the Bundle
      * instance and those objects must be released separately.
+     *
+     * When memoryMapped is true the whole bundle file is mapped into memory
+     * (or read into memory once if the file cannot be mapped, e.g. Android assets
+     * and package files) and all objects are parsed directly out of memory
+     * instead of through many small Stream reads. This is considerably faster
+     * for large bundles at the cost of keeping the file contents resident for
+     * the lifetime of the Bundle. A loaded bundle that is held in memory is
+     * returned for either mode, while a request for a memory-mapped load does
+     * not reuse a bundle that was loaded through a stream.
+     * 
+     * @param path The path to the bundle file.
+     * @param memoryMapped True to load objects from the memory-mapped file contents.
      * 
      * @return The new Bundle or NULL if there was an error.
      * @script{create}
      */
-    static Bundle* create(const char* path);
+    static Bundle* create(const char* path, bool memoryMapped = false);
 
     /**
      * Loads the scene with the specified ID from the bundle.
@@ -173,6 +186,33 @@ private:
      */
     ~Bundle();
 
+    /**
+     * Opens a bundle and reads its reference table without looking it up in or adding it
+     * to the bundle cache, so that it can be called from a worker thread.
+     *
+     * @param path The path to the bundle file.
+     * @param memoryMapped True to load objects from the memory-mapped file contents.
+     *
+     * @return The new Bundle or NULL if there was an error.
+     */
+    static Bundle* open(const char* path, bool memoryMapped);
+
+    /**
+     * Adds a bundle returned by open() to the bundle cache. If an equivalent bundle was
+     * cached in the meantime, the given bundle is released and the cached one is returned
+     * with its reference count incremented. Must be called from the main thread.
+     *
+     * @param bundle The bundle to cache.
+     *
+     * @return The cached bundle.
+     */
+    static Bundle* cache(Bundle* bundle);
+
+    /**
+     * Finds a cached bundle that can serve a request and increments its reference count.
+     */
+    static Bundle* findCached(const char* path, bool memoryMapped);
+
     /**
      * Hidden copy assignment operator.
      */
@@ -255,6 +295,50 @@ private:
      */
     Mesh* loadMesh(const char* id, const char* nodeId);
 
+    /**
+     * Builds the hashed ID and offset lookup tables for the reference table.
+     */
+    void buildReferenceIndex();
+
+    /**
+     * Reads an array of <code>count</code> elements, each of size <code>size</code>,
+     * from the current file position.
+     *
+     * Reads are served directly from the bundle contents when the bundle is
+     * memory-mapped and go through the stream otherwise.
+     *
+     * @param ptr The pointer to the memory to copy into.
+     * @param size The size of each element to be read, in bytes.
+     * @param count The number of elements to read.
+     *
+     * @return The number of elements read.
+     */
+    size_t readData(void* ptr, size_t size, size_t count);
+
+    /**
+     * Sets the current file position.
+     *
+     * @param offset The number of bytes to offset from origin.
+     * @param origin The position used as a reference for offset (same as fseek()).
+     *
+     * @return True if successful, false otherwise.
+     */
+    bool seek(long int offset, int origin);
+
+    /**
+     * Returns the current file position.
+     *
+     * @return The file position in bytes.
+     */
+    long int position() const;
+
+    /**
+     * Reads a length-prefixed string from the current file position.
+     *
+     * @return The string read, or an empty string if there was an error.
+     */
+    std::string readString();
+
     /**
      * Reads an unsigned int from the current file position.
      *
@@ -455,7 +539,14 @@ private:
     std::string _materialPath;
     unsigned int _referenceCount;
     Reference* _references;
+    std::unordered_map<std::string, Reference*> _referenceIndex;
+    std::unordered_map<unsigned int, Reference*> _offsetIndex;
     Stream* _stream;
+    const unsigned char* _data;
+    size_t _dataLength;
+    size_t _dataPosition;
+    bool _dataMapped;
+    bool _cached;
 
     std::vector<MeshSkinData*> _meshSkins;
     std::map<std::string, Node*>* _trackedNodes;
@@ -13,6 +13,7 @@
 #include "Control.h"
 #include "Form.h"
 #include "Theme.h"
+#include "GlyphAtlas.h"
 
 namespace gameplay
 {
@@ -21,7 +22,7 @@ Control::Control()
     : _id(""), _boundsBits(0), _dirtyBits(DIRTY_BOUNDS | DIRTY_STATE), _consumeInputEvents(true), _alignment(ALIGN_TOP_LEFT),
     _autoSize(AUTO_SIZE_BOTH), _style(NULL), _listeners(NULL), _visible(true), _zIndex(-1), _isAlignmentSet(false), _opacity (0.0f),
     _contactIndex(INVALID_CONTACT_INDEX), _focusIndex(-1), _canFocus(false), _state(NORMAL), _parent(NULL), _styleOverridden(false), _skin(NULL),
-    _receiveInputEvents(false)
+    _receiveInputEvents(false), _geometryDrawCalls(0), _geometryAtlasChangeCount(0)
 {
     GP_REGISTER_SCRIPT_EVENTS();
 }
@@ -1175,7 +1176,7 @@ void Control::controlEvent(Control::Listener::EventType evt)
 
 void Control::setDirty(int bits)
 {
-    _dirtyBits |= bits;
+    _dirtyBits |= bits | DIRTY_GEOMETRY;
 }
 
 bool Control::isDirty(int bit) const
@@ -1193,9 +1194,14 @@ void Control::update(float elapsedTime)
 
     // Since opacity is pre-multiplied, we compute it every frame so that we don't need to
     // dirty the entire hierarchy any time a state changes (which could affect opacity).
-    _opacity = getOpacity(state);
+    float opacity = getOpacity(state);
     if (_parent)
-        _opacity *= _parent->_opacity;
+        opacity *= _parent->_opacity;
+    if (opacity != _opacity)
+    {
+        _opacity = opacity;
+        _dirtyBits |= DIRTY_GEOMETRY;
+    }
 }
 
 void Control::updateState(State state)
@@ -1383,12 +1389,46 @@ unsigned int Control::draw(Form* form) const
     if (!_visible || _absoluteClipBounds.width <= 0 || _absoluteClipBounds.height <= 0 || _opacity <= 0)
         return 0;
 
+    if (form && form->_geometryCached && form->_batched)
+        return drawCached(form);
+
     unsigned int drawCalls = drawBorder(form);
     drawCalls += drawImages(form);
     drawCalls += drawText(form);
     return drawCalls;
 }
 
+unsigned int Control::drawCached(Form* form) const
+{
+    GP_ASSERT(form);
+
+    // Glyph quads in the cached geometry may point at atlas cells that were reused since.
+    if ((_dirtyBits & DIRTY_GEOMETRY) == 0 && _geometryAtlasChangeCount == GlyphAtlas::getChangeCount())
+    {
+        for (size_t i = 0, count = _geometry.size(); i < count; ++i)
+        {
+            GeometryBatch& geometry = _geometry[i];
+            startBatch(form, geometry.batch);
+            if (!geometry.vertices.empty())
+                geometry.batch->draw(&geometry.vertices[0], (unsigned int)geometry.vertices.size());
+            finishBatch(form, geometry.batch);
+        }
+        return _geometryDrawCalls;
+    }
+
+    // Taken before drawing, so glyphs skipped while recording get the geometry rebuilt later.
+    _geometryAtlasChangeCount = GlyphAtlas::getChangeCount();
+    form->beginGeometry();
+    unsigned int drawCalls = drawBorder(form);
+    drawCalls += drawImages(form);
+    drawCalls += drawText(form);
+    form->endGeometry(&_geometry);
+
+    _geometryDrawCalls = drawCalls;
+    const_cast<Control*>(this)->_dirtyBits &= ~DIRTY_GEOMETRY;
+    return drawCalls;
+}
+
 unsigned int Control::drawBorder(Form* form) const
 {
     if (!form || !_skin)
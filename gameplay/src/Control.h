@@ -1118,6 +1118,13 @@ protected:
      */
     static const int DIRTY_STATE = 2;
 
+    /**
+     * Indicates that the cached geometry of the control is out of date.
+     *
+     * Set along with every other dirty bit, and cleared once the geometry is rebuilt.
+     */
+    static const int DIRTY_GEOMETRY = 4;
+
     /**
      * Indicates that the x position of the control is a percentage.
      */
@@ -1359,6 +1366,15 @@ protected:
      */
     virtual unsigned int drawBorder(Form* form) const;
 
+    /**
+     * Draws the control from its cached geometry, rebuilding the geometry first if it is dirty.
+     *
+     * @param form The top level form being drawn.
+     *
+     * @return The number of draw calls issued.
+     */
+    unsigned int drawCached(Form* form) const;
+
     /**
      * Draw the images associated with this control.
      *
@@ -1527,6 +1543,30 @@ protected:
      */
     int _dirtyBits;
 
+    /**
+     * Vertices the control added to a single sprite batch, replayed while the control is unchanged.
+     */
+    struct GeometryBatch
+    {
+        SpriteBatch* batch;
+        std::vector<SpriteBatch::SpriteVertex> vertices;
+    };
+
+    /**
+     * The cached geometry of the control, one entry per sprite batch it draws into.
+     */
+    mutable std::vector<GeometryBatch> _geometry;
+
+    /**
+     * The number of draw calls reported when the cached geometry was built.
+     */
+    mutable unsigned int _geometryDrawCalls;
+
+    /**
+     * The glyph atlas change count taken when the cached geometry was built.
+     */
+    mutable unsigned int _geometryAtlasChangeCount;
+
     /**
      * Flag for whether the Control consumes input events.
      */
@@ -7,6 +7,7 @@
 #include <memory>
 
 using std::memcpy;
+using std::memset;
 using std::fabs;
 using std::sqrt;
 using std::cos;
@@ -50,6 +51,12 @@ using std::strcmp;
     }
 #endif
 
+// The largest number of components of a quantized curve.
+#define CURVE_MAX_QUANTIZED_COMPONENTS 16
+
+// The components of a quaternion other than its largest one lie within +-1/sqrt(2).
+#define CURVE_QUATERNION_RANGE 0.70710678f
+
 static inline float bezier(float eq0, float eq1, float eq2, float eq3, float from, float out, float to, float in)
 {
     return from * eq0 + out * eq1 + in * eq2 + to * eq3;
@@ -89,23 +96,57 @@ Curve* Curve::create(unsigned int pointCount, unsigned int componentCount)
 }
 
 Curve::Curve(unsigned int pointCount, unsigned int componentCount)
-    : _pointCount(pointCount), _componentCount(componentCount), _componentSize(sizeof(float)*componentCount), _quaternionOffset(NULL), _points(NULL)
+    : _pointCount(pointCount), _componentCount(componentCount), _componentSize(sizeof(float)*componentCount), _quaternionOffset(NULL), _points(NULL),
+      _times(NULL), _values(NULL), _revision(0), _nonLinearCount(0), _keys(NULL), _ranges(NULL), _keyStride(0)
 {
+    // Keep the values and tangents of neighbouring points next to each other in memory.
     _points = new Point[_pointCount];
+    _times = new float[_pointCount];
+    _values = new float[_pointCount * _componentCount * 3];
     for (unsigned int i = 0; i < _pointCount; i++)
     {
+        float* values = _values + i * _componentCount * 3;
         _points[i].time = 0.0f;
-        _points[i].value = new float[_componentCount];
-        _points[i].inValue = new float[_componentCount];
-        _points[i].outValue = new float[_componentCount];
+        _points[i].value = values;
+        _points[i].inValue = values + _componentCount;
+        _points[i].outValue = values + _componentCount * 2;
         _points[i].type = LINEAR;
+        _times[i] = 0.0f;
     }
     _points[_pointCount - 1].time = 1.0f;
+    _times[_pointCount - 1] = 1.0f;
+}
+
+Curve* Curve::createQuantized(unsigned int pointCount, unsigned int componentCount, unsigned int keyStride,
+                              const float* times, const unsigned short* keys, const float* ranges)
+{
+    assert(times && keys && ranges);
+
+    Curve* curve = new Curve(pointCount, componentCount, keyStride);
+    memcpy(curve->_times, times, sizeof(float) * pointCount);
+    memcpy(curve->_keys, keys, sizeof(unsigned short) * pointCount * keyStride);
+    memcpy(curve->_ranges, ranges, sizeof(float) * componentCount * 2);
+    return curve;
+}
+
+Curve::Curve(unsigned int pointCount, unsigned int componentCount, unsigned int keyStride)
+    : _pointCount(pointCount), _componentCount(componentCount), _componentSize(sizeof(float)*componentCount), _quaternionOffset(NULL), _points(NULL),
+      _times(NULL), _values(NULL), _revision(0), _nonLinearCount(0), _keys(NULL), _ranges(NULL), _keyStride(keyStride)
+{
+    assert(pointCount > 0 && componentCount <= CURVE_MAX_QUANTIZED_COMPONENTS && keyStride <= componentCount);
+
+    _times = new float[_pointCount];
+    _keys = new unsigned short[_pointCount * _keyStride];
+    _ranges = new float[_componentCount * 2];
 }
 
 Curve::~Curve()
 {
     SAFE_DELETE_ARRAY(_points);
+    SAFE_DELETE_ARRAY(_times);
+    SAFE_DELETE_ARRAY(_values);
+    SAFE_DELETE_ARRAY(_keys);
+    SAFE_DELETE_ARRAY(_ranges);
     SAFE_DELETE_ARRAY(_quaternionOffset);
 }
 
@@ -116,9 +157,7 @@ Curve::Point::Point()
 
 Curve::Point::~Point()
 {
-    SAFE_DELETE_ARRAY(value);
-    SAFE_DELETE_ARRAY(inValue);
-    SAFE_DELETE_ARRAY(outValue);
+    // The values are owned by the curve.
 }
 
 unsigned int Curve::getPointCount() const
@@ -131,27 +170,32 @@ unsigned int Curve::getComponentCount() const
     return _componentCount;
 }
 
+bool Curve::isQuantized() const
+{
+    return _keys != NULL;
+}
+
 float Curve::getStartTime() const
 {
-    return _points[0].time;
+    return _times[0];
 }
 
 float Curve::getEndTime() const
 {
-    return _points[_pointCount-1].time;
+    return _times[_pointCount-1];
 }
 
 float Curve::getPointTime(unsigned int index) const
 {
     assert(index < _pointCount);
-    return _points[index].time;
+    return _times[index];
 }
 
 
 Curve::InterpolationType Curve::getPointInterpolation(unsigned int index) const
 {
     assert(index < _pointCount);
-    return _points[index].type;;
+    return _points ? _points[index].type : LINEAR;
 }
 
 void Curve::getPointValues(unsigned int index, float* value, float* inValue, float* outValue) const
@@ -159,13 +203,24 @@ void Curve::getPointValues(unsigned int index, float* value, float* inValue, flo
     assert(index < _pointCount);
     
     if (value)
-        memcpy(value, _points[index].value, _componentSize);
-    
+        getValue(index, value);
+
+    // Quantized curves are linear and have no tangents.
     if (inValue)
-        memcpy(inValue, _points[index].inValue, _componentSize);
+    {
+        if (_points)
+            memcpy(inValue, _points[index].inValue, _componentSize);
+        else
+            memset(inValue, 0, _componentSize);
+    }
     
     if (outValue)
-        memcpy(outValue, _points[index].outValue, _componentSize);
+    {
+        if (_points)
+            memcpy(outValue, _points[index].outValue, _componentSize);
+        else
+            memset(outValue, 0, _componentSize);
+    }
 }
 
 void Curve::setPoint(unsigned int index, float time, float* value, InterpolationType type)
@@ -175,10 +230,15 @@ void Curve::setPoint(unsigned int index, float time, float* value, Interpolation
 
 void Curve::setPoint(unsigned int index, float time, float* value, InterpolationType type, float* inValue, float* outValue)
 {
-    assert(index < _pointCount && time >= 0.0f && time <= 1.0f && !(_pointCount > 1 && index == 0 && time != 0.0f) && !(_pointCount != 1 && index == _pointCount - 1 && time != 1.0f));
+    assert(_points && index < _pointCount && time >= 0.0f && time <= 1.0f && !(_pointCount > 1 && index == 0 && time != 0.0f) && !(_pointCount != 1 && index == _pointCount - 1 && time != 1.0f));
 
+    if (_times[index] != time)
+    {
+        _times[index] = time;
+        ++_revision;
+    }
     _points[index].time = time;
-    _points[index].type = type;
+    setInterpolation(index, type);
 
     if (value)
         memcpy(_points[index].value, value, _componentSize);
@@ -192,9 +252,9 @@ void Curve::setPoint(unsigned int index, float time, float* value, Interpolation
 
 void Curve::setTangent(unsigned int index, InterpolationType type, float* inValue, float* outValue)
 {
-    assert(index < _pointCount);
+    assert(_points && index < _pointCount);
 
-    _points[index].type = type;
+    setInterpolation(index, type);
 
     if (inValue)
         memcpy(_points[index].inValue, inValue, _componentSize);
@@ -212,85 +272,122 @@ void Curve::evaluate(float time, float* dst) const
 
 void Curve::evaluate(float time, float startTime, float endTime, float loopBlendTime, float* dst) const
 {
-    assert(dst && startTime >= 0.0f && startTime <= endTime && endTime <= 1.0f && loopBlendTime >= 0.0f);
+    Cursor cursor;
+    evaluate(time, startTime, endTime, loopBlendTime, dst, &cursor);
+}
+
+void Curve::evaluate(float time, float startTime, float endTime, float loopBlendTime, float* dst, Cursor* cursor) const
+{
+    assert(dst && cursor && startTime >= 0.0f && startTime <= endTime && endTime <= 1.0f && loopBlendTime >= 0.0f);
 
     // If there's only one point on the curve, return its value.
     if (_pointCount == 1)
     {
-        memcpy(dst, _points[0].value, _componentSize);
+        getValue(0, dst);
         return;
     }
 
-    unsigned int min = 0;
-    unsigned int max = _pointCount - 1;
+    // The subregion rarely changes between evaluations, so it is only searched for when it does.
+    if (cursor->startTime != startTime || cursor->endTime != endTime || cursor->revision != _revision)
+    {
+        cursor->min = 0;
+        cursor->max = _pointCount - 1;
+        if (startTime > 0.0f || endTime < 1.0f)
+        {
+            // Evaluating a sub section of the curve
+            cursor->min = determineIndex(startTime, 0, cursor->max);
+            cursor->max = determineIndex(endTime, cursor->min, cursor->max);
+        }
+        cursor->index = cursor->min;
+        cursor->startTime = startTime;
+        cursor->endTime = endTime;
+        cursor->revision = _revision;
+    }
+
+    unsigned int min = cursor->min;
+    unsigned int max = cursor->max;
     float localTime = time;
     if (startTime > 0.0f || endTime < 1.0f)
     {
-        // Evaluating a sub section of the curve
-        min = determineIndex(startTime, 0, max);
-        max = determineIndex(endTime, min, max);
-
         // Convert time to fall within the subregion
-        localTime = _points[min].time + (_points[max].time - _points[min].time) * time;
+        localTime = _times[min] + (_times[max] - _times[min]) * time;
     }
 
     if (loopBlendTime == 0.0f)
     {
         // If no loop blend time is specified, clamp time to end points
-        if (localTime < _points[min].time)
-            localTime = _points[min].time;
-        else if (localTime > _points[max].time)
-            localTime = _points[max].time;
+        if (localTime < _times[min])
+            localTime = _times[min];
+        else if (localTime > _times[max])
+            localTime = _times[max];
     }
 
     // If an exact endpoint was specified, skip interpolation and return the value directly
-    if (localTime == _points[min].time)
+    if (localTime == _times[min])
     {
-        memcpy(dst, _points[min].value, _componentSize);
+        getValue(min, dst);
         return;
     }
-    if (localTime == _points[max].time)
+    if (localTime == _times[max])
     {
-        memcpy(dst, _points[max].value, _componentSize);
+        getValue(max, dst);
         return;
     }
 
-    Point* from;
-    Point* to;
     float scale;
     float t;
     unsigned int index;
+    unsigned int toIndex;
 
-    if (localTime > _points[max].time)
+    if (localTime > _times[max])
     {
         // Looping forward
         index = max;
-        from = &_points[max];
-        to = &_points[min];
+        toIndex = min;
 
         // Calculate the fractional time between the two points.
-        t = (localTime - from->time) / loopBlendTime;
+        t = (localTime - _times[max]) / loopBlendTime;
     }
-    else if (localTime < _points[min].time)
+    else if (localTime < _times[min])
     {
         // Looping in reverse
         index = min;
-        from = &_points[min];
-        to = &_points[max];
+        toIndex = max;
 
         // Calculate the fractional time between the two points.
-        t = (from->time - localTime) / loopBlendTime;
+        t = (_times[min] - localTime) / loopBlendTime;
     }
     else
     {
-        // Locate the points we are interpolating between using a binary search.
-        index = determineIndex(localTime, min, max);
-        from = &_points[index];
-        to = &_points[index == max ? index : index+1];
+        // Locate the points we are interpolating between, near the previous ones if possible.
+        index = findIndex(localTime, min, max, cursor->index);
+        cursor->index = index;
+        toIndex = index == max ? index : index+1;
 
         // Calculate the fractional time between the two points.
-        scale = (to->time - from->time);
-        t = (localTime - from->time) / scale;
+        scale = (_times[toIndex] - _times[index]);
+        t = (localTime - _times[index]) / scale;
+    }
+
+    // Quantized curves are linear; only the two keys being blended are decoded.
+    if (_keys)
+    {
+        float fromValue[CURVE_MAX_QUANTIZED_COMPONENTS];
+        float toValue[CURVE_MAX_QUANTIZED_COMPONENTS];
+        decodeKey(index, fromValue);
+        decodeKey(toIndex, toValue);
+        interpolateLinear(t, fromValue, toValue, dst);
+        return;
+    }
+
+    Point* from = &_points[index];
+    Point* to = &_points[toIndex];
+
+    // Curves made of linear segments only, such as sampled animations, skip the dispatch below.
+    if (_nonLinearCount == 0)
+    {
+        interpolateLinear(t, from, to, dst);
+        return;
     }
 
     // Calculate the value of the curve discretely if appropriate.
@@ -1198,9 +1295,11 @@ void Curve::interpolateHermiteSmooth(float s, unsigned int index, Point* from, P
 
 void Curve::interpolateLinear(float s, Point* from, Point* to, float* dst) const
 {
-    float* fromValue = from->value;
-    float* toValue = to->value;
+    interpolateLinear(s, from->value, to->value, dst);
+}
 
+void Curve::interpolateLinear(float s, const float* fromValue, const float* toValue, float* dst) const
+{
     if (!_quaternionOffset)
     {
         for (unsigned int i = 0; i < _componentCount; i++)
@@ -1238,7 +1337,45 @@ void Curve::interpolateLinear(float s, Point* from, Point* to, float* dst) const
     }
 }
 
-void Curve::interpolateQuaternion(float s, float* from, float* to, float* dst) const
+void Curve::getValue(unsigned int index, float* dst) const
+{
+    if (_keys)
+        decodeKey(index, dst);
+    else
+        memcpy(dst, _points[index].value, _componentSize);
+}
+
+void Curve::decodeKey(unsigned int index, float* dst) const
+{
+    const unsigned short* key = _keys + index * _keyStride;
+    for (unsigned int i = 0; i < _componentCount; ++i)
+    {
+        if (_quaternionOffset && i == *_quaternionOffset)
+        {
+            // The top bits of the first two values hold the index of the largest component,
+            // which is positive and follows from the unit length.
+            unsigned int largest = ((key[0] >> 15) << 1) | (key[1] >> 15);
+            float* q = dst + i;
+            float sum = 0.0f;
+            for (unsigned int j = 0, k = 0; j < 4; ++j)
+            {
+                if (j == largest)
+                    continue;
+                q[j] = (float)(key[k++] & 0x7FFF) * (2.0f * CURVE_QUATERNION_RANGE / 32767.0f) - CURVE_QUATERNION_RANGE;
+                sum += q[j] * q[j];
+            }
+            q[largest] = sum < 1.0f ? sqrt(1.0f - sum) : 0.0f;
+            key += 3;
+            i += 3;
+        }
+        else
+        {
+            dst[i] = _ranges[i * 2] + _ranges[i * 2 + 1] * (float)*key++;
+        }
+    }
+}
+
+void Curve::interpolateQuaternion(float s, const float* from, const float* to, float* dst) const
 {
     // Evaluate.
     if (s >= 0)
@@ -1256,9 +1393,9 @@ int Curve::determineIndex(float time, unsigned int min, unsigned int max) const
     {
         mid = (min + max) >> 1;
 
-        if (time >= _points[mid].time && time < _points[mid + 1].time)
+        if (time >= _times[mid] && time < _times[mid + 1])
             return mid;
-        else if (time < _points[mid].time)
+        else if (time < _times[mid])
             max = mid - 1;
         else
             min = mid + 1;
@@ -1267,6 +1404,36 @@ int Curve::determineIndex(float time, unsigned int min, unsigned int max) const
     return max;
 }
 
+unsigned int Curve::findIndex(float time, unsigned int min, unsigned int max, unsigned int hint) const
+{
+    // Playback mostly stays between the same points or moves on to the neighbouring ones.
+    if (hint >= min && hint < max)
+    {
+        if (time >= _times[hint])
+        {
+            if (time < _times[hint + 1])
+                return hint;
+            if (hint + 1 < max && time < _times[hint + 2])
+                return hint + 1;
+        }
+        else if (hint > min && time >= _times[hint - 1])
+        {
+            return hint - 1;
+        }
+    }
+
+    return (unsigned int)determineIndex(time, min, max);
+}
+
+void Curve::setInterpolation(unsigned int index, InterpolationType type)
+{
+    if (_points[index].type != LINEAR)
+        --_nonLinearCount;
+    if (type != LINEAR)
+        ++_nonLinearCount;
+    _points[index].type = type;
+}
+
 int Curve::getInterpolationType(const char* curveId)
 {
     if (strcmp(curveId, "BEZIER") == 0)
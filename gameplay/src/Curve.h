@@ -284,6 +284,24 @@ public:
      */
     static Curve* create(unsigned int pointCount, unsigned int componentCount);
 
+    /**
+     * Creates a new linear curve whose keys stay quantized in memory.
+     *
+     * Each key holds one 16-bit value per scalar component, decoded as
+     * min + scale * value. A quaternion, located later with setQuaternionOffset(),
+     * is stored in three 16-bit values as its three smallest components.
+     *
+     * @param pointCount The number of points in the curve.
+     * @param componentCount The number of float component values per key value.
+     * @param keyStride The number of quantized values per key.
+     * @param times The times of the points, between 0 and 1 and ascending.
+     * @param keys The quantized keys, point by point.
+     * @param ranges The min and scale of each component. The values at the quaternion components are unused.
+     * @script{ignore}
+     */
+    static Curve* createQuantized(unsigned int pointCount, unsigned int componentCount, unsigned int keyStride,
+                                  const float* times, const unsigned short* keys, const float* ranges);
+
     /**
      * Gets the number of points in the curve.
      *
@@ -298,6 +316,17 @@ public:
      */
     unsigned int getComponentCount() const;
 
+    /**
+     * Determines whether the key values of the curve are stored quantized.
+     *
+     * Quantized curves are loaded from bundles written with animation compression.
+     * They are linear, their keys are decoded when evaluated and their points
+     * cannot be changed.
+     *
+     * @return True if the curve is quantized, false otherwise.
+     */
+    bool isQuantized() const;
+
     /**
      * Returns the start time for the curve.
      *
@@ -414,6 +443,51 @@ public:
      */
     void evaluate(float time, float startTime, float endTime, float loopBlendTime, float* dst) const;
 
+    /**
+     * Remembers where the previous evaluation of a curve ended, so that the next
+     * evaluation of a nearby time finds its points without a search.
+     *
+     * @script{ignore}
+     */
+    struct Cursor
+    {
+        /**
+         * Constructor.
+         */
+        Cursor() : index(0), min(0), max(0), startTime(-1.0f), endTime(-1.0f), revision(0) {}
+
+        /** The index of the point the previous evaluation interpolated from. */
+        unsigned int index;
+        /** The first point of the subregion. */
+        unsigned int min;
+        /** The last point of the subregion. */
+        unsigned int max;
+        /** The start time the subregion was found for. */
+        float startTime;
+        /** The end time the subregion was found for. */
+        float endTime;
+        /** The revision of the curve the subregion was found in. */
+        unsigned int revision;
+    };
+
+    /**
+     * Evaluates the curve like evaluate(float, float, float, float, float*), starting
+     * from the points found by the previous evaluation with the same cursor.
+     *
+     * Playback that moves forwards or backwards a little at a time finds its points
+     * in constant time, instead of searching the curve on every evaluation.
+     *
+     * @param time The position within the subregion of the curve to evaluate the curve at.
+     * @param startTime Start time for the subregion (between 0.0 - 1.0).
+     * @param endTime End time for the subregion (between 0.0 - 1.0).
+     * @param loopBlendTime Time (in seconds) to blend between the end points of the curve
+     *      for looping purposes when time is outside the range 0-1.
+     * @param dst The evaluated value of the curve at the given time.
+     * @param cursor The cursor of the previous evaluation, updated for this one.
+     * @script{ignore}
+     */
+    void evaluate(float time, float startTime, float endTime, float loopBlendTime, float* dst, Cursor* cursor) const;
+
     /**
      * Linear interpolation function.
      */
@@ -476,6 +550,15 @@ private:
      */
     Curve(unsigned int pointCount, unsigned int componentCount);
 
+    /**
+     * Constructs a new quantized curve.
+     *
+     * @param pointCount The number of points in the curve.
+     * @param componentCount The number of float component values per key value.
+     * @param keyStride The number of quantized values per key.
+     */
+    Curve(unsigned int pointCount, unsigned int componentCount, unsigned int keyStride);
+
     /**
      * Constructor.
      */
@@ -521,16 +604,42 @@ private:
      */
     void interpolateLinear(float s, Point* from, Point* to, float* dst) const;
 
+    /**
+     * Linear interpolation function.
+     */
+    void interpolateLinear(float s, const float* from, const float* to, float* dst) const;
+
+    /**
+     * Copies the value of a point, decoding it if the curve is quantized.
+     */
+    void getValue(unsigned int index, float* dst) const;
+
+    /**
+     * Decodes a key of a quantized curve.
+     */
+    void decodeKey(unsigned int index, float* dst) const;
+
     /**
      * Quaternion interpolation function.
      */
-    void interpolateQuaternion(float s, float* from, float* to, float* dst) const;
+    void interpolateQuaternion(float s, const float* from, const float* to, float* dst) const;
 
     /**
      * Determines the current keyframe to interpolate from based on the specified time.
      */
     int determineIndex(float time, unsigned int min, unsigned int max) const;
 
+    /**
+     * Determines the keyframe to interpolate from, trying the given keyframe and
+     * its neighbours before searching.
+     */
+    unsigned int findIndex(float time, unsigned int min, unsigned int max, unsigned int hint) const;
+
+    /**
+     * Sets the interpolation type of a point, keeping count of the non-linear points.
+     */
+    void setInterpolation(unsigned int index, InterpolationType type);
+
     /**
      * Sets the offset for the beginning of a Quaternion piece of data within the curve's value span at the specified
      * index. The next four components of data starting at the given index will be interpolated as a Quaternion.
@@ -546,6 +655,13 @@ private:
     unsigned int _componentSize;        // The component size (in bytes).
     unsigned int* _quaternionOffset;    // Offset for the rotation component.
     Point* _points;                     // The points on the curve.
+    float* _times;                      // The times of the points, packed for searching.
+    float* _values;                     // The values and tangents of all points, stored point by point.
+    unsigned int _revision;             // Changed whenever point times change.
+    unsigned int _nonLinearCount;       // The number of points that are not linearly interpolated.
+    unsigned short* _keys;              // The keys of a quantized curve, NULL otherwise.
+    float* _ranges;                     // The min and scale of each component of a quantized curve.
+    unsigned int _keyStride;            // The number of quantized values per key.
 };
 
 }
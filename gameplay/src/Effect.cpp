@@ -2,6 +2,7 @@
 #include "Effect.h"
 #include "FileSystem.h"
 #include "Game.h"
+#include "RenderQueue.h"
 
 #define OPENGL_ES_DEFINE  "OPENGL_ES"
 
@@ -12,6 +13,9 @@ namespace gameplay
 static std::map<std::string, Effect*> __effectCache;
 static Effect* __currentEffect = NULL;
 
+// The largest uniform value, in bytes, whose last upload is remembered.
+#define UNIFORM_CACHE_SIZE sizeof(Matrix)
+
 Effect::Effect() : _program(0)
 {
 }
@@ -527,82 +531,112 @@ unsigned int Effect::getUniformCount() const
     return (unsigned int)_uniforms.size();
 }
 
+bool Effect::updateUniformValue(Uniform* uniform, const void* value, size_t size)
+{
+    if (size <= UNIFORM_CACHE_SIZE)
+    {
+        if (uniform->_cacheSize == size && memcmp(uniform->_cache, value, size) == 0)
+            return false;
+        memcpy(uniform->_cache, value, size);
+        uniform->_cacheSize = (unsigned int)size;
+    }
+    else
+    {
+        // The value does not fit in the cache, so forget the previously cached one.
+        uniform->_cacheSize = 0;
+    }
+    RenderQueue::_statistics.uniformUploads++;
+    return true;
+}
+
 void Effect::setValue(Uniform* uniform, float value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform1f(uniform->_location, value) );
+    if (updateUniformValue(uniform, &value, sizeof(float)))
+        GL_ASSERT( glUniform1f(uniform->_location, value) );
 }
 
 void Effect::setValue(Uniform* uniform, const float* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform1fv(uniform->_location, count, values) );
+    if (updateUniformValue(uniform, values, sizeof(float) * count))
+        GL_ASSERT( glUniform1fv(uniform->_location, count, values) );
 }
 
 void Effect::setValue(Uniform* uniform, int value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform1i(uniform->_location, value) );
+    if (updateUniformValue(uniform, &value, sizeof(int)))
+        GL_ASSERT( glUniform1i(uniform->_location, value) );
 }
 
 void Effect::setValue(Uniform* uniform, const int* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform1iv(uniform->_location, count, values) );
+    if (updateUniformValue(uniform, values, sizeof(int) * count))
+        GL_ASSERT( glUniform1iv(uniform->_location, count, values) );
 }
 
 void Effect::setValue(Uniform* uniform, const Matrix& value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniformMatrix4fv(uniform->_location, 1, GL_FALSE, value.m) );
+    if (updateUniformValue(uniform, value.m, sizeof(Matrix)))
+        GL_ASSERT( glUniformMatrix4fv(uniform->_location, 1, GL_FALSE, value.m) );
 }
 
 void Effect::setValue(Uniform* uniform, const Matrix* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniformMatrix4fv(uniform->_location, count, GL_FALSE, (GLfloat*)values) );
+    if (updateUniformValue(uniform, values, sizeof(Matrix) * count))
+        GL_ASSERT( glUniformMatrix4fv(uniform->_location, count, GL_FALSE, (GLfloat*)values) );
 }
 
 void Effect::setValue(Uniform* uniform, const Vector2& value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform2f(uniform->_location, value.x, value.y) );
+    if (updateUniformValue(uniform, &value, sizeof(Vector2)))
+        GL_ASSERT( glUniform2f(uniform->_location, value.x, value.y) );
 }
 
 void Effect::setValue(Uniform* uniform, const Vector2* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform2fv(uniform->_location, count, (GLfloat*)values) );
+    if (updateUniformValue(uniform, values, sizeof(Vector2) * count))
+        GL_ASSERT( glUniform2fv(uniform->_location, count, (GLfloat*)values) );
 }
 
 void Effect::setValue(Uniform* uniform, const Vector3& value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform3f(uniform->_location, value.x, value.y, value.z) );
+    if (updateUniformValue(uniform, &value, sizeof(Vector3)))
+        GL_ASSERT( glUniform3f(uniform->_location, value.x, value.y, value.z) );
 }
 
 void Effect::setValue(Uniform* uniform, const Vector3* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform3fv(uniform->_location, count, (GLfloat*)values) );
+    if (updateUniformValue(uniform, values, sizeof(Vector3) * count))
+        GL_ASSERT( glUniform3fv(uniform->_location, count, (GLfloat*)values) );
 }
 
 void Effect::setValue(Uniform* uniform, const Vector4& value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform4f(uniform->_location, value.x, value.y, value.z, value.w) );
+    if (updateUniformValue(uniform, &value, sizeof(Vector4)))
+        GL_ASSERT( glUniform4f(uniform->_location, value.x, value.y, value.z, value.w) );
 }
 
 void Effect::setValue(Uniform* uniform, const Vector4* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform4fv(uniform->_location, count, (GLfloat*)values) );
+    if (updateUniformValue(uniform, values, sizeof(Vector4) * count))
+        GL_ASSERT( glUniform4fv(uniform->_location, count, (GLfloat*)values) );
 }
 
 void Effect::setValue(Uniform* uniform, const Texture::Sampler* sampler)
@@ -616,7 +650,8 @@ void Effect::setValue(Uniform* uniform, const Texture::Sampler* sampler)
     // Bind the sampler - this binds the texture and applies sampler state
     const_cast<Texture::Sampler*>(sampler)->bind(uniform->_index);
 
-    GL_ASSERT( glUniform1i(uniform->_location, uniform->_index) );
+    if (updateUniformValue(uniform, &uniform->_index, sizeof(unsigned int)))
+        GL_ASSERT( glUniform1i(uniform->_location, uniform->_index) );
 }
 
 void Effect::setValue(Uniform* uniform, const Texture::Sampler** values, unsigned int count)
@@ -639,12 +674,18 @@ void Effect::setValue(Uniform* uniform, const Texture::Sampler** values, unsigne
     }
 
     // Pass texture unit array to GL
-    GL_ASSERT( glUniform1iv(uniform->_location, count, units) );
+    if (updateUniformValue(uniform, units, sizeof(GLint) * count))
+        GL_ASSERT( glUniform1iv(uniform->_location, count, units) );
 }
 
 void Effect::bind()
 {
-   GL_ASSERT( glUseProgram(_program) );
+    // The program is most likely still bound when draws are sorted by effect.
+    if (__currentEffect == this)
+        return;
+
+    GL_ASSERT( glUseProgram(_program) );
+    RenderQueue::_statistics.programSwitches++;
 
     __currentEffect = this;
 }
@@ -655,7 +696,7 @@ Effect* Effect::getCurrentEffect()
 }
 
 Uniform::Uniform() :
-    _location(-1), _type(0), _index(0), _effect(NULL)
+    _location(-1), _type(0), _index(0), _effect(NULL), _cacheSize(0)
 {
 }
 
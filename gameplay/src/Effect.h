@@ -241,6 +241,15 @@ private:
 
     static Effect* createFromSource(const char* vshPath, const char* vshSource, const char* fshPath, const char* fshSource, const char* defines = NULL);
 
+    /**
+     * Remembers the value last uploaded to a uniform and determines whether a new value differs from it.
+     *
+     * Values larger than a matrix are not remembered and are always uploaded.
+     *
+     * @return True if the value must be uploaded, false if the uniform already holds it.
+     */
+    static bool updateUniformValue(Uniform* uniform, const void* value, size_t size);
+
     GLuint _program;
     std::string _id;
     std::map<std::string, VertexAttribute> _vertexAttributes;
@@ -305,6 +314,8 @@ private:
     GLenum _type;
     unsigned int _index;
     Effect* _effect;
+    float _cache[16];
+    unsigned int _cacheSize;
 };
 
 }
@@ -29,6 +29,9 @@
     #define __EXT_POSIX2
     #include <libgen.h>
     #include <dirent.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
     #define gp_stat stat
     #define gp_stat_struct struct stat
 #endif
@@ -468,6 +471,102 @@ char* FileSystem::readAll(const char* filePath, int* fileSize)
     return buffer;
 }
 
+const char* FileSystem::mapFile(const char* filePath, size_t* fileSize)
+{
+    GP_ASSERT(filePath);
+    GP_ASSERT(fileSize);
+
+    std::string fullPath;
+    getFullPath(filePath, fullPath);
+
+#ifdef WIN32
+    HANDLE file = CreateFileA(fullPath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    // The view keeps the mapping alive, so both handles can be closed right away.
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL)
+        return NULL;
+
+    const char* data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == NULL)
+        return NULL;
+
+    *fileSize = (size_t)size.QuadPart;
+    return data;
+#else
+    int fd = ::open(fullPath.c_str(), O_RDONLY);
+    if (fd == -1)
+        return NULL;
+
+    gp_stat_struct s;
+    if (fstat(fd, &s) != 0 || s.st_size == 0)
+    {
+        ::close(fd);
+        return NULL;
+    }
+
+    void* data = mmap(NULL, (size_t)s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return NULL;
+
+    *fileSize = (size_t)s.st_size;
+    return (const char*)data;
+#endif
+}
+
+void FileSystem::unmapFile(const char* data, size_t fileSize)
+{
+    if (data == NULL)
+        return;
+
+#ifdef WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap((void*)data, fileSize);
+#endif
+}
+
+bool FileSystem::createDirectory(const char* dirPath)
+{
+    GP_ASSERT(dirPath);
+
+    std::string fullPath;
+    getFullPath(dirPath, fullPath);
+    std::replace(fullPath.begin(), fullPath.end(), '\\', '/');
+
+    // Create each directory along the path. Failures are ignored on the way since the
+    // directory may be a drive or may have been created by someone else in the meantime.
+    gp_stat_struct s;
+    for (size_t index = fullPath.find('/', 1); ; index = fullPath.find('/', index + 1))
+    {
+        std::string path = fullPath.substr(0, index);
+        if (stat(path.c_str(), &s) != 0)
+        {
+#ifdef WIN32
+            _mkdir(path.c_str());
+#else
+            mkdir(path.c_str(), 0777);
+#endif
+        }
+        if (index == std::string::npos)
+            break;
+    }
+
+    return stat(fullPath.c_str(), &s) == 0 && (s.st_mode & S_IFDIR) != 0;
+}
+
 bool FileSystem::isAbsolutePath(const char* filePath)
 {
     if (filePath == 0 || filePath[0] == '\0')
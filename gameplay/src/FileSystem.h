@@ -202,6 +202,42 @@ public:
      */
     static char* readAll(const char* filePath, int* fileSize = NULL);
 
+    /**
+     * Maps the entire contents of the specified file into memory for reading.
+     *
+     * Only files residing on the local file system can be mapped. Files served from
+     * Android assets or registered packages are not mapped and NULL is returned, in which
+     * case the caller should fall back to reading the file through open().
+     *
+     * The returned memory is read-only and must be released using unmapFile().
+     *
+     * @param filePath The path to the file to be mapped.
+     * @param fileSize Populated with the size of the mapped file in bytes.
+     * 
+     * @return A pointer to the mapped contents of the file, or NULL if the file could not be mapped.
+     * @script{ignore}
+     */
+    static const char* mapFile(const char* filePath, size_t* fileSize);
+
+    /**
+     * Releases the memory returned by a previous call to mapFile().
+     *
+     * @param data The pointer returned by mapFile().
+     * @param fileSize The size of the mapped file in bytes.
+     * @script{ignore}
+     */
+    static void unmapFile(const char* data, size_t fileSize);
+
+    /**
+     * Creates a directory on the local file system, including any missing parent directories.
+     *
+     * @param dirPath The path to the directory.
+     *
+     * @return True if the directory exists afterwards, false otherwise.
+     * @script{ignore}
+     */
+    static bool createDirectory(const char* dirPath);
+
     /**
      * Determines if the file path is an absolute path for the current platform.
      * 
@@ -10,6 +10,7 @@
 
 #include "Base.h"
 #include "Font.h"
+#include "GlyphAtlas.h"
 #include "Text.h"
 #include "Game.h"
 #include "FileSystem.h"
@@ -21,6 +22,12 @@
 #define FONT_FSH "res/shaders/font.frag"
 #define FONT_FSH_ALPHA "res/shaders/font_alpha.frag"
 
+// The largest character code looked up in the direct glyph table (the end of the BMP).
+#define FONT_GLYPH_TABLE_MAX_CODE 0xFFFF
+
+// The number of text layouts and measurements each font keeps.
+#define FONT_LAYOUT_CACHE_SIZE 128
+
 namespace gameplay
 {
 
@@ -30,7 +37,7 @@ static Effect* __fontEffect = NULL;
 static Effect* __fontEffectAlpha = NULL;
 
 Font::Font() :
-    _format(BITMAP), _style(PLAIN), _size(0), _glyphs(NULL), _glyphCount(0), _texture(NULL), _batch(NULL), _cutoffParam(NULL)
+    _format(BITMAP), _style(PLAIN), _size(0), _glyphs(NULL), _glyphCount(0), _texture(NULL), _batch(NULL), _atlas(NULL), _cutoffParam(NULL)
 {
 }
 
@@ -44,6 +51,7 @@ Font::~Font()
     }
 
     SAFE_DELETE(_batch);
+    SAFE_DELETE(_atlas);
     SAFE_DELETE_ARRAY(_glyphs);
     SAFE_RELEASE(_texture);
 
@@ -110,24 +118,22 @@ Font* Font::create(const char* path, const char* id)
     return font;
 }
 
-Font* Font::create(const char* family, Style style, unsigned int size, Glyph* glyphs, int glyphCount, Texture* texture, Font::Format format)
+/**
+ * Creates the sprite batch a font draws its glyphs with.
+ */
+static SpriteBatch* createFontBatch(Texture* texture, Font::Style style, Font::Format format)
 {
-    GP_ASSERT(family);
-    GP_ASSERT(glyphs);
-    GP_ASSERT(texture);
-
     // Create the effect for the font's sprite batch.
     Effect ** fontEffect = style == Font::TEXTURED ? &__fontEffect : &__fontEffectAlpha;
     if (*fontEffect == NULL)
     {
         const char* defines = NULL;
-        if (format == DISTANCE_FIELD)
+        if (format == Font::DISTANCE_FIELD)
             defines = "DISTANCE_FIELD";
         *fontEffect = Effect::createFromFile(FONT_VSH, style == Font::TEXTURED ? FONT_FSH : FONT_FSH_ALPHA, defines);
         if (*fontEffect == NULL)
         {
             GP_WARN("Failed to create effect for font.");
-            SAFE_RELEASE(texture);
             return NULL;
         }
     }
@@ -153,6 +159,19 @@ Font* Font::create(const char* family, Style style, unsigned int size, Glyph* gl
     sampler->setFilterMode(Texture::LINEAR, Texture::LINEAR);
     sampler->setWrapMode(Texture::CLAMP, Texture::CLAMP);
 
+    return batch;
+}
+
+Font* Font::create(const char* family, Style style, unsigned int size, Glyph* glyphs, int glyphCount, Texture* texture, Font::Format format)
+{
+    GP_ASSERT(family);
+    GP_ASSERT(glyphs);
+    GP_ASSERT(texture);
+
+    SpriteBatch* batch = createFontBatch(texture, style, format);
+    if (batch == NULL)
+        return NULL;
+
     // Increase the ref count of the texture to retain it.
     texture->addRef();
 
@@ -168,6 +187,52 @@ Font* Font::create(const char* family, Style style, unsigned int size, Glyph* gl
     font->_glyphs = new Glyph[glyphCount];
     memcpy(font->_glyphs, glyphs, sizeof(Glyph) * glyphCount);
     font->_glyphCount = glyphCount;
+    font->buildGlyphTable();
+
+    return font;
+}
+
+Font* Font::createDynamic(GlyphRasterizer* rasterizer, unsigned int size, Format format, unsigned int atlasWidth, unsigned int atlasHeight)
+{
+    GP_ASSERT(rasterizer);
+    GP_ASSERT(size > 0);
+
+    // Start from a cleared atlas, since the padding around glyphs is sampled when filtering.
+    std::vector<unsigned char> pixels(atlasWidth * atlasHeight, 0);
+    Texture* texture = Texture::create(Texture::ALPHA, atlasWidth, atlasHeight, &pixels[0]);
+    if (texture == NULL)
+    {
+        GP_WARN("Failed to create texture for font atlas.");
+        return NULL;
+    }
+
+    SpriteBatch* batch = createFontBatch(texture, PLAIN, format);
+    if (batch == NULL)
+    {
+        SAFE_RELEASE(texture);
+        return NULL;
+    }
+
+    Font* font = new Font();
+    font->_format = format;
+    font->_style = PLAIN;
+    font->_size = size;
+    font->_texture = texture;
+    font->_batch = batch;
+
+    // Glyph slots are allocated up front, so glyph pointers stay valid as glyphs come and go.
+    GlyphAtlas* atlas = new GlyphAtlas(font, rasterizer, texture, size);
+    if (atlas->getRowCount() == 0)
+    {
+        GP_WARN("Font atlas of height %u is too small for glyphs of size %u.", atlasHeight, size);
+        SAFE_DELETE(atlas);
+        SAFE_RELEASE(font);
+        return NULL;
+    }
+    font->_atlas = atlas;
+    font->_glyphCount = atlas->getGlyphCapacity();
+    font->_glyphs = new Glyph[font->_glyphCount];
+    memset(font->_glyphs, 0, sizeof(Glyph) * font->_glyphCount);
 
     return font;
 }
@@ -190,11 +255,19 @@ Font::Format Font::getFormat() const
     return _format;
 }
 
+bool Font::isDynamic() const
+{
+    return _atlas != NULL;
+}
+
+GlyphAtlas* Font::getGlyphAtlas() const
+{
+    return _atlas;
+}
+
 bool Font::isCharacterSupported(int character) const
 {
-    // TODO: Update this once we support unicode fonts
-    int glyphIndex = character - 32; // HACK for ASCII
-    return (glyphIndex >= 0 && glyphIndex < (int)_glyphCount);
+    return getGlyphIndexByCode(character) >= 0;
 }
 
 void Font::start() const
@@ -465,6 +538,55 @@ void Font::drawText(const wchar_t* text, const Rectangle& areaIn, const Vector4&
 
     lazyStart();
 
+    // Lay the text out only when it changed; moving the area by whole pixels reuses the layout.
+    LayoutKey key(LAYOUT_DRAW, text, size, flags, areaIn, justify, wrap, characterSpacing, lineSpacing);
+    TextLayout* layout = findLayout(key);
+    if (layout == NULL)
+    {
+        // Laying out may rasterize glyphs and evict atlas rows, so the layout is only
+        // added afterwards to record the atlas version it was built against.
+        std::vector<GlyphQuad> quads;
+        layoutText(text, areaIn, size, justify, wrap, flags, characterSpacing, lineSpacing, &quads);
+        layout = addLayout(key);
+        layout->quads.swap(quads);
+    }
+
+    const size_t quadCount = layout->quads.size();
+    if (quadCount == 0)
+        return;
+
+    GP_ASSERT(_batch);
+    if (getFormat() == DISTANCE_FIELD)
+    {
+        if (_cutoffParam == NULL)
+            _cutoffParam = _batch->getMaterial()->getParameter("u_cutoff");
+        // TODO: Fix me so that smaller font are much smoother
+        _cutoffParam->setVector2(Vector2(1.0, 1.0));
+    }
+
+    bool clipText = clip != Rectangle(0, 0, 0, 0);
+    for (size_t i = 0; i < quadCount; ++i)
+    {
+        const GlyphQuad& q = layout->quads[i];
+        if (_atlas)
+            _atlas->touch(q.glyph);
+        float x = areaIn.x + q.x;
+        float y = areaIn.y + q.y;
+        if (q.rotation != 0.0f)
+            _batch->draw(x, y, 0.0f, q.width, q.height, q.uvs[0], q.uvs[1], q.uvs[2], q.uvs[3], color, gameplay::Vector2::zero(), q.rotation);
+        else if (clipText)
+            _batch->draw(x, y, q.width, q.height, q.uvs[0], q.uvs[1], q.uvs[2], q.uvs[3], color, clip);
+        else
+            _batch->draw(x, y, q.width, q.height, q.uvs[0], q.uvs[1], q.uvs[2], q.uvs[3], color);
+    }
+}
+
+void Font::layoutText(const wchar_t* text, const Rectangle& areaIn, float size, Justify justify, bool wrap, DrawFlags flags,
+    float characterSpacing, float lineSpacing, std::vector<GlyphQuad>* quads) const
+{
+    GP_ASSERT(text);
+    GP_ASSERT(quads);
+
     Rectangle area(areaIn);
 
     float scale = (float)size / _size;
@@ -473,7 +595,6 @@ void Font::drawText(const wchar_t* text, const Rectangle& areaIn, const Vector4&
     float yPos = area.y;
     std::vector<float> xPositions;
     std::vector<unsigned int> lineLengths;
-    bool clipText = clip != Rectangle(0, 0, 0, 0);
 
     // For vertically drawn font assume we calculate positions of the glyphs still horizontally
     // but rotate them at the moment of actual batch drawing. We also need to remap text's justify
@@ -607,7 +728,6 @@ void Font::drawText(const wchar_t* text, const Rectangle& areaIn, const Vector4&
         }
 
         GP_ASSERT(_glyphs);
-        GP_ASSERT(_batch);
         for (int i = startIndex; i < (int)tokenLength && i >= 0; i += iteration)
         {
             wchar_t c = token[i];
@@ -625,37 +745,39 @@ void Font::drawText(const wchar_t* text, const Rectangle& areaIn, const Vector4&
                 }
                 else if (xPos + g.advance*scale >= area.x)
                 {
-                    // Draw this character.
+                    // Record this character, relative to the area.
                     if (draw)
                     {
-                        if (getFormat() == DISTANCE_FIELD)
-                        {
-                            if (_cutoffParam == NULL)
-                                _cutoffParam = _batch->getMaterial()->getParameter("u_cutoff");
-                            // TODO: Fix me so that smaller font are much smoother
-                            _cutoffParam->setVector2(Vector2(1.0, 1.0));
-                        }
+                        float dx = xPos - area.x;
+                        float dy = yPos - area.y;
+                        GlyphQuad quad;
+                        quad.glyph = glyphIndex;
+                        quad.width = g.width * scale;
+                        quad.height = size;
 
                         // TODO: Clipping is unsupported for vertically drawn text
                         if ((flags & DRAW_VERTICAL_CW) != 0)
                         {
-                            float dx = xPos - area.x;
-                            float dy = yPos - area.y;
-                            _batch->draw(area.x + area.height - dy, area.y + dx + g.bearingX * scale, 0.0f, g.width * scale, size, g.uvs[0], g.uvs[3], g.uvs[2], g.uvs[1], color, gameplay::Vector2::zero(), MATH_PIOVER2);
+                            quad.x = area.height - dy;
+                            quad.y = dx + g.bearingX * scale;
+                            quad.uvs[0] = g.uvs[0]; quad.uvs[1] = g.uvs[3]; quad.uvs[2] = g.uvs[2]; quad.uvs[3] = g.uvs[1];
+                            quad.rotation = MATH_PIOVER2;
                         }
                         else if ((flags & DRAW_VERTICAL_CCW) != 0)
                         {
-                            float dx = xPos - area.x;
-                            float dy = yPos - area.y;
-                            _batch->draw(area.x + dy, area.y + area.width - dx - g.bearingX * scale, 0.0f, g.width * scale, size, g.uvs[0], g.uvs[3], g.uvs[2], g.uvs[1], color, gameplay::Vector2::zero(), -MATH_PIOVER2);
+                            quad.x = dy;
+                            quad.y = area.width - dx - g.bearingX * scale;
+                            quad.uvs[0] = g.uvs[0]; quad.uvs[1] = g.uvs[3]; quad.uvs[2] = g.uvs[2]; quad.uvs[3] = g.uvs[1];
+                            quad.rotation = -MATH_PIOVER2;
                         }
                         else
                         {
-                            if (clipText)
-                                _batch->draw(xPos + g.bearingX * scale, yPos, g.width * scale, size, g.uvs[0], g.uvs[1], g.uvs[2], g.uvs[3], color, clip);
-                            else
-                                _batch->draw(xPos + g.bearingX * scale, yPos, g.width * scale, size, g.uvs[0], g.uvs[1], g.uvs[2], g.uvs[3], color);
+                            quad.x = dx + g.bearingX * scale;
+                            quad.y = dy;
+                            memcpy(quad.uvs, g.uvs, sizeof(quad.uvs));
+                            quad.rotation = 0.0f;
                         }
+                        quads->push_back(quad);
                     }
                 }
                 xPos += g.advance*scale + spacing;
@@ -770,6 +892,15 @@ void Font::measureText(const wchar_t* text, float size, DrawFlags flags, float*
         return;
     }
 
+    LayoutKey key(LAYOUT_MEASURE, text, size, flags, Rectangle(), ALIGN_TOP_LEFT, false, characterSpacing, lineSpacing);
+    TextLayout* layout = findLayout(key);
+    if (layout)
+    {
+        *width = layout->bounds.width;
+        *height = layout->bounds.height;
+        return;
+    }
+
     float scale = (float)size / _size;
     const wchar_t* token = text;
     float verticalAdvance = size + lineSpacing;
@@ -798,6 +929,8 @@ void Font::measureText(const wchar_t* text, float size, DrawFlags flags, float*
 
     if ((flags & (DRAW_VERTICAL_CCW | DRAW_VERTICAL_CW)) != 0)
         std::swap(*width, *height);
+
+    addLayout(key)->bounds.set(0, 0, *width, *height);
 }
 
 void Font::measureText(const wchar_t* text, const Rectangle& clipIn, float size, DrawFlags flags, Rectangle* out, Justify justify, bool wrap, bool ignoreClip,
@@ -828,6 +961,15 @@ void Font::measureText(const wchar_t* text, const Rectangle& clipIn, float size,
         return;
     }
 
+    // Bounds are cached relative to the clip, like the layouts of drawn text.
+    LayoutKey key(ignoreClip ? LAYOUT_MEASURE_UNCLIPPED : LAYOUT_MEASURE_CLIPPED, text, size, flags, clipIn, justify, wrap, characterSpacing, lineSpacing);
+    TextLayout* layout = findLayout(key);
+    if (layout)
+    {
+        out->set(clipIn.x + layout->bounds.x, clipIn.y + layout->bounds.y, layout->bounds.width, layout->bounds.height);
+        return;
+    }
+
     Rectangle clip(clipIn);
 
     // For vertically drawn font assume we calculate positions of the glyphs still horizontally
@@ -1217,6 +1359,8 @@ void Font::measureText(const wchar_t* text, const Rectangle& clipIn, float size,
         out->y = clip.y - dx + clip.width - out->width;
         std::swap(out->width, out->height);
     }
+
+    addLayout(key)->bounds.set(out->x - clipIn.x, out->y - clipIn.y, out->width, out->height);
 }
 
 void Font::getMeasurementInfo(const wchar_t* text, const Rectangle& area, float size, Justify justify, bool wrap, DrawFlags flags,
@@ -2001,26 +2145,155 @@ Font::DrawFlags Font::getDrawFlags(const char* flags)
 }
 
 
-int Font::getGlyphIndexByCode(int characterCode) const
+Font::LayoutKey::LayoutKey(LayoutKind kind, const wchar_t* text, float size, DrawFlags flags, const Rectangle& area, Justify justify, bool wrap,
+    float characterSpacing, float lineSpacing)
+    : kind(kind), text(text), size(size), flags(flags), width(area.width), height(area.height),
+      originX(area.x - floorf(area.x)), originY(area.y - floorf(area.y)), justify(justify), wrap(wrap),
+      characterSpacing(characterSpacing), lineSpacing(lineSpacing)
 {
-    for( unsigned i = 0; i < _glyphCount; i++ )
+}
+
+bool Font::LayoutKey::operator==(const LayoutKey& key) const
+{
+    return kind == key.kind && size == key.size && flags == key.flags && width == key.width && height == key.height &&
+        originX == key.originX && originY == key.originY && justify == key.justify && wrap == key.wrap &&
+        characterSpacing == key.characterSpacing && lineSpacing == key.lineSpacing && text == key.text;
+}
+
+size_t Font::LayoutKey::hash() const
+{
+    const float values[] = { size, width, height, originX, originY, characterSpacing, lineSpacing };
+    size_t h = std::hash<std::wstring>()(text);
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
     {
-        if( _glyphs[ i ].code == characterCode )
-            return i;
+        h = h * 31 + std::hash<float>()(values[i]);
     }
+    return h * 31 + (((size_t)kind << 16) ^ ((size_t)flags << 8) ^ ((size_t)justify << 1) ^ (size_t)wrap);
+}
 
-    return -1;
+Font::TextLayout* Font::findLayout(const LayoutKey& key) const
+{
+    std::unordered_map<size_t, std::list<TextLayout>::iterator>::iterator itr = _layoutIndex.find(key.hash());
+    if (itr == _layoutIndex.end() || !(itr->second->key == key))
+        return NULL;
+
+    // Drop layouts that may refer to evicted glyphs or lack skipped ones.
+    if (_atlas && itr->second->atlasVersion != _atlas->getVersion())
+    {
+        _layouts.erase(itr->second);
+        _layoutIndex.erase(itr);
+        return NULL;
+    }
+
+    // Keep the most recently used layouts at the front.
+    _layouts.splice(_layouts.begin(), _layouts, itr->second);
+    return &_layouts.front();
 }
 
-const Font::Glyph * Font::getGlyphByCode(int characterCode) const
+Font::TextLayout* Font::addLayout(const LayoutKey& key) const
 {
-    for( unsigned i = 0; i < _glyphCount; i++ )
+    // Evict the least recently used layout, unless another key took over its index slot.
+    if (_layouts.size() >= FONT_LAYOUT_CACHE_SIZE)
     {
-        if( _glyphs[ i ].code == characterCode )
-            return &_glyphs[ i ];
+        std::unordered_map<size_t, std::list<TextLayout>::iterator>::iterator itr = _layoutIndex.find(_layouts.back().key.hash());
+        if (itr != _layoutIndex.end() && itr->second == --_layouts.end())
+            _layoutIndex.erase(itr);
+        _layouts.pop_back();
     }
 
-    return NULL;
+    _layouts.push_front(TextLayout());
+    TextLayout& layout = _layouts.front();
+    layout.key = key;
+    layout.atlasVersion = _atlas ? _atlas->getVersion() : 0;
+    _layoutIndex[key.hash()] = _layouts.begin();
+    return &layout;
+}
+
+void Font::clearLayouts() const
+{
+    _layouts.clear();
+    _layoutIndex.clear();
+}
+
+void Font::buildGlyphTable()
+{
+    _glyphTable.clear();
+    _glyphMap.clear();
+
+    // Size the direct table by the largest BMP code, so small fonts keep small tables.
+    unsigned int tableSize = 0;
+    for (unsigned int i = 0; i < _glyphCount; ++i)
+    {
+        unsigned int code = _glyphs[i].code;
+        if (code <= FONT_GLYPH_TABLE_MAX_CODE && code >= tableSize)
+            tableSize = code + 1;
+    }
+    _glyphTable.resize(tableSize, -1);
+
+    // Keep the first glyph of duplicated codes, as the linear search did.
+    for (unsigned int i = 0; i < _glyphCount; ++i)
+    {
+        unsigned int code = _glyphs[i].code;
+        if (code <= FONT_GLYPH_TABLE_MAX_CODE)
+        {
+            if (_glyphTable[code] < 0)
+                _glyphTable[code] = (int)i;
+        }
+        else
+        {
+            _glyphMap.insert(std::make_pair(code, (int)i));
+        }
+    }
+}
+
+void Font::setGlyphIndex(unsigned int code, int index)
+{
+    if (code <= FONT_GLYPH_TABLE_MAX_CODE)
+    {
+        if (code >= _glyphTable.size())
+            _glyphTable.resize(code + 1, -1);
+        _glyphTable[code] = index;
+    }
+    else if (index >= 0)
+    {
+        _glyphMap[code] = index;
+    }
+    else
+    {
+        _glyphMap.erase(code);
+    }
+}
+
+int Font::getGlyphIndexByCode(int characterCode) const
+{
+    unsigned int code = (unsigned int)characterCode;
+    int index = -1;
+    if (code < _glyphTable.size())
+    {
+        index = _glyphTable[code];
+    }
+    else if (code > FONT_GLYPH_TABLE_MAX_CODE && !_glyphMap.empty())
+    {
+        std::unordered_map<unsigned int, int>::const_iterator itr = _glyphMap.find(code);
+        if (itr != _glyphMap.end())
+            index = itr->second;
+    }
+
+    // Dynamic fonts rasterize glyphs on first use and keep the used ones resident.
+    if (_atlas)
+    {
+        if (index >= 0)
+            _atlas->touch(index);
+        else
+            index = _atlas->addGlyph(code);
+    }
+    return index;
+}
+
+const Font::Glyph * Font::getGlyphByCode(int characterCode) const
+{
+    int index = getGlyphIndexByCode(characterCode);
+    return index >= 0 ? &_glyphs[index] : NULL;
 }
 
 }
@@ -16,6 +16,9 @@
 namespace gameplay
 {
 
+class GlyphAtlas;
+class GlyphRasterizer;
+
 /**
  * Defines a font for text rendering.
  */
@@ -24,6 +27,7 @@ class Font : public Ref
     friend class Bundle;
     friend class Text;
     friend class TextBox;
+    friend class GlyphAtlas;
 
 public:
 
@@ -99,6 +103,27 @@ public:
      */
     static Font* create(const char* path, const char* id = NULL);
 
+    /**
+     * Creates a font that rasterizes its glyphs the first time they are drawn
+     * or measured, instead of loading them from a bundle.
+     *
+     * The glyphs are kept in an atlas texture that evicts the least recently
+     * used ones when it is full, so a font can cover large character sets
+     * with a fixed amount of texture memory.
+     *
+     * @param rasterizer The rasterizer that renders the glyphs. The font keeps a reference to it.
+     * @param size The font size (height of glyphs) in pixels.
+     * @param format The format of the glyphs in the atlas.
+     * @param atlasWidth The width of the atlas texture.
+     * @param atlasHeight The height of the atlas texture.
+     *
+     * @return The new Font or NULL if there was an error.
+     * @see GlyphRasterizer::create
+     * @script{ignore}
+     */
+    static Font* createDynamic(GlyphRasterizer* rasterizer, unsigned int size, Format format = BITMAP,
+        unsigned int atlasWidth = 512, unsigned int atlasHeight = 512);
+
     /**
      * Gets the font size (max height of glyphs) in pixels, at the specified index.
      *
@@ -120,6 +145,21 @@ public:
      */
     Format getFormat() const;
 
+    /**
+     * Determines if this font rasterizes its glyphs at runtime.
+     *
+     * @return True if the font was created with createDynamic, false otherwise.
+     */
+    bool isDynamic() const;
+
+    /**
+     * Gets the atlas the glyphs of a dynamic font are rasterized into.
+     *
+     * @return The glyph atlas, or NULL if the font is not dynamic.
+     * @script{ignore}
+     */
+    GlyphAtlas* getGlyphAtlas() const;
+
     /**
      * Determines if this font supports the specified character code.
      *
@@ -312,6 +352,75 @@ public:
     const Glyph * getGlyphByCode( int characterCode ) const;
 
 private:
+
+    /**
+     * Defines what a cached text layout holds.
+     */
+    enum LayoutKind
+    {
+        LAYOUT_DRAW,
+        LAYOUT_MEASURE,
+        LAYOUT_MEASURE_CLIPPED,
+        LAYOUT_MEASURE_UNCLIPPED
+    };
+
+    /**
+     * Identifies a text layout by everything its glyph positions depend on.
+     *
+     * The area only contributes its size and the fractions of its position,
+     * so the layout of text moved by whole pixels is reused.
+     */
+    struct LayoutKey
+    {
+        LayoutKey() : kind(LAYOUT_DRAW), size(0), flags(LEFT_TO_RIGHT), width(0), height(0), originX(0), originY(0),
+            justify(ALIGN_TOP_LEFT), wrap(false), characterSpacing(0), lineSpacing(0) {}
+
+        LayoutKey(LayoutKind kind, const wchar_t* text, float size, DrawFlags flags, const Rectangle& area, Justify justify, bool wrap,
+            float characterSpacing, float lineSpacing);
+
+        bool operator==(const LayoutKey& key) const;
+
+        size_t hash() const;
+
+        LayoutKind kind;
+        std::wstring text;
+        float size;
+        DrawFlags flags;
+        float width;
+        float height;
+        float originX;
+        float originY;
+        Justify justify;
+        bool wrap;
+        float characterSpacing;
+        float lineSpacing;
+    };
+
+    /**
+     * A glyph quad positioned relative to the area it was laid out in.
+     */
+    struct GlyphQuad
+    {
+        float x;
+        float y;
+        float width;
+        float height;
+        float uvs[4];
+        float rotation;
+        int glyph;
+    };
+
+    /**
+     * A cached layout: the glyph quads of drawn text, or the bounds of measured text.
+     */
+    struct TextLayout
+    {
+        LayoutKey key;
+        std::vector<GlyphQuad> quads;
+        Rectangle bounds;
+        unsigned int atlasVersion;
+    };
+
     /**
      * Constructor.
      */
@@ -350,6 +459,26 @@ private:
      */
     static Font* create(const char* family, Style style, unsigned int size, Glyph* glyphs, int glyphCount, Texture* texture, Font::Format format);
 
+    void layoutText(const wchar_t* text, const Rectangle& area, float size, Justify justify, bool wrap, DrawFlags flags,
+                    float characterSpacing, float lineSpacing, std::vector<GlyphQuad>* quads) const;
+
+    /**
+     * Finds a cached layout and marks it as recently used.
+     *
+     * @return The layout, or NULL if it is not cached.
+     */
+    TextLayout* findLayout(const LayoutKey& key) const;
+
+    /**
+     * Adds an empty layout to the cache, evicting the least recently used one if the cache is full.
+     */
+    TextLayout* addLayout(const LayoutKey& key) const;
+
+    /**
+     * Drops all cached layouts, for instance when glyphs change.
+     */
+    void clearLayouts() const;
+
     void getMeasurementInfo(const wchar_t* text, const Rectangle& area, float size, Justify justify, bool wrap, DrawFlags flags,
                             std::vector<float>* xPositions, float* yPosition, std::vector<unsigned int>* lineLengths,
                             float characterSpacing, float lineSpacing) const;
@@ -375,6 +504,12 @@ private:
     //! Returns glyph index by character code or -1.
     int getGlyphIndexByCode( int characterCode ) const;
 
+    //! Builds the tables getGlyphIndexByCode looks glyphs up in.
+    void buildGlyphTable();
+
+    //! Maps a character code to a glyph index in those tables, or unmaps it for an index of -1.
+    void setGlyphIndex(unsigned int code, int index);
+
     const Font* findClosestSize(int size) const;
 
     void lazyStart() const;
@@ -388,10 +523,15 @@ private:
     std::vector<Font*> _sizes; // stores additional font sizes of the same family
     Glyph* _glyphs;
     unsigned int _glyphCount;
+    std::vector<int> _glyphTable;                       // glyph indices of BMP characters, -1 where missing
+    std::unordered_map<unsigned int, int> _glyphMap;    // glyph indices of characters beyond the BMP
     Texture* _texture;
     SpriteBatch* _batch;
+    GlyphAtlas* _atlas;
     Rectangle _viewport;
     mutable MaterialParameter* _cutoffParam;    // cached value, updated on draw.
+    mutable std::list<TextLayout> _layouts;     // most recently used first
+    mutable std::unordered_map<size_t, std::list<TextLayout>::iterator> _layoutIndex;
 };
 
 }
@@ -53,7 +53,7 @@ struct FormInit
 };
 static FormInit __init;
 
-Form::Form() : Drawable(), _batched(true)
+Form::Form() : Drawable(), _batched(true), _geometryCached(false), _recordingGeometry(false), _generatedVertexCount(0)
 {
 }
 
@@ -125,6 +125,7 @@ Form* Form::create(Properties * properties, Theme * themeFallback)
     }
 
     form->_batched = formProperties->getBool("batchingEnabled", true);
+    form->_geometryCached = formProperties->getBool("geometryCacheEnabled", false);
 
     // Initialize the form and all of its child controls
     form->initialize("Form", style, formProperties);
@@ -237,6 +238,50 @@ void Form::startBatch(SpriteBatch* batch)
         if (_batched)
             _batches.push_back(batch);
     }
+
+    if (_recordingGeometry)
+    {
+        for (size_t i = 0, count = _geometryStarts.size(); i < count; ++i)
+        {
+            if (_geometryStarts[i].first == batch)
+                return;
+        }
+        _geometryStarts.push_back(std::make_pair(batch, batch->_batch->getVertexCount()));
+    }
+}
+
+void Form::beginGeometry()
+{
+    GP_ASSERT(!_recordingGeometry);
+    GP_ASSERT(_batched);
+
+    _recordingGeometry = true;
+    _geometryStarts.clear();
+}
+
+void Form::endGeometry(std::vector<Control::GeometryBatch>* geometry)
+{
+    GP_ASSERT(_recordingGeometry);
+    GP_ASSERT(geometry);
+
+    _recordingGeometry = false;
+
+    // Batches are only flushed at the end of the form, so everything a control
+    // added since it first used a batch is still at the end of that batch.
+    geometry->resize(_geometryStarts.size());
+    for (size_t i = 0, count = _geometryStarts.size(); i < count; ++i)
+    {
+        SpriteBatch* batch = _geometryStarts[i].first;
+        unsigned int first = _geometryStarts[i].second;
+        unsigned int last = batch->_batch->getVertexCount();
+        GP_ASSERT(first <= last);
+
+        Control::GeometryBatch& entry = (*geometry)[i];
+        entry.batch = batch;
+        const SpriteBatch::SpriteVertex* vertices = batch->_batch->getVertices<SpriteBatch::SpriteVertex>();
+        entry.vertices.assign(vertices + first, vertices + last);
+        _generatedVertexCount += last - first;
+    }
 }
 
 void Form::finishBatch(SpriteBatch* batch)
@@ -281,6 +326,7 @@ unsigned int Form::draw(bool wireframe) const
     }
 
     // Draw the form
+    _generatedVertexCount = 0;
     unsigned int drawCalls = Container::draw(const_cast<Form *>(this));
 
     // Flush all batches that were queued during drawing and then empty the batch list
@@ -311,8 +357,30 @@ void Form::setBatchingEnabled(bool enabled)
     _batched = enabled;
 }
 
+bool Form::isGeometryCacheEnabled() const
+{
+    return _geometryCached;
+}
+
+void Form::setGeometryCacheEnabled(bool enabled)
+{
+    if (enabled != _geometryCached)
+    {
+        _geometryCached = enabled;
+        setChildrenDirty(DIRTY_GEOMETRY, true);
+        setDirty(DIRTY_GEOMETRY);
+    }
+}
+
+unsigned int Form::getGeneratedVertexCount() const
+{
+    return _generatedVertexCount;
+}
+
 void Form::updateInternal(float elapsedTime)
 {
+    GP_PROFILE_SCOPE("Form::updateInternal");
+
     pollGamepads();
 
     for (size_t i = 0, size = __forms.size(); i < size; ++i)
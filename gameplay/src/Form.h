@@ -151,6 +151,40 @@ public:
      */
     void setBatchingEnabled(bool enabled);
 
+    /**
+     * Determines whether controls of this form draw from cached geometry.
+     *
+     * @return True if geometry caching is enabled for this form, false otherwise.
+     */
+    bool isGeometryCacheEnabled() const;
+
+    /**
+     * Turns geometry caching on or off for this form.
+     *
+     * When enabled, every control keeps the sprite vertices it generated and
+     * adds them to the batches again while it is unchanged, so only controls
+     * that moved or changed state, text, opacity or images regenerate their
+     * geometry. Controls outside the visible area are still skipped. Geometry
+     * caching requires batching and has no effect when batching is disabled.
+     *
+     * Controls written outside of the library must call setDirty() whenever
+     * anything they draw changes.
+     *
+     * @param enabled True to enable geometry caching, false otherwise (default).
+     */
+    void setGeometryCacheEnabled(bool enabled);
+
+    /**
+     * Gets the number of vertices controls generated during the last draw.
+     *
+     * Only counted while geometry caching is enabled. Vertices added from
+     * cached geometry are not included.
+     *
+     * @return The number of generated vertices.
+     * @script{ignore}
+     */
+    unsigned int getGeneratedVertexCount() const;
+
 private:
     
     /**
@@ -252,6 +286,16 @@ private:
      */
     void finishBatch(SpriteBatch* batch);
 
+    /**
+     * Starts recording the vertices a control adds to the batches of this form.
+     */
+    void beginGeometry();
+
+    /**
+     * Stops recording and stores the recorded vertices, one entry per batch used.
+     */
+    void endGeometry(std::vector<Control::GeometryBatch>* geometry);
+
     /**
      * Unproject a point (from a mouse or touch event) into the scene and then project it onto the form.
      *
@@ -290,6 +334,10 @@ private:
     mutable Matrix _projectionMatrix;           // Projection matrix to be set on SpriteBatch objects when rendering the form
     mutable std::vector<SpriteBatch*> _batches;
     bool _batched;
+    bool _geometryCached;
+    std::vector<std::pair<SpriteBatch*, unsigned int> > _geometryStarts;   // batches used by the recorded control and their first vertex
+    bool _recordingGeometry;
+    mutable unsigned int _generatedVertexCount;
 };
 
 }
@@ -2,6 +2,11 @@
 #include "Frustum.h"
 #include "BoundingSphere.h"
 #include "BoundingBox.h"
+#include "MathUtil.h"
+
+#ifdef GP_USE_SSE
+#include <emmintrin.h>
+#endif
 
 namespace gameplay
 {
@@ -115,6 +120,69 @@ bool Frustum::intersects(const BoundingSphere& sphere) const
     return sphere.intersects(*this);
 }
 
+unsigned int Frustum::intersects(const BoundingSphere* spheres, unsigned int count, unsigned int* indices) const
+{
+    GP_ASSERT(spheres || count == 0);
+    GP_ASSERT(indices || count == 0);
+
+    const Plane* planes[6] = { &_near, &_far, &_left, &_right, &_bottom, &_top };
+    unsigned int visibleCount = 0;
+    unsigned int i = 0;
+
+#ifdef GP_USE_SSE
+    // A BoundingSphere is four packed floats, so four spheres transpose into
+    // separate registers of x, y, z and radius, which are tested against one
+    // plane at a time.
+    __m128 nx[6], ny[6], nz[6], d[6];
+    for (unsigned int p = 0; p < 6; ++p)
+    {
+        const Vector3& normal = planes[p]->getNormal();
+        nx[p] = _mm_set1_ps(normal.x);
+        ny[p] = _mm_set1_ps(normal.y);
+        nz[p] = _mm_set1_ps(normal.z);
+        d[p] = _mm_set1_ps(planes[p]->getDistance());
+    }
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(&spheres[i].center.x);
+        __m128 y = _mm_loadu_ps(&spheres[i + 1].center.x);
+        __m128 z = _mm_loadu_ps(&spheres[i + 2].center.x);
+        __m128 r = _mm_loadu_ps(&spheres[i + 3].center.x);
+        _MM_TRANSPOSE4_PS(x, y, z, r);
+
+        // A sphere is outside if it lies entirely behind any plane.
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), r);
+        for (unsigned int p = 0; p < 6; ++p)
+        {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], x), _mm_mul_ps(ny[p], y)), _mm_add_ps(_mm_mul_ps(nz[p], z), d[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        if (mask & 1) indices[visibleCount++] = i;
+        if (mask & 2) indices[visibleCount++] = i + 1;
+        if (mask & 4) indices[visibleCount++] = i + 2;
+        if (mask & 8) indices[visibleCount++] = i + 3;
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        const BoundingSphere& sphere = spheres[i];
+        bool inside = true;
+        for (unsigned int p = 0; p < 6 && inside; ++p)
+        {
+            inside = planes[p]->distance(sphere.center) >= -sphere.radius;
+        }
+        if (inside)
+            indices[visibleCount++] = i;
+    }
+
+    return visibleCount;
+}
+
 bool Frustum::intersects(const BoundingBox& box) const
 {
     return box.intersects(*this);
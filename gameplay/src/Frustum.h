@@ -162,6 +162,22 @@ public:
      */
     bool intersects(const BoundingSphere& sphere) const;
 
+    /**
+     * Tests an array of bounding spheres against this frustum at once and
+     * stores the indices of the spheres that intersect it.
+     *
+     * This is considerably faster than testing the spheres one by one and
+     * uses SIMD instructions where available.
+     *
+     * @param spheres The bounding spheres to test.
+     * @param count The number of spheres.
+     * @param indices An array of at least count elements to store the indices of the intersecting spheres in.
+     *
+     * @return The number of spheres that intersect this frustum.
+     * @script{ignore}
+     */
+    unsigned int intersects(const BoundingSphere* spheres, unsigned int count, unsigned int* indices) const;
+
     /**
      * Tests whether this frustum intersects the specified bounding box.
      *
@@ -78,13 +78,14 @@ Game::Game()
       _clearDepth(1.0f), _clearStencil(0), _properties(NULL),
       _animationController(NULL), _audioController(NULL),
       _physicsController(NULL), _aiController(NULL), _audioListener(NULL),
-      _timeEvents(NULL), _scriptController(NULL), _scriptTarget(NULL),
-      _clearColor(0.0f, 0.0f, 0.0f, 0.0f), _storeController(NULL)
+      _timeScheduler(NULL), _scriptController(NULL), _scriptTarget(NULL),
+      _clearColor(0.0f, 0.0f, 0.0f, 0.0f), _storeController(NULL), _resourceLoader(NULL),
+      _jobScheduler(NULL), _parallelControllers(false)
 {
     GP_ASSERT(__gameInstance == NULL);
 
     __gameInstance = this;
-    _timeEvents = new std::priority_queue<TimeEvent, std::vector<TimeEvent>, std::less<TimeEvent> >();
+    _timeScheduler = new TimeScheduler();
 }
 
 Game::~Game()
@@ -94,7 +95,7 @@ Game::~Game()
 
     // Do not call any virtual functions from the destructor.
     // Finalization is done from outside this class.
-    SAFE_DELETE(_timeEvents);
+    SAFE_DELETE(_timeScheduler);
 #ifdef GP_USE_MEM_LEAK_DETECTION
     Ref::printLeaks();
     printMemoryLeaks();
@@ -184,6 +185,12 @@ bool Game::startup()
     RenderState::initialize();
     FrameBuffer::initialize();
 
+    // Start the job scheduler first so the controllers can use it.
+    Properties* jobProperties = _properties ? _properties->getNamespace("jobs", true) : NULL;
+    _jobScheduler = new JobScheduler();
+    _jobScheduler->initialize(jobProperties ? (unsigned int)jobProperties->getInt("threads") : 0);
+    _parallelControllers = jobProperties && jobProperties->getBool("parallelControllers");
+
     _animationController = new AnimationController();
     _animationController->initialize();
 
@@ -197,6 +204,16 @@ bool Game::startup()
     {
         _physicsController = new PhysicsController();
         _physicsController->initialize();
+
+        Properties* physicsProperties = _properties ? _properties->getNamespace("physics", true) : NULL;
+        if (physicsProperties)
+        {
+            _physicsController->setCookedShapePath(physicsProperties->getString("cookedShapePath"));
+            _physicsController->setFixedTimeStep(physicsProperties->getFloat("fixedTimeStep"));
+            if (physicsProperties->exists("maxSubSteps"))
+                _physicsController->setMaxSubSteps((unsigned int)physicsProperties->getInt("maxSubSteps"));
+            _physicsController->setInterpolation(physicsProperties->getBool("interpolation", true));
+        }
     }
 
     _aiController = new AIController();
@@ -214,6 +231,16 @@ bool Game::startup()
     _storeController = new StoreController();
     _storeController->initialize();
 
+    Properties* loaderProperties = _properties ? _properties->getNamespace("resourceLoader", true) : NULL;
+    _resourceLoader = new ResourceLoader();
+    _resourceLoader->initialize(loaderProperties ? (unsigned int)loaderProperties->getInt("threads") : 0);
+    if (loaderProperties && loaderProperties->exists("frameBudget"))
+        _resourceLoader->setFrameBudget(loaderProperties->getFloat("frameBudget"));
+
+    Properties* schedulerProperties = _properties ? _properties->getNamespace("timeScheduler", true) : NULL;
+    if (schedulerProperties && schedulerProperties->exists("frameBudget"))
+        _timeScheduler->setFrameBudget(schedulerProperties->getFloat("frameBudget"));
+
     // Load any gamepads, ui or physical.
     loadGamepads();
 
@@ -288,6 +315,10 @@ void Game::shutdown()
         if (_scriptController)
 		    _scriptController->finalize();
 
+        // Stop background loading before the systems that loaded resources depend on go away.
+        _resourceLoader->finalize();
+        SAFE_DELETE(_resourceLoader);
+
         unsigned int gamepadCount = Gamepad::getGamepadCount();
         for (unsigned int i = 0; i < gamepadCount; i++)
         {
@@ -319,6 +350,10 @@ void Game::shutdown()
         _storeController->finalize();
         SAFE_DELETE(_storeController);
 
+        // Stop the job scheduler after the controllers that may have queued jobs.
+        _jobScheduler->finalize();
+        SAFE_DELETE(_jobScheduler);
+
         ControlFactory::finalize();
 
         Theme::finalize();
@@ -409,6 +444,9 @@ void Game::exit()
 
 void Game::frame()
 {
+    GP_PROFILE_FRAME();
+    GP_PROFILE_SCOPE("Game::frame");
+
     if (_state != UNINITIALIZED && !_initialized)
     {
         // Perform lazy first time initialization
@@ -426,26 +464,24 @@ void Game::frame()
 	double frameTime = getGameTime();
 
     // Fire time events to scheduled TimeListeners
-    fireTimeEvents(frameTime);
+    _timeScheduler->update(frameTime);
+
+    // Update Time. Paused frames pass no elapsed time, the same as to the other systems.
+    float elapsedTime = _state == Game::RUNNING ? (float)(frameTime - lastFrameTime) : 0.0f;
+
+    // Complete finished background loads within the frame budget.
+    if (_resourceLoader)
+        _resourceLoader->update(elapsedTime);
 
     if (_state == Game::RUNNING)
     {
         GP_ASSERT(_animationController);
         GP_ASSERT(_aiController);
 
-        // Update Time.
-        float elapsedTime = (frameTime - lastFrameTime);
         lastFrameTime = frameTime;
 
-        // Update the scheduled and running animations.
-        _animationController->update(elapsedTime);
-
-        // Update the physics.
-        if (_physicsController)
-            _physicsController->update(elapsedTime);
-
-        // Update AI.
-        _aiController->update(elapsedTime);
+        // Update the scheduled and running animations, the physics and AI.
+        updateControllers(elapsedTime);
 
         // Update gamepads.
         Gamepad::updateInternal(elapsedTime);
@@ -510,6 +546,55 @@ void Game::frame()
     }
 }
 
+void Game::updateControllers(float elapsedTime)
+{
+    GP_ASSERT(_animationController);
+    GP_ASSERT(_aiController);
+
+    if (!_parallelControllers || _jobScheduler->getWorkerCount() == 0)
+    {
+        _animationController->update(elapsedTime);
+        if (_physicsController)
+            _physicsController->update(elapsedTime);
+        _aiController->update(elapsedTime);
+        return;
+    }
+
+    // Physics follows the animated transforms of kinematic bodies, so it waits for
+    // animation. AI state handlers and their scripts move nodes and hold references
+    // like the listeners of the other controllers, so AI waits for both.
+    JobScheduler::Job* animationJob = _jobScheduler->createJob([this, elapsedTime]()
+    {
+        _animationController->update(elapsedTime);
+    }, "AnimationController::update");
+
+    JobScheduler::Job* physicsJob = NULL;
+    if (_physicsController)
+    {
+        physicsJob = _jobScheduler->createJob([this, elapsedTime]()
+        {
+            _physicsController->update(elapsedTime);
+        }, "PhysicsController::update");
+        _jobScheduler->addDependency(physicsJob, animationJob);
+    }
+
+    JobScheduler::Job* aiJob = _jobScheduler->createJob([this, elapsedTime]()
+    {
+        _aiController->update(elapsedTime);
+    }, "AIController::update");
+    _jobScheduler->addDependency(aiJob, physicsJob ? physicsJob : animationJob);
+
+    _jobScheduler->submit(animationJob);
+    if (physicsJob)
+        _jobScheduler->submit(physicsJob);
+    _jobScheduler->submit(aiJob);
+
+    _jobScheduler->wait(aiJob);
+    if (physicsJob)
+        _jobScheduler->wait(physicsJob);
+    _jobScheduler->wait(animationJob);
+}
+
 void Game::renderOnce(const char* function)
 {
     if (_scriptController)
@@ -530,16 +615,15 @@ void Game::updateOnce()
     lastFrameTime = frameTime;
 
     // Update the internal controllers.
-    _animationController->update(elapsedTime);
-    if (_physicsController)
-        _physicsController->update(elapsedTime);
-    _aiController->update(elapsedTime);
+    updateControllers(elapsedTime);
     if (_audioController)
         _audioController->update(elapsedTime);
     if (_scriptTarget)
         _scriptTarget->fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(GameScriptTarget, update), elapsedTime);
     _socialController->update(elapsedTime);
     _storeController->update(elapsedTime);
+    if (_resourceLoader)
+        _resourceLoader->update(elapsedTime);
 }
 
 void Game::setViewport(const Rectangle& viewport)
@@ -808,50 +892,27 @@ void Game::getArguments(int* argc, char*** argv) const
     Platform::getArguments(argc, argv);
 }
 
-void Game::schedule(float timeOffset, TimeListener* timeListener, void* cookie)
+unsigned int Game::schedule(float timeOffset, TimeListener* timeListener, void* cookie)
 {
-    GP_ASSERT(_timeEvents);
-    TimeEvent timeEvent(getGameTime() + timeOffset, timeListener, cookie);
-    _timeEvents->push(timeEvent);
+    GP_ASSERT(_timeScheduler);
+    return _timeScheduler->schedule(timeOffset, timeListener, cookie);
 }
 
-void Game::schedule(float timeOffset, const char* function)
+unsigned int Game::schedule(float timeOffset, const char* function)
 {
-    getScriptController()->schedule(timeOffset, function);
+    return getScriptController()->schedule(timeOffset, function);
 }
 
-void Game::clearSchedule()
-{
-    SAFE_DELETE(_timeEvents);
-    _timeEvents = new std::priority_queue<TimeEvent, std::vector<TimeEvent>, std::less<TimeEvent> >();
-}
-
-void Game::fireTimeEvents(double frameTime)
-{
-    while (_timeEvents->size() > 0)
-    {
-        const TimeEvent* timeEvent = &_timeEvents->top();
-        if (timeEvent->time > frameTime)
-        {
-            break;
-        }
-        if (timeEvent->listener)
-        {
-            timeEvent->listener->timeEvent(frameTime - timeEvent->time, timeEvent->cookie);
-        }
-        _timeEvents->pop();
-    }
-}
-
-Game::TimeEvent::TimeEvent(double time, TimeListener* timeListener, void* cookie)
-    : time(time), listener(timeListener), cookie(cookie)
+bool Game::cancelSchedule(unsigned int handle)
 {
+    GP_ASSERT(_timeScheduler);
+    return _timeScheduler->cancel(handle);
 }
 
-bool Game::TimeEvent::operator<(const TimeEvent& v) const
+void Game::clearSchedule()
 {
-    // The first element of std::priority_queue is the greatest.
-    return time > v.time;
+    GP_ASSERT(_timeScheduler);
+    _timeScheduler->clear();
 }
 
 Properties* Game::getConfig() const
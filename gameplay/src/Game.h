@@ -22,10 +22,12 @@
 #include "SocialController.h"
 #include "storefront/StoreController.h"
 #include "AIController.h"
+#include "ResourceLoader.h"
+#include "JobScheduler.h"
 #include "AudioListener.h"
 #include "Rectangle.h"
 #include "Vector4.h"
-#include "TimeListener.h"
+#include "TimeScheduler.h"
 
 namespace gameplay
 {
@@ -310,6 +312,33 @@ public:
      */
     inline StoreController* getStoreController() const;
 
+    /**
+     * Gets the resource loader for loading game resources in the background.
+     *
+     * @return The resource loader for this game.
+     *
+     * @script{ignore}
+     */
+    inline ResourceLoader* getResourceLoader() const;
+
+    /**
+     * Gets the job scheduler for running work across multiple cores.
+     *
+     * @return The job scheduler for this game.
+     *
+     * @script{ignore}
+     */
+    inline JobScheduler* getJobScheduler() const;
+
+    /**
+     * Gets the scheduler that fires the time events of schedule().
+     *
+     * @return The time scheduler for this game.
+     *
+     * @script{ignore}
+     */
+    inline TimeScheduler* getTimeScheduler() const;
+
     /**
      * Gets the audio listener for 3D audio.
      * 
@@ -697,9 +726,11 @@ public:
      * @param timeOffset The number of game seconds in the future to schedule the event to be fired.
      * @param timeListener The TimeListener that will receive the event.
      * @param cookie The cookie data that the time event will contain.
+     *
+     * @return The handle of the event, for cancelSchedule() and the TimeScheduler.
      * @script{ignore}
      */
-    void schedule(float timeOffset, TimeListener* timeListener, void* cookie = 0);
+    unsigned int schedule(float timeOffset, TimeListener* timeListener, void* cookie = 0);
 
     /**
      * Schedules a time event to be sent to the given TimeListener a given number of game seconds from now.
@@ -711,8 +742,19 @@ public:
      * 
      * @param timeOffset The number of game seconds in the future to schedule the event to be fired.
      * @param function The script function that will receive the event.
+     *
+     * @return The handle of the event, or zero if the function could not be found.
      */
-    void schedule(float timeOffset, const char* function);
+    unsigned int schedule(float timeOffset, const char* function);
+
+    /**
+     * Cancels a scheduled time event.
+     *
+     * @param handle The handle returned by schedule().
+     *
+     * @return True if the event was cancelled, false if it has already fired.
+     */
+    bool cancelSchedule(unsigned int handle);
 
     /**
      * Clears all scheduled time events.
@@ -828,20 +870,6 @@ private:
         void timeEvent(long timeDiff, void* cookie);
     };
 
-    /**
-     * TimeEvent represents the event that is sent to TimeListeners as a result of calling Game::schedule().
-     */
-    class TimeEvent
-    {
-    public:
-
-        TimeEvent(double time, TimeListener* timeListener, void* cookie);
-        bool operator<(const TimeEvent& v) const;
-        double time;
-        TimeListener* listener;
-        void* cookie;
-    };
-
     /**
      * Constructor.
      *
@@ -860,11 +888,12 @@ private:
     void shutdown();
 
     /**
-     * Fires the time events that were scheduled to be called.
-     * 
-     * @param frameTime The current game frame time. Used to determine which time events need to be fired.
+     * Updates the animation, physics and AI controllers, as dependent jobs if
+     * parallel controller updates are enabled in the game configuration.
+     *
+     * @param elapsedTime The elapsed game time.
      */
-    void fireTimeEvents(double frameTime);
+    void updateControllers(float elapsedTime);
 
     /**
      * Loads the game configuration.
@@ -911,11 +940,14 @@ private:
     PhysicsController* _physicsController;      // Controls the simulation of a physics scene and entities.
     AIController* _aiController;                // Controls AI simulation.
     AudioListener* _audioListener;              // The audio listener in 3D space.
-    std::priority_queue<TimeEvent, std::vector<TimeEvent>, std::less<TimeEvent> >* _timeEvents;     // Contains the scheduled time events.
+    TimeScheduler* _timeScheduler;              // Fires the scheduled time events.
     ScriptController* _scriptController;            // Controls the scripting engine.
     ScriptTarget* _scriptTarget;                // Script target for the game
     SocialController* _socialController;		// Controls social aspect of the game.
     StoreController* _storeController;          // Controls storefront and IAPs.
+    ResourceLoader* _resourceLoader;            // Loads game resources in the background.
+    JobScheduler* _jobScheduler;                // Runs jobs across multiple cores.
+    bool _parallelControllers;                  // If the controllers are updated as jobs.
 
     // Note: Do not add STL object member variables on the stack; this will cause false memory leaks to be reported.
 
@@ -73,6 +73,21 @@ inline StoreController* Game::getStoreController() const
     return _storeController;
 }
 
+inline ResourceLoader* Game::getResourceLoader() const
+{
+    return _resourceLoader;
+}
+
+inline JobScheduler* Game::getJobScheduler() const
+{
+    return _jobScheduler;
+}
+
+inline TimeScheduler* Game::getTimeScheduler() const
+{
+    return _timeScheduler;
+}
+
 template <class T>
 void Game::renderOnce(T* instance, void (T::*method)(void*), void* cookie)
 {
@@ -0,0 +1,477 @@
+#include "Base.h"
+#include "GlyphAtlas.h"
+#include "Game.h"
+#include "FileSystem.h"
+
+#ifdef GP_USE_FREETYPE
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#endif
+
+// Empty texels kept to the right of and below every cell, as in the encoder.
+#define GLYPH_ATLAS_PADDING 2
+
+// Distance fields map one pixel of distance to this many levels around the
+// edge value, as in the encoder.
+#define GLYPH_ATLAS_DISTANCE_SCALE 16.0f
+
+// The characters whose extents decide the character size that fits a cell,
+// matching the encoder's default character set.
+#define GLYPH_RASTERIZER_FIT_START 32
+#define GLYPH_RASTERIZER_FIT_END 127
+
+namespace gameplay
+{
+
+GlyphRasterizer::GlyphRasterizer()
+{
+}
+
+GlyphRasterizer::~GlyphRasterizer()
+{
+}
+
+#ifdef GP_USE_FREETYPE
+
+/**
+ * Rasterizes TrueType fonts with FreeType, fitting the character size to the
+ * cell the same way the encoder does.
+ */
+class FreeTypeRasterizer : public GlyphRasterizer
+{
+public:
+
+    FreeTypeRasterizer()
+        : _library(NULL), _face(NULL), _data(NULL), _size(0), _maxTop(0)
+    {
+    }
+
+    ~FreeTypeRasterizer()
+    {
+        if (_face)
+            FT_Done_Face(_face);
+        if (_library)
+            FT_Done_FreeType(_library);
+        SAFE_DELETE_ARRAY(_data);
+    }
+
+    bool load(const char* path)
+    {
+        int size = 0;
+        _data = FileSystem::readAll(path, &size);
+        if (_data == NULL)
+        {
+            GP_WARN("Failed to read font file '%s'.", path);
+            return false;
+        }
+
+        if (FT_Init_FreeType(&_library) != 0 || FT_New_Memory_Face(_library, (const FT_Byte*)_data, size, 0, &_face) != 0)
+        {
+            GP_WARN("Failed to load font face from '%s'.", path);
+            return false;
+        }
+        return true;
+    }
+
+    bool rasterize(unsigned int code, unsigned int size, Font::Glyph* glyph, std::vector<unsigned char>* pixels)
+    {
+        GP_ASSERT(glyph);
+        GP_ASSERT(pixels);
+
+        if (size != _size && !fitSize(size))
+            return false;
+
+        FT_UInt charIndex = FT_Get_Char_Index(_face, code);
+        if (charIndex == 0 || FT_Load_Glyph(_face, charIndex, FT_LOAD_RENDER) != 0)
+            return false;
+
+        FT_GlyphSlot slot = _face->glyph;
+        const FT_Bitmap& bitmap = slot->bitmap;
+        glyph->width = bitmap.width;
+        glyph->bearingX = slot->metrics.horiBearingX >> 6;
+        glyph->advance = slot->metrics.horiAdvance >> 6;
+
+        // Put the glyph on the baseline shared by all cells of this size.
+        pixels->assign(glyph->width * size, 0);
+        int top = _maxTop - slot->bitmap_top;
+        for (int row = 0; row < (int)bitmap.rows; ++row)
+        {
+            int y = top + row;
+            if (y >= 0 && y < (int)size && glyph->width > 0)
+                memcpy(&(*pixels)[y * glyph->width], bitmap.buffer + row * bitmap.pitch, glyph->width);
+        }
+        return true;
+    }
+
+private:
+
+    /**
+     * Finds the largest character size whose glyphs fit in a cell of the given
+     * height, by trying sizes down from 1.3 times the height like the encoder.
+     */
+    bool fitSize(unsigned int size)
+    {
+        for (unsigned int requestedSize = (unsigned int)(size * 1.3f); requestedSize > 0; --requestedSize)
+        {
+            if (FT_Set_Char_Size(_face, 0, requestedSize * 64, 0, 0) != 0)
+                break;
+
+            int maxTop = 0;
+            int minBottom = 0;
+            for (unsigned int c = GLYPH_RASTERIZER_FIT_START; c < GLYPH_RASTERIZER_FIT_END; ++c)
+            {
+                FT_UInt charIndex = FT_Get_Char_Index(_face, c);
+                if (charIndex == 0 || FT_Load_Glyph(_face, charIndex, FT_LOAD_RENDER) != 0)
+                    continue;
+
+                int top = _face->glyph->bitmap_top;
+                int bottom = top - (int)_face->glyph->bitmap.rows;
+                maxTop = std::max(maxTop, top);
+                minBottom = std::min(minBottom, bottom);
+            }
+
+            if (maxTop - minBottom <= (int)size)
+            {
+                _size = size;
+                _maxTop = maxTop;
+                return true;
+            }
+        }
+
+        GP_WARN("Failed to fit font face into glyphs of size %u.", size);
+        return false;
+    }
+
+    FT_Library _library;
+    FT_Face _face;
+    char* _data;
+    unsigned int _size;
+    int _maxTop;
+};
+
+#endif
+
+GlyphRasterizer* GlyphRasterizer::create(const char* path)
+{
+    GP_ASSERT(path);
+
+#ifdef GP_USE_FREETYPE
+    FreeTypeRasterizer* rasterizer = new FreeTypeRasterizer();
+    if (!rasterizer->load(path))
+    {
+        SAFE_RELEASE(rasterizer);
+        return NULL;
+    }
+    return rasterizer;
+#else
+    GP_WARN("Failed to create rasterizer for font '%s'; TrueType fonts require a build with GP_USE_FREETYPE.", path);
+    return NULL;
+#endif
+}
+
+/**
+ * Computes the distance from every texel of a cell to the nearest texel that
+ * is on the given side of the glyph edge, by propagating the nearest texels
+ * in a forward and a backward pass (dead reckoning).
+ */
+static void computeDistances(const unsigned char* cell, int width, int height, bool inside, float* distances, std::vector<int>& nearest)
+{
+    const int count = width * height;
+    nearest.assign(count, -1);
+    for (int i = 0; i < count; ++i)
+    {
+        if ((cell[i] >= 128) == inside)
+        {
+            distances[i] = 0.0f;
+            nearest[i] = i;
+        }
+        else
+        {
+            distances[i] = (float)(width + height);
+        }
+    }
+
+    static const int forward[4][2] = { { -1, -1 }, { 0, -1 }, { 1, -1 }, { -1, 0 } };
+    static const int backward[4][2] = { { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 } };
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        const int (*offsets)[2] = pass == 0 ? forward : backward;
+        for (int j = 0; j < count; ++j)
+        {
+            int i = pass == 0 ? j : count - 1 - j;
+            int x = i % width;
+            int y = i / width;
+            for (int k = 0; k < 4; ++k)
+            {
+                int nx = x + offsets[k][0];
+                int ny = y + offsets[k][1];
+                if (nx < 0 || nx >= width || ny < 0 || ny >= height)
+                    continue;
+
+                int candidate = nearest[nx + ny * width];
+                if (candidate < 0)
+                    continue;
+
+                float dx = (float)(x - candidate % width);
+                float dy = (float)(y - candidate / width);
+                float distance = sqrtf(dx * dx + dy * dy);
+                if (distance < distances[i])
+                {
+                    distances[i] = distance;
+                    nearest[i] = candidate;
+                }
+            }
+        }
+    }
+}
+
+// Bumped by every atlas whenever glyphs are evicted or skipped.
+static unsigned int __changeCount = 0;
+
+GlyphAtlas::GlyphAtlas(Font* font, GlyphRasterizer* rasterizer, Texture* texture, unsigned int size)
+    : _font(font), _rasterizer(rasterizer), _texture(texture), _size(size), _rowHeight(size + GLYPH_ATLAS_PADDING),
+      _frame(-1.0), _version(0), _skipped(false), _occupiedPixels(0)
+{
+    GP_ASSERT(font);
+    GP_ASSERT(rasterizer);
+    GP_ASSERT(texture);
+
+    _rasterizer->addRef();
+
+    Row row = { 0, -1.0, std::vector<int>() };
+    _rows.resize(_texture->getHeight() / _rowHeight, row);
+
+    // Every cell is at least as wide as the padding.
+    const unsigned int capacity = getGlyphCapacity();
+    _glyphRows.resize(capacity, -1);
+    _freeGlyphs.reserve(capacity);
+    for (unsigned int i = capacity; i-- > 0;)
+    {
+        _freeGlyphs.push_back((int)i);
+    }
+
+    resetStatistics();
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    SAFE_RELEASE(_rasterizer);
+}
+
+Texture* GlyphAtlas::getTexture() const
+{
+    return _texture;
+}
+
+unsigned int GlyphAtlas::getGlyphCount() const
+{
+    return getGlyphCapacity() - (unsigned int)_freeGlyphs.size();
+}
+
+unsigned int GlyphAtlas::getRowCount() const
+{
+    return (unsigned int)_rows.size();
+}
+
+unsigned int GlyphAtlas::getUsedRowCount() const
+{
+    unsigned int count = 0;
+    for (size_t i = 0, rowCount = _rows.size(); i < rowCount; ++i)
+    {
+        if (_rows[i].width > 0)
+            ++count;
+    }
+    return count;
+}
+
+float GlyphAtlas::getOccupancy() const
+{
+    return (float)_occupiedPixels / (float)(_texture->getWidth() * _texture->getHeight());
+}
+
+const GlyphAtlas::Statistics& GlyphAtlas::getStatistics() const
+{
+    return _statistics;
+}
+
+void GlyphAtlas::resetStatistics()
+{
+    _statistics.rasterizations = 0;
+    _statistics.uploads = 0;
+    _statistics.uploadedBytes = 0;
+    _statistics.evictions = 0;
+    _statistics.misses = 0;
+}
+
+unsigned int GlyphAtlas::getGlyphCapacity() const
+{
+    return (unsigned int)_rows.size() * (_texture->getWidth() / GLYPH_ATLAS_PADDING);
+}
+
+int GlyphAtlas::addGlyph(unsigned int code)
+{
+    GP_PROFILE_SCOPE("GlyphAtlas::addGlyph");
+
+    updateFrame();
+    if (_missingCodes.find(code) != _missingCodes.end())
+        return -1;
+
+    Font::Glyph glyph;
+    memset(&glyph, 0, sizeof(glyph));
+    glyph.code = code;
+    _pixels.clear();
+    if (!_rasterizer->rasterize(code, _size, &glyph, &_pixels))
+    {
+        _missingCodes.insert(code);
+        return -1;
+    }
+    GP_ASSERT(_pixels.size() == glyph.width * _size);
+    ++_statistics.rasterizations;
+
+    const unsigned int cellWidth = glyph.width + GLYPH_ATLAS_PADDING;
+    const unsigned int textureWidth = _texture->getWidth();
+    if (cellWidth > textureWidth)
+    {
+        GP_WARN("Glyph %u is wider than the font atlas.", code);
+        _missingCodes.insert(code);
+        return -1;
+    }
+
+    int row = findRow(cellWidth);
+    if (row < 0)
+    {
+        // Layouts made without the glyph are dropped in the next frame, when it may fit.
+        ++_statistics.misses;
+        _skipped = true;
+        ++__changeCount;
+        return -1;
+    }
+
+    // Copy the glyph into a cell cleared around it, so that the padding
+    // overwrites whatever an evicted glyph left there.
+    _cell.assign(cellWidth * _rowHeight, 0);
+    for (unsigned int y = 0; y < _size && glyph.width > 0; ++y)
+    {
+        memcpy(&_cell[y * cellWidth], &_pixels[y * glyph.width], glyph.width);
+    }
+
+    if (_font->getFormat() == Font::DISTANCE_FIELD)
+    {
+        // Bipolar distance field across the cell, with the same scale and bias as the encoder.
+        const int count = (int)_cell.size();
+        _distances.resize(count * 2);
+        computeDistances(&_cell[0], (int)cellWidth, (int)_rowHeight, true, &_distances[0], _nearest);
+        computeDistances(&_cell[0], (int)cellWidth, (int)_rowHeight, false, &_distances[count], _nearest);
+        for (int i = 0; i < count; ++i)
+        {
+            float distance = _cell[i] >= 128 ? _distances[count + i] - 0.5f : 0.5f - _distances[i];
+            _cell[i] = (unsigned char)std::max(0.0f, std::min(255.0f, 127.0f + distance * GLYPH_ATLAS_DISTANCE_SCALE));
+        }
+    }
+
+    Row& r = _rows[row];
+    const unsigned int x = r.width;
+    const unsigned int y = (unsigned int)row * _rowHeight;
+    _texture->setData(&_cell[0], x, y, cellWidth, _rowHeight);
+    ++_statistics.uploads;
+    _statistics.uploadedBytes += (unsigned int)_cell.size();
+
+    const float textureHeight = (float)_texture->getHeight();
+    glyph.uvs[0] = (float)x / (float)textureWidth;
+    glyph.uvs[1] = (float)y / textureHeight;
+    glyph.uvs[2] = (float)(x + glyph.width) / (float)textureWidth;
+    glyph.uvs[3] = (float)(y + _size) / textureHeight;
+
+    GP_ASSERT(!_freeGlyphs.empty());
+    int index = _freeGlyphs.back();
+    _freeGlyphs.pop_back();
+    _font->_glyphs[index] = glyph;
+    _font->setGlyphIndex(code, index);
+    _glyphRows[index] = row;
+
+    r.width += cellWidth;
+    r.lastUsed = _frame;
+    r.glyphs.push_back(index);
+    _occupiedPixels += cellWidth * _rowHeight;
+
+    return index;
+}
+
+void GlyphAtlas::touch(int index)
+{
+    GP_ASSERT(index >= 0 && index < (int)_glyphRows.size());
+
+    int row = _glyphRows[index];
+    if (row >= 0)
+    {
+        updateFrame();
+        _rows[row].lastUsed = _frame;
+    }
+}
+
+unsigned int GlyphAtlas::getChangeCount()
+{
+    return __changeCount;
+}
+
+unsigned int GlyphAtlas::getVersion()
+{
+    updateFrame();
+    return _version;
+}
+
+int GlyphAtlas::findRow(unsigned int width)
+{
+    const unsigned int textureWidth = _texture->getWidth();
+    int leastRecentlyUsed = -1;
+    for (size_t i = 0, count = _rows.size(); i < count; ++i)
+    {
+        const Row& row = _rows[i];
+        if (row.width + width <= textureWidth)
+            return (int)i;
+
+        // Rows used in this frame may still be referenced by queued sprites.
+        if (row.lastUsed != _frame && (leastRecentlyUsed < 0 || row.lastUsed < _rows[leastRecentlyUsed].lastUsed))
+            leastRecentlyUsed = (int)i;
+    }
+
+    if (leastRecentlyUsed >= 0)
+        evictRow(leastRecentlyUsed);
+    return leastRecentlyUsed;
+}
+
+void GlyphAtlas::evictRow(int row)
+{
+    Row& r = _rows[row];
+    for (size_t i = 0, count = r.glyphs.size(); i < count; ++i)
+    {
+        int index = r.glyphs[i];
+        _font->setGlyphIndex(_font->_glyphs[index].code, -1);
+        _glyphRows[index] = -1;
+        _freeGlyphs.push_back(index);
+    }
+    _occupiedPixels -= r.width * _rowHeight;
+    r.glyphs.clear();
+    r.width = 0;
+
+    ++_statistics.evictions;
+    ++_version;
+    ++__changeCount;
+}
+
+void GlyphAtlas::updateFrame()
+{
+    // The absolute time only changes once per frame.
+    double frame = Game::getAbsoluteTime();
+    if (frame != _frame)
+    {
+        _frame = frame;
+        if (_skipped)
+        {
+            _skipped = false;
+            ++_version;
+        }
+    }
+}
+
+}
@@ -0,0 +1,282 @@
+#ifndef GLYPHATLAS_H_
+#define GLYPHATLAS_H_
+
+#include "Font.h"
+
+namespace gameplay
+{
+
+/**
+ * Defines an interface that renders the glyphs of a font at runtime.
+ *
+ * Glyphs are rendered into cells laid out the same way as the atlases written
+ * by the encoder: every cell is as high as the font size, and the baseline
+ * sits at the same height in all cells of a size.
+ *
+ * @see Font::createDynamic
+ * @script{ignore}
+ */
+class GlyphRasterizer : public Ref
+{
+public:
+
+    /**
+     * Creates a rasterizer for a TrueType font file.
+     *
+     * TrueType fonts are only rasterized by builds with GP_USE_FREETYPE defined;
+     * other builds return NULL.
+     *
+     * @param path The path to the font file.
+     *
+     * @return The new rasterizer, or NULL if there was an error.
+     */
+    static GlyphRasterizer* create(const char* path);
+
+    /**
+     * Renders a single glyph.
+     *
+     * @param code The character code of the glyph.
+     * @param size The height of the cell, in pixels.
+     * @param glyph Receives the width, left side bearing and advance of the glyph.
+     *      The code and texture coordinates are filled in by the caller.
+     * @param pixels Receives the coverage of the cell, as width * size bytes,
+     *      starting with the top row.
+     *
+     * @return True if the glyph was rendered, false if the font has no glyph for the character.
+     */
+    virtual bool rasterize(unsigned int code, unsigned int size, Font::Glyph* glyph, std::vector<unsigned char>* pixels) = 0;
+
+protected:
+
+    /**
+     * Constructor.
+     */
+    GlyphRasterizer();
+
+    /**
+     * Destructor.
+     */
+    virtual ~GlyphRasterizer();
+
+private:
+
+    /**
+     * Hidden copy constructor.
+     */
+    GlyphRasterizer(const GlyphRasterizer& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    GlyphRasterizer& operator=(const GlyphRasterizer&);
+};
+
+/**
+ * Defines the texture atlas of a dynamic font.
+ *
+ * Glyphs are rasterized the first time they are looked up and packed into
+ * rows of the atlas texture, one cell upload per glyph. All rows have the
+ * height of a cell, so any glyph fits any row and a row is the unit of
+ * eviction: when no row has room for a new glyph, the least recently used
+ * row is emptied and its glyphs are rasterized again when next needed.
+ *
+ * Rows holding glyphs used during the current frame are never evicted, since
+ * queued sprites may still sample them. If every row is in use the glyph is
+ * skipped for the frame and the miss is counted; a larger atlas fixes that.
+ *
+ * Since the atlas is a single texture, a dynamic font still draws all of its
+ * text in one sprite batch.
+ *
+ * @script{ignore}
+ */
+class GlyphAtlas
+{
+    friend class Font;
+
+public:
+
+    /**
+     * Counters of the work done by the atlas.
+     */
+    struct Statistics
+    {
+        /**
+         * The number of glyphs rasterized.
+         */
+        unsigned int rasterizations;
+
+        /**
+         * The number of texture uploads.
+         */
+        unsigned int uploads;
+
+        /**
+         * The number of bytes uploaded to the texture.
+         */
+        unsigned int uploadedBytes;
+
+        /**
+         * The number of rows evicted.
+         */
+        unsigned int evictions;
+
+        /**
+         * The number of glyphs skipped because every row was in use.
+         */
+        unsigned int misses;
+    };
+
+    /**
+     * Gets the texture glyphs are rasterized into.
+     *
+     * @return The atlas texture.
+     */
+    Texture* getTexture() const;
+
+    /**
+     * Gets the number of glyphs currently in the atlas.
+     *
+     * @return The number of resident glyphs.
+     */
+    unsigned int getGlyphCount() const;
+
+    /**
+     * Gets the number of rows of the atlas.
+     *
+     * @return The number of rows.
+     */
+    unsigned int getRowCount() const;
+
+    /**
+     * Gets the number of rows holding at least one glyph.
+     *
+     * @return The number of used rows.
+     */
+    unsigned int getUsedRowCount() const;
+
+    /**
+     * Gets the fraction of the atlas texture covered by glyph cells.
+     *
+     * @return The occupancy, between 0 and 1.
+     */
+    float getOccupancy() const;
+
+    /**
+     * Gets the counters accumulated since the atlas was created or since the
+     * last call to resetStatistics().
+     *
+     * @return The statistics.
+     */
+    const Statistics& getStatistics() const;
+
+    /**
+     * Resets all counters to zero.
+     */
+    void resetStatistics();
+
+    /**
+     * Gets a number that changes whenever any atlas evicts glyphs or skips a glyph
+     * that did not fit.
+     *
+     * Geometry built from glyph quads and replayed without going through the font,
+     * such as the cached geometry of form controls, must be rebuilt when it changes.
+     *
+     * @return The change count shared by all atlases.
+     */
+    static unsigned int getChangeCount();
+
+private:
+
+    /**
+     * A row of glyph cells, filled from left to right.
+     */
+    struct Row
+    {
+        unsigned int width;
+        double lastUsed;
+        std::vector<int> glyphs;
+    };
+
+    /**
+     * Constructor.
+     */
+    GlyphAtlas(Font* font, GlyphRasterizer* rasterizer, Texture* texture, unsigned int size);
+
+    /**
+     * Destructor.
+     */
+    ~GlyphAtlas();
+
+    /**
+     * Hidden copy constructor.
+     */
+    GlyphAtlas(const GlyphAtlas& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    GlyphAtlas& operator=(const GlyphAtlas&);
+
+    /**
+     * Gets the largest number of glyphs the atlas can hold at once.
+     */
+    unsigned int getGlyphCapacity() const;
+
+    /**
+     * Rasterizes a glyph, uploads it and registers it with the font.
+     *
+     * @return The index of the new glyph, or -1 if it could not be added.
+     */
+    int addGlyph(unsigned int code);
+
+    /**
+     * Marks the row of a glyph as used during the current frame.
+     */
+    void touch(int index);
+
+    /**
+     * Gets a number that changes whenever glyphs that layouts may refer to are
+     * evicted or were skipped.
+     */
+    unsigned int getVersion();
+
+    /**
+     * Finds a row with room for a cell, evicting the least recently used row if needed.
+     *
+     * @return The row, or -1 if every full row is in use.
+     */
+    int findRow(unsigned int width);
+
+    /**
+     * Removes all glyphs of a row.
+     */
+    void evictRow(int row);
+
+    /**
+     * Starts a new frame if the game time moved on since the last call.
+     */
+    void updateFrame();
+
+    Font* _font;
+    GlyphRasterizer* _rasterizer;
+    Texture* _texture;
+    unsigned int _size;
+    unsigned int _rowHeight;
+    std::vector<Row> _rows;
+    std::vector<int> _glyphRows;            // row of each glyph slot, -1 for free slots
+    std::vector<int> _freeGlyphs;
+    std::set<unsigned int> _missingCodes;   // characters the rasterizer has no glyph for
+    std::vector<unsigned char> _pixels;
+    std::vector<unsigned char> _cell;
+    std::vector<float> _distances;
+    std::vector<int> _nearest;
+    double _frame;
+    unsigned int _version;
+    bool _skipped;
+    unsigned int _occupiedPixels;
+    Statistics _statistics;
+};
+
+}
+
+#endif
@@ -2,19 +2,41 @@
 #include "HeightField.h"
 #include "Image.h"
 #include "FileSystem.h"
+#include "Stream.h"
+
+// Tiled heightfield files, in native byte order:
+//   identifier, version, columns, rows, tile size, level count, lowest height, highest height
+//   lowest and highest height of each tile, as floats
+//   for each level, for each tile in row major order: the tile's samples as 16-bit heights
+// A level N tile holds (ceil(tileSize / 2^N) + 3)^2 samples: the samples of the tile every
+// 2^N samples plus one neighbor on each side. The samples of tiles on the far edges of the
+// heightfield, which are smaller, are padded by repeating their last neighbor.
+#define HEIGHTFIELD_TILES_IDENTIFIER "\xABGPH\xBB\r\n\x1A\n"
+#define HEIGHTFIELD_TILES_IDENTIFIER_SIZE 9
+#define HEIGHTFIELD_TILES_VERSION 1
+#define HEIGHTFIELD_TILES_HEADER_WORDS 7
 
 namespace gameplay
 {
 
 HeightField::HeightField(unsigned int columns, unsigned int rows)
-    : _array(NULL), _cols(columns), _rows(rows)
+    : _array(NULL), _cols(columns), _rows(rows), _tiles(NULL), _tilesSize(0), _tileSize(0), _tileLevelCount(0),
+      _tileColumns(0), _tileRows(0), _tileHeightMin(0), _tileHeightScale(0), _tileBounds(NULL)
 {
     _array = new float[columns * rows];
 }
 
+HeightField::HeightField()
+    : _array(NULL), _cols(0), _rows(0), _tiles(NULL), _tilesSize(0), _tileSize(0), _tileLevelCount(0),
+      _tileColumns(0), _tileRows(0), _tileHeightMin(0), _tileHeightScale(0), _tileBounds(NULL)
+{
+}
+
 HeightField::~HeightField()
 {
     SAFE_DELETE_ARRAY(_array);
+    if (_tiles)
+        FileSystem::unmapFile(_tiles, _tilesSize);
 }
 
 HeightField* HeightField::create(unsigned int columns, unsigned int rows)
@@ -159,11 +181,276 @@ HeightField* HeightField::create(const char* path, unsigned int width, unsigned
     return heightfield;
 }
 
+HeightField* HeightField::createFromTiles(const char* path)
+{
+    GP_ASSERT(path);
+
+    size_t size = 0;
+    const char* data = FileSystem::mapFile(path, &size);
+    if (!data)
+    {
+        GP_WARN("Failed to map tiled heightfield file: %s.", path);
+        return NULL;
+    }
+
+    const size_t headerSize = 12 + HEIGHTFIELD_TILES_HEADER_WORDS * sizeof(unsigned int);
+    unsigned int header[HEIGHTFIELD_TILES_HEADER_WORDS - 2];
+    float heightRange[2];
+    if (size < headerSize || memcmp(data, HEIGHTFIELD_TILES_IDENTIFIER, HEIGHTFIELD_TILES_IDENTIFIER_SIZE) != 0)
+    {
+        GP_WARN("Invalid tiled heightfield file: %s.", path);
+        FileSystem::unmapFile(data, size);
+        return NULL;
+    }
+    memcpy(header, data + 12, sizeof(header));
+    memcpy(heightRange, data + 12 + sizeof(header), sizeof(heightRange));
+    if (header[0] != HEIGHTFIELD_TILES_VERSION || header[1] < 2 || header[2] < 2 || header[3] == 0 || header[4] == 0 || header[4] > 16)
+    {
+        GP_WARN("Unsupported tiled heightfield file: %s.", path);
+        FileSystem::unmapFile(data, size);
+        return NULL;
+    }
+
+    HeightField* heightfield = new HeightField();
+    heightfield->_cols = header[1];
+    heightfield->_rows = header[2];
+    heightfield->_tileSize = header[3];
+    heightfield->_tileLevelCount = header[4];
+    heightfield->_tileColumns = (heightfield->_cols - 2) / heightfield->_tileSize + 1;
+    heightfield->_tileRows = (heightfield->_rows - 2) / heightfield->_tileSize + 1;
+    heightfield->_tileHeightMin = heightRange[0];
+    heightfield->_tileHeightScale = (heightRange[1] - heightRange[0]) / 65535.0f;
+
+    // Locate the levels and check that the file holds all of them.
+    size_t tileCount = (size_t)heightfield->_tileColumns * heightfield->_tileRows;
+    size_t offset = headerSize + tileCount * 2 * sizeof(float);
+    for (unsigned int level = 0; level < heightfield->_tileLevelCount; ++level)
+    {
+        size_t side = getSampleCount(0, heightfield->_tileSize, 1 << level) + 3;
+        heightfield->_tileLevels.push_back(offset);
+        offset += tileCount * side * side * sizeof(unsigned short);
+    }
+    if (offset > size)
+    {
+        GP_WARN("Truncated tiled heightfield file: %s.", path);
+        FileSystem::unmapFile(data, size);
+        SAFE_RELEASE(heightfield);
+        return NULL;
+    }
+
+    heightfield->_tiles = data;
+    heightfield->_tilesSize = size;
+    heightfield->_tileBounds = (const float*)(data + headerSize);
+
+    return heightfield;
+}
+
+bool HeightField::writeTiles(Stream* stream, unsigned int tileSize, unsigned int levelCount) const
+{
+    GP_ASSERT(stream);
+    GP_ASSERT(tileSize > 0);
+    GP_ASSERT(levelCount > 0 && levelCount <= 16);
+
+    if (!_array)
+    {
+        GP_WARN("Only heightfields with a height array can be written to tiled heightfield files.");
+        return false;
+    }
+
+    float heightMin = FLT_MAX, heightMax = -FLT_MAX;
+    for (unsigned int i = 0, count = _cols * _rows; i < count; ++i)
+    {
+        heightMin = std::min(heightMin, _array[i]);
+        heightMax = std::max(heightMax, _array[i]);
+    }
+    float heightScale = heightMax > heightMin ? 65535.0f / (heightMax - heightMin) : 0.0f;
+
+    unsigned int tileColumns = (_cols - 2) / tileSize + 1;
+    unsigned int tileRows = (_rows - 2) / tileSize + 1;
+
+    // Tile bounds.
+    std::vector<float> bounds;
+    bounds.reserve(tileColumns * tileRows * 2);
+    for (unsigned int tileRow = 0; tileRow < tileRows; ++tileRow)
+    {
+        unsigned int z1 = tileRow * tileSize;
+        unsigned int z2 = std::min(z1 + tileSize, _rows - 1);
+        for (unsigned int tileColumn = 0; tileColumn < tileColumns; ++tileColumn)
+        {
+            unsigned int x1 = tileColumn * tileSize;
+            unsigned int x2 = std::min(x1 + tileSize, _cols - 1);
+            float minHeight = FLT_MAX, maxHeight = -FLT_MAX;
+            for (unsigned int z = z1; z <= z2; ++z)
+            {
+                for (unsigned int x = x1; x <= x2; ++x)
+                {
+                    minHeight = std::min(minHeight, _array[z * _cols + x]);
+                    maxHeight = std::max(maxHeight, _array[z * _cols + x]);
+                }
+            }
+            bounds.push_back(minHeight);
+            bounds.push_back(maxHeight);
+        }
+    }
+
+    unsigned int header[HEIGHTFIELD_TILES_HEADER_WORDS - 2] = { HEIGHTFIELD_TILES_VERSION, _cols, _rows, tileSize, levelCount };
+    float heightRange[2] = { heightMin, heightMax };
+
+    // The identifier is padded so that the words that follow are aligned.
+    char identifier[12] = { 0 };
+    memcpy(identifier, HEIGHTFIELD_TILES_IDENTIFIER, HEIGHTFIELD_TILES_IDENTIFIER_SIZE);
+    bool result = stream->write(identifier, 1, sizeof(identifier)) == sizeof(identifier) &&
+        stream->write(header, sizeof(unsigned int), HEIGHTFIELD_TILES_HEADER_WORDS - 2) == HEIGHTFIELD_TILES_HEADER_WORDS - 2 &&
+        stream->write(heightRange, sizeof(float), 2) == 2 &&
+        stream->write(&bounds[0], sizeof(float), bounds.size()) == bounds.size();
+
+    // Tile samples, one level at a time.
+    std::vector<unsigned int> columns;
+    std::vector<unsigned int> rows;
+    std::vector<unsigned short> samples;
+    for (unsigned int level = 0; result && level < levelCount; ++level)
+    {
+        unsigned int step = 1 << level;
+        unsigned int side = getSampleCount(0, tileSize, step) + 3;
+        columns.resize(side);
+        rows.resize(side);
+        samples.resize(side * side);
+        for (unsigned int tileRow = 0; result && tileRow < tileRows; ++tileRow)
+        {
+            unsigned int z1 = tileRow * tileSize;
+            unsigned int z2 = std::min(z1 + tileSize, _rows - 1);
+            int lastRow = (int)getSampleCount(z1, z2, step) + 1;
+            for (unsigned int i = 0; i < side; ++i)
+                rows[i] = getSampleCoord(z1, z2, _rows, step, std::min((int)i - 1, lastRow));
+
+            for (unsigned int tileColumn = 0; result && tileColumn < tileColumns; ++tileColumn)
+            {
+                unsigned int x1 = tileColumn * tileSize;
+                unsigned int x2 = std::min(x1 + tileSize, _cols - 1);
+                int lastColumn = (int)getSampleCount(x1, x2, step) + 1;
+                for (unsigned int i = 0; i < side; ++i)
+                    columns[i] = getSampleCoord(x1, x2, _cols, step, std::min((int)i - 1, lastColumn));
+
+                for (unsigned int z = 0, i = 0; z < side; ++z)
+                {
+                    for (unsigned int x = 0; x < side; ++x, ++i)
+                        samples[i] = (unsigned short)((_array[rows[z] * _cols + columns[x]] - heightMin) * heightScale + 0.5f);
+                }
+                result = stream->write(&samples[0], sizeof(unsigned short), samples.size()) == samples.size();
+            }
+        }
+    }
+
+    if (!result)
+        GP_WARN("Failed to write tiled heightfield.");
+    return result;
+}
+
 float* HeightField::getArray() const
 {
     return _array;
 }
 
+bool HeightField::isTiled() const
+{
+    return _tiles != NULL;
+}
+
+unsigned int HeightField::getTileSize() const
+{
+    return _tileSize;
+}
+
+unsigned int HeightField::getTileLevelCount() const
+{
+    return _tileLevelCount;
+}
+
+float HeightField::getSample(unsigned int column, unsigned int row) const
+{
+    if (_array)
+        return _array[column + row * _cols];
+
+    // Level 0 of the tile holding the sample, which holds every sample of the tile.
+    unsigned int tileColumn = std::min(column / _tileSize, _tileColumns - 1);
+    unsigned int tileRow = std::min(row / _tileSize, _tileRows - 1);
+    unsigned int side = _tileSize + 3;
+    const unsigned short* samples = (const unsigned short*)(_tiles + _tileLevels[0]) +
+        ((size_t)tileRow * _tileColumns + tileColumn) * side * side;
+    unsigned int x = column - tileColumn * _tileSize + 1;
+    unsigned int z = row - tileRow * _tileSize + 1;
+    return _tileHeightMin + samples[z * side + x] * _tileHeightScale;
+}
+
+unsigned int HeightField::getSampleCount(unsigned int first, unsigned int last, unsigned int step)
+{
+    return (last - first + step - 1) / step;
+}
+
+unsigned int HeightField::getSampleCoord(unsigned int first, unsigned int last, unsigned int size, unsigned int step, int i)
+{
+    if (i < 0)
+        return first >= step ? first - step : first;
+
+    unsigned int count = getSampleCount(first, last, step);
+    if ((unsigned int)i <= count)
+        return std::min(first + i * step, last);
+
+    return last + step < size ? last + step : last;
+}
+
+void HeightField::getSamples(unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2, unsigned int step,
+                             float* heights, unsigned int* columns, unsigned int* rows) const
+{
+    GP_ASSERT(heights);
+    GP_ASSERT(columns);
+    GP_ASSERT(rows);
+
+    unsigned int columnCount = getSampleCount(x1, x2, step) + 3;
+    unsigned int rowCount = getSampleCount(z1, z2, step) + 3;
+    for (unsigned int i = 0; i < columnCount; ++i)
+        columns[i] = getSampleCoord(x1, x2, _cols, step, (int)i - 1);
+    for (unsigned int i = 0; i < rowCount; ++i)
+        rows[i] = getSampleCoord(z1, z2, _rows, step, (int)i - 1);
+
+    if (_array)
+    {
+        for (unsigned int z = 0; z < rowCount; ++z)
+        {
+            for (unsigned int x = 0; x < columnCount; ++x)
+                *heights++ = _array[rows[z] * _cols + columns[x]];
+        }
+        return;
+    }
+
+    // Find the level and tile.
+    unsigned int level = 0;
+    while ((1u << level) < step)
+        ++level;
+    GP_ASSERT((1u << level) == step && level < _tileLevelCount);
+    GP_ASSERT(x1 % _tileSize == 0 && z1 % _tileSize == 0);
+    unsigned int side = getSampleCount(0, _tileSize, step) + 3;
+    const unsigned short* samples = (const unsigned short*)(_tiles + _tileLevels[level]) +
+        ((size_t)(z1 / _tileSize) * _tileColumns + x1 / _tileSize) * side * side;
+
+    for (unsigned int z = 0; z < rowCount; ++z)
+    {
+        const unsigned short* row = samples + z * side;
+        for (unsigned int x = 0; x < columnCount; ++x)
+            *heights++ = _tileHeightMin + row[x] * _tileHeightScale;
+    }
+}
+
+void HeightField::getTileBounds(unsigned int tileRow, unsigned int tileColumn, float* minHeight, float* maxHeight) const
+{
+    GP_ASSERT(_tileBounds);
+    GP_ASSERT(tileRow < _tileRows && tileColumn < _tileColumns);
+
+    const float* bounds = _tileBounds + ((size_t)tileRow * _tileColumns + tileColumn) * 2;
+    *minHeight = bounds[0];
+    *maxHeight = bounds[1];
+}
+
 float HeightField::getHeight(float column, float row) const
 {
     // Clamp to heightfield boundaries
@@ -182,15 +469,15 @@ float HeightField::getHeight(float column, float row) const
 
     if (x2 >= _cols && y2 >= _rows)
     {
-        return _array[x1 + y1 * _cols];
+        return getSample(x1, y1);
     }
     else if (x2 >= _cols)
     {
-        return _array[x1 + y1 * _cols] * yFactorI + _array[x1 + y2 * _cols] * yFactor;
+        return getSample(x1, y1) * yFactorI + getSample(x1, y2) * yFactor;
     }
     else if (y2 >= _rows)
     {
-        return _array[x1 + y1 * _cols] * xFactorI + _array[x2 + y1 * _cols] * xFactor;
+        return getSample(x1, y1) * xFactorI + getSample(x2, y1) * xFactor;
     }
     else
     {
@@ -198,8 +485,8 @@ float HeightField::getHeight(float column, float row) const
         float b = xFactorI * yFactor;
         float c = xFactor * yFactor;
         float d = xFactor * yFactorI;
-        return _array[x1 + y1 * _cols] * a + _array[x1 + y2 * _cols] * b +
-            _array[x2 + y2 * _cols] * c + _array[x2 + y1 * _cols] * d;
+        return getSample(x1, y1) * a + getSample(x1, y2) * b +
+            getSample(x2, y2) * c + getSample(x2, y1) * d;
     }
 }
 
@@ -6,15 +6,26 @@
 namespace gameplay
 {
 
+    class Stream;
+
     /**
      * Defines height data used to store values representing elevation.
      *
      * Heightfields can be used to construct both Terrain objects as well as PhysicsCollisionShape
      * heightfield defintions, which are used in heightfield rigid body creation. Heightfields can
      * be populated manually, or loaded from images and RAW files.
+     *
+     * Large heightfields can be stored in a tiled heightfield file (.gph), which is written with
+     * writeTiles() and loaded with createFromTiles(). The file splits the heightfield into square
+     * tiles and stores each tile at a number of detail levels, each level using every second
+     * sample of the level above it. A tiled heightfield is memory-mapped instead of read into
+     * memory, so only the tiles that are accessed are paged in. Terrains created from a tiled
+     * heightfield use its tiles as patches and stream their geometry.
      */
     class HeightField : public Ref
     {
+        friend class TerrainPatch;
+
     public:
 
         /**
@@ -72,16 +83,72 @@ namespace gameplay
          */
         static HeightField* createFromRAW(const char* path, unsigned int width, unsigned int height, float heightMin = 0, float heightMax = 1);
 
+        /**
+         * Creates a HeightField from the specified tiled heightfield file.
+         *
+         * The file is memory-mapped and stays mapped until the HeightField is destroyed. Heights
+         * are stored with 16 bits of precision between the lowest and highest height of the
+         * heightfield the file was written from.
+         *
+         * @param path Path to the tiled heightfield file (.gph).
+         *
+         * @return The new HeightField, or NULL if the file could not be mapped or is invalid.
+         * @script{ignore}
+         */
+        static HeightField* createFromTiles(const char* path);
+
+        /**
+         * Writes this heightfield to a tiled heightfield file.
+         *
+         * Tiles span tileSize quads along each axis, so a heightfield with C columns and R rows
+         * is split into ceil((C - 1) / tileSize) by ceil((R - 1) / tileSize) tiles, matching the
+         * patches of a Terrain with a patch size of tileSize. Level N of each tile holds every
+         * 2^N-th sample of the tile.
+         *
+         * @param stream The stream to write the file to.
+         * @param tileSize The number of quads that a tile spans along each axis.
+         * @param levelCount The number of detail levels to store for each tile.
+         *
+         * @return True if the file was written, false if this heightfield is itself tiled or
+         *      the stream could not be written.
+         * @script{ignore}
+         */
+        bool writeTiles(Stream* stream, unsigned int tileSize, unsigned int levelCount) const;
+
         /**
          * Returns a pointer to the underlying height array.
          *
          * The array is packed in row major order, meaning that the data is aligned in rows,
          * from top left to bottom right.
          *
-         * @return The underlying height array.
+         * @return The underlying height array, or NULL for a tiled heightfield.
          */
         float* getArray() const;
 
+        /**
+         * Determines if this heightfield was loaded from a tiled heightfield file.
+         *
+         * @return True if the heightfield is tiled, false if it has a height array.
+         * @script{ignore}
+         */
+        bool isTiled() const;
+
+        /**
+         * Returns the number of quads that a tile of a tiled heightfield spans along each axis.
+         *
+         * @return The tile size, or zero if the heightfield is not tiled.
+         * @script{ignore}
+         */
+        unsigned int getTileSize() const;
+
+        /**
+         * Returns the number of detail levels stored for each tile of a tiled heightfield.
+         *
+         * @return The number of detail levels, or zero if the heightfield is not tiled.
+         * @script{ignore}
+         */
+        unsigned int getTileLevelCount() const;
+
         /**
          * Returns the height at the specified row and column.
          *
@@ -120,6 +187,11 @@ namespace gameplay
          */
         HeightField(unsigned int columns, unsigned int rows);
 
+        /**
+         * Hidden constructor for a tiled heightfield.
+         */
+        HeightField();
+
         /**
          * Hidden destructor (use Ref::release()).
          */
@@ -130,9 +202,55 @@ namespace gameplay
          */
         static HeightField* create(const char* path, unsigned int width, unsigned int height, float heightMin, float heightMax);
 
+        /**
+         * Returns the height at an integer column and row.
+         */
+        float getSample(unsigned int column, unsigned int row) const;
+
+        /**
+         * Returns the number of samples after the first one along an axis of a region
+         * from first to last that is sampled every step samples.
+         */
+        static unsigned int getSampleCount(unsigned int first, unsigned int last, unsigned int step);
+
+        /**
+         * Returns the column or row of sample i of a region from first to last, in a heightfield
+         * with size columns or rows. Samples -1 and getSampleCount() + 1 are the neighbors of the
+         * region, clamped to the heightfield.
+         */
+        static unsigned int getSampleCoord(unsigned int first, unsigned int last, unsigned int size, unsigned int step, int i);
+
+        /**
+         * Reads the samples of a region, including its neighbors, for building a mesh.
+         *
+         * The region of a tiled heightfield must be one of its tiles, and step must be the
+         * step of one of its levels.
+         *
+         * @param heights Receives (getSampleCount(z1, z2, step) + 3) rows of (getSampleCount(x1, x2, step) + 3) heights.
+         * @param columns Receives the column of each sample in a row.
+         * @param rows Receives the row of each sample in a column.
+         */
+        void getSamples(unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2, unsigned int step,
+                        float* heights, unsigned int* columns, unsigned int* rows) const;
+
+        /**
+         * Gets the lowest and highest height of the tile at the given tile row and column.
+         */
+        void getTileBounds(unsigned int tileRow, unsigned int tileColumn, float* minHeight, float* maxHeight) const;
+
         float* _array;
         unsigned int _cols;
         unsigned int _rows;
+        const char* _tiles;             // the mapped tiled heightfield file
+        size_t _tilesSize;
+        unsigned int _tileSize;
+        unsigned int _tileLevelCount;
+        unsigned int _tileColumns;
+        unsigned int _tileRows;
+        float _tileHeightMin;
+        float _tileHeightScale;
+        const float* _tileBounds;       // lowest and highest height of each tile
+        std::vector<size_t> _tileLevels; // offset of each level in the file
     };
 
 }
@@ -109,6 +109,8 @@ void ImageControl::setImage(const char* path)
     }
 
 
+    // The cached geometry refers to the batch that was just deleted.
+    setDirty(DIRTY_GEOMETRY);
     if (_autoSize != AUTO_SIZE_NONE)
         setDirty(DIRTY_BOUNDS);
 }
@@ -124,6 +126,8 @@ void ImageControl::setImage(Image * image)
     texture->release();
     _batch->getSampler()->setWrapMode(Texture::CLAMP, Texture::CLAMP);
 
+    // The cached geometry refers to the batch that was just deleted.
+    setDirty(DIRTY_GEOMETRY);
     if (_autoSize != AUTO_SIZE_NONE)
         setDirty(DIRTY_BOUNDS);
 }
@@ -136,6 +140,7 @@ void ImageControl::setRegionSrc(float x, float y, float width, float height)
     _uvs.u2 = (x + width) * _tw;
     _uvs.v1 = y * _th;
     _uvs.v2 = (y + height) * _th;
+    setDirty(DIRTY_GEOMETRY);
 }
 
 void ImageControl::setRegionSrc(const Rectangle& region)
@@ -151,6 +156,7 @@ const Rectangle& ImageControl::getRegionSrc() const
 void ImageControl::setRegionDst(float x, float y, float width, float height)
 {
     _dstRegion.set(x, y, width, height);
+    setDirty(DIRTY_GEOMETRY);
 }
 
 void ImageControl::setRegionDst(const Rectangle& region)
@@ -221,6 +227,7 @@ const Vector4& ImageControl::getColor() const
 void ImageControl::setColor(const Vector4& color)
 {
     _color = color;
+    setDirty(DIRTY_GEOMETRY);
 }
 
 }
@@ -0,0 +1,322 @@
+#include "Base.h"
+#include "JobScheduler.h"
+#include "Game.h"
+
+namespace gameplay
+{
+
+JobScheduler::Job::Job(const std::function<void()>& function, const char* name)
+    : _function(function), _name(name), _dependencyCount(1), _refCount(1), _finished(false)
+{
+}
+
+JobScheduler::Job::~Job()
+{
+}
+
+bool JobScheduler::Job::isFinished() const
+{
+    return _finished;
+}
+
+const char* JobScheduler::Job::getName() const
+{
+    return _name;
+}
+
+JobScheduler::JobScheduler()
+    : _queuedCount(0), _running(false), _listener(NULL)
+{
+}
+
+JobScheduler::~JobScheduler()
+{
+}
+
+void JobScheduler::initialize(unsigned int workerCount)
+{
+    if (workerCount == 0)
+    {
+        // Leave one hardware thread for the main thread.
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    _mutex.reset(new std::mutex());
+    _condition.reset(new std::condition_variable());
+    _running = true;
+
+    // Queue 0 belongs to the main thread (and any other thread that is not a worker).
+    for (unsigned int i = 0; i <= workerCount; ++i)
+    {
+        _queues.push_back(new Queue());
+    }
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        _threads.push_back(new std::thread(&workerThreadProc, this, i + 1));
+        _threadIds.push_back(_threads.back()->get_id());
+    }
+}
+
+void JobScheduler::finalize()
+{
+    // Run whatever is still queued before the workers go away.
+    while (_queuedCount > 0)
+    {
+        Job* job = dequeue(0);
+        if (job)
+            execute(job, 0);
+        else
+            std::this_thread::yield();
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(*_mutex);
+        _running = false;
+    }
+    _condition->notify_all();
+
+    for (size_t i = 0, count = _threads.size(); i < count; ++i)
+    {
+        _threads[i]->join();
+        SAFE_DELETE(_threads[i]);
+    }
+    _threads.clear();
+    _threadIds.clear();
+
+    // Jobs that were still running may have released continuations.
+    while (_queuedCount > 0)
+    {
+        execute(dequeue(0), 0);
+    }
+
+    for (size_t i = 0, count = _queues.size(); i < count; ++i)
+    {
+        SAFE_DELETE(_queues[i]);
+    }
+    _queues.clear();
+}
+
+JobScheduler::Job* JobScheduler::createJob(const std::function<void()>& function, const char* name)
+{
+    return new Job(function, name);
+}
+
+void JobScheduler::addDependency(Job* job, Job* dependency)
+{
+    GP_ASSERT(job);
+    GP_ASSERT(dependency);
+    GP_ASSERT(job != dependency);
+
+    std::unique_lock<std::mutex> lock(*_mutex);
+    if (dependency->_finished)
+        return;
+
+    ++job->_dependencyCount;
+    dependency->_continuations.push_back(job);
+}
+
+void JobScheduler::submit(Job* job)
+{
+    GP_ASSERT(job);
+    GP_ASSERT(_running);
+
+    // The scheduler holds its own reference until the job has run.
+    ++job->_refCount;
+
+    // Drop the reference that kept the job from starting before it was submitted.
+    if (--job->_dependencyCount == 0)
+        enqueue(job);
+}
+
+void JobScheduler::wait(Job* job)
+{
+    GP_ASSERT(job);
+
+    unsigned int threadIndex = getThreadIndex();
+    while (!job->_finished)
+    {
+        Job* other = dequeue(threadIndex);
+        if (other)
+            execute(other, threadIndex);
+        else
+            std::this_thread::yield();
+    }
+    releaseJob(job);
+}
+
+void JobScheduler::run(const std::function<void()>& function, const char* name)
+{
+    Job* job = createJob(function, name);
+    submit(job);
+    releaseJob(job);
+}
+
+void JobScheduler::parallelFor(unsigned int count, unsigned int grainSize, const std::function<void(unsigned int, unsigned int)>& function, const char* name)
+{
+    if (count == 0)
+        return;
+
+    if (grainSize == 0)
+        grainSize = 1;
+
+    unsigned int chunkCount = (count + grainSize - 1) / grainSize;
+    if (chunkCount == 1 || _threads.empty())
+    {
+        function(0, count);
+        return;
+    }
+
+    // The calling thread processes the first chunk itself.
+    std::vector<Job*> jobs;
+    jobs.reserve(chunkCount - 1);
+    for (unsigned int chunk = 1; chunk < chunkCount; ++chunk)
+    {
+        unsigned int begin = chunk * grainSize;
+        unsigned int end = std::min(begin + grainSize, count);
+        Job* job = createJob([&function, begin, end]() { function(begin, end); }, name);
+        submit(job);
+        jobs.push_back(job);
+    }
+
+    function(0, std::min(grainSize, count));
+
+    for (size_t i = 0, jobCount = jobs.size(); i < jobCount; ++i)
+    {
+        wait(jobs[i]);
+    }
+}
+
+unsigned int JobScheduler::getWorkerCount() const
+{
+    return (unsigned int)_threads.size();
+}
+
+void JobScheduler::setListener(Listener* listener)
+{
+    _listener = listener;
+}
+
+JobScheduler::Listener* JobScheduler::getListener() const
+{
+    return _listener;
+}
+
+void JobScheduler::enqueue(Job* job)
+{
+    Queue* queue = _queues[getThreadIndex()];
+    {
+        std::unique_lock<std::mutex> lock(queue->mutex);
+        queue->jobs.push_back(job);
+    }
+    ++_queuedCount;
+
+    // Taking the lock orders this notification after a worker's check of the queued count.
+    {
+        std::unique_lock<std::mutex> lock(*_mutex);
+    }
+    _condition->notify_one();
+}
+
+JobScheduler::Job* JobScheduler::dequeue(unsigned int threadIndex)
+{
+    if (_queuedCount == 0)
+        return NULL;
+
+    // Own queue first, newest job first, since its data is most likely still in cache.
+    {
+        Queue* queue = _queues[threadIndex];
+        std::unique_lock<std::mutex> lock(queue->mutex);
+        if (!queue->jobs.empty())
+        {
+            Job* job = queue->jobs.back();
+            queue->jobs.pop_back();
+            --_queuedCount;
+            return job;
+        }
+    }
+
+    // Steal the oldest job from the other queues.
+    size_t queueCount = _queues.size();
+    for (size_t i = 1; i < queueCount; ++i)
+    {
+        Queue* queue = _queues[(threadIndex + i) % queueCount];
+        std::unique_lock<std::mutex> lock(queue->mutex);
+        if (!queue->jobs.empty())
+        {
+            Job* job = queue->jobs.front();
+            queue->jobs.pop_front();
+            --_queuedCount;
+            return job;
+        }
+    }
+
+    return NULL;
+}
+
+void JobScheduler::execute(Job* job, unsigned int threadIndex)
+{
+    GP_ASSERT(job);
+
+    Listener* listener = _listener;
+    double startTime = listener ? Game::getPlatformTime() : 0.0;
+
+    if (job->_function)
+        job->_function();
+
+    if (listener)
+        listener->jobFinished(job->_name, threadIndex, startTime, Game::getPlatformTime());
+
+    std::vector<Job*> continuations;
+    {
+        std::unique_lock<std::mutex> lock(*_mutex);
+        continuations.swap(job->_continuations);
+        job->_finished = true;
+    }
+
+    for (size_t i = 0, count = continuations.size(); i < count; ++i)
+    {
+        if (--continuations[i]->_dependencyCount == 0)
+            enqueue(continuations[i]);
+    }
+
+    releaseJob(job);
+}
+
+void JobScheduler::releaseJob(Job* job)
+{
+    if (--job->_refCount == 0)
+        delete job;
+}
+
+unsigned int JobScheduler::getThreadIndex() const
+{
+    std::thread::id id = std::this_thread::get_id();
+    for (size_t i = 0, count = _threadIds.size(); i < count; ++i)
+    {
+        if (_threadIds[i] == id)
+            return (unsigned int)i + 1;
+    }
+    return 0;
+}
+
+void JobScheduler::workerThreadProc(JobScheduler* scheduler, unsigned int threadIndex)
+{
+    while (true)
+    {
+        Job* job = scheduler->dequeue(threadIndex);
+        if (job)
+        {
+            scheduler->execute(job, threadIndex);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(*scheduler->_mutex);
+        while (scheduler->_running && scheduler->_queuedCount == 0)
+            scheduler->_condition->wait(lock);
+        if (!scheduler->_running)
+            break;
+    }
+}
+
+}
@@ -0,0 +1,285 @@
+#ifndef JOBSCHEDULER_H_
+#define JOBSCHEDULER_H_
+
+namespace gameplay
+{
+
+/**
+ * Defines a work-stealing scheduler for running jobs across multiple cores.
+ *
+ * A job is a function that runs on one of the scheduler's worker threads or on
+ * a thread that is waiting for a job to finish. Jobs can depend on other jobs,
+ * in which case they are not started until all of their dependencies have
+ * finished, which allows a frame to be expressed as a graph of independent
+ * pieces of work.
+ *
+ * Each thread owns a queue of jobs. A thread takes the most recently queued
+ * job from its own queue and steals the oldest job from another thread's
+ * queue when its own is empty. Threads that wait for a job keep running other
+ * jobs until it finishes, so waiting never blocks a core.
+ *
+ * The scheduler is configured from the game.config file:
+ *
+ * @code
+ * jobs
+ * {
+ *     threads = 7                    // number of worker threads (0 uses the number of hardware threads minus one)
+ *     parallelControllers = true     // update the animation, physics and AI controllers as jobs
+ * }
+ * @endcode
+ *
+ * The engine controllers are updated on the calling thread unless
+ * parallelControllers is set. Even then they run one after another, since user
+ * callbacks fired from them (animation listeners, AI state handlers, collision
+ * listeners and their scripts) touch nodes, reference counts and the script
+ * state. Other queued jobs still run alongside them.
+ *
+ * @script{ignore}
+ */
+class JobScheduler
+{
+    friend class Game;
+
+public:
+
+    /**
+     * Defines a handle to a job created by the JobScheduler.
+     */
+    class Job
+    {
+        friend class JobScheduler;
+
+    public:
+
+        /**
+         * Determines whether the job has finished running.
+         *
+         * @return True if the job has finished, false otherwise.
+         */
+        bool isFinished() const;
+
+        /**
+         * Gets the name of the job.
+         *
+         * @return The name of the job (may be NULL).
+         */
+        const char* getName() const;
+
+    private:
+
+        /**
+         * Constructor.
+         */
+        Job(const std::function<void()>& function, const char* name);
+
+        /**
+         * Destructor.
+         */
+        ~Job();
+
+        /**
+         * Hidden copy constructor.
+         */
+        Job(const Job& copy);
+
+        /**
+         * Hidden copy assignment operator.
+         */
+        Job& operator=(const Job&);
+
+        std::function<void()> _function;
+        const char* _name;
+        std::atomic<int> _dependencyCount;
+        std::atomic<int> _refCount;
+        std::atomic<bool> _finished;
+        std::vector<Job*> _continuations;
+    };
+
+    /**
+     * Defines an interface for receiving the timing of every job run by the scheduler.
+     */
+    class Listener
+    {
+    public:
+
+        /**
+         * Destructor.
+         */
+        virtual ~Listener() { }
+
+        /**
+         * Called after a job has run, on the thread that ran it.
+         *
+         * @param name The name of the job (may be NULL).
+         * @param threadIndex The index of the thread that ran the job (0 for the main thread).
+         * @param startTime The platform time the job started at (in seconds).
+         * @param endTime The platform time the job finished at (in seconds).
+         */
+        virtual void jobFinished(const char* name, unsigned int threadIndex, double startTime, double endTime) = 0;
+    };
+
+    /**
+     * Creates a job that is not yet submitted.
+     *
+     * Dependencies can be added to the job until it is submitted. The caller owns
+     * the returned handle and must pass it to wait() once submitted.
+     *
+     * @param function The function to run.
+     * @param name The name of the job, reported to the listener. The string must outlive the job.
+     *
+     * @return The job handle.
+     */
+    Job* createJob(const std::function<void()>& function, const char* name = NULL);
+
+    /**
+     * Makes a job wait for another job to finish before it starts.
+     *
+     * @param job The job that has not been submitted yet.
+     * @param dependency The job to wait for. It may already be submitted or finished.
+     */
+    void addDependency(Job* job, Job* dependency);
+
+    /**
+     * Submits a job. The job is queued as soon as all of its dependencies have finished.
+     *
+     * @param job The job to submit.
+     */
+    void submit(Job* job);
+
+    /**
+     * Waits for a job to finish, running other queued jobs on the calling thread
+     * in the meantime, and releases the job handle.
+     *
+     * @param job The job to wait for.
+     */
+    void wait(Job* job);
+
+    /**
+     * Creates and submits a job that nobody waits for.
+     *
+     * @param function The function to run.
+     * @param name The name of the job, reported to the listener. The string must outlive the job.
+     */
+    void run(const std::function<void()>& function, const char* name = NULL);
+
+    /**
+     * Runs a function over a range of indices split into chunks that are processed
+     * concurrently, and waits for all of them to finish.
+     *
+     * @param count The number of indices.
+     * @param grainSize The maximum number of indices passed to a single call of the function.
+     * @param function The function called with the [begin, end) range of indices of each chunk.
+     * @param name The name of the jobs, reported to the listener.
+     */
+    void parallelFor(unsigned int count, unsigned int grainSize, const std::function<void(unsigned int, unsigned int)>& function, const char* name = NULL);
+
+    /**
+     * Gets the number of worker threads.
+     *
+     * The calling thread of wait() and parallelFor() also runs jobs, so up to
+     * one more job than this number runs at the same time.
+     *
+     * @return The number of worker threads.
+     */
+    unsigned int getWorkerCount() const;
+
+    /**
+     * Sets the listener that receives the timing of every job.
+     *
+     * @param listener The listener, or NULL to stop timing jobs.
+     */
+    void setListener(Listener* listener);
+
+    /**
+     * Gets the listener that receives the timing of every job.
+     *
+     * @return The listener (may be NULL).
+     */
+    Listener* getListener() const;
+
+private:
+
+    /**
+     * Defines a queue of jobs owned by one thread.
+     */
+    struct Queue
+    {
+        std::deque<Job*> jobs;
+        std::mutex mutex;
+    };
+
+    /**
+     * Constructor.
+     */
+    JobScheduler();
+
+    /**
+     * Destructor.
+     */
+    ~JobScheduler();
+
+    /**
+     * Hidden copy constructor.
+     */
+    JobScheduler(const JobScheduler& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    JobScheduler& operator=(const JobScheduler&);
+
+    /**
+     * Controller initialize.
+     *
+     * @param workerCount The number of worker threads (0 to pick a default).
+     */
+    void initialize(unsigned int workerCount);
+
+    /**
+     * Controller finalize. Runs all remaining jobs and stops the worker threads.
+     */
+    void finalize();
+
+    /**
+     * Puts a job whose dependencies have finished on the calling thread's queue.
+     */
+    void enqueue(Job* job);
+
+    /**
+     * Takes a job from the given thread's queue or steals one from another thread.
+     */
+    Job* dequeue(unsigned int threadIndex);
+
+    /**
+     * Runs a job and starts the jobs that depended on it.
+     */
+    void execute(Job* job, unsigned int threadIndex);
+
+    /**
+     * Drops a reference to the job and deletes it once nothing refers to it.
+     */
+    void releaseJob(Job* job);
+
+    /**
+     * Gets the queue index of the calling thread (0 for any thread that is not a worker).
+     */
+    unsigned int getThreadIndex() const;
+
+    /**
+     * Worker thread entry point.
+     */
+    static void workerThreadProc(JobScheduler* scheduler, unsigned int threadIndex);
+
+    std::vector<Queue*> _queues;
+    std::vector<std::thread*> _threads;
+    std::vector<std::thread::id> _threadIds;
+    std::unique_ptr<std::mutex> _mutex;
+    std::unique_ptr<std::condition_variable> _condition;
+    std::atomic<unsigned int> _queuedCount;
+    std::atomic<bool> _running;
+    Listener* _listener;
+};
+
+}
+
+#endif
@@ -87,14 +87,6 @@ protected:
      */
     void setInverseBindPose(const Matrix& m);
 
-    /**
-     * Updates the joint matrix.
-     * 
-     * @param bindShape The bind shape matrix.
-     * @param matrixPalette The matrix palette to update.
-     */
-    void updateJointMatrix(const Matrix& bindShape, Vector4* matrixPalette);
-
     /**
      * Called when this Joint's transform changes.
      */
@@ -128,16 +120,16 @@ private:
 
     void removeSkin(MeshSkin* skin);
 
+    /**
+     * Marks the matrix palettes of all skins referencing this joint as out of date.
+     */
+    void setSkinsDirty(bool bindPoseChanged);
+
     /** 
      * The Matrix representation of the Joint's bind pose.
      */
     Matrix _bindPose;
 
-    /**
-     * Flag used to mark if the Joint's matrix is dirty.
-     */
-    bool _jointMatrixDirty;
-
     /**
      * Linked list of mesh skins that are referenced by this joint.
      */
@@ -77,6 +77,7 @@ void Label::setText(const wchar_t* text)
     if ((text == NULL && _text.length() > 0) || wcscmp(text, _text.c_str()) != 0)
     {
         _text = text ? text : L"";
+        setDirty(DIRTY_GEOMETRY);
         if (_autoSize != AUTO_SIZE_NONE)
         {
             // keep our bounds up-to-date even when control is hidden
@@ -96,8 +97,18 @@ void Label::update(float elapsedTime)
     Control::update(elapsedTime);
 
     // Update text opacity each frame since opacity is updated in Control::update.
-    _textColor = getTextColor(getState());
-    _textColor.w *= _opacity;
+    Vector4 textColor = getTextColor(getState());
+    textColor.w *= _opacity;
+    if (textColor != _textColor)
+    {
+        _textColor = textColor;
+        setDirty(DIRTY_GEOMETRY);
+    }
+
+    // Glyphs of dynamic fonts may move in the atlas between frames, so their
+    // sprites are regenerated instead of replayed from the form's geometry cache.
+    if (_font && _font->isDynamic())
+        setDirty(DIRTY_GEOMETRY);
 }
 
 void Label::updateState(State state)
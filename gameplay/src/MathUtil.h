@@ -77,6 +77,10 @@ private:
 
     inline static void crossVector3(const float* v1, const float* v2, float* dst);
 
+    inline static void multiplyMatrices(const float* m1, const float* m2, unsigned int count, float* dst);
+
+    inline static void transformPoints(const float* m, const float* points, unsigned int count, float* dst);
+
 
     inline static void addMatrix3(const float* m, float scalar, float* dst);
 
@@ -104,8 +108,15 @@ private:
 #define MATRIX_SIZE ( sizeof(float) * 16 )
 #define MATRIX3_SIZE ( sizeof(float) * 9 )
 
-#ifdef GP_USE_NEON
+// SSE2 is always available on x86-64 and on 32-bit builds targeting it.
+#if !defined(GP_USE_NEON) && !defined(GP_USE_SSE) && !defined(GP_NO_SSE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define GP_USE_SSE
+#endif
+
+#if defined(GP_USE_NEON)
 #include "MathUtilNeon.inl"
+#elif defined(GP_USE_SSE)
+#include "MathUtilSSE.inl"
 #else
 #include "MathUtil.inl"
 #endif
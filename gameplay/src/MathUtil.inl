@@ -182,6 +182,29 @@ inline void MathUtil::crossVector3(const float* v1, const float* v2, float* dst)
     dst[2] = z;
 }
 
+inline void MathUtil::multiplyMatrices(const float* m1, const float* m2, unsigned int count, float* dst)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        multiplyMatrix(m1 + i * 16, m2 + i * 16, dst + i * 16);
+    }
+}
+
+inline void MathUtil::transformPoints(const float* m, const float* points, unsigned int count, float* dst)
+{
+    for (unsigned int i = 0; i < count; ++i, points += 3, dst += 3)
+    {
+        // Handle case where points == dst.
+        float x = points[0] * m[0] + points[1] * m[4] + points[2] * m[8] + m[12];
+        float y = points[0] * m[1] + points[1] * m[5] + points[2] * m[9] + m[13];
+        float z = points[0] * m[2] + points[1] * m[6] + points[2] * m[10] + m[14];
+
+        dst[0] = x;
+        dst[1] = y;
+        dst[2] = z;
+    }
+}
+
 inline void MathUtil::addMatrix3(const float* m, float scalar, float* dst)
 {
     dst[0]  = m[0]  + scalar;
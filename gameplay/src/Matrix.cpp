@@ -733,6 +733,15 @@ void Matrix::multiply(const Matrix& m1, const Matrix& m2, Matrix* dst)
     MathUtil::multiplyMatrix(m1.m, m2.m, dst->m);
 }
 
+void Matrix::multiply(const Matrix* m1, const Matrix* m2, unsigned int count, Matrix* dst)
+{
+    GP_ASSERT(m1 || count == 0);
+    GP_ASSERT(m2 || count == 0);
+    GP_ASSERT(dst || count == 0);
+
+    MathUtil::multiplyMatrices(m1->m, m2->m, count, dst->m);
+}
+
 void Matrix::negate()
 {
     negate(this);
@@ -902,6 +911,14 @@ void Matrix::transformPoint(const Vector3& point, Vector3* dst) const
     transformVector(point.x, point.y, point.z, 1.0f, dst);
 }
 
+void Matrix::transformPoints(const Vector3* points, unsigned int count, Vector3* dst) const
+{
+    GP_ASSERT(points || count == 0);
+    GP_ASSERT(dst || count == 0);
+
+    MathUtil::transformPoints(m, &points->x, count, &dst->x);
+}
+
 void Matrix::transformVector(Vector3* vector) const
 {
     GP_ASSERT(vector);
@@ -528,6 +528,21 @@ public:
      */
     static void multiply(const Matrix& m1, const Matrix& m2, Matrix* dst);
 
+    /**
+     * Multiplies each matrix in m1 by the matrix at the same index in m2 and
+     * stores the results in dst.
+     *
+     * This is faster than multiplying the matrices one by one and is meant for
+     * large batches, such as skinning palettes or world transforms.
+     *
+     * @param m1 The first array of matrices to multiply.
+     * @param m2 The second array of matrices to multiply.
+     * @param count The number of matrices in each array.
+     * @param dst An array of count matrices to store the results in (may be m1 or m2).
+     * @script{ignore}
+     */
+    static void multiply(const Matrix* m1, const Matrix* m2, unsigned int count, Matrix* dst);
+
     /**
      * Negates this matrix.
      */
@@ -763,6 +778,16 @@ public:
      */
     void transformPoint(const Vector3& point, Vector3* dst) const;
 
+    /**
+     * Transforms an array of points by this matrix, and stores the results in dst.
+     *
+     * @param points The points to transform.
+     * @param count The number of points.
+     * @param dst An array of count points to store the results in (may be points).
+     * @script{ignore}
+     */
+    void transformPoints(const Vector3* points, unsigned int count, Vector3* dst) const;
+
     /**
      * Transforms the specified vector by this matrix by
      * treating the fourth (w) coordinate as zero.
@@ -12,6 +12,7 @@
 #include "MeshBatch.h"
 #include "Material.h"
 #include "Model.h"
+#include "RenderQueue.h"
 
 namespace gameplay
 {
@@ -311,9 +312,15 @@ void MeshBatch::draw() const
         }
 
         pass->unbind();
+        RenderQueue::_statistics.drawCalls++;
     }
 }
 
+unsigned int MeshBatch::getVertexCount() const
+{
+    return _vertexCount;
+}
+
 void MeshBatch::erase(unsigned int vertexCount)
 {
     GP_ASSERT(!_indexed);
@@ -136,6 +136,24 @@ public:
      */
     void erase(unsigned int vertexCount);
 
+    /**
+     * Gets the number of vertices currently in the batch.
+     *
+     * @return The number of vertices.
+     */
+    unsigned int getVertexCount() const;
+
+    /**
+     * Gets the vertices currently in the batch. Works only for unindexed primitives.
+     *
+     * The pointer is invalidated when vertices are added to the batch.
+     *
+     * @return The vertex data, as an array of vertices of the batch's vertex format.
+     * @script{ignore}
+     */
+    template< class T >
+    const T* getVertices() const;
+
     /**
      * Starts batching.
      *
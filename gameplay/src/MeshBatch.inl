@@ -44,4 +44,13 @@ T * MeshBatch::reserve(unsigned int vertexCount)
     return reinterpret_cast< T * >( oldPtr );
 }
 
+template <class T>
+const T* MeshBatch::getVertices() const
+{
+    GP_ASSERT(sizeof(T) == _vertexFormat.getVertexSize());
+    GP_ASSERT(!_indexed);
+
+    return reinterpret_cast<const T*>(_vertices);
+}
+
 }
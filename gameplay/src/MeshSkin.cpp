@@ -2,15 +2,21 @@
 #include "MeshSkin.h"
 #include "Joint.h"
 #include "Model.h"
+#include "Game.h"
+#include "PhysicsCollisionObject.h"
 
 // The number of rows in each palette matrix.
 #define PALETTE_ROWS 3
 
+// The number of skins whose palettes are computed by a single job.
+#define PALETTE_GRAIN_SIZE 8
+
 namespace gameplay
 {
 
 MeshSkin::MeshSkin()
-    : _rootJoint(NULL), _rootNode(NULL), _matrixPalette(NULL), _model(NULL)
+    : _rootJoint(NULL), _rootNode(NULL), _matrixPalette(NULL), _model(NULL),
+      _sortedJointsDirty(true), _bindMatricesDirty(true), _matrixPaletteDirty(true)
 {
 }
 
@@ -29,6 +35,7 @@ const Matrix& MeshSkin::getBindShape() const
 void MeshSkin::setBindShape(const float* matrix)
 {
     _bindShape.set(matrix);
+    setMatrixPaletteDirty(true);
 }
 
 unsigned int MeshSkin::getJointCount() const
@@ -134,6 +141,9 @@ void MeshSkin::setJointCount(unsigned int jointCount)
             _matrixPalette[i+2].set(0.0f, 0.0f, 1.0f, 0.0f);
         }
     }
+
+    _sortedJointsDirty = true;
+    setMatrixPaletteDirty(true);
 }
 
 void MeshSkin::setJoint(Joint* joint, unsigned int index)
@@ -153,20 +163,219 @@ void MeshSkin::setJoint(Joint* joint, unsigned int index)
         joint->addRef();
         joint->addSkin(this);
     }
+
+    _sortedJointsDirty = true;
+    setMatrixPaletteDirty(true);
 }
 
 Vector4* MeshSkin::getMatrixPalette() const
 {
     GP_ASSERT(_matrixPalette);
 
-    for (size_t i = 0, count = _joints.size(); i < count; i++)
+    if (_matrixPaletteDirty)
     {
-        GP_ASSERT(_joints[i]);
-        _joints[i]->updateJointMatrix(getBindShape(), &_matrixPalette[i * PALETTE_ROWS]);
+        prepareMatrixPalette();
+        computeMatrixPalette();
     }
     return _matrixPalette;
 }
 
+void MeshSkin::updateMatrixPalettes(MeshSkin* const* skins, unsigned int count)
+{
+    GP_ASSERT(skins || count == 0);
+
+    // Reading joint transforms resolves dirty nodes, which is not thread-safe,
+    // so only the matrix math runs on the worker threads.
+    std::vector<MeshSkin*> dirtySkins;
+    dirtySkins.reserve(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        MeshSkin* skin = skins[i];
+        GP_ASSERT(skin);
+        if (skin->_matrixPaletteDirty && skin->_matrixPalette)
+        {
+            skin->prepareMatrixPalette();
+            dirtySkins.push_back(skin);
+        }
+    }
+
+    JobScheduler* scheduler = Game::getInstance()->getJobScheduler();
+    if (scheduler)
+    {
+        scheduler->parallelFor((unsigned int)dirtySkins.size(), PALETTE_GRAIN_SIZE, [&dirtySkins](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                dirtySkins[i]->computeMatrixPalette();
+            }
+        }, "MeshSkin::updateMatrixPalettes");
+    }
+    else
+    {
+        for (size_t i = 0, dirtyCount = dirtySkins.size(); i < dirtyCount; ++i)
+        {
+            dirtySkins[i]->computeMatrixPalette();
+        }
+    }
+}
+
+void MeshSkin::sortJoints() const
+{
+    const unsigned int jointCount = (unsigned int)_joints.size();
+    _sortedJoints.resize(jointCount);
+    _jointMatrices.resize(jointCount);
+    _bindMatrices.resize(jointCount);
+
+    // Sort the joints by their depth within this skin, so that every parent
+    // comes before its children.
+    std::vector<unsigned int> depths(jointCount, 0);
+    for (unsigned int i = 0; i < jointCount; ++i)
+    {
+        GP_ASSERT(_joints[i]);
+        for (Node* node = _joints[i]->getParent(); node && node->getType() == Node::JOINT; node = node->getParent())
+        {
+            if (getJointIndex(static_cast<Joint*>(node)) < 0)
+                break;
+            ++depths[i];
+        }
+        _sortedJoints[i].index = i;
+    }
+    std::stable_sort(_sortedJoints.begin(), _sortedJoints.end(), [&depths](const SortedJoint& a, const SortedJoint& b)
+    {
+        return depths[a.index] < depths[b.index];
+    });
+
+    std::vector<int> positions(jointCount);
+    for (unsigned int i = 0; i < jointCount; ++i)
+    {
+        positions[_sortedJoints[i].index] = (int)i;
+    }
+    for (unsigned int i = 0; i < jointCount; ++i)
+    {
+        Node* parent = _joints[_sortedJoints[i].index]->getParent();
+        int parentIndex = parent && parent->getType() == Node::JOINT ? getJointIndex(static_cast<Joint*>(parent)) : -1;
+        _sortedJoints[i].parent = parentIndex >= 0 ? positions[parentIndex] : -1;
+    }
+
+    _sortedJointsDirty = false;
+    _bindMatricesDirty = true;
+}
+
+void MeshSkin::prepareMatrixPalette() const
+{
+    if (_sortedJointsDirty)
+        sortJoints();
+
+    if (_bindMatricesDirty)
+    {
+        for (size_t i = 0, count = _sortedJoints.size(); i < count; ++i)
+        {
+            Matrix::multiply(_joints[_sortedJoints[i].index]->getInverseBindPose(), _bindShape, &_bindMatrices[i]);
+        }
+        _bindMatricesDirty = false;
+    }
+
+    for (size_t i = 0, count = _sortedJoints.size(); i < count; ++i)
+    {
+        Joint* joint = _joints[_sortedJoints[i].index];
+        GP_ASSERT(joint);
+
+        // Joints outside this skin's hierarchy, static joints and joints driven
+        // by physics resolve their world matrix through the node itself.
+        SortedJoint& sortedJoint = _sortedJoints[i];
+        sortedJoint.world = sortedJoint.parent < 0 || joint->isStatic() || (joint->_collisionObject && !joint->_collisionObject->isKinematic());
+        _jointMatrices[i] = sortedJoint.world ? joint->getWorldMatrix() : joint->getMatrix();
+    }
+}
+
+void MeshSkin::computeMatrixPalette() const
+{
+    const unsigned int count = (unsigned int)_sortedJoints.size();
+    if (count == 0)
+    {
+        _matrixPaletteDirty = false;
+        return;
+    }
+
+    const SortedJoint* sortedJoints = &_sortedJoints[0];
+    Matrix* matrices = &_jointMatrices[0];
+
+    // Parents are always resolved before their children.
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (!sortedJoints[i].world)
+            Matrix::multiply(matrices[sortedJoints[i].parent], matrices[i], &matrices[i]);
+    }
+
+    // Palette matrix = world * inverse bind pose * bind shape.
+    Matrix::multiply(matrices, &_bindMatrices[0], count, matrices);
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const float* m = matrices[i].m;
+        Vector4* rows = &_matrixPalette[sortedJoints[i].index * PALETTE_ROWS];
+        rows[0].set(m[0], m[4], m[8], m[12]);
+        rows[1].set(m[1], m[5], m[9], m[13]);
+        rows[2].set(m[2], m[6], m[10], m[14]);
+    }
+
+    _matrixPaletteDirty = false;
+}
+
+void MeshSkin::setMatrixPaletteDirty(bool bindPoseChanged)
+{
+    _matrixPaletteDirty = true;
+    if (bindPoseChanged)
+        _bindMatricesDirty = true;
+}
+
+void MeshSkin::skinVertices(const Vector3* positions, const Vector3* normals, const Vector4* blendIndices, const Vector4* blendWeights,
+                            unsigned int count, Vector3* dstPositions, Vector3* dstNormals) const
+{
+    GP_ASSERT(positions || count == 0);
+    GP_ASSERT(blendIndices || count == 0);
+    GP_ASSERT(blendWeights || count == 0);
+    GP_ASSERT(dstPositions || count == 0);
+
+    const Vector4* palette = getMatrixPalette();
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        // Blend the palette rows by the vertex weights, then transform once.
+        const float* indices = &blendIndices[i].x;
+        const float* weights = &blendWeights[i].x;
+        Vector4 row0(0.0f, 0.0f, 0.0f, 0.0f);
+        Vector4 row1(0.0f, 0.0f, 0.0f, 0.0f);
+        Vector4 row2(0.0f, 0.0f, 0.0f, 0.0f);
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            float weight = weights[j];
+            if (weight == 0.0f)
+                continue;
+
+            unsigned int joint = (unsigned int)indices[j];
+            GP_ASSERT(joint < getJointCount());
+            const Vector4* rows = &palette[joint * PALETTE_ROWS];
+            row0 += rows[0] * weight;
+            row1 += rows[1] * weight;
+            row2 += rows[2] * weight;
+        }
+
+        const Vector3& p = positions[i];
+        dstPositions[i].set(row0.x * p.x + row0.y * p.y + row0.z * p.z + row0.w,
+                            row1.x * p.x + row1.y * p.y + row1.z * p.z + row1.w,
+                            row2.x * p.x + row2.y * p.y + row2.z * p.z + row2.w);
+
+        if (normals && dstNormals)
+        {
+            const Vector3& n = normals[i];
+            dstNormals[i].set(row0.x * n.x + row0.y * n.y + row0.z * n.z,
+                              row1.x * n.x + row1.y * n.y + row1.z * n.z,
+                              row2.x * n.x + row2.y * n.y + row2.z * n.z);
+        }
+    }
+}
+
 unsigned int MeshSkin::getMatrixPaletteSize() const
 {
     return (unsigned int)_joints.size() * PALETTE_ROWS;
@@ -193,6 +402,8 @@ void MeshSkin::setRootJoint(Joint* joint)
     }
 
     _rootJoint = joint;
+    _sortedJointsDirty = true;
+    _matrixPaletteDirty = true;
 
     // If the root joint has a parent node, register for its transformChanged event
     if (_rootJoint && _rootJoint->getParent())
@@ -226,7 +437,8 @@ void MeshSkin::transformChanged(Transform* transform, long cookie)
         // case allows us to have much tighter bounding volumes for
         // skinned meshes by only considering local skin/joint transformations
         // during bounding volume computation instead of fully resolved
-        // joint transformations.
+        // joint transformations. Dirtying the bounds also refits the node
+        // in the scene's spatial index.
         if (_model && _model->getNode())
         {
             _model->getNode()->setBoundsDirty();
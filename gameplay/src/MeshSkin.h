@@ -92,6 +92,9 @@ public:
 
     /**
      * Returns the pointer to the Vector4 array for the purpose of binding to a shader.
+     *
+     * The palette is recomputed in a single pass over the joints if any joint
+     * has moved since the last call.
      * 
      * @return The pointer to the matrix palette.
      */
@@ -111,6 +114,38 @@ public:
      */
     Model* getModel() const;
 
+    /**
+     * Transforms vertices on the CPU by the current matrix palette.
+     *
+     * This applies the same linear blend skinning as the built-in skinning
+     * shaders and can be used where GPU skinning is not available, or to get
+     * skinned positions for picking and collision.
+     *
+     * @param positions The bind pose vertex positions.
+     * @param normals The bind pose vertex normals (may be NULL).
+     * @param blendIndices The joint indices of each vertex (up to 4 influences).
+     * @param blendWeights The joint weights of each vertex, matching blendIndices.
+     * @param count The number of vertices.
+     * @param dstPositions An array of count vectors to store the skinned positions in.
+     * @param dstNormals An array of count vectors to store the skinned normals in (may be NULL).
+     * @script{ignore}
+     */
+    void skinVertices(const Vector3* positions, const Vector3* normals, const Vector4* blendIndices, const Vector4* blendWeights,
+                      unsigned int count, Vector3* dstPositions, Vector3* dstNormals) const;
+
+    /**
+     * Updates the matrix palettes of several skins at once.
+     *
+     * Joint transforms are gathered on the calling thread, after which the
+     * palettes are computed concurrently on the game's JobScheduler. Skins
+     * whose joints have not moved are skipped. Each skin must appear only once.
+     *
+     * @param skins The skins to update.
+     * @param count The number of skins.
+     * @script{ignore}
+     */
+    static void updateMatrixPalettes(MeshSkin* const* skins, unsigned int count);
+
     /**
      * Handles transform change events for joints.
      */
@@ -175,6 +210,46 @@ private:
      */
     void clearJoints();
 
+    /**
+     * Rebuilds the topologically sorted joint array.
+     */
+    void sortJoints() const;
+
+    /**
+     * Gathers the joint transforms needed by computeMatrixPalette().
+     *
+     * Must be called on the thread that owns the scene.
+     */
+    void prepareMatrixPalette() const;
+
+    /**
+     * Computes the matrix palette from the gathered joint transforms.
+     */
+    void computeMatrixPalette() const;
+
+    /**
+     * Marks the matrix palette as out of date.
+     *
+     * @param bindPoseChanged Whether a bind pose or the bind shape has changed.
+     */
+    void setMatrixPaletteDirty(bool bindPoseChanged);
+
+    /**
+     * A joint in the topologically sorted joint array.
+     */
+    struct SortedJoint
+    {
+        // The index of the joint in _joints.
+        unsigned int index;
+
+        // The position of the parent joint in the sorted array, or -1 if the
+        // parent is not a joint of this skin.
+        int parent;
+
+        // Whether the gathered matrix is already the world matrix of the joint.
+        bool world;
+    };
+
     Matrix _bindShape;
     std::vector<Joint*> _joints;
     Joint* _rootJoint;
@@ -190,6 +265,20 @@ private:
     // The number of Vector4's is (_joints.size() * 3).
     Vector4* _matrixPalette;
     Model* _model;
+
+    // The joints sorted so that parents come before their children.
+    mutable std::vector<SortedJoint> _sortedJoints;
+
+    // The world matrix of each sorted joint. Holds local matrices between
+    // prepareMatrixPalette() and computeMatrixPalette().
+    mutable std::vector<Matrix> _jointMatrices;
+
+    // The inverse bind pose times the bind shape of each sorted joint.
+    mutable std::vector<Matrix> _bindMatrices;
+
+    mutable bool _sortedJointsDirty;
+    mutable bool _bindMatricesDirty;
+    mutable bool _matrixPaletteDirty;
 };
 
 }
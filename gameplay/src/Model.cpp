@@ -5,6 +5,7 @@
 #include "Technique.h"
 #include "Pass.h"
 #include "Node.h"
+#include "RenderQueue.h"
 
 namespace gameplay
 {
@@ -353,6 +354,7 @@ static bool drawWireframe(MeshPart* part)
 
 unsigned int Model::draw(bool wireframe) const
 {
+    GP_PROFILE_SCOPE("Model::draw");
     GP_ASSERT(_mesh);
 
     unsigned int partCount = _mesh->getPartCount();
@@ -366,15 +368,7 @@ unsigned int Model::draw(bool wireframe) const
             unsigned int passCount = technique->getPassCount();
             for (unsigned int i = 0; i < passCount; ++i)
             {
-                Pass* pass = technique->getPassByIndex(i);
-                GP_ASSERT(pass);
-                pass->bind();
-                GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
-                if (!wireframe || !drawWireframe(_mesh))
-                {
-                    GL_ASSERT( glDrawArrays(_mesh->getPrimitiveType(), 0, _mesh->getVertexCount()) );
-                }
-                pass->unbind();
+                drawPass(NULL, technique->getPassByIndex(i), wireframe);
             }
         }
     }
@@ -394,15 +388,7 @@ unsigned int Model::draw(bool wireframe) const
                 unsigned int passCount = technique->getPassCount();
                 for (unsigned int j = 0; j < passCount; ++j)
                 {
-                    Pass* pass = technique->getPassByIndex(j);
-                    GP_ASSERT(pass);
-                    pass->bind();
-                    GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, part->_indexBuffer) );
-                    if (!wireframe || !drawWireframe(part))
-                    {
-                        GL_ASSERT( glDrawElements(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), 0) );
-                    }
-                    pass->unbind();
+                    drawPass(part, technique->getPassByIndex(j), wireframe);
                 }
             }
         }
@@ -410,6 +396,31 @@ unsigned int Model::draw(bool wireframe) const
     return partCount;
 }
 
+void Model::drawPass(MeshPart* part, Pass* pass, bool wireframe) const
+{
+    GP_ASSERT(pass);
+
+    pass->bind();
+    if (part)
+    {
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, part->_indexBuffer) );
+        if (!wireframe || !drawWireframe(part))
+        {
+            GL_ASSERT( glDrawElements(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), 0) );
+        }
+    }
+    else
+    {
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
+        if (!wireframe || !drawWireframe(_mesh))
+        {
+            GL_ASSERT( glDrawArrays(_mesh->getPrimitiveType(), 0, _mesh->getVertexCount()) );
+        }
+    }
+    pass->unbind();
+    RenderQueue::_statistics.drawCalls++;
+}
+
 void Model::setMaterialNodeBinding(Material *material)
 {
     GP_ASSERT(material);
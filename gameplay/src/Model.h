@@ -25,6 +25,7 @@ class Model : public Ref, public Drawable
     friend class Scene;
     friend class Mesh;
     friend class Bundle;
+    friend class RenderQueue;
 
 public:
 
@@ -186,6 +187,11 @@ private:
      */
     void setMaterialNodeBinding(Material *m);
 
+    /**
+     * Draws a mesh part, or the whole mesh if the part is NULL, with a single pass.
+     */
+    void drawPass(MeshPart* part, Pass* pass, bool wireframe) const;
+
     void validatePartCount();
 
     Mesh* _mesh;
@@ -3,6 +3,8 @@
 #include "AudioSource.h"
 #include "Scene.h"
 #include "Joint.h"
+#include "TransformHierarchy.h"
+#include "SpatialIndex.h"
 #include "PhysicsRigidBody.h"
 #include "PhysicsVehicle.h"
 #include "PhysicsVehicleWheel.h"
@@ -26,7 +28,8 @@ namespace gameplay
 Node::Node(const char* id)
     : _scene(NULL), _firstChild(NULL), _nextSibling(NULL), _prevSibling(NULL), _parent(NULL), _childCount(0), _enabled(true), _tags(NULL),
     _drawable(NULL), _camera(NULL), _light(NULL), _audioSource(NULL), _collisionObject(NULL), _agent(NULL), _userObject(NULL),
-      _dirtyBits(NODE_DIRTY_ALL)
+      _dirtyBits(NODE_DIRTY_ALL), _transformHierarchy(NULL), _transformIndex(-1),
+      _spatialIndex(NULL), _spatialProxy(-1)
 {
     GP_REGISTER_SCRIPT_EVENTS();
     if (id)
@@ -72,7 +75,13 @@ void Node::setId(const char* id)
 {
     if (id)
     {
+        std::string oldId;
+        oldId.swap(_id);
         _id = id;
+
+        // Keep the agent findable by the new ID.
+        if (_agent)
+            Game::getInstance()->getAIController()->renameAgent(_agent, oldId.c_str());
     }
 }
 
@@ -122,6 +131,13 @@ void Node::addChild(Node* child)
     ++_childCount;
     setBoundsDirty();
 
+    if (_transformHierarchy)
+        _transformHierarchy->invalidate();
+
+    Scene* scene = getScene();
+    if (scene && scene->getSpatialIndex())
+        scene->getSpatialIndex()->addNode(child);
+
     if (_dirtyBits & NODE_DIRTY_HIERARCHY)
     {
         hierarchyChanged();
@@ -154,6 +170,8 @@ void Node::removeAllChildren()
 
 void Node::remove()
 {
+    Scene* scene = _spatialIndex || _firstChild ? getScene() : NULL;
+
     // Re-link our neighbours.
     if (_prevSibling)
     {
@@ -177,6 +195,11 @@ void Node::remove()
     _prevSibling = NULL;
     _parent = NULL;
 
+    if (_transformHierarchy)
+        _transformHierarchy->removeNode(this);
+    if (scene && scene->getSpatialIndex())
+        scene->getSpatialIndex()->removeNode(this);
+
     if (parent && parent->_dirtyBits & NODE_DIRTY_HIERARCHY)
     {
         parent->hierarchyChanged();
@@ -467,6 +490,26 @@ const Matrix& Node::getWorldMatrix() const
     return _world;
 }
 
+void Node::updateWorldMatrix(const Matrix* parentWorld) const
+{
+    if (_dirtyBits & NODE_DIRTY_WORLD)
+    {
+        _dirtyBits &= ~NODE_DIRTY_WORLD;
+
+        if (!isStatic())
+        {
+            if (parentWorld && (!_collisionObject || _collisionObject->isKinematic()))
+            {
+                Matrix::multiply(*parentWorld, getMatrix(), &_world);
+            }
+            else
+            {
+                _world = getMatrix();
+            }
+        }
+    }
+}
+
 const Matrix& Node::getWorldViewMatrix() const
 {
     static Matrix worldView;
@@ -663,6 +706,12 @@ void Node::transformChanged()
     // Our local transform was changed, so mark our world matrices dirty.
     _dirtyBits |= NODE_DIRTY_WORLD | NODE_DIRTY_BOUNDS;
 
+    // A dirty parent has already marked our subtree in the flat hierarchy.
+    if (_transformHierarchy && !(_parent && (_parent->_dirtyBits & NODE_DIRTY_WORLD)))
+        _transformHierarchy->setDirty(this);
+    if (_spatialIndex)
+        _spatialIndex->setMoved(this);
+
     // Notify our children that their transform has also changed (since transforms are inherited).
     for (Node* n = getFirstChild(); n != NULL; n = n->getNextSibling())
     {
@@ -685,12 +734,17 @@ void Node::transformChanged()
 
 void Node::setBoundsDirty()
 {
-    // Mark ourself and our parent nodes as dirty
-    _dirtyBits |= NODE_DIRTY_BOUNDS;
+    // Our bounds can change without our transform changing (a skeleton moving under
+    // a skinned model or a light changing its range), so refit our spatial index leaf.
+    // Parent leaves only hold their own drawables and are not affected.
+    if (_spatialIndex)
+        _spatialIndex->setMoved(this);
 
-    // Mark our parent bounds as dirty as well
-    if (_parent)
-        _parent->setBoundsDirty();
+    // Mark ourself and our parent nodes as dirty
+    for (Node* node = this; node != NULL; node = node->_parent)
+    {
+        node->_dirtyBits |= NODE_DIRTY_BOUNDS;
+    }
 }
 
 Animation* Node::getAnimation(const char* id) const
@@ -831,6 +885,10 @@ void Node::setDrawable(Drawable* drawable)
                 ref->addRef();
             _drawable->setNode(this);
         }
+
+        Scene* scene = getScene();
+        if (scene && scene->getSpatialIndex())
+            scene->getSpatialIndex()->refreshNode(this);
     }
     setBoundsDirty();
 }
@@ -841,109 +899,118 @@ const BoundingSphere& Node::getBoundingSphere() const
     {
         _dirtyBits &= ~NODE_DIRTY_BOUNDS;
 
-        const Matrix& worldMatrix = getWorldMatrix();
+        bool empty = !computeBoundingSphere(&_bounds);
 
-        // Start with our local bounding sphere
-        // TODO: Incorporate bounds from entities other than mesh (i.e. particleemitters, audiosource, etc)
-        bool empty = true;
-        Terrain* terrain = dynamic_cast<Terrain*>(_drawable);
-        if (terrain)
-        {
-            _bounds.set(terrain->getBoundingBox());
-            empty = false;
-        }
-        Model* model = dynamic_cast<Model*>(_drawable);
-        if (model && model->getMesh())
-        {
-            if (empty)
-            {
-                _bounds.set(model->getMesh()->getBoundingSphere());
-                empty = false;
-            }
-            else
-            {
-                _bounds.merge(model->getMesh()->getBoundingSphere());
-            }
-        }
-        if (_light)
+        // Merge this world-space bounding sphere with our childrens' bounding volumes.
+        for (Node* n = getFirstChild(); n != NULL; n = n->getNextSibling())
         {
-            switch (_light->getLightType())
+            const BoundingSphere& childSphere = n->getBoundingSphere();
+            if (!childSphere.isEmpty())
             {
-            case Light::POINT:
                 if (empty)
                 {
-                    _bounds.set(Vector3::zero(), _light->getRange());
+                    _bounds.set(childSphere);
                     empty = false;
                 }
                 else
                 {
-                    _bounds.merge(BoundingSphere(Vector3::zero(), _light->getRange()));
+                    _bounds.merge(childSphere);
                 }
-                break;
-            case Light::SPOT:
-                // TODO: Implement spot light bounds
-                break;
             }
         }
+    }
+
+    return _bounds;
+}
+
+bool Node::computeBoundingSphere(BoundingSphere* sphere) const
+{
+    GP_ASSERT(sphere);
+
+    const Matrix& worldMatrix = getWorldMatrix();
+
+    // Start with our local bounding sphere
+    // TODO: Incorporate bounds from entities other than mesh (i.e. particleemitters, audiosource, etc)
+    bool empty = true;
+    Terrain* terrain = dynamic_cast<Terrain*>(_drawable);
+    if (terrain)
+    {
+        sphere->set(terrain->getBoundingBox());
+        empty = false;
+    }
+    Model* model = dynamic_cast<Model*>(_drawable);
+    if (model && model->getMesh())
+    {
         if (empty)
         {
-            // Empty bounding sphere, set the world translation with zero radius
-            worldMatrix.getTranslation(&_bounds.center);
-            _bounds.radius = 0;
+            sphere->set(model->getMesh()->getBoundingSphere());
+            empty = false;
         }
-
-        // Transform the sphere (if not empty) into world space.
-        if (!empty)
+        else
+        {
+            sphere->merge(model->getMesh()->getBoundingSphere());
+        }
+    }
+    if (_light)
+    {
+        switch (_light->getLightType())
         {
-            bool applyWorldTransform = true;
-            if (model && model->getSkin())
+        case Light::POINT:
+            if (empty)
             {
-                // Special case: If the root joint of our mesh skin is parented by any nodes, 
-                // multiply the world matrix of the root joint's parent by this node's
-                // world matrix. This computes a final world matrix used for transforming this
-                // node's bounding volume. This allows us to store a much smaller bounding
-                // volume approximation than would otherwise be possible for skinned meshes,
-                // since joint parent nodes that are not in the matrix palette do not need to
-                // be considered as directly transforming vertices on the GPU (they can instead
-                // be applied directly to the bounding volume transformation below).
-                GP_ASSERT(model->getSkin()->getRootJoint());
-                Node* jointParent = model->getSkin()->getRootJoint()->getParent();
-                if (jointParent)
-                {
-                    // TODO: Should we protect against the case where joints are nested directly
-                    // in the node hierachy of the model (this is normally not the case)?
-                    Matrix boundsMatrix;
-                    Matrix::multiply(getWorldMatrix(), jointParent->getWorldMatrix(), &boundsMatrix);
-                    _bounds.transform(boundsMatrix);
-                    applyWorldTransform = false;
-                }
+                sphere->set(Vector3::zero(), _light->getRange());
+                empty = false;
             }
-            if (applyWorldTransform)
+            else
             {
-                _bounds.transform(getWorldMatrix());
+                sphere->merge(BoundingSphere(Vector3::zero(), _light->getRange()));
             }
+            break;
+        case Light::SPOT:
+            // TODO: Implement spot light bounds
+            break;
         }
+    }
+    if (empty)
+    {
+        // Empty bounding sphere, set the world translation with zero radius
+        worldMatrix.getTranslation(&sphere->center);
+        sphere->radius = 0;
+    }
 
-        // Merge this world-space bounding sphere with our childrens' bounding volumes.
-        for (Node* n = getFirstChild(); n != NULL; n = n->getNextSibling())
+    // Transform the sphere (if not empty) into world space.
+    if (!empty)
+    {
+        bool applyWorldTransform = true;
+        if (model && model->getSkin())
         {
-            const BoundingSphere& childSphere = n->getBoundingSphere();
-            if (!childSphere.isEmpty())
+            // Special case: If the root joint of our mesh skin is parented by any nodes, 
+            // multiply the world matrix of the root joint's parent by this node's
+            // world matrix. This computes a final world matrix used for transforming this
+            // node's bounding volume. This allows us to store a much smaller bounding
+            // volume approximation than would otherwise be possible for skinned meshes,
+            // since joint parent nodes that are not in the matrix palette do not need to
+            // be considered as directly transforming vertices on the GPU (they can instead
+            // be applied directly to the bounding volume transformation below).
+            GP_ASSERT(model->getSkin()->getRootJoint());
+            Node* jointParent = model->getSkin()->getRootJoint()->getParent();
+            if (jointParent)
             {
-                if (empty)
-                {
-                    _bounds.set(childSphere);
-                    empty = false;
-                }
-                else
-                {
-                    _bounds.merge(childSphere);
-                }
+                // TODO: Should we protect against the case where joints are nested directly
+                // in the node hierachy of the model (this is normally not the case)?
+                Matrix boundsMatrix;
+                Matrix::multiply(getWorldMatrix(), jointParent->getWorldMatrix(), &boundsMatrix);
+                sphere->transform(boundsMatrix);
+                applyWorldTransform = false;
             }
         }
+        if (applyWorldTransform)
+        {
+            sphere->transform(getWorldMatrix());
+        }
     }
 
-    return _bounds;
+    return !empty;
 }
 
 Node* Node::clone() const
@@ -25,6 +25,8 @@ class Light;
 class AudioSource;
 class AIAgent;
 class Drawable;
+class TransformHierarchy;
+class SpatialIndex;
 
 /**
  * Defines a hierarchical structure of objects in 3D transformation spaces.
@@ -41,6 +43,8 @@ class Node : public Transform, public Ref
     friend class Bundle;
     friend class MeshSkin;
     friend class Light;
+    friend class TransformHierarchy;
+    friend class SpatialIndex;
 
     GP_SCRIPT_EVENTS_START();
     GP_SCRIPT_EVENT(update, "<Node>f");
@@ -661,10 +665,29 @@ protected:
     void hierarchyChanged();
 
     /**
-     * Marks the bounding volume of the node as dirty.
+     * Marks the bounding volume of the node as dirty and refits the node in the
+     * scene's spatial index.
      */
     void setBoundsDirty();
 
+    /**
+     * Resolves the world matrix of this node from the already resolved world
+     * matrix of its parent, without recursing through the hierarchy.
+     *
+     * @param parentWorld The world matrix of the parent, or NULL if the node has no parent.
+     */
+    void updateWorldMatrix(const Matrix* parentWorld) const;
+
+    /**
+     * Computes the world-space bounding sphere of this node alone, without its children.
+     *
+     * @param sphere The sphere to store the bounds in.
+     *
+     * @return False if the node has no bounds of its own, in which case the sphere
+     *      is set to the world translation of the node with a zero radius.
+     */
+    bool computeBoundingSphere(BoundingSphere* sphere) const;
+
     /**
      * Returns the first child node that matches the given ID.
      *
@@ -752,6 +775,14 @@ protected:
     mutable BoundingSphere _bounds;
     /** The dirty bits used for optimization. */
     mutable int _dirtyBits;
+    /** The flat transform hierarchy of the scene this node is in, if enabled. */
+    TransformHierarchy* _transformHierarchy;
+    /** The index of this node in the flat transform hierarchy. */
+    int _transformIndex;
+    /** The spatial index of the scene this node is in, if the node is indexed. */
+    SpatialIndex* _spatialIndex;
+    /** The leaf of this node in the spatial index. */
+    int _spatialProxy;
 };
 
 /**
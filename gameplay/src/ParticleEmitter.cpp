@@ -9,13 +9,86 @@
 #define PARTICLE_COUNT_MAX                       100
 #define PARTICLE_EMISSION_RATE                   10
 #define PARTICLE_EMISSION_RATE_TIME_INTERVAL     1.0f / (float)PARTICLE_EMISSION_RATE
-#define PARTICLE_UPDATE_RATE_MAX                 8
+#define PARTICLE_UPDATE_RATE_MAX                 0.008f
+#define PARTICLE_FLOAT_ARRAY_COUNT               34
+
+// The number of emitters updated by a single job.
+#define PARTICLE_EMITTER_GRAIN_SIZE              4
+
+#if defined(GP_USE_NEON)
+#include <arm_neon.h>
+#elif defined(GP_USE_SSE)
+#include <xmmintrin.h>
+#endif
 
 namespace gameplay
 {
 
+// Computes dst += src * dt over count particles.
+static void integrate(float* dst, const float* src, float dt, unsigned int count)
+{
+    unsigned int i = 0;
+#if defined(GP_USE_NEON)
+    float32x4_t t = vdupq_n_f32(dt);
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), t));
+    }
+#elif defined(GP_USE_SSE)
+    __m128 t = _mm_set1_ps(dt);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), t)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] += src[i] * dt;
+    }
+}
+
+// Computes dst = start + (end - start) * t over count particles.
+static void interpolate(float* dst, const float* start, const float* end, const float* t, unsigned int count)
+{
+    unsigned int i = 0;
+#if defined(GP_USE_NEON)
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t s = vld1q_f32(start + i);
+        vst1q_f32(dst + i, vmlaq_f32(s, vsubq_f32(vld1q_f32(end + i), s), vld1q_f32(t + i)));
+    }
+#elif defined(GP_USE_SSE)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 s = _mm_loadu_ps(start + i);
+        _mm_storeu_ps(dst + i, _mm_add_ps(s, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(end + i), s), _mm_loadu_ps(t + i))));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = start[i] + (end[i] - start[i]) * t[i];
+    }
+}
+
+// Computes percent = 1 - energy / energyStart over count particles.
+static void lifePercent(float* percent, const float* energy, const float* energyStart, unsigned int count)
+{
+    unsigned int i = 0;
+#if defined(GP_USE_SSE)
+    __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(percent + i, _mm_sub_ps(one, _mm_div_ps(_mm_loadu_ps(energy + i), _mm_loadu_ps(energyStart + i))));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        percent[i] = 1.0f - energy[i] / energyStart[i];
+    }
+}
+
 ParticleEmitter::ParticleEmitter(unsigned int particleCountMax) : Drawable(),
-    _particleCountMax(particleCountMax), _particleCount(0), _particles(NULL),
+    _particleCountMax(particleCountMax), _particleCount(0), _particleData(NULL), _particleStride(0),
     _emissionRate(PARTICLE_EMISSION_RATE), _started(false), _ellipsoid(false),
     _sizeStartMin(1.0f), _sizeStartMax(1.0f), _sizeEndMin(1.0f), _sizeEndMax(1.0f),
     _energyMin(1.0f), _energyMax(1.0f),
@@ -29,19 +102,63 @@ ParticleEmitter::ParticleEmitter(unsigned int particleCountMax) : Drawable(),
     _spriteBatch(NULL), _spriteBlendMode(BLEND_ALPHA),  _spriteTextureWidth(0), _spriteTextureHeight(0), _spriteTextureWidthRatio(0), _spriteTextureHeightRatio(0), _spriteTextureCoords(NULL),
     _spriteAnimated(false),  _spriteLooped(false), _spriteFrameCount(1), _spriteFrameRandomOffset(0),_spriteFrameDuration(0L), _spriteFrameDurationSecs(0.0f), _spritePercentPerFrame(0.0f),
     _orbitPosition(false), _orbitVelocity(false), _orbitAcceleration(false),
-    _timePerEmission(PARTICLE_EMISSION_RATE_TIME_INTERVAL), _emitTime(0), _lastUpdated(0)
+    _timePerEmission(PARTICLE_EMISSION_RATE_TIME_INTERVAL), _emitTime(0), _updateTime(0)
 {
     GP_ASSERT(particleCountMax);
-    _particles = new Particle[particleCountMax];
+    allocateParticles(particleCountMax);
 }
 
 ParticleEmitter::~ParticleEmitter()
 {
     SAFE_DELETE(_spriteBatch);
-    SAFE_DELETE_ARRAY(_particles);
+    SAFE_DELETE_ARRAY(_particleData);
+    SAFE_DELETE_ARRAY(_particles._frame);
     SAFE_DELETE_ARRAY(_spriteTextureCoords);
 }
 
+void ParticleEmitter::allocateParticles(unsigned int particleCountMax)
+{
+    // Round each array up to a multiple of four floats so four-float blocks never straddle two arrays.
+    // new float[] is not guaranteed to be 16-byte aligned, so the kernels use unaligned loads and stores.
+    _particleStride = (particleCountMax + 3) & ~3u;
+    _particleData = new float[_particleStride * PARTICLE_FLOAT_ARRAY_COUNT];
+    memset(_particleData, 0, _particleStride * PARTICLE_FLOAT_ARRAY_COUNT * sizeof(float));
+
+    float** arrays[PARTICLE_FLOAT_ARRAY_COUNT] =
+    {
+        &_particles._positionX, &_particles._positionY, &_particles._positionZ,
+        &_particles._velocityX, &_particles._velocityY, &_particles._velocityZ,
+        &_particles._accelerationX, &_particles._accelerationY, &_particles._accelerationZ,
+        &_particles._colorStartR, &_particles._colorStartG, &_particles._colorStartB, &_particles._colorStartA,
+        &_particles._colorEndR, &_particles._colorEndG, &_particles._colorEndB, &_particles._colorEndA,
+        &_particles._colorR, &_particles._colorG, &_particles._colorB, &_particles._colorA,
+        &_particles._rotationPerParticleSpeed,
+        &_particles._rotationAxisX, &_particles._rotationAxisY, &_particles._rotationAxisZ,
+        &_particles._rotationSpeed, &_particles._angle,
+        &_particles._energyStart, &_particles._energy,
+        &_particles._sizeStart, &_particles._sizeEnd, &_particles._size,
+        &_particles._timeOnCurrentFrame, &_particles._percent
+    };
+    for (unsigned int i = 0; i < PARTICLE_FLOAT_ARRAY_COUNT; ++i)
+    {
+        *arrays[i] = _particleData + i * _particleStride;
+    }
+
+    _particles._frame = new unsigned int[particleCountMax];
+    memset(_particles._frame, 0, particleCountMax * sizeof(unsigned int));
+}
+
+void ParticleEmitter::moveParticle(unsigned int dst, unsigned int src)
+{
+    // _percent is scratch space that is recomputed every update, so it is not copied.
+    for (unsigned int i = 0; i < PARTICLE_FLOAT_ARRAY_COUNT - 1; ++i)
+    {
+        float* array = _particleData + i * _particleStride;
+        array[dst] = array[src];
+    }
+    _particles._frame[dst] = _particles._frame[src];
+}
+
 ParticleEmitter* ParticleEmitter::create(const char* textureFile, BlendMode blendMode, unsigned int particleCountMax)
 {
     Texture* texture = Texture::create(textureFile, true);
@@ -250,7 +367,27 @@ Texture* ParticleEmitter::getTexture() const
 
 void ParticleEmitter::setParticleCountMax(unsigned int max)
 {
+    GP_ASSERT(max);
+    if (max == _particleCountMax)
+        return;
+
+    // Reallocate the arrays at the new stride and keep as many living particles as fit.
+    float* data = _particleData;
+    unsigned int* frame = _particles._frame;
+    unsigned int stride = _particleStride;
+    unsigned int count = std::min(_particleCount, max);
+
+    allocateParticles(max);
+    for (unsigned int i = 0; i < PARTICLE_FLOAT_ARRAY_COUNT; ++i)
+    {
+        memcpy(_particleData + i * _particleStride, data + i * stride, count * sizeof(float));
+    }
+    memcpy(_particles._frame, frame, count * sizeof(unsigned int));
+    SAFE_DELETE_ARRAY(data);
+    SAFE_DELETE_ARRAY(frame);
+
     _particleCountMax = max;
+    _particleCount = count;
 }
 
 unsigned int ParticleEmitter::getParticleCountMax() const
@@ -273,7 +410,7 @@ void ParticleEmitter::setEmissionRate(unsigned int rate)
 void ParticleEmitter::start()
 {
     _started = true;
-    _lastUpdated = 0;
+    _updateTime = 0;
 }
 
 void ParticleEmitter::stop()
@@ -300,7 +437,7 @@ bool ParticleEmitter::isActive() const
 void ParticleEmitter::emitOnce(unsigned int particleCount)
 {
     GP_ASSERT(_node);
-    GP_ASSERT(_particles);
+    GP_ASSERT(_particleData);
 
     // Limit particleCount so as not to go over _particleCountMax.
     if (particleCount + _particleCount > _particleCountMax)
@@ -318,63 +455,90 @@ void ParticleEmitter::emitOnce(unsigned int particleCount)
     world.m[14] = 0.0f;
 
     // Emit the new particles.
+    ParticleArrays& p = _particles;
     for (unsigned int i = 0; i < particleCount; i++)
     {
-        Particle* p = &_particles[_particleCount];
-
-        generateColor(_colorStart, _colorStartVar, &p->_colorStart);
-        generateColor(_colorEnd, _colorEndVar, &p->_colorEnd);
-        p->_color.set(p->_colorStart);
-
-        p->_energy = p->_energyStart = generateScalar(_energyMin, _energyMax);
-        p->_size = p->_sizeStart = generateScalar(_sizeStartMin, _sizeStartMax);
-        p->_sizeEnd = generateScalar(_sizeEndMin, _sizeEndMax);
-        p->_rotationPerParticleSpeed = generateScalar(_rotationPerParticleSpeedMin, _rotationPerParticleSpeedMax);
-        p->_angle = generateScalar(0.0f, p->_rotationPerParticleSpeed);
-        p->_rotationSpeed = generateScalar(_rotationSpeedMin, _rotationSpeedMax);
+        unsigned int index = _particleCount;
+
+        Vector4 colorStart;
+        Vector4 colorEnd;
+        generateColor(_colorStart, _colorStartVar, &colorStart);
+        generateColor(_colorEnd, _colorEndVar, &colorEnd);
+        p._colorStartR[index] = p._colorR[index] = colorStart.x;
+        p._colorStartG[index] = p._colorG[index] = colorStart.y;
+        p._colorStartB[index] = p._colorB[index] = colorStart.z;
+        p._colorStartA[index] = p._colorA[index] = colorStart.w;
+        p._colorEndR[index] = colorEnd.x;
+        p._colorEndG[index] = colorEnd.y;
+        p._colorEndB[index] = colorEnd.z;
+        p._colorEndA[index] = colorEnd.w;
+
+        p._energy[index] = p._energyStart[index] = generateScalar(_energyMin, _energyMax);
+        p._size[index] = p._sizeStart[index] = generateScalar(_sizeStartMin, _sizeStartMax);
+        p._sizeEnd[index] = generateScalar(_sizeEndMin, _sizeEndMax);
+        p._rotationPerParticleSpeed[index] = generateScalar(_rotationPerParticleSpeedMin, _rotationPerParticleSpeedMax);
+        p._angle[index] = generateScalar(0.0f, p._rotationPerParticleSpeed[index]);
+        p._rotationSpeed[index] = generateScalar(_rotationSpeedMin, _rotationSpeedMax);
 
         // Only initial position can be generated within an ellipsoidal domain.
-        generateVector(_position, _positionVar, &p->_position, _ellipsoid);
-        generateVector(_velocity, _velocityVar, &p->_velocity, false);
-        generateVector(_acceleration, _accelerationVar, &p->_acceleration, false);
-        generateVector(_rotationAxis, _rotationAxisVar, &p->_rotationAxis, false);
+        Vector3 position;
+        Vector3 velocity;
+        Vector3 acceleration;
+        Vector3 rotationAxis;
+        generateVector(_position, _positionVar, &position, _ellipsoid);
+        generateVector(_velocity, _velocityVar, &velocity, false);
+        generateVector(_acceleration, _accelerationVar, &acceleration, false);
+        generateVector(_rotationAxis, _rotationAxisVar, &rotationAxis, false);
 
         // Initial position, velocity and acceleration can all be relative to the emitter's transform.
         // Rotate specified properties by the node's rotation.
         if (_orbitPosition)
         {
-            world.transformPoint(p->_position, &p->_position);
+            world.transformPoint(position, &position);
         }
 
         if (_orbitVelocity)
         {
-            world.transformPoint(p->_velocity, &p->_velocity);
+            world.transformPoint(velocity, &velocity);
         }
 
         if (_orbitAcceleration)
         {
-            world.transformPoint(p->_acceleration, &p->_acceleration);
+            world.transformPoint(acceleration, &acceleration);
         }
 
         // The rotation axis always orbits the node.
-        if (p->_rotationSpeed != 0.0f && !p->_rotationAxis.isZero())
+        if (p._rotationSpeed[index] != 0.0f && !rotationAxis.isZero())
         {
-            world.transformPoint(p->_rotationAxis, &p->_rotationAxis);
+            world.transformPoint(rotationAxis, &rotationAxis);
         }
 
         // Translate position relative to the node's world space.
-        p->_position.add(translation);
+        position.add(translation);
+
+        p._positionX[index] = position.x;
+        p._positionY[index] = position.y;
+        p._positionZ[index] = position.z;
+        p._velocityX[index] = velocity.x;
+        p._velocityY[index] = velocity.y;
+        p._velocityZ[index] = velocity.z;
+        p._accelerationX[index] = acceleration.x;
+        p._accelerationY[index] = acceleration.y;
+        p._accelerationZ[index] = acceleration.z;
+        p._rotationAxisX[index] = rotationAxis.x;
+        p._rotationAxisY[index] = rotationAxis.y;
+        p._rotationAxisZ[index] = rotationAxis.z;
 
         // Initial sprite frame.
         if (_spriteFrameRandomOffset > 0)
         {
-            p->_frame = rand() % _spriteFrameRandomOffset;
+            p._frame[index] = rand() % _spriteFrameRandomOffset;
         }
         else
         {
-            p->_frame = 0;
+            p._frame[index] = 0;
         }
-        p->_timeOnCurrentFrame = 0.0f;
+        p._timeOnCurrentFrame[index] = 0.0f;
 
         ++_particleCount;
     }
@@ -864,19 +1028,17 @@ void ParticleEmitter::update(float elapsedTime)
     // Cap particle updates at a maximum rate. This saves processing
     // and also improves precision since updating with very small
     // time increments is more lossy.
-    static double runningTime = 0;
-    runningTime += elapsedTime;
-    if (runningTime < PARTICLE_UPDATE_RATE_MAX)
-        return;    
-
-    float elapsedSecs = runningTime;
-    runningTime = 0;
+    _updateTime += elapsedTime;
+    if (_updateTime < PARTICLE_UPDATE_RATE_MAX)
+        return;
 
+    float elapsedSecs = _updateTime;
+    _updateTime = 0;
 
     if (_started && _emissionRate)
     {
         // Calculate how much time has passed since we last emitted particles.
-        _emitTime += elapsedSecs; //+= elapsedTime;
+        _emitTime += elapsedSecs;
 
         // How many particles should we emit this frame?
         GP_ASSERT(_timePerEmission);
@@ -893,87 +1055,155 @@ void ParticleEmitter::update(float elapsedTime)
     }
 
     // Now update all currently living particles.
-    GP_ASSERT(_particles);
-    for (unsigned int particlesIndex = 0; particlesIndex < _particleCount; ++particlesIndex)
+    GP_ASSERT(_particleData);
+    updateParticles(elapsedSecs);
+}
+
+void ParticleEmitter::update(ParticleEmitter** emitters, unsigned int count, float elapsedTime)
+{
+    GP_ASSERT(emitters || count == 0);
+
+    // Resolve the world matrices first. Computing them lazily from several jobs
+    // would write the cached matrices of shared ancestor nodes concurrently.
+    for (unsigned int i = 0; i < count; ++i)
     {
-        Particle* p = &_particles[particlesIndex];
-        p->_energy -= elapsedSecs;
+        GP_ASSERT(emitters[i]);
+        if (emitters[i]->_node)
+            emitters[i]->_node->getWorldMatrix();
+    }
 
-        if (p->_energy > 0L)
+    JobScheduler* scheduler = Game::getInstance()->getJobScheduler();
+    if (scheduler && count > 1)
+    {
+        scheduler->parallelFor(count, PARTICLE_EMITTER_GRAIN_SIZE, [emitters, elapsedTime](unsigned int begin, unsigned int end)
         {
-            if (p->_rotationSpeed != 0.0f && !p->_rotationAxis.isZero())
+            for (unsigned int i = begin; i < end; ++i)
             {
-                Matrix::createRotation(p->_rotationAxis, p->_rotationSpeed * elapsedSecs, &_rotation);
-
-                _rotation.transformPoint(p->_velocity, &p->_velocity);
-                _rotation.transformPoint(p->_acceleration, &p->_acceleration);
+                emitters[i]->update(elapsedTime);
             }
+        }, "ParticleEmitter::update");
+    }
+    else
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            emitters[i]->update(elapsedTime);
+        }
+    }
+}
 
-            // Particle is still alive.
-            p->_velocity.x += p->_acceleration.x * elapsedSecs;
-            p->_velocity.y += p->_acceleration.y * elapsedSecs;
-            p->_velocity.z += p->_acceleration.z * elapsedSecs;
-
-            p->_position.x += p->_velocity.x * elapsedSecs;
-            p->_position.y += p->_velocity.y * elapsedSecs;
-            p->_position.z += p->_velocity.z * elapsedSecs;
+void ParticleEmitter::updateParticles(float elapsedSecs)
+{
+    ParticleArrays& p = _particles;
 
-            p->_angle += p->_rotationPerParticleSpeed * elapsedSecs;
+    // Age particles and remove the dead ones. Move the particle furthest from the start
+    // of the arrays down to take the place of a dead one, and re-use the slot at the end
+    // of the list of living particles.
+    for (unsigned int i = 0; i < _particleCount; )
+    {
+        p._energy[i] -= elapsedSecs;
+        if (p._energy[i] > 0.0f)
+        {
+            ++i;
+            continue;
+        }
 
-            // Simple linear interpolation of color and size.
-            float percent = 1.0f - ((float)p->_energy / (float)p->_energyStart);
+        --_particleCount;
+        if (i != _particleCount)
+        {
+            // The moved particle has not been aged yet, so stay on this index.
+            moveParticle(i, _particleCount);
+        }
+    }
 
-            p->_color.x = p->_colorStart.x + (p->_colorEnd.x - p->_colorStart.x) * percent;
-            p->_color.y = p->_colorStart.y + (p->_colorEnd.y - p->_colorStart.y) * percent;
-            p->_color.z = p->_colorStart.z + (p->_colorEnd.z - p->_colorStart.z) * percent;
-            p->_color.w = p->_colorStart.w + (p->_colorEnd.w - p->_colorStart.w) * percent;
+    const unsigned int count = _particleCount;
+    if (count == 0)
+        return;
 
-            p->_size = p->_sizeStart + (p->_sizeEnd - p->_sizeStart) * percent;
+    // Rotate velocity and acceleration around each particle's rotation axis. Skipped
+    // entirely when the emitter generates no rotation speed.
+    if (_rotationSpeedMin != 0.0f || _rotationSpeedMax != 0.0f)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            if (p._rotationSpeed[i] == 0.0f)
+                continue;
+
+            Vector3 axis(p._rotationAxisX[i], p._rotationAxisY[i], p._rotationAxisZ[i]);
+            if (axis.isZero())
+                continue;
+
+            Matrix::createRotation(axis, p._rotationSpeed[i] * elapsedSecs, &_rotation);
+
+            Vector3 velocity(p._velocityX[i], p._velocityY[i], p._velocityZ[i]);
+            Vector3 acceleration(p._accelerationX[i], p._accelerationY[i], p._accelerationZ[i]);
+            _rotation.transformPoint(&velocity);
+            _rotation.transformPoint(&acceleration);
+            p._velocityX[i] = velocity.x;
+            p._velocityY[i] = velocity.y;
+            p._velocityZ[i] = velocity.z;
+            p._accelerationX[i] = acceleration.x;
+            p._accelerationY[i] = acceleration.y;
+            p._accelerationZ[i] = acceleration.z;
+        }
+    }
 
-            // Handle sprite animations.
-            if (_spriteAnimated)
+    // The kernels below touch one or two components each and have no dependencies
+    // between particles, so they run four particles at a time with SSE/NEON.
+    integrate(p._velocityX, p._accelerationX, elapsedSecs, count);
+    integrate(p._velocityY, p._accelerationY, elapsedSecs, count);
+    integrate(p._velocityZ, p._accelerationZ, elapsedSecs, count);
+    integrate(p._positionX, p._velocityX, elapsedSecs, count);
+    integrate(p._positionY, p._velocityY, elapsedSecs, count);
+    integrate(p._positionZ, p._velocityZ, elapsedSecs, count);
+    integrate(p._angle, p._rotationPerParticleSpeed, elapsedSecs, count);
+
+    // Simple linear interpolation of color and size.
+    float* percent = p._percent;
+    lifePercent(percent, p._energy, p._energyStart, count);
+
+    interpolate(p._colorR, p._colorStartR, p._colorEndR, percent, count);
+    interpolate(p._colorG, p._colorStartG, p._colorEndG, percent, count);
+    interpolate(p._colorB, p._colorStartB, p._colorEndB, percent, count);
+    interpolate(p._colorA, p._colorStartA, p._colorEndA, percent, count);
+    interpolate(p._size, p._sizeStart, p._sizeEnd, percent, count);
+
+    // Handle sprite animations.
+    if (_spriteAnimated)
+    {
+        if (!_spriteLooped)
+        {
+            // The last frame should finish exactly when the particle dies. Frames never
+            // move backwards, so particles starting at a random offset hold that frame
+            // until their lifetime catches up with it.
+            const unsigned int lastFrame = _spriteFrameCount - 1;
+            for (unsigned int i = 0; i < count; ++i)
             {
-                if (!_spriteLooped)
-                {
-                    // The last frame should finish exactly when the particle dies.
-                    float percentSpent = 0.0f;
-                    for (unsigned int i = 0; i < p->_frame; i++)
-                    {
-                        percentSpent += _spritePercentPerFrame;
-                    }
-                    p->_timeOnCurrentFrame = percent - percentSpent;
-                    if (p->_frame < _spriteFrameCount - 1 &&
-                        p->_timeOnCurrentFrame >= _spritePercentPerFrame)
-                    {
-                        ++p->_frame;
-                    }
-                }
-                else
-                {
-                    // _spriteFrameDurationSecs is an absolute time measured in seconds,
-                    // and the animation repeats indefinitely.
-                    p->_timeOnCurrentFrame += elapsedSecs;
-                    if (p->_timeOnCurrentFrame >= _spriteFrameDurationSecs)
-                    {
-                        p->_timeOnCurrentFrame -= _spriteFrameDurationSecs;
-                        ++p->_frame;
-                        if (p->_frame == _spriteFrameCount)
-                        {
-                            p->_frame = 0;
-                        }
-                    }
-                }
+                unsigned int frame = percent[i] > 0.0f ? (unsigned int)(percent[i] * _spriteFrameCount) : 0;
+                if (frame > lastFrame)
+                    frame = lastFrame;
+                if (frame > p._frame[i])
+                    p._frame[i] = frame;
+                p._timeOnCurrentFrame[i] = percent[i] - p._frame[i] * _spritePercentPerFrame;
             }
         }
         else
         {
-            // Particle is dead.  Move the particle furthest from the start of the array
-            // down to take its place, and re-use the slot at the end of the list of living particles.
-            if (particlesIndex != _particleCount - 1)
+            // _spriteFrameDurationSecs is an absolute time measured in seconds,
+            // and the animation repeats indefinitely.
+            for (unsigned int i = 0; i < count; ++i)
             {
-                _particles[particlesIndex] = _particles[_particleCount - 1];
+                p._timeOnCurrentFrame[i] += elapsedSecs;
+                if (p._timeOnCurrentFrame[i] >= _spriteFrameDurationSecs)
+                {
+                    p._timeOnCurrentFrame[i] -= _spriteFrameDurationSecs;
+                    ++p._frame[i];
+                    if (p._frame[i] == _spriteFrameCount)
+                    {
+                        p._frame[i] = 0;
+                    }
+                }
             }
-            --_particleCount;
         }
     }
 }
@@ -986,7 +1216,7 @@ unsigned int ParticleEmitter::draw(bool wireframe) const
     if (_particleCount > 0)
     {
         GP_ASSERT(_spriteBatch);
-        GP_ASSERT(_particles);
+        GP_ASSERT(_particleData);
         GP_ASSERT(_spriteTextureCoords);
 
         // Set our node's view projection matrix to this emitter's effect.
@@ -1010,13 +1240,16 @@ unsigned int ParticleEmitter::draw(bool wireframe) const
         Vector3 up;
         cameraWorldMatrix.getUpVector(&up);
 
+        const ParticleArrays& p = _particles;
         for (unsigned int i = 0; i < _particleCount; i++)
         {
-            Particle* p = &_particles[i];
+            Vector3 position(p._positionX[i], p._positionY[i], p._positionZ[i]);
+            Vector4 color(p._colorR[i], p._colorG[i], p._colorB[i], p._colorA[i]);
+            const float* texCoords = &_spriteTextureCoords[p._frame[i] * 4];
 
-            _spriteBatch->draw(p->_position, right, up, p->_size, p->_size,
-                                _spriteTextureCoords[p->_frame * 4], _spriteTextureCoords[p->_frame * 4 + 1], _spriteTextureCoords[p->_frame * 4 + 2], _spriteTextureCoords[p->_frame * 4 + 3],
-                                p->_color, pivot, p->_angle);
+            _spriteBatch->draw(position, right, up, p._size[i], p._size[i],
+                                texCoords[0], texCoords[1], texCoords[2], texCoords[3],
+                                color, pivot, p._angle[i]);
         }
 
         // Render.
@@ -219,6 +219,8 @@ public:
     /**
      * Sets the maximum number of particles that can be emitted.
      *
+     * Living particles that do not fit in the new maximum are discarded.
+     *
      * @param max The maximum number of particles that can be emitted.
      */
     void setParticleCountMax(unsigned int max);
@@ -707,6 +709,20 @@ public:
      */
     void update(float elapsedTime);
 
+    /**
+     * Updates a set of particle emitters, running them concurrently on the game's
+     * JobScheduler when one is available.
+     *
+     * Each emitter must appear only once, and the emitters and their nodes must not
+     * be modified by other threads until this returns.
+     *
+     * @param emitters The emitters to update.
+     * @param count The number of emitters.
+     * @param elapsedTime The amount of time that has passed since the last call to update(), in seconds.
+     * @script{ignore}
+     */
+    static void update(ParticleEmitter** emitters, unsigned int count, float elapsedTime);
+
     /**
      * @see Drawable::draw
      *
@@ -766,34 +782,74 @@ private:
     static ParticleEmitter::BlendMode getBlendModeFromString(const char* src);
 
     /**
-     * Defines the data for a single particle in the system.
+     * Allocates storage for the given maximum number of particles.
+     */
+    void allocateParticles(unsigned int particleCountMax);
+
+    /**
+     * Copies the particle at index src over the particle at index dst.
+     */
+    void moveParticle(unsigned int dst, unsigned int src);
+
+    /**
+     * Advances all living particles by the given time step.
+     */
+    void updateParticles(float elapsedSecs);
+
+    /**
+     * Defines the data for the particles in the system.
+     *
+     * Particles are stored as a structure of arrays, one array per component,
+     * so each stage of the simulation streams through contiguous memory and
+     * the compiler can vectorize the per-component loops. All float arrays
+     * point into a single allocation.
      */
-    class Particle
+    class ParticleArrays
     {
 
     public:
-        Vector3 _position;
-        Vector3 _velocity;
-        Vector3 _acceleration;
-        Vector4 _colorStart;
-        Vector4 _colorEnd;
-        Vector4 _color;
-        float _rotationPerParticleSpeed;
-        Vector3 _rotationAxis;
-        float _rotationSpeed;
-        float _angle;
-        long _energyStart;
-        long _energy;
-        float _sizeStart;
-        float _sizeEnd;
-        float _size;
-        unsigned int _frame;
-        float _timeOnCurrentFrame;
+        float* _positionX;
+        float* _positionY;
+        float* _positionZ;
+        float* _velocityX;
+        float* _velocityY;
+        float* _velocityZ;
+        float* _accelerationX;
+        float* _accelerationY;
+        float* _accelerationZ;
+        float* _colorStartR;
+        float* _colorStartG;
+        float* _colorStartB;
+        float* _colorStartA;
+        float* _colorEndR;
+        float* _colorEndG;
+        float* _colorEndB;
+        float* _colorEndA;
+        float* _colorR;
+        float* _colorG;
+        float* _colorB;
+        float* _colorA;
+        float* _rotationPerParticleSpeed;
+        float* _rotationAxisX;
+        float* _rotationAxisY;
+        float* _rotationAxisZ;
+        float* _rotationSpeed;
+        float* _angle;
+        float* _energyStart;
+        float* _energy;
+        float* _sizeStart;
+        float* _sizeEnd;
+        float* _size;
+        float* _timeOnCurrentFrame;
+        float* _percent;
+        unsigned int* _frame;
     };
 
     unsigned int _particleCountMax;
     unsigned int _particleCount;
-    Particle* _particles;
+    float* _particleData;
+    unsigned int _particleStride;
+    ParticleArrays _particles;
     unsigned int _emissionRate;
     bool _started;
     bool _ellipsoid;
@@ -839,7 +895,7 @@ private:
     bool _orbitAcceleration;
     float _timePerEmission;
     float _emitTime;
-    double _lastUpdated;
+    float _updateTime;
 };
 
 }
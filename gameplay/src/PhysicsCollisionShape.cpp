@@ -26,11 +26,21 @@ PhysicsCollisionShape::~PhysicsCollisionShape()
         case SHAPE_MESH:
             if (_shapeData.meshData)
             {
-                SAFE_DELETE_ARRAY(_shapeData.meshData->vertexData);
-                for (unsigned int i = 0; i < _shapeData.meshData->indexData.size(); i++)
+                // Cooked vertex and index data belong to the mapping of the cooked file.
+                if (_shapeData.meshData->cookedData)
                 {
-                    SAFE_DELETE_ARRAY(_shapeData.meshData->indexData[i]);
+                    FileSystem::unmapFile(_shapeData.meshData->cookedData, _shapeData.meshData->cookedSize);
                 }
+                else
+                {
+                    SAFE_DELETE_ARRAY(_shapeData.meshData->vertexData);
+                    for (unsigned int i = 0; i < _shapeData.meshData->indexData.size(); i++)
+                    {
+                        SAFE_DELETE_ARRAY(_shapeData.meshData->indexData[i]);
+                    }
+                }
+                if (_shapeData.meshData->bvhData)
+                    btAlignedFree(_shapeData.meshData->bvhData);
                 SAFE_DELETE(_shapeData.meshData);
             }
 
@@ -241,6 +241,12 @@ private:
     {
         float* vertexData;
         std::vector<unsigned char*> indexData;
+        std::string url;            // URL of the mesh the shape was built from
+        Vector3 scale;              // scale baked into the vertex data
+        bool dynamic;               // whether the shape is a convex hull
+        const char* cookedData;     // mapped cooked file the vertex and index data point into, or NULL
+        size_t cookedSize;
+        void* bvhData;              // aligned buffer holding a cooked BVH, or NULL
     };
 
     struct HeightfieldData
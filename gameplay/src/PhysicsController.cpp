@@ -19,10 +19,27 @@
 // The initial capacity of the Bullet debug drawer's vertex batch.
 #define INITIAL_CAPACITY 280
 
+// The step length of simulate() when no fixed time step is set, which is Bullet's internal step length.
+#define DEFAULT_FIXED_TIME_STEP (1.0f / 60.0f)
+
+// The number of batched ray or sweep tests each job runs.
+#define QUERY_GRAIN_SIZE 64
+
+// Cooked mesh collision shapes, in native byte order:
+//   identifier padded to 12 bytes, version, bundle hash, dynamic, vertex count, part count, BVH offset, BVH size
+//   parts: index type, triangle stride, triangle count, vertex count, index offset, index size
+//   scaled vertex positions, then the index data of each part, each padded to 4 bytes
+//   serialized BVH of static shapes, aligned to 16 bytes
+// Dynamic shapes store the points of their convex hull as the vertices and have no parts.
+#define COOKED_SHAPE_IDENTIFIER "\xABGPC\xBB\r\n\x1A\n"
+#define COOKED_SHAPE_IDENTIFIER_SIZE 9
+#define COOKED_SHAPE_VERSION 2
+#define COOKED_SHAPE_HEADER_SIZE (12 + 7 * sizeof(unsigned int))
+#define COOKED_SHAPE_PART_WORDS 6
+
 namespace gameplay
 {
 
-const int PhysicsController::DIRTY         = 0x01;
 const int PhysicsController::COLLISION     = 0x02;
 const int PhysicsController::REGISTERED    = 0x04;
 const int PhysicsController::REMOVE        = 0x08;
@@ -31,17 +48,23 @@ PhysicsController::PhysicsController()
   : _isUpdating(false), _collisionConfiguration(NULL), _dispatcher(NULL),
     _overlappingPairCache(NULL), _solver(NULL), _world(NULL), _ghostPairCallback(NULL),
     _debugDrawer(NULL), _status(PhysicsController::Listener::DEACTIVATED), _listeners(NULL),
-    _gravity(btScalar(0.0), btScalar(-9.8), btScalar(0.0)), _collisionCallback(NULL)
+    _gravity(btScalar(0.0), btScalar(-9.8), btScalar(0.0)), _activeObjectHint(0), _collisionStep(0),
+    _fixedTimeStep(0.0f), _maxSubSteps(10), _interpolation(true), _accumulatedTime(0.0)
 {
     GP_REGISTER_SCRIPT_EVENTS();
-
-    // Default gravity is 9.8 along the negative Y axis.
-    _collisionCallback = new CollisionCallback(this);
+    resetStatistics();
 }
 
 PhysicsController::~PhysicsController()
 {
-    SAFE_DELETE(_collisionCallback);
+    for (CollisionStatusMap::iterator iter = _collisionStatus.begin(); iter != _collisionStatus.end(); ++iter)
+    {
+        SAFE_DELETE(iter->second);
+    }
+    for (size_t i = 0; i < _freeCollisionInfos.size(); ++i)
+    {
+        SAFE_DELETE(_freeCollisionInfos[i]);
+    }
     SAFE_DELETE(_ghostPairCallback);
     SAFE_DELETE(_debugDrawer);
     SAFE_DELETE(_listeners);
@@ -147,6 +170,62 @@ PhysicsSpringConstraint* PhysicsController::createSpringConstraint(PhysicsRigidB
     return constraint;
 }
 
+const char* PhysicsController::getCookedShapePath() const
+{
+    return _cookedShapePath.c_str();
+}
+
+void PhysicsController::setCookedShapePath(const char* path)
+{
+    _cookedShapePath = path ? path : "";
+    if (!_cookedShapePath.empty() && !FileSystem::createDirectory(_cookedShapePath.c_str()))
+        GP_WARN("Failed to create the cooked collision shape directory '%s'.", _cookedShapePath.c_str());
+}
+
+float PhysicsController::getFixedTimeStep() const
+{
+    return _fixedTimeStep;
+}
+
+void PhysicsController::setFixedTimeStep(float step)
+{
+    _fixedTimeStep = step > 0.0f ? step : 0.0f;
+    _accumulatedTime = 0.0;
+}
+
+unsigned int PhysicsController::getMaxSubSteps() const
+{
+    return _maxSubSteps;
+}
+
+void PhysicsController::setMaxSubSteps(unsigned int count)
+{
+    _maxSubSteps = count > 0 ? count : 1;
+}
+
+bool PhysicsController::isInterpolation() const
+{
+    return _interpolation;
+}
+
+void PhysicsController::setInterpolation(bool interpolation)
+{
+    _interpolation = interpolation;
+}
+
+const PhysicsController::Statistics& PhysicsController::getStatistics() const
+{
+    return _statistics;
+}
+
+void PhysicsController::resetStatistics()
+{
+    _statistics.steps = 0;
+    _statistics.lastStepTime = 0.0f;
+    _statistics.maxStepTime = 0.0f;
+    _statistics.totalStepTime = 0.0f;
+}
+
 const Vector3& PhysicsController::getGravity() const
 {
     return _gravity;
@@ -304,19 +383,7 @@ bool PhysicsController::sweepTest(PhysicsCollisionObject* object, const Vector3&
 
     // Define the start transform.
     btTransform start;
-    start.setIdentity();
-    if (object->getNode())
-    {
-        Vector3 translation;
-        Quaternion rotation;
-        const Matrix& m = object->getNode()->getWorldMatrix();
-        m.getTranslation(&translation);
-        m.getRotation(&rotation);
-
-        start.setIdentity();
-        start.setOrigin(BV(translation));
-        start.setRotation(BQ(rotation));
-    }
+    getSweepStart(object, &start);
 
     // Define the end transform.
     btTransform end(start);
@@ -360,77 +427,242 @@ bool PhysicsController::sweepTest(PhysicsCollisionObject* object, const Vector3&
     return false;
 }
 
-btScalar PhysicsController::CollisionCallback::addSingleResult(btManifoldPoint& cp, const btCollisionObjectWrapper* a, int partIdA, int indexA, 
-    const btCollisionObjectWrapper* b, int partIdB, int indexB)
+void PhysicsController::getSweepStart(PhysicsCollisionObject* object, btTransform* start)
 {
-    GP_ASSERT(_pc);
+    GP_ASSERT(object);
+    GP_ASSERT(start);
 
-    // Get pointers to the PhysicsCollisionObject objects.
-    PhysicsCollisionObject* objectA = _pc->getCollisionObject(a->m_collisionObject);
-    PhysicsCollisionObject* objectB = _pc->getCollisionObject(b->m_collisionObject);
+    start->setIdentity();
+    if (object->getNode())
+    {
+        Vector3 translation;
+        Quaternion rotation;
+        const Matrix& m = object->getNode()->getWorldMatrix();
+        m.getTranslation(&translation);
+        m.getRotation(&rotation);
 
-    // If the given collision object pair has collided in the past, then
-    // we notify the listeners only if the pair was not colliding
-    // during the previous frame. Otherwise, it's a new pair, so add a
-    // new entry to the cache with the appropriate listeners and notify them.
-    PhysicsCollisionObject::CollisionPair pair(objectA, objectB);
+        start->setOrigin(BV(translation));
+        start->setRotation(BQ(rotation));
+    }
+}
 
-    CollisionInfo* collisionInfo;
-    if (_pc->_collisionStatus.count(pair) > 0)
+/**
+ * Tests a ray against the objects in the leaves of a broadphase tree.
+ *
+ * btDbvtBroadphase::rayTest() shares a traversal stack between calls, so batched
+ * queries walk the trees with btDbvt's own traversals instead, which keep their
+ * state on the stack and only read the world.
+ */
+struct BatchRayTester : public btDbvt::ICollide
+{
+    BatchRayTester(const btTransform& from, const btTransform& to, int mask, btCollisionWorld::ClosestRayResultCallback& callback)
+        : from(from), to(to), mask(mask), callback(callback)
     {
-        collisionInfo = &_pc->_collisionStatus[pair];
     }
-    else
+
+    void Process(const btDbvtNode* leaf)
     {
-        // Add a new collision pair for these objects.
-        collisionInfo = &_pc->_collisionStatus[pair];
+        btBroadphaseProxy* proxy = (btBroadphaseProxy*)leaf->data;
+        btCollisionObject* co = (btCollisionObject*)proxy->m_clientObject;
+        if ((proxy->m_collisionFilterGroup & mask) != 0 && co->getUserPointer())
+            btCollisionWorld::rayTestSingle(from, to, co, co->getCollisionShape(), co->getWorldTransform(), callback);
+    }
 
-        // Add the appropriate listeners.
-        PhysicsCollisionObject::CollisionPair p1(pair.objectA, NULL);
-        if (_pc->_collisionStatus.count(p1) > 0)
-        {
-            const CollisionInfo& ci = _pc->_collisionStatus[p1];
-            std::vector<PhysicsCollisionObject::CollisionListener*>::const_iterator iter = ci._listeners.begin();
-            for (; iter != ci._listeners.end(); iter++)
-            {
-                GP_ASSERT(*iter);
-                collisionInfo->_listeners.push_back(*iter);
-            }
-        }
-        PhysicsCollisionObject::CollisionPair p2(pair.objectB, NULL);
-        if (_pc->_collisionStatus.count(p2) > 0)
+    const btTransform& from;
+    const btTransform& to;
+    int mask;
+    btCollisionWorld::ClosestRayResultCallback& callback;
+};
+
+/**
+ * Tests a convex sweep against the objects in the leaves of a broadphase tree.
+ */
+struct BatchSweepTester : public btDbvt::ICollide
+{
+    BatchSweepTester(const btConvexShape* shape, const btTransform& from, const btTransform& to, const btCollisionObject* me, int mask,
+                     btScalar allowedPenetration, btCollisionWorld::ClosestConvexResultCallback& callback)
+        : shape(shape), from(from), to(to), me(me), mask(mask), allowedPenetration(allowedPenetration), callback(callback)
+    {
+    }
+
+    void Process(const btDbvtNode* leaf)
+    {
+        btBroadphaseProxy* proxy = (btBroadphaseProxy*)leaf->data;
+        btCollisionObject* co = (btCollisionObject*)proxy->m_clientObject;
+        if ((proxy->m_collisionFilterGroup & mask) != 0 && co != me && co->getUserPointer())
+            btCollisionWorld::objectQuerySingle(shape, from, to, co, co->getCollisionShape(), co->getWorldTransform(), callback, allowedPenetration);
+    }
+
+    const btConvexShape* shape;
+    const btTransform& from;
+    const btTransform& to;
+    const btCollisionObject* me;
+    int mask;
+    btScalar allowedPenetration;
+    btCollisionWorld::ClosestConvexResultCallback& callback;
+};
+
+/**
+ * A dynamics world that can take fixed steps one at a time.
+ *
+ * btDiscreteDynamicsWorld::stepSimulation() clears the forces applied to the bodies and
+ * writes their motion states after every call, so calling it once per fixed step applies
+ * forces in the first step only and moves the nodes in every step. Between beginSteps()
+ * and endSteps(), forces and gravity last for all the steps, as they do for Bullet's own
+ * sub-steps, and the motion states are left for the caller to write.
+ */
+class FixedStepDynamicsWorld : public btDiscreteDynamicsWorld
+{
+public:
+
+    FixedStepDynamicsWorld(btDispatcher* dispatcher, btBroadphaseInterface* pairCache, btConstraintSolver* solver, btCollisionConfiguration* configuration)
+        : btDiscreteDynamicsWorld(dispatcher, pairCache, solver, configuration)
+    {
+    }
+
+    void beginSteps(unsigned int stepCount, btScalar timeStep)
+    {
+        // Kinematic bodies get the velocity that moves them to their nodes over all the steps.
+        saveKinematicState(timeStep * stepCount);
+        applyGravity();
+    }
+
+    void step(btScalar timeStep)
+    {
+        internalSingleStepSimulation(timeStep);
+    }
+
+    void endSteps()
+    {
+        clearForces();
+    }
+};
+
+unsigned int PhysicsController::rayTest(unsigned int count, const Ray* rays, const float* distances, int mask, PhysicsCollisionObject** objects,
+                                        float* fractions, Vector3* points, Vector3* normals)
+{
+    GP_ASSERT(_world);
+    GP_ASSERT(!_isUpdating);
+    GP_ASSERT(count == 0 || (rays && distances && objects));
+
+    btDbvtBroadphase* broadphase = static_cast<btDbvtBroadphase*>(_overlappingPairCache);
+    auto test = [&](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
         {
-            const CollisionInfo& ci = _pc->_collisionStatus[p2];
-            std::vector<PhysicsCollisionObject::CollisionListener*>::const_iterator iter = ci._listeners.begin();
-            for (; iter != ci._listeners.end(); iter++)
+            btTransform from(btQuaternion::getIdentity(), BV(rays[i].getOrigin()));
+            btTransform to(btQuaternion::getIdentity(), from.getOrigin() + BV(rays[i].getDirection() * distances[i]));
+            btCollisionWorld::ClosestRayResultCallback callback(from.getOrigin(), to.getOrigin());
+            BatchRayTester tester(from, to, mask, callback);
+
+            // Test both the dynamic and the static tree.
+            for (int j = 0; j < 2; ++j)
             {
-                GP_ASSERT(*iter);
-                collisionInfo->_listeners.push_back(*iter);
+                btDbvt::rayTest(broadphase->m_sets[j].m_root, from.getOrigin(), to.getOrigin(), tester);
             }
+
+            // The hit point and normal of the callback are only set on a hit.
+            bool hit = callback.hasHit();
+            objects[i] = hit ? getCollisionObject(callback.m_collisionObject) : NULL;
+            if (fractions)
+                fractions[i] = hit ? callback.m_closestHitFraction : 1.0f;
+            if (points)
+                points[i] = hit ? Vector3(callback.m_hitPointWorld.x(), callback.m_hitPointWorld.y(), callback.m_hitPointWorld.z()) : Vector3::zero();
+            if (normals)
+                normals[i] = hit ? Vector3(callback.m_hitNormalWorld.x(), callback.m_hitNormalWorld.y(), callback.m_hitNormalWorld.z()) : Vector3::zero();
         }
+    };
+
+    JobScheduler* scheduler = Game::getInstance()->getJobScheduler();
+    if (scheduler && count > QUERY_GRAIN_SIZE)
+        scheduler->parallelFor(count, QUERY_GRAIN_SIZE, test, "PhysicsController::rayTest");
+    else
+        test(0, count);
+
+    unsigned int hitCount = 0;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (objects[i])
+            ++hitCount;
     }
+    return hitCount;
+}
+
+unsigned int PhysicsController::sweepTest(unsigned int count, PhysicsCollisionObject* const* objects, const Vector3* endPositions, int mask, PhysicsCollisionObject** hitObjects,
+                                          float* fractions, Vector3* points, Vector3* normals)
+{
+    GP_ASSERT(_world);
+    GP_ASSERT(!_isUpdating);
+    GP_ASSERT(count == 0 || (objects && endPositions && hitObjects));
 
-    // Fire collision event.
-    if ((collisionInfo->_status & COLLISION) == 0)
+    btDbvtBroadphase* broadphase = static_cast<btDbvtBroadphase*>(_overlappingPairCache);
+    btScalar allowedPenetration = _world->getDispatchInfo().m_allowedCcdPenetration;
+    auto test = [&](unsigned int begin, unsigned int end)
     {
-        std::vector<PhysicsCollisionObject::CollisionListener*>::const_iterator iter = collisionInfo->_listeners.begin();
-        for (; iter != collisionInfo->_listeners.end(); iter++)
+        for (unsigned int i = begin; i < end; ++i)
         {
-            GP_ASSERT(*iter);
-            if ((collisionInfo->_status & REMOVE) == 0)
+            hitObjects[i] = NULL;
+            if (fractions)
+                fractions[i] = 1.0f;
+            if (points)
+                points[i] = Vector3::zero();
+            if (normals)
+                normals[i] = Vector3::zero();
+
+            PhysicsCollisionObject* object = objects[i];
+            GP_ASSERT(object && object->getCollisionShape());
+            PhysicsCollisionShape::Type type = object->getCollisionShape()->getType();
+            if (type != PhysicsCollisionShape::SHAPE_BOX && type != PhysicsCollisionShape::SHAPE_SPHERE && type != PhysicsCollisionShape::SHAPE_CAPSULE)
+                continue; // unsupported type
+
+            btTransform start;
+            getSweepStart(object, &start);
+            btTransform end(start);
+            end.setOrigin(BV(endPositions[i]));
+
+            // Find the candidates overlapping the volume swept by the shape.
+            const btConvexShape* shape = static_cast<const btConvexShape*>(object->getCollisionShape()->getShape());
+            btVector3 startMin, startMax, endMin, endMax;
+            shape->getAabb(start, startMin, startMax);
+            shape->getAabb(end, endMin, endMax);
+            startMin.setMin(endMin);
+            startMax.setMax(endMax);
+            btDbvtVolume volume = btDbvtVolume::FromMM(startMin, startMax);
+
+            btCollisionWorld::ClosestConvexResultCallback callback(start.getOrigin(), end.getOrigin());
+            BatchSweepTester tester(shape, start, end, object->getCollisionObject(), mask, allowedPenetration, callback);
+            for (int j = 0; j < 2; ++j)
             {
-                (*iter)->collisionEvent(PhysicsCollisionObject::CollisionListener::COLLIDING, pair, Vector3(cp.getPositionWorldOnA().x(), cp.getPositionWorldOnA().y(), cp.getPositionWorldOnA().z()),
-                    Vector3(cp.getPositionWorldOnB().x(), cp.getPositionWorldOnB().y(), cp.getPositionWorldOnB().z()));
+                broadphase->m_sets[j].collideTV(broadphase->m_sets[j].m_root, volume, tester);
+            }
+
+            // The hit point and normal of the callback are only set on a hit.
+            if (callback.hasHit())
+            {
+                hitObjects[i] = getCollisionObject(callback.m_hitCollisionObject);
+                if (fractions)
+                    fractions[i] = callback.m_closestHitFraction;
+                if (points)
+                    points[i].set(callback.m_hitPointWorld.x(), callback.m_hitPointWorld.y(), callback.m_hitPointWorld.z());
+                if (normals)
+                    normals[i].set(callback.m_hitNormalWorld.x(), callback.m_hitNormalWorld.y(), callback.m_hitNormalWorld.z());
             }
         }
-    }
+    };
+
+    JobScheduler* scheduler = Game::getInstance()->getJobScheduler();
+    if (scheduler && count > QUERY_GRAIN_SIZE)
+        scheduler->parallelFor(count, QUERY_GRAIN_SIZE, test, "PhysicsController::sweepTest");
+    else
+        test(0, count);
 
-    // Update the collision status cache (we remove the dirty bit
-    // set in the controller's update so that this particular collision pair's
-    // status is not reset to 'no collision' when the controller's update completes).
-    collisionInfo->_status &= ~DIRTY;
-    collisionInfo->_status |= COLLISION;
-    return 0.0f;
+    unsigned int hitCount = 0;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (hitObjects[i])
+            ++hitCount;
+    }
+    return hitCount;
 }
 
 void PhysicsController::initialize()
@@ -441,7 +673,7 @@ void PhysicsController::initialize()
     _solver = bullet_new<btSequentialImpulseConstraintSolver>();
 
     // Create the world.
-    _world = bullet_new<btDiscreteDynamicsWorld>(_dispatcher, _overlappingPairCache, _solver, _collisionConfiguration);
+    _world = bullet_new<FixedStepDynamicsWorld>(_dispatcher, _overlappingPairCache, _solver, _collisionConfiguration);
     _world->setGravity(BV(_gravity));
 
     // Register ghost pair callback so bullet detects collisions with ghost objects (used for character collisions).
@@ -478,133 +710,190 @@ void PhysicsController::resume()
 
 void PhysicsController::update(float elapsedTime)
 {
+    GP_PROFILE_SCOPE("PhysicsController::update");
     GP_ASSERT(_world);
     _isUpdating = true;
 
-    // Update the physics simulation, with a maximum
-    // of 10 simulation steps being performed in a given frame.
-    _world->stepSimulation(elapsedTime, 10);
+    // Drop the pairs whose listeners or objects were removed since the last update.
+    removeCollisionPairs();
 
-    // If we have status listeners, then check if our status has changed.
-    if (_listeners || hasScriptListener(GP_GET_SCRIPT_EVENT(PhysicsController, statusEvent)))
+    if (_fixedTimeStep > 0.0f)
     {
-        Listener::EventType oldStatus = _status;
-
-        if (_status == Listener::DEACTIVATED)
+        // Take as many whole steps as the accumulated time allows, dropping the time beyond the step limit.
+        _accumulatedTime += elapsedTime;
+        unsigned int stepCount = (unsigned int)(_accumulatedTime / _fixedTimeStep);
+        if (stepCount > _maxSubSteps)
         {
-            for (int i = 0; i < _world->getNumCollisionObjects(); i++)
-            {
-                GP_ASSERT(_world->getCollisionObjectArray()[i]);
-                if (_world->getCollisionObjectArray()[i]->isActive())
-                {
-                    _status = Listener::ACTIVATED;
-                    break;
-                }
-            }
+            stepCount = _maxSubSteps;
+            _accumulatedTime = stepCount * (double)_fixedTimeStep;
         }
-        else
-        {
-            bool allInactive = true;
-            for (int i = 0; i < _world->getNumCollisionObjects(); i++)
-            {
-                GP_ASSERT(_world->getCollisionObjectArray()[i]);
-                if (_world->getCollisionObjectArray()[i]->isActive())
-                {
-                    allInactive = false;
-                    break;
-                }
-            }
+        stepFixed(stepCount, _fixedTimeStep);
+        _accumulatedTime -= stepCount * (double)_fixedTimeStep;
 
-            if (allInactive)
-                _status = Listener::DEACTIVATED;
-        }
-
-        // If the status has changed, notify our listeners.
-        if (oldStatus != _status)
+        synchronizeNodes(_interpolation ? (float)(_accumulatedTime / _fixedTimeStep) : 1.0f);
+    }
+    else
+    {
+        // Let Bullet split the frame time into its own steps.
+        double start = Game::getAbsoluteTime();
+        int stepCount = _world->stepSimulation(elapsedTime, (int)_maxSubSteps);
+        if (stepCount > 0)
         {
-            if (_listeners)
-            {
-                for (unsigned int k = 0; k < _listeners->size(); k++)
-                {
-                    GP_ASSERT((*_listeners)[k]);
-                    (*_listeners)[k]->statusEvent(_status);
-                }
-            }
-
-            fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(PhysicsController, statusEvent), _status);
+            float stepTime = (float)((Game::getAbsoluteTime() - start) * 1000.0) / stepCount;
+            _statistics.steps += stepCount;
+            _statistics.lastStepTime = stepTime;
+            _statistics.maxStepTime = std::max(_statistics.maxStepTime, stepTime);
+            _statistics.totalStepTime += stepTime * stepCount;
         }
     }
 
-    // All statuses are set with the DIRTY bit before collision processing occurs.
-    // During collision processing, if a collision occurs, the status is 
-    // set to COLLISION and the DIRTY bit is cleared. Then, after collision processing 
-    // is finished, if a given status is still dirty, the COLLISION bit is cleared.
-    //
-    // If an entry was marked for removal in the last frame, fire NOT_COLLIDING if appropriate and remove it now.
+    fireEvents();
+
+    _isUpdating = false;
+}
+
+void PhysicsController::simulate(unsigned int stepCount)
+{
+    GP_PROFILE_SCOPE("PhysicsController::simulate");
+    GP_ASSERT(_world);
+    GP_ASSERT(!_isUpdating);
+    _isUpdating = true;
+
+    removeCollisionPairs();
+    stepFixed(stepCount, _fixedTimeStep > 0.0f ? _fixedTimeStep : DEFAULT_FIXED_TIME_STEP);
+    synchronizeNodes(1.0f);
+    fireEvents();
 
-    // Dirty the collision status cache entries.
-    std::map<PhysicsCollisionObject::CollisionPair, CollisionInfo>::iterator iter = _collisionStatus.begin();
-    for (; iter != _collisionStatus.end();)
+    _isUpdating = false;
+}
+
+void PhysicsController::stepFixed(unsigned int stepCount, float step)
+{
+    if (stepCount == 0)
+        return;
+
+    FixedStepDynamicsWorld* world = static_cast<FixedStepDynamicsWorld*>(_world);
+    world->beginSteps(stepCount, step);
+    for (unsigned int i = 0; i < stepCount; ++i)
     {
-        if ((iter->second._status & REMOVE) != 0)
+        // Only the step before the last matters for interpolation.
+        if (i == stepCount - 1)
         {
-            if ((iter->second._status & COLLISION) != 0 && iter->first.objectB)
+            for (size_t j = 0, count = _movableObjects.size(); j < count; ++j)
             {
-                size_t size = iter->second._listeners.size();
-                for (size_t i = 0; i < size; i++)
-                {
-                    PhysicsCollisionObject::CollisionPair cp(iter->first.objectA, NULL);
-                    iter->second._listeners[i]->collisionEvent(PhysicsCollisionObject::CollisionListener::NOT_COLLIDING, cp);
-                }
+                const btTransform& transform = _movableObjects[j]->getWorldTransform();
+                const btQuaternion& rotation = transform.getRotation();
+                const btVector3& position = transform.getOrigin();
+                _previousTransforms[j].position.set(position.x(), position.y(), position.z());
+                _previousTransforms[j].rotation.set(rotation.x(), rotation.y(), rotation.z(), rotation.w());
             }
-
-            std::map<PhysicsCollisionObject::CollisionPair, CollisionInfo>::iterator eraseIter = iter;
-            iter++;
-            _collisionStatus.erase(eraseIter);
         }
-        else
+
+        double start = Game::getAbsoluteTime();
+        world->step(step);
+        float stepTime = (float)((Game::getAbsoluteTime() - start) * 1000.0);
+
+        _statistics.steps++;
+        _statistics.lastStepTime = stepTime;
+        _statistics.maxStepTime = std::max(_statistics.maxStepTime, stepTime);
+        _statistics.totalStepTime += stepTime;
+    }
+    world->endSteps();
+}
+
+void PhysicsController::synchronizeNodes(float alpha)
+{
+    for (size_t i = 0, count = _movableObjects.size(); i < count; ++i)
+    {
+        // Kinematic bodies follow their nodes, and only rigid bodies have motion states written by steps.
+        btRigidBody* body = btRigidBody::upcast(_movableObjects[i]);
+        if (!body || body->isStaticOrKinematicObject() || !body->getMotionState())
+            continue;
+
+        const btTransform& transform = body->getWorldTransform();
+        const btQuaternion& rotation = transform.getRotation();
+        const btVector3& position = transform.getOrigin();
+        Vector3 p(position.x(), position.y(), position.z());
+        Quaternion q(rotation.x(), rotation.y(), rotation.z(), rotation.w());
+
+        // Bodies that sleep have already been placed at their last step, unless they fell asleep in it.
+        const PreviousTransform& previous = _previousTransforms[i];
+        if (!body->isActive() && p == previous.position && q == previous.rotation)
+            continue;
+
+        if (alpha < 1.0f)
         {
-            iter->second._status |= DIRTY;
-            iter++;
+            p = previous.position + (p - previous.position) * alpha;
+            Quaternion::slerp(previous.rotation, q, alpha, &q);
         }
+
+        body->getMotionState()->setWorldTransform(btTransform(BQ(q), BV(p)));
     }
+}
 
-    // Go through the collision status cache and perform all registered collision tests.
-    iter = _collisionStatus.begin();
-    for (; iter != _collisionStatus.end(); iter++)
+unsigned int PhysicsController::getStateHash() const
+{
+    GP_ASSERT(_world);
+
+    // FNV-1a over the exact bits of the state.
+    unsigned int hash = 2166136261u;
+    const btCollisionObjectArray& objects = _world->getCollisionObjectArray();
+    for (int i = 0; i < objects.size(); ++i)
     {
-        // If this collision pair was one that was registered for listening, then perform the collision test.
-        // (In the case where we register for all collisions with a rigid body, there will be a lot
-        // of collision pairs in the status cache that we did not explicitly register for.)
-        if ((iter->second._status & REGISTERED) != 0 && (iter->second._status & REMOVE) == 0)
+        btScalar state[22];
+        objects[i]->getWorldTransform().getOpenGLMatrix(state);
+        unsigned int size = 16;
+        const btRigidBody* body = btRigidBody::upcast(objects[i]);
+        if (body)
         {
-            if (iter->first.objectB)
-                _world->contactPairTest(iter->first.objectA->getCollisionObject(), iter->first.objectB->getCollisionObject(), *_collisionCallback);
-            else
-                _world->contactTest(iter->first.objectA->getCollisionObject(), *_collisionCallback);
+            const btVector3& linearVelocity = body->getLinearVelocity();
+            const btVector3& angularVelocity = body->getAngularVelocity();
+            state[size++] = linearVelocity.x();
+            state[size++] = linearVelocity.y();
+            state[size++] = linearVelocity.z();
+            state[size++] = angularVelocity.x();
+            state[size++] = angularVelocity.y();
+            state[size++] = angularVelocity.z();
+        }
+
+        const unsigned char* bytes = (const unsigned char*)state;
+        for (size_t j = 0; j < size * sizeof(btScalar); ++j)
+        {
+            hash ^= bytes[j];
+            hash *= 16777619u;
         }
     }
+    return hash;
+}
 
-    // Update all the collision status cache entries.
-    iter = _collisionStatus.begin();
-    for ( ; iter != _collisionStatus.end(); iter++)
+void PhysicsController::fireEvents()
+{
+    // If we have status listeners, then check if our status has changed.
+    if (_listeners || hasScriptListener(GP_GET_SCRIPT_EVENT(PhysicsController, statusEvent)))
     {
-        if ((iter->second._status & DIRTY) != 0)
+        Listener::EventType oldStatus = _status;
+        _status = isAnyObjectActive() ? Listener::ACTIVATED : Listener::DEACTIVATED;
+
+        // If the status has changed, notify our listeners.
+        if (oldStatus != _status)
         {
-            if ((iter->second._status & COLLISION) != 0 && iter->first.objectB)
+            if (_listeners)
             {
-                size_t size = iter->second._listeners.size();
-                for (size_t i = 0; i < size; i++)
+                for (unsigned int k = 0; k < _listeners->size(); k++)
                 {
-                    iter->second._listeners[i]->collisionEvent(PhysicsCollisionObject::CollisionListener::NOT_COLLIDING, iter->first);
+                    GP_ASSERT((*_listeners)[k]);
+                    (*_listeners)[k]->statusEvent(_status);
                 }
             }
 
-            iter->second._status &= ~COLLISION;
+            fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(PhysicsController, statusEvent), _status);
         }
     }
 
-    _isUpdating = false;
+    // Collision events come from the contact manifolds Bullet keeps for the step,
+    // and are fired together once the collision status cache is up to date.
+    updateCollisionStatus();
+    fireCollisionEvents();
 }
 
 void PhysicsController::addCollisionListener(PhysicsCollisionObject::CollisionListener* listener, PhysicsCollisionObject* objectA, PhysicsCollisionObject* objectB)
@@ -616,9 +905,19 @@ void PhysicsController::addCollisionListener(PhysicsCollisionObject::CollisionLi
     PhysicsCollisionObject::CollisionPair pair(objectA, objectB);
 
     // Add the listener and ensure the status includes that this collision pair is registered.
-    CollisionInfo& info = _collisionStatus[pair];
-    info._listeners.push_back(listener);
-    info._status |= PhysicsController::REGISTERED;
+    // A pair that is still waiting to be removed starts over with the new listener.
+    CollisionInfo* info = findCollisionInfo(objectA, objectB);
+    if (!info)
+    {
+        info = createCollisionInfo(objectA ? objectA : objectB, objectA ? objectB : NULL);
+    }
+    else if ((info->_status & REMOVE) != 0)
+    {
+        info->_listeners.clear();
+        info->_status &= ~REMOVE;
+    }
+    info->_listeners.push_back(listener);
+    info->_status |= PhysicsController::REGISTERED;
 }
 
 void PhysicsController::removeCollisionListener(PhysicsCollisionObject::CollisionListener* listener, PhysicsCollisionObject* objectA, PhysicsCollisionObject* objectB)
@@ -628,9 +927,11 @@ void PhysicsController::removeCollisionListener(PhysicsCollisionObject::Collisio
     PhysicsCollisionObject::CollisionPair pair(objectA, objectB);
 
     // Mark the collision pair for these objects for removal.
-    if (_collisionStatus.count(pair) > 0)
+    CollisionInfo* info = findCollisionInfo(objectA, objectB);
+    if (info && (info->_status & REMOVE) == 0)
     {
-        _collisionStatus[pair]._status |= REMOVE;
+        info->_status |= REMOVE;
+        _removedPairs.push_back(pair);
     }
 }
 
@@ -664,6 +965,8 @@ void PhysicsController::addCollisionObject(PhysicsCollisionObject* object)
         GP_ERROR("Unsupported collision object type (%d).", object->getType());
         break;
     }
+
+    updateMovableObject(object->getCollisionObject(), true);
 }
 
 void PhysicsController::removeCollisionObject(PhysicsCollisionObject* object, bool removeListeners)
@@ -690,16 +993,21 @@ void PhysicsController::removeCollisionObject(PhysicsCollisionObject* object, bo
             GP_ERROR("Unsupported collision object type (%d).", object->getType());
             break;
         }
+
+        updateMovableObject(object->getCollisionObject(), false);
     }
 
     // Find all references to the object in the collision status cache and mark them for removal.
     if (removeListeners)
     {
-        std::map<PhysicsCollisionObject::CollisionPair, CollisionInfo>::iterator iter = _collisionStatus.begin();
+        CollisionStatusMap::iterator iter = _collisionStatus.begin();
         for (; iter != _collisionStatus.end(); iter++)
         {
-            if (iter->first.objectA == object || iter->first.objectB == object)
-                iter->second._status |= REMOVE;
+            if ((iter->first.objectA == object || iter->first.objectB == object) && (iter->second->_status & REMOVE) == 0)
+            {
+                iter->second->_status |= REMOVE;
+                _removedPairs.push_back(iter->first);
+            }
         }
     }
 }
@@ -711,6 +1019,267 @@ PhysicsCollisionObject* PhysicsController::getCollisionObject(const btCollisionO
     return reinterpret_cast<PhysicsCollisionObject*>(collisionObject->getUserPointer());
 }
 
+void PhysicsController::updateMovableObject(btCollisionObject* collisionObject, bool inWorld)
+{
+    GP_ASSERT(collisionObject);
+
+    // Static objects never become active, so only the others are checked for the status events
+    // and interpolated between fixed steps. Bullet flags zero-mass kinematic bodies as static
+    // too, but they never deactivate, so they are kept like any other object that can move.
+    bool movable = inWorld && (!collisionObject->isStaticObject() || collisionObject->isKinematicObject());
+    std::vector<btCollisionObject*>::iterator itr = std::find(_movableObjects.begin(), _movableObjects.end(), collisionObject);
+    if (movable && itr == _movableObjects.end())
+    {
+        const btQuaternion& rotation = collisionObject->getWorldTransform().getRotation();
+        const btVector3& position = collisionObject->getWorldTransform().getOrigin();
+        PreviousTransform previous;
+        previous.position.set(position.x(), position.y(), position.z());
+        previous.rotation.set(rotation.x(), rotation.y(), rotation.z(), rotation.w());
+        _movableObjects.push_back(collisionObject);
+        _previousTransforms.push_back(previous);
+    }
+    else if (!movable && itr != _movableObjects.end())
+    {
+        size_t index = itr - _movableObjects.begin();
+        _movableObjects[index] = _movableObjects.back();
+        _previousTransforms[index] = _previousTransforms.back();
+        _movableObjects.pop_back();
+        _previousTransforms.pop_back();
+    }
+}
+
+bool PhysicsController::isAnyObjectActive()
+{
+    // Start from the object that was active last time, which usually still is,
+    // so that only a world that went to sleep is scanned in full.
+    size_t count = _movableObjects.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t index = (_activeObjectHint + i) % count;
+        if (_movableObjects[index]->isActive())
+        {
+            _activeObjectHint = index;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t PhysicsController::CollisionPairHash::operator()(const PhysicsCollisionObject::CollisionPair& pair) const
+{
+    size_t a = (size_t)pair.objectA;
+    size_t b = (size_t)pair.objectB;
+    if (a > b)
+        std::swap(a, b);
+    return a * 31 + (b >> 3);
+}
+
+bool PhysicsController::CollisionPairEqual::operator()(const PhysicsCollisionObject::CollisionPair& a, const PhysicsCollisionObject::CollisionPair& b) const
+{
+    return (a.objectA == b.objectA && a.objectB == b.objectB) || (a.objectA == b.objectB && a.objectB == b.objectA);
+}
+
+PhysicsController::CollisionInfo* PhysicsController::findCollisionInfo(PhysicsCollisionObject* objectA, PhysicsCollisionObject* objectB) const
+{
+    CollisionStatusMap::const_iterator iter = _collisionStatus.find(PhysicsCollisionObject::CollisionPair(objectA, objectB));
+    return iter != _collisionStatus.end() ? iter->second : NULL;
+}
+
+PhysicsController::CollisionInfo* PhysicsController::createCollisionInfo(PhysicsCollisionObject* objectA, PhysicsCollisionObject* objectB)
+{
+    CollisionInfo* info;
+    if (_freeCollisionInfos.empty())
+    {
+        info = new CollisionInfo();
+    }
+    else
+    {
+        info = _freeCollisionInfos.back();
+        _freeCollisionInfos.pop_back();
+    }
+    info->_objectA = objectA;
+    info->_objectB = objectB;
+    _collisionStatus[PhysicsCollisionObject::CollisionPair(objectA, objectB)] = info;
+    return info;
+}
+
+void PhysicsController::destroyCollisionInfo(CollisionStatusMap::iterator iter)
+{
+    CollisionInfo* info = iter->second;
+    _collisionStatus.erase(iter);
+
+    if (info->_collidingIndex >= 0)
+    {
+        _collidingPairs[info->_collidingIndex] = _collidingPairs.back();
+        _collidingPairs[info->_collidingIndex]->_collidingIndex = info->_collidingIndex;
+        _collidingPairs.pop_back();
+    }
+
+    // Keep the listener storage for the next pair.
+    info->_objectA = info->_objectB = NULL;
+    info->_listeners.clear();
+    info->_status = 0;
+    info->_collidingIndex = -1;
+    _freeCollisionInfos.push_back(info);
+}
+
+void PhysicsController::removeCollisionPairs()
+{
+    for (size_t i = 0; i < _removedPairs.size(); ++i)
+    {
+        CollisionStatusMap::iterator iter = _collisionStatus.find(_removedPairs[i]);
+        if (iter == _collisionStatus.end() || (iter->second->_status & REMOVE) == 0)
+            continue;
+
+        // Let the listeners of a pair that was colliding know that it no longer is.
+        CollisionInfo* info = iter->second;
+        if ((info->_status & COLLISION) != 0 && info->_objectB)
+        {
+            PhysicsCollisionObject::CollisionPair cp(info->_objectA, NULL);
+            for (size_t j = 0; j < info->_listeners.size(); j++)
+            {
+                info->_listeners[j]->collisionEvent(PhysicsCollisionObject::CollisionListener::NOT_COLLIDING, cp);
+            }
+        }
+        destroyCollisionInfo(iter);
+    }
+    _removedPairs.clear();
+}
+
+void PhysicsController::updateCollisionStatus()
+{
+    if (_collisionStatus.empty())
+        return;
+
+    ++_collisionStep;
+
+    // Find the listened to pairs that are touching.
+    GP_ASSERT(_dispatcher);
+    for (int i = 0, count = _dispatcher->getNumManifolds(); i < count; ++i)
+    {
+        btPersistentManifold* manifold = _dispatcher->getManifoldByIndexInternal(i);
+        GP_ASSERT(manifold);
+        int contactCount = manifold->getNumContacts();
+        if (contactCount == 0)
+            continue;
+
+        PhysicsCollisionObject* objectA = getCollisionObject(manifold->getBody0());
+        PhysicsCollisionObject* objectB = getCollisionObject(manifold->getBody1());
+        if (!objectA || !objectB)
+            continue;
+
+        CollisionInfo* info = findCollisionInfo(objectA, objectB);
+        if (!info)
+        {
+            // Pairs that are not registered are tracked if one of their objects listens to all of its collisions.
+            CollisionInfo* infoA = findCollisionInfo(objectA, NULL);
+            CollisionInfo* infoB = findCollisionInfo(objectB, NULL);
+            bool listenA = infoA && (infoA->_status & REMOVE) == 0;
+            bool listenB = infoB && (infoB->_status & REMOVE) == 0;
+            if (!listenA && !listenB)
+                continue;
+
+            // Report the listening object first.
+            info = listenA ? createCollisionInfo(objectA, objectB) : createCollisionInfo(objectB, objectA);
+        }
+        if ((info->_status & REMOVE) != 0)
+            continue;
+
+        info->_step = _collisionStep;
+        if ((info->_status & COLLISION) == 0)
+        {
+            info->_status |= COLLISION;
+            info->_collidingIndex = (int)_collidingPairs.size();
+            _collidingPairs.push_back(info);
+
+            // Report the deepest contact point.
+            const btManifoldPoint* point = &manifold->getContactPoint(0);
+            for (int j = 1; j < contactCount; ++j)
+            {
+                if (manifold->getContactPoint(j).getDistance() < point->getDistance())
+                    point = &manifold->getContactPoint(j);
+            }
+            bool swapped = info->_objectA != objectA;
+            const btVector3& pointA = swapped ? point->getPositionWorldOnB() : point->getPositionWorldOnA();
+            const btVector3& pointB = swapped ? point->getPositionWorldOnA() : point->getPositionWorldOnB();
+
+            CollisionEvent event;
+            event.type = PhysicsCollisionObject::CollisionListener::COLLIDING;
+            event.objectA = info->_objectA;
+            event.objectB = info->_objectB;
+            event.contactPointA.set(pointA.x(), pointA.y(), pointA.z());
+            event.contactPointB.set(pointB.x(), pointB.y(), pointB.z());
+            _collisionEvents.push_back(event);
+        }
+    }
+
+    // Pairs that were colliding but were not touching in this step have separated.
+    for (size_t i = 0; i < _collidingPairs.size();)
+    {
+        CollisionInfo* info = _collidingPairs[i];
+        if (info->_step == _collisionStep)
+        {
+            ++i;
+            continue;
+        }
+
+        CollisionEvent event;
+        event.type = PhysicsCollisionObject::CollisionListener::NOT_COLLIDING;
+        event.objectA = info->_objectA;
+        event.objectB = info->_objectB;
+        _collisionEvents.push_back(event);
+
+        // Pairs nobody registered for are only tracked while they collide.
+        if ((info->_status & REGISTERED) == 0)
+        {
+            destroyCollisionInfo(_collisionStatus.find(PhysicsCollisionObject::CollisionPair(info->_objectA, info->_objectB)));
+        }
+        else
+        {
+            info->_status &= ~COLLISION;
+            _collidingPairs[i] = _collidingPairs.back();
+            _collidingPairs[i]->_collidingIndex = (int)i;
+            _collidingPairs.pop_back();
+            info->_collidingIndex = -1;
+        }
+    }
+}
+
+void PhysicsController::fireCollisionEvents()
+{
+    // Listeners can add and remove listeners, so the listeners of each event are looked up as it is fired.
+    for (size_t i = 0; i < _collisionEvents.size(); ++i)
+    {
+        const CollisionEvent& event = _collisionEvents[i];
+        CollisionInfo* infos[3] =
+        {
+            findCollisionInfo(event.objectA, event.objectB),
+            findCollisionInfo(event.objectA, NULL),
+            findCollisionInfo(event.objectB, NULL)
+        };
+
+        _eventListeners.clear();
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            if (!infos[j] || (infos[j]->_status & REMOVE) != 0)
+                continue;
+            for (size_t k = 0; k < infos[j]->_listeners.size(); ++k)
+            {
+                if (std::find(_eventListeners.begin(), _eventListeners.end(), infos[j]->_listeners[k]) == _eventListeners.end())
+                    _eventListeners.push_back(infos[j]->_listeners[k]);
+            }
+        }
+
+        PhysicsCollisionObject::CollisionPair pair(event.objectA, event.objectB);
+        for (size_t j = 0; j < _eventListeners.size(); ++j)
+        {
+            GP_ASSERT(_eventListeners[j]);
+            _eventListeners[j]->collisionEvent(event.type, pair, event.contactPointA, event.contactPointB);
+        }
+    }
+    _collisionEvents.clear();
+}
+
 static void getBoundingBox(Node* node, BoundingBox* out, bool merge = false)
 {
     GP_ASSERT(node);
@@ -1019,6 +1588,12 @@ PhysicsCollisionShape* PhysicsController::createHeightfield(Node* node, HeightFi
     GP_ASSERT(heightfield);
     GP_ASSERT(centerOfMassOffset);
 
+    if (heightfield->isTiled())
+    {
+        GP_ERROR("Tiled heightfields have no height array and cannot be used for heightfield collision shapes.");
+        return NULL;
+    }
+
     // Inspect the height array for the min and max values
     float* heights = heightfield->getArray();
     float minHeight = FLT_MAX, maxHeight = -FLT_MAX;
@@ -1112,6 +1687,55 @@ PhysicsCollisionShape* PhysicsController::createMesh(Mesh* mesh, const Vector3&
         }
     }
 
+    // Share the shape with other bodies that use the same mesh at the same scale.
+    PhysicsCollisionShape* shape;
+    for (unsigned int i = 0; i < _shapes.size(); ++i)
+    {
+        shape = _shapes[i];
+        GP_ASSERT(shape);
+        if (shape->getType() == PhysicsCollisionShape::SHAPE_MESH)
+        {
+            PhysicsCollisionShape::MeshData* meshData = shape->_shapeData.meshData;
+            if (meshData && meshData->dynamic == dynamic && meshData->scale == scale && meshData->url == mesh->getUrl())
+            {
+                shape->addRef();
+                return shape;
+            }
+        }
+    }
+
+    // Load the cooked shape if there is one for the current bundle.
+    std::string cookedFile;
+    unsigned int bundleHash = 0;
+    bool rewriteCookedFile = false;
+    if (!_cookedShapePath.empty())
+    {
+        std::string url = mesh->getUrl();
+        bundleHash = getBundleHash(url.substr(0, url.find('#')));
+
+        // Name the file after the mesh URL, the exact scale and the kind of shape.
+        for (size_t i = 0; i < url.size(); ++i)
+        {
+            if (url[i] == '/' || url[i] == '\\' || url[i] == '#' || url[i] == ':' || url[i] == '.')
+                url[i] = '_';
+        }
+        unsigned int scaleBits[3];
+        memcpy(scaleBits, &scale.x, sizeof(scaleBits));
+        char suffix[40];
+        sprintf(suffix, "_%08x%08x%08x_%c.gpc", scaleBits[0], scaleBits[1], scaleBits[2], dynamic ? 'd' : 's');
+        cookedFile = _cookedShapePath + "/" + url + suffix;
+
+        shape = loadCookedMesh(cookedFile.c_str(), bundleHash, dynamic, &rewriteCookedFile);
+        if (shape)
+        {
+            shape->_shapeData.meshData->url = mesh->getUrl();
+            shape->_shapeData.meshData->scale = scale;
+            shape->_shapeData.meshData->dynamic = dynamic;
+            _shapes.push_back(shape);
+            return shape;
+        }
+    }
+
     // Read mesh data from URL
     Bundle::MeshData* data = Bundle::readMeshData(mesh->getUrl());
     if (data == NULL)
@@ -1123,6 +1747,12 @@ PhysicsCollisionShape* PhysicsController::createMesh(Mesh* mesh, const Vector3&
     // Create mesh data to be populated and store in returned collision shape.
     PhysicsCollisionShape::MeshData* shapeMeshData = new PhysicsCollisionShape::MeshData();
     shapeMeshData->vertexData = NULL;
+    shapeMeshData->url = mesh->getUrl();
+    shapeMeshData->scale = scale;
+    shapeMeshData->dynamic = dynamic;
+    shapeMeshData->cookedData = NULL;
+    shapeMeshData->cookedSize = 0;
+    shapeMeshData->bvhData = NULL;
 
     // Copy the scaled vertex position data to the rigid body's local buffer.
     Matrix m;
@@ -1245,17 +1875,261 @@ PhysicsCollisionShape* PhysicsController::createMesh(Mesh* mesh, const Vector3&
     }
 
     // Create our collision shape object and store shapeMeshData in it.
-    PhysicsCollisionShape* shape = new PhysicsCollisionShape(PhysicsCollisionShape::SHAPE_MESH, collisionShape, meshInterface);
+    shape = new PhysicsCollisionShape(PhysicsCollisionShape::SHAPE_MESH, collisionShape, meshInterface);
     shape->_shapeData.meshData = shapeMeshData;
 
     _shapes.push_back(shape);
 
+    // Cook the shape so that the next run can skip reading the bundle and building it.
+    if (rewriteCookedFile)
+        writeCookedMesh(cookedFile.c_str(), bundleHash, shape, data->vertexCount);
+
     // Free the temporary mesh data now that it's stored in physics system.
     SAFE_DELETE(data);
 
     return shape;
 }
 
+unsigned int PhysicsController::getBundleHash(const std::string& bundlePath)
+{
+    std::map<std::string, unsigned int>::const_iterator itr = _bundleHashes.find(bundlePath);
+    if (itr != _bundleHashes.end())
+        return itr->second;
+
+    // FNV-1a over the contents of the bundle. Bundles that cannot be mapped
+    // (such as packaged ones) are read in chunks.
+    unsigned int hash = 2166136261u;
+    size_t size = 0;
+    const char* data = FileSystem::mapFile(bundlePath.c_str(), &size);
+    if (data)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ (unsigned char)data[i]) * 16777619u;
+        }
+        FileSystem::unmapFile(data, size);
+    }
+    else
+    {
+        std::unique_ptr<Stream> bundle(FileSystem::open(bundlePath.c_str()));
+        if (bundle.get())
+        {
+            unsigned char buffer[4096];
+            size_t read;
+            while ((read = bundle->read(buffer, 1, sizeof(buffer))) > 0)
+            {
+                for (size_t i = 0; i < read; ++i)
+                {
+                    hash = (hash ^ buffer[i]) * 16777619u;
+                }
+            }
+        }
+    }
+
+    _bundleHashes[bundlePath] = hash;
+    return hash;
+}
+
+PhysicsCollisionShape* PhysicsController::loadCookedMesh(const char* filePath, unsigned int bundleHash, bool dynamic, bool* rewrite)
+{
+    GP_ASSERT(filePath);
+    GP_ASSERT(rewrite);
+
+    // Cooked files that exist but cannot be mapped (such as packaged ones) are left alone.
+    size_t size = 0;
+    const char* data = FileSystem::mapFile(filePath, &size);
+    if (!data)
+    {
+        *rewrite = !FileSystem::fileExists(filePath);
+        return NULL;
+    }
+    *rewrite = true;
+
+    // The cooked file is stale if its bundle changed or the format is older.
+    unsigned int header[7];
+    if (size < COOKED_SHAPE_HEADER_SIZE || memcmp(data, COOKED_SHAPE_IDENTIFIER, COOKED_SHAPE_IDENTIFIER_SIZE) != 0)
+    {
+        FileSystem::unmapFile(data, size);
+        return NULL;
+    }
+    memcpy(header, data + 12, sizeof(header));
+    unsigned int vertexCount = header[3];
+    unsigned int partCount = header[4];
+    size_t verticesStart = COOKED_SHAPE_HEADER_SIZE + (size_t)partCount * COOKED_SHAPE_PART_WORDS * sizeof(unsigned int);
+    if (header[0] != COOKED_SHAPE_VERSION || header[1] != bundleHash || (header[2] != 0) != dynamic ||
+        verticesStart + (size_t)vertexCount * 3 * sizeof(float) > size || (size_t)header[5] + header[6] > size || (header[5] & 15) != 0)
+    {
+        FileSystem::unmapFile(data, size);
+        return NULL;
+    }
+
+    // Mapped files are page aligned and the sections are word aligned, so they can be used in place.
+    const float* vertices = (const float*)(data + verticesStart);
+
+    PhysicsCollisionShape::MeshData* shapeMeshData = new PhysicsCollisionShape::MeshData();
+    shapeMeshData->vertexData = NULL;
+    shapeMeshData->dynamic = dynamic;
+    shapeMeshData->cookedData = NULL;
+    shapeMeshData->cookedSize = 0;
+    shapeMeshData->bvhData = NULL;
+
+    btCollisionShape* collisionShape = NULL;
+    btTriangleIndexVertexArray* meshInterface = NULL;
+    if (dynamic)
+    {
+        // The hull copies its points, so the file is not needed afterwards.
+        collisionShape = bullet_new<btConvexHullShape>(vertices, (int)vertexCount, (int)(sizeof(float) * 3));
+        FileSystem::unmapFile(data, size);
+    }
+    else
+    {
+        // The mesh interface points into the mapping, which stays open as long as the shape.
+        shapeMeshData->vertexData = const_cast<float*>(vertices);
+        shapeMeshData->cookedData = data;
+        shapeMeshData->cookedSize = size;
+
+        meshInterface = bullet_new<btTriangleIndexVertexArray>();
+        const unsigned int* parts = (const unsigned int*)(data + COOKED_SHAPE_HEADER_SIZE);
+        for (unsigned int i = 0; i < partCount; ++i)
+        {
+            const unsigned int* part = parts + i * COOKED_SHAPE_PART_WORDS;
+            if ((size_t)part[4] + part[5] > size)
+            {
+                partCount = 0;
+                break;
+            }
+
+            btIndexedMesh indexedMesh;
+            indexedMesh.m_indexType = (PHY_ScalarType)part[0];
+            indexedMesh.m_numTriangles = part[2];
+            indexedMesh.m_numVertices = part[3];
+            indexedMesh.m_triangleIndexBase = (const unsigned char*)(data + part[4]);
+            indexedMesh.m_triangleIndexStride = part[1];
+            indexedMesh.m_vertexBase = (const unsigned char*)vertices;
+            indexedMesh.m_vertexStride = sizeof(float)*3;
+            indexedMesh.m_vertexType = PHY_FLOAT;
+            meshInterface->addIndexedMesh(indexedMesh, indexedMesh.m_indexType);
+            shapeMeshData->indexData.push_back((unsigned char*)(data + part[4]));
+        }
+
+        // The BVH is fixed up in place, so it gets its own aligned copy.
+        btOptimizedBvh* bvh = NULL;
+        if (partCount > 0 && header[6] > 0)
+        {
+            shapeMeshData->bvhData = btAlignedAlloc(header[6], 16);
+            memcpy(shapeMeshData->bvhData, data + header[5], header[6]);
+            bvh = btOptimizedBvh::deserializeInPlace(shapeMeshData->bvhData, header[6], false);
+        }
+        if (!bvh)
+        {
+            GP_WARN("Ignoring corrupt cooked collision shape '%s'.", filePath);
+            SAFE_DELETE(meshInterface);
+            if (shapeMeshData->bvhData)
+                btAlignedFree(shapeMeshData->bvhData);
+            SAFE_DELETE(shapeMeshData);
+            FileSystem::unmapFile(data, size);
+            return NULL;
+        }
+
+        btBvhTriangleMeshShape* triangleMeshShape = bullet_new<btBvhTriangleMeshShape>(meshInterface, true, false);
+        triangleMeshShape->setOptimizedBvh(bvh);
+        collisionShape = triangleMeshShape;
+    }
+
+    PhysicsCollisionShape* shape = new PhysicsCollisionShape(PhysicsCollisionShape::SHAPE_MESH, collisionShape, meshInterface);
+    shape->_shapeData.meshData = shapeMeshData;
+    return shape;
+}
+
+void PhysicsController::writeCookedMesh(const char* filePath, unsigned int bundleHash, PhysicsCollisionShape* shape, unsigned int vertexCount) const
+{
+    GP_ASSERT(filePath);
+    GP_ASSERT(shape && shape->_shapeData.meshData);
+
+    PhysicsCollisionShape::MeshData* meshData = shape->_shapeData.meshData;
+    std::vector<unsigned int> parts;
+    std::vector<float> vertices;
+    void* bvhData = NULL;
+    unsigned int bvhSize = 0;
+    if (meshData->dynamic)
+    {
+        // Store the points of the hull rather than the whole mesh.
+        btConvexHullShape* hull = static_cast<btConvexHullShape*>(shape->_shape);
+        vertexCount = (unsigned int)hull->getNumPoints();
+        for (unsigned int i = 0; i < vertexCount; ++i)
+        {
+            const btVector3& point = hull->getUnscaledPoints()[i];
+            vertices.push_back(point.x());
+            vertices.push_back(point.y());
+            vertices.push_back(point.z());
+        }
+    }
+    else
+    {
+        vertices.assign(meshData->vertexData, meshData->vertexData + vertexCount * 3);
+
+        btOptimizedBvh* bvh = static_cast<btBvhTriangleMeshShape*>(shape->_shape)->getOptimizedBvh();
+        GP_ASSERT(bvh);
+        bvhSize = bvh->calculateSerializeBufferSize();
+        bvhData = btAlignedAlloc(bvhSize, 16);
+        if (!bvh->serializeInPlace(bvhData, bvhSize, false))
+        {
+            GP_WARN("Failed to serialize the BVH of collision shape '%s'.", meshData->url.c_str());
+            btAlignedFree(bvhData);
+            return;
+        }
+    }
+
+    // Lay out the index data of each part after the vertices.
+    btTriangleIndexVertexArray* meshInterface = static_cast<btTriangleIndexVertexArray*>(shape->_meshInterface);
+    unsigned int partCount = meshInterface ? (unsigned int)meshInterface->getIndexedMeshArray().size() : 0;
+    unsigned int offset = (unsigned int)(COOKED_SHAPE_HEADER_SIZE + partCount * COOKED_SHAPE_PART_WORDS * sizeof(unsigned int) + vertices.size() * sizeof(float));
+    for (unsigned int i = 0; i < partCount; ++i)
+    {
+        const btIndexedMesh& indexedMesh = meshInterface->getIndexedMeshArray()[i];
+        unsigned int indexSize = indexedMesh.m_indexType == PHY_UCHAR ? 1 : (indexedMesh.m_indexType == PHY_SHORT ? 2 : 4);
+        unsigned int dataSize = indexedMesh.m_numTriangles > 0 ? (indexedMesh.m_numTriangles - 1) * indexedMesh.m_triangleIndexStride + indexSize * 3 : 0;
+        parts.push_back((unsigned int)indexedMesh.m_indexType);
+        parts.push_back((unsigned int)indexedMesh.m_triangleIndexStride);
+        parts.push_back((unsigned int)indexedMesh.m_numTriangles);
+        parts.push_back((unsigned int)indexedMesh.m_numVertices);
+        parts.push_back(offset);
+        parts.push_back(dataSize);
+        offset += (dataSize + 3) & ~3u;
+    }
+    unsigned int bvhOffset = bvhData ? (offset + 15) & ~15u : 0;
+
+    unsigned int header[7] = { COOKED_SHAPE_VERSION, bundleHash, meshData->dynamic ? 1u : 0u, vertexCount, partCount, bvhOffset, bvhSize };
+    char identifier[12] = { 0 };
+    memcpy(identifier, COOKED_SHAPE_IDENTIFIER, COOKED_SHAPE_IDENTIFIER_SIZE);
+    const char padding[16] = { 0 };
+
+    std::unique_ptr<Stream> stream(FileSystem::open(filePath, FileSystem::WRITE));
+    bool result = stream.get() &&
+        stream->write(identifier, 1, sizeof(identifier)) == sizeof(identifier) &&
+        stream->write(header, sizeof(unsigned int), 7) == 7 &&
+        (parts.empty() || stream->write(&parts[0], sizeof(unsigned int), parts.size()) == parts.size()) &&
+        (vertices.empty() || stream->write(&vertices[0], sizeof(float), vertices.size()) == vertices.size());
+    for (unsigned int i = 0; result && i < partCount; ++i)
+    {
+        const btIndexedMesh& indexedMesh = meshInterface->getIndexedMeshArray()[i];
+        unsigned int dataSize = parts[i * COOKED_SHAPE_PART_WORDS + 5];
+        result = stream->write(indexedMesh.m_triangleIndexBase, 1, dataSize) == dataSize &&
+            stream->write(padding, 1, ((dataSize + 3) & ~3u) - dataSize) == ((dataSize + 3) & ~3u) - dataSize;
+    }
+    if (result && bvhData)
+    {
+        result = stream->write(padding, 1, bvhOffset - offset) == bvhOffset - offset &&
+            stream->write(bvhData, 1, bvhSize) == bvhSize;
+    }
+    if (!result)
+        GP_WARN("Failed to write cooked collision shape '%s'.", filePath);
+    if (stream.get())
+        stream->close();
+    if (bvhData)
+        btAlignedFree(bvhData);
+}
+
 void PhysicsController::destroyShape(PhysicsCollisionShape* shape)
 {
     if (shape)
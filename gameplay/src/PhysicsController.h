@@ -148,6 +148,32 @@ public:
         virtual bool hit(const HitResult& result);
     };
 
+    /**
+     * Counters of the simulation steps taken by the controller.
+     */
+    struct Statistics
+    {
+        /**
+         * The number of simulation steps.
+         */
+        unsigned int steps;
+
+        /**
+         * The time (in milliseconds) taken by the last simulation step.
+         */
+        float lastStepTime;
+
+        /**
+         * The longest time (in milliseconds) taken by a simulation step.
+         */
+        float maxStepTime;
+
+        /**
+         * The total time (in milliseconds) taken by simulation steps.
+         */
+        float totalStepTime;
+    };
+
     /**
      * Extends ScriptTarget::getTypeName() to return the type name of this class.
      *
@@ -301,6 +327,118 @@ public:
      */
     void setGravity(const Vector3& gravity);
 
+    /**
+     * Gets the length of a fixed simulation step.
+     *
+     * @return The step length in seconds, or zero if the simulation follows the frame time.
+     * @script{ignore}
+     */
+    float getFixedTimeStep() const;
+
+    /**
+     * Sets the length of a fixed simulation step.
+     *
+     * By default the simulation is advanced by the frame time, which Bullet
+     * splits into internal steps of 1/60th of a second. With a fixed time step
+     * the controller itself steps the world by exactly that length as many
+     * times as the accumulated frame time allows, so that the same inputs
+     * always give the same simulation. Nodes of dynamic rigid bodies are then
+     * placed by interpolating between the last two steps (see setInterpolation()).
+     *
+     * The fixed step mode can also be set from the game.config file:
+     *
+     * @code
+     * physics
+     * {
+     *     fixedTimeStep = 0.0166667    // step length in seconds, 0 to follow the frame time
+     *     maxSubSteps = 10             // steps per frame before the simulation falls behind
+     *     interpolation = true         // whether nodes are interpolated between steps
+     * }
+     * @endcode
+     *
+     * @param step The step length in seconds, or zero to follow the frame time.
+     * @script{ignore}
+     */
+    void setFixedTimeStep(float step);
+
+    /**
+     * Gets the largest number of simulation steps taken per frame.
+     *
+     * @return The number of steps.
+     * @script{ignore}
+     */
+    unsigned int getMaxSubSteps() const;
+
+    /**
+     * Sets the largest number of simulation steps taken per frame.
+     *
+     * Frame time beyond that number of steps is dropped, which slows the
+     * simulation down rather than letting a slow frame make the next one slower.
+     *
+     * @param count The number of steps, at least one.
+     * @script{ignore}
+     */
+    void setMaxSubSteps(unsigned int count);
+
+    /**
+     * Determines if nodes are interpolated between fixed simulation steps.
+     *
+     * @return True if nodes are interpolated, false if they are placed at the last step.
+     * @script{ignore}
+     */
+    bool isInterpolation() const;
+
+    /**
+     * Sets whether nodes are interpolated between fixed simulation steps.
+     *
+     * Interpolation places nodes a frame's worth of time behind the
+     * simulation, so that they move smoothly when frames and steps do not
+     * line up. It only changes the node transforms, never the simulation.
+     *
+     * @param interpolation True to interpolate nodes, false to place them at the last step.
+     * @script{ignore}
+     */
+    void setInterpolation(bool interpolation);
+
+    /**
+     * Advances the simulation by a number of fixed steps right away, regardless of the frame time.
+     *
+     * This is for running the simulation without rendering, such as on a
+     * server or when replaying a recorded scene to check that it gives the
+     * same result. Collision and status events are fired as in a frame update.
+     * The fixed time step is used, or 1/60th of a second if none is set.
+     *
+     * @param stepCount The number of steps to take.
+     * @script{ignore}
+     */
+    void simulate(unsigned int stepCount);
+
+    /**
+     * Gets a hash of the state of all collision objects in the world.
+     *
+     * The hash covers the exact transforms of all objects and the velocities
+     * of rigid bodies, so two runs of the same scene with the same steps give
+     * the same hash only if they simulated exactly the same thing.
+     *
+     * @return The hash.
+     * @script{ignore}
+     */
+    unsigned int getStateHash() const;
+
+    /**
+     * Gets the counters accumulated since the last call to resetStatistics().
+     *
+     * @return The statistics.
+     * @script{ignore}
+     */
+    const Statistics& getStatistics() const;
+
+    /**
+     * Resets all counters to zero.
+     * @script{ignore}
+     */
+    void resetStatistics();
+
     /**
      * Draws debugging information (rigid body outlines, etc.) using the given view projection matrix.
      * 
@@ -308,6 +446,40 @@ public:
      */
     void drawDebug(const Matrix& viewProjection);
 
+    /**
+     * Gets the directory that cooked mesh collision shapes are kept in.
+     *
+     * @return The directory, or an empty string if mesh shapes are not cooked.
+     * @script{ignore}
+     */
+    const char* getCookedShapePath() const;
+
+    /**
+     * Sets the directory that cooked mesh collision shapes are kept in.
+     *
+     * Building a mesh collision shape reads the mesh back from its bundle and
+     * builds a BVH (or a convex hull for dynamic bodies), which is slow for
+     * large meshes. When a directory is set, the first build of each mesh
+     * shape is written there and later runs map the cooked file instead,
+     * without reading the bundle or building the BVH again. A cooked file is
+     * rebuilt when the contents of its bundle change, which is detected from a
+     * hash of the bundle computed once per bundle. The directory is created if
+     * it does not exist.
+     *
+     * The directory can also be set from the game.config file:
+     *
+     * @code
+     * physics
+     * {
+     *     cookedShapePath = res/cooked
+     * }
+     * @endcode
+     *
+     * @param path The directory, or NULL or an empty string to not cook mesh shapes.
+     * @script{ignore}
+     */
+    void setCookedShapePath(const char* path);
+
     /**
      * Performs a ray test on the physics world.
      * 
@@ -341,33 +513,60 @@ public:
      */
     bool sweepTest(PhysicsCollisionObject* object, const Vector3& endPosition, PhysicsController::HitResult* result = NULL, PhysicsController::HitFilter* filter = NULL);
 
-private:
-
     /**
-     * Internal class used to integrate with Bullet collision callbacks.
+     * Performs ray tests for a batch of rays on the physics world.
+     *
+     * Each ray finds the closest object it hits. Instead of a HitFilter,
+     * objects are filtered by their collision group: only objects whose group
+     * has a bit in common with the mask are tested. The rays are tested in
+     * parallel on the job scheduler, so this must not be called while the
+     * physics controller is updating.
+     *
+     * The results are written to arrays with one element per ray. The result
+     * arrays other than objects are optional.
+     *
+     * @param count The number of rays.
+     * @param rays The rays to test.
+     * @param distances How far along each ray to test for intersections.
+     * @param mask The collision groups to test against, or -1 for all groups.
+     * @param objects Receives the object hit by each ray, or NULL for rays that hit nothing.
+     * @param fractions Receives the fraction (0-1) of the distance to each hit, or NULL.
+     * @param points Receives the world space point of each hit, or NULL.
+     * @param normals Receives the world space normal of the surface at each hit, or NULL.
+     *
+     * @return The number of rays that hit an object.
+     * @script{ignore}
      */
-    class CollisionCallback : public btCollisionWorld::ContactResultCallback
-    {
-    public:
-        /**
-         * Constructor.
-         * 
-         * @param pc The physics controller that owns the callback.
-         */
-        CollisionCallback(PhysicsController* pc) : _pc(pc) {}
+    unsigned int rayTest(unsigned int count, const Ray* rays, const float* distances, int mask, PhysicsCollisionObject** objects,
+                         float* fractions = NULL, Vector3* points = NULL, Vector3* normals = NULL);
 
-    protected:
-        /**
-            * Internal function used for Bullet integration (do not use or override).
-            */
-        btScalar addSingleResult(btManifoldPoint& cp, const btCollisionObjectWrapper* a, int partIdA, int indexA, const btCollisionObjectWrapper* b, int partIdB, int indexB);    
+    /**
+     * Performs sweep tests for a batch of collision objects on the physics world.
+     *
+     * Each object is swept from its current world position to its end
+     * position and finds the closest other object it hits. Objects are
+     * filtered by collision group and the results are returned as for the
+     * batched rayTest(). Objects whose shape is not a box, sphere or capsule
+     * hit nothing.
+     *
+     * @param count The number of sweeps.
+     * @param objects The collision objects to sweep.
+     * @param endPositions The end position of each sweep, in world space.
+     * @param mask The collision groups to test against, or -1 for all groups.
+     * @param hitObjects Receives the object hit by each sweep, or NULL for sweeps that hit nothing.
+     * @param fractions Receives the fraction (0-1) of the distance to each hit, or NULL.
+     * @param points Receives the world space point of each hit, or NULL.
+     * @param normals Receives the world space normal of the surface at each hit, or NULL.
+     *
+     * @return The number of sweeps that hit an object.
+     * @script{ignore}
+     */
+    unsigned int sweepTest(unsigned int count, PhysicsCollisionObject* const* objects, const Vector3* endPositions, int mask, PhysicsCollisionObject** hitObjects,
+                           float* fractions = NULL, Vector3* points = NULL, Vector3* normals = NULL);
 
-    private:
-        PhysicsController* _pc;
-    };
+private:
 
     // Internal constants for the collision status cache.
-    static const int DIRTY;
     static const int COLLISION;
     static const int REGISTERED;
     static const int REMOVE;
@@ -375,10 +574,45 @@ private:
     // Represents the collision listeners and status for a given collision pair (used by the collision status cache).
     struct CollisionInfo
     {
-        CollisionInfo() : _status(0) { }
+        CollisionInfo() : _objectA(NULL), _objectB(NULL), _status(0), _step(0), _collidingIndex(-1) { }
 
+        PhysicsCollisionObject* _objectA;   // the objects in the order collision events report them
+        PhysicsCollisionObject* _objectB;
         std::vector<PhysicsCollisionObject::CollisionListener*> _listeners;
         int _status;
+        unsigned int _step;                 // the last update in which the pair was colliding
+        int _collidingIndex;                // position in the list of colliding pairs, or -1
+    };
+
+    // Hashes a collision pair regardless of the order of its objects.
+    struct CollisionPairHash
+    {
+        size_t operator()(const PhysicsCollisionObject::CollisionPair& pair) const;
+    };
+
+    // Compares collision pairs regardless of the order of their objects.
+    struct CollisionPairEqual
+    {
+        bool operator()(const PhysicsCollisionObject::CollisionPair& a, const PhysicsCollisionObject::CollisionPair& b) const;
+    };
+
+    // A collision event waiting to be fired at the end of an update.
+    struct CollisionEvent
+    {
+        PhysicsCollisionObject::CollisionListener::EventType type;
+        PhysicsCollisionObject* objectA;
+        PhysicsCollisionObject* objectB;
+        Vector3 contactPointA;
+        Vector3 contactPointB;
+    };
+
+    typedef std::unordered_map<PhysicsCollisionObject::CollisionPair, CollisionInfo*, CollisionPairHash, CollisionPairEqual> CollisionStatusMap;
+
+    // The transform of a movable object at the step before the last, for interpolating nodes.
+    struct PreviousTransform
+    {
+        Vector3 position;
+        Quaternion rotation;
     };
 
     /**
@@ -431,6 +665,43 @@ private:
     // Gets the corresponding GamePlay object for the given Bullet object.
     PhysicsCollisionObject* getCollisionObject(const btCollisionObject* collisionObject) const;
 
+    // Adds or removes a collision object in the list of objects that can move, depending on whether
+    // it is in the world and on its static and kinematic flags.
+    void updateMovableObject(btCollisionObject* collisionObject, bool inWorld);
+
+    // Determines if any collision object that can move is active.
+    bool isAnyObjectActive();
+
+    // Takes a number of fixed simulation steps.
+    void stepFixed(unsigned int stepCount, float step);
+
+    // Places the nodes of dynamic rigid bodies between their last two fixed steps.
+    void synchronizeNodes(float alpha);
+
+    // Fires the status and collision events of the steps taken in an update.
+    void fireEvents();
+
+    // Gets the transform of a collision object's node, for starting a sweep test.
+    static void getSweepStart(PhysicsCollisionObject* object, btTransform* start);
+
+    // Gets the collision status of a pair, or NULL if the pair is not in the collision status cache.
+    CollisionInfo* findCollisionInfo(PhysicsCollisionObject* objectA, PhysicsCollisionObject* objectB) const;
+
+    // Adds a pair to the collision status cache.
+    CollisionInfo* createCollisionInfo(PhysicsCollisionObject* objectA, PhysicsCollisionObject* objectB);
+
+    // Removes a pair from the collision status cache and returns its status to the pool.
+    void destroyCollisionInfo(CollisionStatusMap::iterator iter);
+
+    // Removes the pairs marked for removal from the collision status cache.
+    void removeCollisionPairs();
+
+    // Queues collision events for the pairs that started or stopped colliding in the last simulation step.
+    void updateCollisionStatus();
+
+    // Fires the queued collision events.
+    void fireCollisionEvents();
+
     // Creates a collision shape for the given node and gameplay shape definition.
     // Populates 'centerOfMassOffset' with the correct calculated center of mass offset.
     PhysicsCollisionShape* createShape(Node* node, const PhysicsCollisionShape::Definition& shape, Vector3* centerOfMassOffset, bool dynamic);
@@ -450,6 +721,16 @@ private:
     // Creates a triangle mesh collision shape.
     PhysicsCollisionShape* createMesh(Mesh* mesh, const Vector3& scale, bool dynamic);
 
+    // Gets the hash of the contents of a bundle, which cooked files are keyed on. The hash is computed once per bundle.
+    unsigned int getBundleHash(const std::string& bundlePath);
+
+    // Creates a mesh collision shape from a cooked file, or returns NULL if there is no valid cooked file.
+    // Sets 'rewrite' to whether the cooked file should be written again, which it should not when it exists but cannot be mapped.
+    PhysicsCollisionShape* loadCookedMesh(const char* filePath, unsigned int bundleHash, bool dynamic, bool* rewrite);
+
+    // Writes a mesh collision shape to a cooked file.
+    void writeCookedMesh(const char* filePath, unsigned int bundleHash, PhysicsCollisionShape* shape, unsigned int vertexCount) const;
+
     // Destroys a collision shape created through PhysicsController
     void destroyShape(PhysicsCollisionShape* shape);
 
@@ -555,8 +836,23 @@ private:
     Listener::EventType _status;
     std::vector<Listener*>* _listeners;
     Vector3 _gravity;
-    std::map<PhysicsCollisionObject::CollisionPair, CollisionInfo> _collisionStatus;
-    CollisionCallback* _collisionCallback;
+    std::vector<btCollisionObject*> _movableObjects;
+    std::vector<PreviousTransform> _previousTransforms;     // parallel to _movableObjects
+    size_t _activeObjectHint;
+    CollisionStatusMap _collisionStatus;
+    std::vector<CollisionInfo*> _freeCollisionInfos;
+    std::vector<CollisionInfo*> _collidingPairs;
+    std::vector<PhysicsCollisionObject::CollisionPair> _removedPairs;
+    std::vector<CollisionEvent> _collisionEvents;
+    std::vector<PhysicsCollisionObject::CollisionListener*> _eventListeners;
+    unsigned int _collisionStep;
+    float _fixedTimeStep;
+    unsigned int _maxSubSteps;
+    bool _interpolation;
+    double _accumulatedTime;
+    Statistics _statistics;
+    std::string _cookedShapePath;
+    std::map<std::string, unsigned int> _bundleHashes;
 };
 
 }
@@ -270,6 +270,11 @@ void PhysicsRigidBody::setKinematic(bool kinematic)
         _body->setCollisionFlags(_body->getCollisionFlags() & ~btCollisionObject::CF_KINEMATIC_OBJECT);
         _body->setActivationState(ACTIVE_TAG);
     }
+
+    // A zero-mass body only moves while it is kinematic. Bodies that are not in the world yet are
+    // handled when they are added.
+    if (_body->getBroadphaseHandle())
+        Game::getInstance()->getPhysicsController()->updateMovableObject(_body, true);
 }
 
 void PhysicsRigidBody::setEnabled(bool enable)
@@ -0,0 +1,334 @@
+#include "Base.h"
+#include "Profiler.h"
+#include "FileSystem.h"
+#include "Stream.h"
+
+// Default number of scopes held by each thread's ring buffer.
+#define PROFILER_DEFAULT_BUFFER_SIZE 65536
+
+namespace gameplay
+{
+
+#ifdef GP_USE_PROFILER
+
+/**
+ * A completed scope.
+ */
+struct ProfilerEvent
+{
+    const char* name;
+    double startTime;
+    double endTime;
+};
+
+/**
+ * The ring buffer of completed scopes recorded by one thread.
+ */
+struct ProfilerThreadBuffer
+{
+    std::vector<ProfilerEvent> events;
+    size_t written;
+    size_t aggregated;
+    unsigned int threadIndex;
+    std::mutex mutex;
+};
+
+/**
+ * The sum of one scope's completions during a frame.
+ */
+struct ProfilerAggregate
+{
+    const char* name;
+    double time;
+    unsigned int calls;
+};
+
+static std::atomic<bool> __profilerRecording(false);
+static std::mutex __profilerMutex;
+static std::vector<ProfilerThreadBuffer*> __profilerBuffers;
+static std::vector<ProfilerAggregate> __profilerAggregates;
+static unsigned int __profilerBufferSize = PROFILER_DEFAULT_BUFFER_SIZE;
+static double __profilerFrameStart = 0.0;
+static double __profilerFrameTime = 0.0;
+static thread_local ProfilerThreadBuffer* __profilerThreadBuffer = NULL;
+
+static double getProfilerTime()
+{
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+static ProfilerThreadBuffer* getThreadBuffer()
+{
+    if (!__profilerThreadBuffer)
+    {
+        ProfilerThreadBuffer* buffer = new ProfilerThreadBuffer();
+        buffer->written = 0;
+        buffer->aggregated = 0;
+
+        std::unique_lock<std::mutex> lock(__profilerMutex);
+        buffer->events.resize(__profilerBufferSize);
+        buffer->threadIndex = (unsigned int)__profilerBuffers.size();
+        __profilerBuffers.push_back(buffer);
+        __profilerThreadBuffer = buffer;
+    }
+    return __profilerThreadBuffer;
+}
+
+Profiler::Scope::Scope(const char* name)
+    : _name(name), _startTime(__profilerRecording ? getProfilerTime() : -1.0)
+{
+}
+
+Profiler::Scope::~Scope()
+{
+    if (_startTime < 0.0 || !__profilerRecording)
+        return;
+
+    ProfilerThreadBuffer* buffer = getThreadBuffer();
+    std::unique_lock<std::mutex> lock(buffer->mutex);
+    ProfilerEvent& event = buffer->events[buffer->written % buffer->events.size()];
+    event.name = _name;
+    event.startTime = _startTime;
+    event.endTime = getProfilerTime();
+    ++buffer->written;
+}
+
+void Profiler::start()
+{
+    std::unique_lock<std::mutex> lock(__profilerMutex);
+    for (size_t i = 0, count = __profilerBuffers.size(); i < count; ++i)
+    {
+        ProfilerThreadBuffer* buffer = __profilerBuffers[i];
+        std::unique_lock<std::mutex> bufferLock(buffer->mutex);
+        buffer->written = 0;
+        buffer->aggregated = 0;
+    }
+    __profilerAggregates.clear();
+    __profilerFrameStart = getProfilerTime();
+    __profilerFrameTime = 0.0;
+    __profilerRecording = true;
+}
+
+void Profiler::stop()
+{
+    __profilerRecording = false;
+}
+
+bool Profiler::isRecording()
+{
+    return __profilerRecording;
+}
+
+float Profiler::getFrameTime()
+{
+    return (float)(__profilerFrameTime * 1000.0);
+}
+
+unsigned int Profiler::getFrameScopeCount()
+{
+    return (unsigned int)__profilerAggregates.size();
+}
+
+const char* Profiler::getFrameScopeName(unsigned int index)
+{
+    GP_ASSERT(index < __profilerAggregates.size());
+    return __profilerAggregates[index].name;
+}
+
+float Profiler::getFrameScopeTime(unsigned int index)
+{
+    GP_ASSERT(index < __profilerAggregates.size());
+    return (float)(__profilerAggregates[index].time * 1000.0);
+}
+
+unsigned int Profiler::getFrameScopeCallCount(unsigned int index)
+{
+    GP_ASSERT(index < __profilerAggregates.size());
+    return __profilerAggregates[index].calls;
+}
+
+void Profiler::setBufferSize(unsigned int size)
+{
+    GP_ASSERT(size);
+    std::unique_lock<std::mutex> lock(__profilerMutex);
+    __profilerBufferSize = size;
+}
+
+void Profiler::endFrame()
+{
+    if (!__profilerRecording)
+        return;
+
+    double now = getProfilerTime();
+    __profilerFrameTime = now - __profilerFrameStart;
+    __profilerFrameStart = now;
+    __profilerAggregates.clear();
+
+    std::unique_lock<std::mutex> lock(__profilerMutex);
+    for (size_t i = 0, count = __profilerBuffers.size(); i < count; ++i)
+    {
+        ProfilerThreadBuffer* buffer = __profilerBuffers[i];
+        std::unique_lock<std::mutex> bufferLock(buffer->mutex);
+
+        // Scopes that were overwritten before this frame ended are lost.
+        size_t capacity = buffer->events.size();
+        size_t first = buffer->written - buffer->aggregated > capacity ? buffer->written - capacity : buffer->aggregated;
+        for (size_t j = first; j < buffer->written; ++j)
+        {
+            const ProfilerEvent& event = buffer->events[j % capacity];
+
+            // Scope names usually are string literals, so compare pointers before contents.
+            ProfilerAggregate* aggregate = NULL;
+            for (size_t k = 0, aggregateCount = __profilerAggregates.size(); k < aggregateCount; ++k)
+            {
+                if (__profilerAggregates[k].name == event.name || strcmp(__profilerAggregates[k].name, event.name) == 0)
+                {
+                    aggregate = &__profilerAggregates[k];
+                    break;
+                }
+            }
+            if (!aggregate)
+            {
+                ProfilerAggregate newAggregate = { event.name, 0.0, 0 };
+                __profilerAggregates.push_back(newAggregate);
+                aggregate = &__profilerAggregates.back();
+            }
+            aggregate->time += event.endTime - event.startTime;
+            ++aggregate->calls;
+        }
+        buffer->aggregated = buffer->written;
+    }
+}
+
+static void writeTraceString(Stream* stream, const char* str)
+{
+    stream->write("\"", 1, 1);
+    for (const char* c = str; *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+            stream->write("\\", 1, 1);
+        stream->write(c, 1, 1);
+    }
+    stream->write("\"", 1, 1);
+}
+
+bool Profiler::writeTrace(const char* path)
+{
+    GP_ASSERT(path);
+
+    Stream* stream = FileSystem::open(path, FileSystem::WRITE);
+    if (!stream)
+    {
+        GP_WARN("Failed to open file '%s' for writing the profiler trace.", path);
+        return false;
+    }
+
+    char line[256];
+    const char* header = "{\"traceEvents\":[\n";
+    stream->write(header, 1, strlen(header));
+
+    bool first = true;
+    std::unique_lock<std::mutex> lock(__profilerMutex);
+    for (size_t i = 0, count = __profilerBuffers.size(); i < count; ++i)
+    {
+        ProfilerThreadBuffer* buffer = __profilerBuffers[i];
+        std::unique_lock<std::mutex> bufferLock(buffer->mutex);
+
+        // Thread name metadata.
+        sprintf(line, "%s{\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"Thread %u\"}}",
+            first ? "" : ",\n", buffer->threadIndex, buffer->threadIndex);
+        stream->write(line, 1, strlen(line));
+        first = false;
+
+        size_t capacity = buffer->events.size();
+        size_t start = buffer->written > capacity ? buffer->written - capacity : 0;
+        for (size_t j = start; j < buffer->written; ++j)
+        {
+            const ProfilerEvent& event = buffer->events[j % capacity];
+            const char* prefix = ",\n{\"ph\":\"X\",\"pid\":0,\"name\":";
+            stream->write(prefix, 1, strlen(prefix));
+            writeTraceString(stream, event.name);
+            sprintf(line, ",\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                buffer->threadIndex, event.startTime * 1000000.0, (event.endTime - event.startTime) * 1000000.0);
+            stream->write(line, 1, strlen(line));
+        }
+    }
+
+    const char* footer = "\n]}\n";
+    stream->write(footer, 1, strlen(footer));
+    stream->close();
+    SAFE_DELETE(stream);
+
+    return true;
+}
+
+#else
+
+Profiler::Scope::Scope(const char* name)
+    : _name(name), _startTime(-1.0)
+{
+}
+
+Profiler::Scope::~Scope()
+{
+}
+
+void Profiler::start()
+{
+}
+
+void Profiler::stop()
+{
+}
+
+bool Profiler::isRecording()
+{
+    return false;
+}
+
+float Profiler::getFrameTime()
+{
+    return 0.0f;
+}
+
+unsigned int Profiler::getFrameScopeCount()
+{
+    return 0;
+}
+
+const char* Profiler::getFrameScopeName(unsigned int index)
+{
+    GP_ASSERT(false);
+    return NULL;
+}
+
+float Profiler::getFrameScopeTime(unsigned int index)
+{
+    GP_ASSERT(false);
+    return 0.0f;
+}
+
+unsigned int Profiler::getFrameScopeCallCount(unsigned int index)
+{
+    GP_ASSERT(false);
+    return 0;
+}
+
+void Profiler::setBufferSize(unsigned int size)
+{
+}
+
+void Profiler::endFrame()
+{
+}
+
+bool Profiler::writeTrace(const char* path)
+{
+    GP_WARN("Profiler support is not compiled in; define GP_USE_PROFILER to enable it.");
+    return false;
+}
+
+#endif
+
+}
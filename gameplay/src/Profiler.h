@@ -0,0 +1,187 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+namespace gameplay
+{
+
+/**
+ * Defines a CPU profiler that records named, nested timing scopes.
+ *
+ * Scopes are placed in code with the GP_PROFILE_SCOPE macro. While recording,
+ * each thread writes the scopes it completes into its own ring buffer. At the
+ * end of every frame the profiler sums up the scopes completed during that
+ * frame by name, and writeTrace() dumps everything still
+ * held in the ring buffers as a Chrome trace_event JSON file that can be opened
+ * in chrome://tracing.
+ *
+ * Instrumentation is only compiled in when GP_USE_PROFILER is defined (the
+ * CMake option of the same name defines it). Otherwise the macros expand to
+ * nothing and start() does not record anything.
+ */
+class Profiler
+{
+public:
+
+    /**
+     * Defines a scope that is timed from its construction to its destruction.
+     *
+     * Use the GP_PROFILE_SCOPE macro rather than this class directly.
+     *
+     * @script{ignore}
+     */
+    class Scope
+    {
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param name The name of the scope. The string must stay valid while the profiler runs.
+         */
+        Scope(const char* name);
+
+        /**
+         * Destructor.
+         */
+        ~Scope();
+
+    private:
+
+        /**
+         * Hidden copy constructor.
+         */
+        Scope(const Scope& copy);
+
+        /**
+         * Hidden copy assignment operator.
+         */
+        Scope& operator=(const Scope&);
+
+        const char* _name;
+        double _startTime;
+    };
+
+    /**
+     * Starts recording scopes.
+     */
+    static void start();
+
+    /**
+     * Stops recording scopes. Recorded data stays available until the next start().
+     */
+    static void stop();
+
+    /**
+     * Determines whether scopes are being recorded.
+     *
+     * @return True if the profiler is recording, false otherwise.
+     */
+    static bool isRecording();
+
+    /**
+     * Gets the duration of the last completed frame.
+     *
+     * @return The frame time in milliseconds.
+     */
+    static float getFrameTime();
+
+    /**
+     * Gets the number of distinct scopes completed during the last frame.
+     *
+     * @return The number of scopes.
+     */
+    static unsigned int getFrameScopeCount();
+
+    /**
+     * Gets the name of a scope completed during the last frame.
+     *
+     * @param index The index of the scope.
+     *
+     * @return The name of the scope.
+     */
+    static const char* getFrameScopeName(unsigned int index);
+
+    /**
+     * Gets the total time spent in a scope during the last frame, summed over all threads.
+     *
+     * @param index The index of the scope.
+     *
+     * @return The total time in milliseconds.
+     */
+    static float getFrameScopeTime(unsigned int index);
+
+    /**
+     * Gets the number of times a scope was completed during the last frame.
+     *
+     * @param index The index of the scope.
+     *
+     * @return The number of calls.
+     */
+    static unsigned int getFrameScopeCallCount(unsigned int index);
+
+    /**
+     * Writes the scopes held in the ring buffers as a Chrome trace_event JSON file.
+     *
+     * @param path The path of the file to write.
+     *
+     * @return True if the file was written, false otherwise.
+     */
+    static bool writeTrace(const char* path);
+
+    /**
+     * Sets the number of scopes each thread's ring buffer holds.
+     *
+     * Only affects threads that record their first scope after this call.
+     *
+     * @param size The number of scopes.
+     *
+     * @script{ignore}
+     */
+    static void setBufferSize(unsigned int size);
+
+    /**
+     * Marks the end of a frame and updates the per-frame aggregates.
+     *
+     * Called by the Game at the start of each frame (ending the previous one)
+     * through GP_PROFILE_FRAME().
+     *
+     * @script{ignore}
+     */
+    static void endFrame();
+
+private:
+
+    /**
+     * Hidden constructor.
+     */
+    Profiler();
+
+    /**
+     * Hidden destructor.
+     */
+    ~Profiler();
+
+    /**
+     * Hidden copy constructor.
+     */
+    Profiler(const Profiler& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    Profiler& operator=(const Profiler&);
+};
+
+}
+
+#ifdef GP_USE_PROFILER
+#define GP_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GP_PROFILE_CONCAT(a, b) GP_PROFILE_CONCAT_IMPL(a, b)
+#define GP_PROFILE_SCOPE(name) gameplay::Profiler::Scope GP_PROFILE_CONCAT(__profileScope, __LINE__)(name)
+#define GP_PROFILE_FRAME() gameplay::Profiler::endFrame()
+#else
+#define GP_PROFILE_SCOPE(name)
+#define GP_PROFILE_FRAME()
+#endif
+
+#endif
@@ -13,6 +13,35 @@
 #include "FileSystem.h"
 #include "Quaternion.h"
 #include <yaml.h>
+#include <unordered_set>
+
+// Namespaces with more properties than this get a hash table; smaller ones are scanned.
+#define PROPERTIES_HASH_THRESHOLD 8
+#define PROPERTIES_NO_ITERATOR ((size_t)-1)
+
+// Kinds of typed values cached in a property.
+#define PROPERTIES_CACHE_NONE 0
+#define PROPERTIES_CACHE_INT 1
+#define PROPERTIES_CACHE_LONG 2
+#define PROPERTIES_CACHE_FLOAT 3
+#define PROPERTIES_CACHE_VECTOR2 4
+#define PROPERTIES_CACHE_VECTOR3 5
+#define PROPERTIES_CACHE_VECTOR4 6
+
+// Binary properties, in native byte order:
+//   identifier, version, string count, string data size, namespace count, property count, variable count
+//   string offsets, NUL-terminated string data padded to 4 bytes
+//   namespaces in depth-first order: namespace, id, parent id, child count, property count, variable count
+//   properties: name, value, cache type, 4 cache words
+//   variables: name, value
+// Names and values are indices into the string table.
+#define PROPERTIES_BINARY_IDENTIFIER "\xABGPP\xBB\r\n\x1A\n"
+#define PROPERTIES_BINARY_IDENTIFIER_SIZE 9
+#define PROPERTIES_BINARY_VERSION 1
+#define PROPERTIES_BINARY_HEADER_WORDS 6
+#define PROPERTIES_BINARY_NAMESPACE_WORDS 6
+#define PROPERTIES_BINARY_PROPERTY_WORDS 7
+#define PROPERTIES_BINARY_VARIABLE_WORDS 2
 
 namespace gameplay
 {
@@ -30,6 +59,115 @@ static signed char readChar(Stream* stream)
     return c;
 }
 
+/**
+ * Hashes a property name (FNV-1a).
+ */
+static unsigned int hashName(const char* name)
+{
+    unsigned int hash = 2166136261u;
+    while (*name)
+    {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Gets the shared copy of a property name. Properties may be loaded on
+ * several threads, so the pool is locked.
+ */
+static const char* internName(const char* name)
+{
+    static std::unordered_set<std::string> names;
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    return names.insert(name).first->c_str();
+}
+
+Properties::Property::Property(const char* name, const char* value)
+    : name(internName(name)), hash(hashName(name)), value(value), cacheType(PROPERTIES_CACHE_NONE)
+{
+}
+
+Properties::Property::Property(const char* internedName, unsigned int hash, const char* value)
+    : name(internedName), hash(hash), value(value), cacheType(PROPERTIES_CACHE_NONE)
+{
+}
+
+Properties::Property* Properties::PropertyTable::find(const char* name)
+{
+    unsigned int hash = hashName(name);
+    if (slots.empty())
+    {
+        for (size_t i = 0, count = properties.size(); i < count; ++i)
+        {
+            Property& prop = properties[i];
+            if (prop.hash == hash && (prop.name == name || strcmp(prop.name, name) == 0))
+                return &prop;
+        }
+        return NULL;
+    }
+
+    unsigned int mask = (unsigned int)slots.size() - 1;
+    for (unsigned int slot = hash & mask; slots[slot]; slot = (slot + 1) & mask)
+    {
+        Property& prop = properties[slots[slot] - 1];
+        if (prop.hash == hash && (prop.name == name || strcmp(prop.name, name) == 0))
+            return &prop;
+    }
+    return NULL;
+}
+
+void Properties::PropertyTable::add(const char* name, const char* value)
+{
+    add(Property(name, value));
+}
+
+void Properties::PropertyTable::add(const Property& prop)
+{
+    properties.push_back(prop);
+    unsigned int count = (unsigned int)properties.size();
+    if (count <= PROPERTIES_HASH_THRESHOLD)
+        return;
+
+    if (count * 2 > slots.size())
+    {
+        // Keep the table at most half full.
+        unsigned int size = 16;
+        while (size < count * 2)
+            size *= 2;
+        slots.assign(size, 0);
+        for (unsigned int i = 0; i < count; ++i)
+            insertSlot(i);
+    }
+    else
+    {
+        insertSlot(count - 1);
+    }
+}
+
+void Properties::PropertyTable::insertSlot(unsigned int index)
+{
+    const Property& prop = properties[index];
+    unsigned int mask = (unsigned int)slots.size() - 1;
+    unsigned int slot = prop.hash & mask;
+    for (; slots[slot]; slot = (slot + 1) & mask)
+    {
+        // Lookups find the first property with a name.
+        const Property& other = properties[slots[slot] - 1];
+        if (other.name == prop.name)
+            return;
+    }
+    slots[slot] = index + 1;
+}
+
+void Properties::PropertyTable::clear()
+{
+    properties.clear();
+    slots.clear();
+}
+
 // Utility functions (shared with SceneLoader).
 /** @script{ignore} */
 void calculateNamespacePath(const std::string& urlString, std::string& fileString, std::vector<std::string>& namespacePath);
@@ -37,12 +175,12 @@ void calculateNamespacePath(const std::string& urlString, std::string& fileStrin
 Properties* getPropertiesFromNamespacePath(Properties* properties, const std::vector<std::string>& namespacePath);
 
 Properties::Properties()
-    : _variables(NULL), _dirPath(NULL), _visited(false), _parent(NULL)
+    : _propertiesItr(PROPERTIES_NO_ITERATOR), _variables(NULL), _dirPath(NULL), _visited(false), _parent(NULL)
 {
 }
 
 Properties::Properties(const Properties& copy)
-    : _namespace(copy._namespace), _id(copy._id), _parentID(copy._parentID), _properties(copy._properties), _variables(NULL), _dirPath(NULL), _visited(false), _parent(copy._parent)
+    : _namespace(copy._namespace), _id(copy._id), _parentID(copy._parentID), _properties(copy._properties), _propertiesItr(PROPERTIES_NO_ITERATOR), _variables(NULL), _dirPath(NULL), _visited(false), _parent(copy._parent)
 {
     setDirectoryPath(copy._dirPath);
     _namespaces = std::vector<Properties*>();
@@ -56,14 +194,14 @@ Properties::Properties(const Properties& copy)
 }
 
 Properties::Properties(Stream* stream)
-    : _variables(NULL), _dirPath(NULL), _visited(false), _parent(NULL)
+    : _propertiesItr(PROPERTIES_NO_ITERATOR), _variables(NULL), _dirPath(NULL), _visited(false), _parent(NULL)
 {
     readProperties(stream);
     rewind();
 }
 
 Properties::Properties(Stream* stream, const char* name, const char* id, const char* parentID, Properties* parent)
-    : _namespace(name), _variables(NULL), _dirPath(NULL), _visited(false), _parent(parent)
+    : _namespace(name), _propertiesItr(PROPERTIES_NO_ITERATOR), _variables(NULL), _dirPath(NULL), _visited(false), _parent(parent)
 {
     if (id)
     {
@@ -95,16 +233,33 @@ Properties* Properties::create(const char* url)
     std::vector<std::string> namespacePath;
     calculateNamespacePath(urlString, fileString, namespacePath);
 
-    std::unique_ptr<Stream> stream(FileSystem::open(fileString.c_str()));
-    if (stream.get() == NULL)
+    // Binary properties are read straight from a mapping of the file when possible.
+    Properties* properties = NULL;
+    size_t size = 0;
+    const char* data = FileSystem::mapFile(fileString.c_str(), &size);
+    bool binary = data && isBinary(data, size);
+    if (binary)
+        properties = createBinary(data, size);
+    FileSystem::unmapFile(data, size);
+
+    if (!binary)
     {
-        GP_WARN("Failed to open file '%s'.", fileString.c_str());
+        std::unique_ptr<Stream> stream(FileSystem::open(fileString.c_str()));
+        if (stream.get() == NULL)
+        {
+            GP_WARN("Failed to open file '%s'.", fileString.c_str());
+            return NULL;
+        }
+
+        properties = Properties::create(stream.get());
+        stream->close();
+    }
+    if (!properties)
+    {
+        GP_WARN("Failed to load properties from file '%s'.", fileString.c_str());
         return NULL;
     }
 
-    Properties* properties = Properties::create(stream.get());
-    stream->close();
-
     // Get the specified properties object.
     Properties* p = getPropertiesFromNamespacePath(properties, namespacePath);
     if (!p)
@@ -128,14 +283,346 @@ Properties* Properties::create(const char* url)
 
 Properties * Properties::create(gameplay::Stream * stream)
 {
+    GP_ASSERT(stream);
+
+    // Load binary properties in one piece.
+    char identifier[PROPERTIES_BINARY_IDENTIFIER_SIZE];
+    long int start = stream->position();
+    if (stream->read(identifier, 1, sizeof(identifier)) == sizeof(identifier) && isBinary(identifier, sizeof(identifier)))
+    {
+        std::vector<char> data(sizeof(identifier));
+        memcpy(&data[0], identifier, sizeof(identifier));
+        char buffer[4096];
+        size_t read;
+        while ((read = stream->read(buffer, 1, sizeof(buffer))) > 0)
+            data.insert(data.end(), buffer, buffer + read);
+        return createBinary(&data[0], data.size());
+    }
+    if (!stream->seek(start, SEEK_SET))
+    {
+        GP_ERROR("Failed to seek back to the start of the properties.");
+        return NULL;
+    }
+
     Properties* properties = new Properties(stream);
     properties->resolveInheritance();
 
     return properties;
 }
 
+bool Properties::isBinary(const char* data, size_t size)
+{
+    return size >= PROPERTIES_BINARY_IDENTIFIER_SIZE && memcmp(data, PROPERTIES_BINARY_IDENTIFIER, PROPERTIES_BINARY_IDENTIFIER_SIZE) == 0;
+}
+
+/**
+ * Collects the strings and records of binary properties.
+ */
+struct PropertiesBinaryWriter
+{
+    std::unordered_map<std::string, unsigned int> stringIndices;
+    std::vector<const std::string*> strings;
+    std::vector<unsigned int> namespaces;
+    std::vector<unsigned int> properties;
+    std::vector<unsigned int> variables;
+
+    unsigned int getString(const std::string& str)
+    {
+        std::pair<std::unordered_map<std::string, unsigned int>::iterator, bool> result =
+            stringIndices.insert(std::make_pair(str, (unsigned int)strings.size()));
+        if (result.second)
+            strings.push_back(&result.first->first);
+        return result.first->second;
+    }
+};
+
+/**
+ * Parses a value the way the typed getters would, for storing it parsed.
+ */
+static unsigned int parseBinaryValue(const char* value, unsigned int* cache)
+{
+    if (value[0] == '$' || !*value)
+        return PROPERTIES_CACHE_NONE;
+
+    unsigned int commaCount = 0;
+    for (const char* c = value; *c; ++c)
+    {
+        if (*c == ',')
+            ++commaCount;
+    }
+
+    float f[4];
+    switch (commaCount)
+    {
+    case 0:
+    {
+        int i;
+        char end;
+        if (!strchr(value, '.') && sscanf(value, "%d%c", &i, &end) == 1)
+        {
+            memcpy(cache, &i, sizeof(i));
+            return PROPERTIES_CACHE_INT;
+        }
+        if (sscanf(value, "%f%c", &f[0], &end) == 1)
+        {
+            memcpy(cache, f, sizeof(float));
+            return PROPERTIES_CACHE_FLOAT;
+        }
+        return PROPERTIES_CACHE_NONE;
+    }
+    case 1:
+        if (sscanf(value, "%f,%f", &f[0], &f[1]) != 2)
+            return PROPERTIES_CACHE_NONE;
+        memcpy(cache, f, sizeof(float) * 2);
+        return PROPERTIES_CACHE_VECTOR2;
+    case 2:
+        if (sscanf(value, "%f,%f,%f", &f[0], &f[1], &f[2]) != 3)
+            return PROPERTIES_CACHE_NONE;
+        memcpy(cache, f, sizeof(float) * 3);
+        return PROPERTIES_CACHE_VECTOR3;
+    case 3:
+        if (sscanf(value, "%f,%f,%f,%f", &f[0], &f[1], &f[2], &f[3]) != 4)
+            return PROPERTIES_CACHE_NONE;
+        memcpy(cache, f, sizeof(float) * 4);
+        return PROPERTIES_CACHE_VECTOR4;
+    default:
+        return PROPERTIES_CACHE_NONE;
+    }
+}
+
+bool Properties::writeBinary(Stream* stream) const
+{
+    GP_ASSERT(stream);
+
+    PropertiesBinaryWriter writer;
+    writer.getString("");
+
+    // Flatten the namespaces depth first.
+    std::vector<const Properties*> stack(1, this);
+    while (!stack.empty())
+    {
+        const Properties* p = stack.back();
+        stack.pop_back();
+
+        const std::vector<Property>& properties = p->_properties.properties;
+        size_t variableCount = p->_variables ? p->_variables->size() : 0;
+        writer.namespaces.push_back(writer.getString(p->_namespace));
+        writer.namespaces.push_back(writer.getString(p->_id));
+        writer.namespaces.push_back(writer.getString(p->_parentID));
+        writer.namespaces.push_back((unsigned int)p->_namespaces.size());
+        writer.namespaces.push_back((unsigned int)properties.size());
+        writer.namespaces.push_back((unsigned int)variableCount);
+
+        for (size_t i = 0, count = properties.size(); i < count; ++i)
+        {
+            unsigned int cache[4] = { 0, 0, 0, 0 };
+            unsigned int cacheType = parseBinaryValue(properties[i].value.c_str(), cache);
+            writer.properties.push_back(writer.getString(properties[i].name));
+            writer.properties.push_back(writer.getString(properties[i].value));
+            writer.properties.push_back(cacheType);
+            writer.properties.insert(writer.properties.end(), cache, cache + 4);
+        }
+        for (size_t i = 0; i < variableCount; ++i)
+        {
+            writer.variables.push_back(writer.getString((*p->_variables)[i].name));
+            writer.variables.push_back(writer.getString((*p->_variables)[i].value));
+        }
+
+        // Push the children in reverse so they come out in order.
+        for (size_t i = p->_namespaces.size(); i > 0; --i)
+            stack.push_back(p->_namespaces[i - 1]);
+    }
+
+    std::vector<unsigned int> offsets;
+    std::string stringData;
+    for (size_t i = 0, count = writer.strings.size(); i < count; ++i)
+    {
+        offsets.push_back((unsigned int)stringData.size());
+        stringData.append(writer.strings[i]->c_str(), writer.strings[i]->size() + 1);
+    }
+    stringData.resize((stringData.size() + 3) & ~(size_t)3, '\0');
+
+    unsigned int header[PROPERTIES_BINARY_HEADER_WORDS + 1] =
+    {
+        PROPERTIES_BINARY_VERSION,
+        (unsigned int)offsets.size(),
+        (unsigned int)stringData.size(),
+        (unsigned int)(writer.namespaces.size() / PROPERTIES_BINARY_NAMESPACE_WORDS),
+        (unsigned int)(writer.properties.size() / PROPERTIES_BINARY_PROPERTY_WORDS),
+        (unsigned int)(writer.variables.size() / PROPERTIES_BINARY_VARIABLE_WORDS),
+        0
+    };
+
+    // The identifier is padded so that the words that follow are aligned.
+    char identifier[12] = { 0 };
+    memcpy(identifier, PROPERTIES_BINARY_IDENTIFIER, PROPERTIES_BINARY_IDENTIFIER_SIZE);
+    bool result = stream->write(identifier, 1, sizeof(identifier)) == sizeof(identifier) &&
+        stream->write(header, sizeof(unsigned int), PROPERTIES_BINARY_HEADER_WORDS) == PROPERTIES_BINARY_HEADER_WORDS &&
+        stream->write(&offsets[0], sizeof(unsigned int), offsets.size()) == offsets.size() &&
+        stream->write(stringData.data(), 1, stringData.size()) == stringData.size() &&
+        stream->write(&writer.namespaces[0], sizeof(unsigned int), writer.namespaces.size()) == writer.namespaces.size() &&
+        (writer.properties.empty() || stream->write(&writer.properties[0], sizeof(unsigned int), writer.properties.size()) == writer.properties.size()) &&
+        (writer.variables.empty() || stream->write(&writer.variables[0], sizeof(unsigned int), writer.variables.size()) == writer.variables.size());
+    if (!result)
+        GP_WARN("Failed to write binary properties.");
+    return result;
+}
+
+bool Properties::convertToBinary(const char* filePath, const char* binaryFilePath)
+{
+    GP_ASSERT(filePath);
+    GP_ASSERT(binaryFilePath);
+
+    // The whole source file is loaded before the destination is opened, so both may be the same file.
+    std::unique_ptr<Properties> properties(Properties::create(filePath));
+    if (properties.get() == NULL)
+        return false;
+
+    std::unique_ptr<Stream> stream(FileSystem::open(binaryFilePath, FileSystem::WRITE));
+    if (stream.get() == NULL)
+    {
+        GP_WARN("Failed to open file '%s' for writing.", binaryFilePath);
+        return false;
+    }
+    bool result = properties->writeBinary(stream.get());
+    stream->close();
+    return result;
+}
+
+Properties* Properties::createBinary(const char* data, size_t size)
+{
+    GP_ASSERT(isBinary(data, size));
+
+    const size_t headerSize = 12 + PROPERTIES_BINARY_HEADER_WORDS * sizeof(unsigned int);
+    if (size < headerSize)
+    {
+        GP_WARN("Binary properties are truncated.");
+        return NULL;
+    }
+    unsigned int header[PROPERTIES_BINARY_HEADER_WORDS];
+    memcpy(header, data + 12, sizeof(header));
+    if (header[0] != PROPERTIES_BINARY_VERSION)
+    {
+        GP_WARN("Unsupported binary properties version %u.", header[0]);
+        return NULL;
+    }
+
+    // Check that all sections fit in the data before reading any of them.
+    unsigned int stringCount = header[1];
+    size_t stringDataSize = header[2];
+    unsigned int namespaceCount = header[3];
+    unsigned int propertyCount = header[4];
+    unsigned int variableCount = header[5];
+    size_t offsetsStart = headerSize;
+    size_t stringsStart = offsetsStart + (size_t)stringCount * sizeof(unsigned int);
+    size_t namespacesStart = stringsStart + stringDataSize;
+    size_t propertiesStart = namespacesStart + (size_t)namespaceCount * PROPERTIES_BINARY_NAMESPACE_WORDS * sizeof(unsigned int);
+    size_t variablesStart = propertiesStart + (size_t)propertyCount * PROPERTIES_BINARY_PROPERTY_WORDS * sizeof(unsigned int);
+    size_t end = variablesStart + (size_t)variableCount * PROPERTIES_BINARY_VARIABLE_WORDS * sizeof(unsigned int);
+    if (end > size || namespaceCount == 0 || stringCount == 0 || stringDataSize == 0 || data[namespacesStart - 1] != 0)
+    {
+        GP_WARN("Binary properties are truncated.");
+        return NULL;
+    }
+
+    // Mapped files are page aligned and the sections are word aligned, so the words can be read in place.
+    const unsigned int* offsets = (const unsigned int*)(data + offsetsStart);
+    const char* strings = data + stringsStart;
+    const unsigned int* namespaces = (const unsigned int*)(data + namespacesStart);
+    const unsigned int* properties = (const unsigned int*)(data + propertiesStart);
+    const unsigned int* variables = (const unsigned int*)(data + variablesStart);
+    for (unsigned int i = 0; i < stringCount; ++i)
+    {
+        if (offsets[i] >= stringDataSize)
+        {
+            GP_WARN("Binary properties are corrupt.");
+            return NULL;
+        }
+    }
+
+    // Names are interned once per string rather than once per property.
+    std::vector<const char*> names(stringCount, (const char*)NULL);
+    std::vector<unsigned int> hashes(stringCount, 0);
+
+#define PROPERTIES_BINARY_STRING(index) ((index) < stringCount ? strings + offsets[index] : "")
+
+    Properties* root = NULL;
+    std::vector<std::pair<Properties*, unsigned int> > parents;   // namespace and its remaining children
+    unsigned int propertyIndex = 0;
+    unsigned int variableIndex = 0;
+    for (unsigned int i = 0; i < namespaceCount; ++i)
+    {
+        const unsigned int* record = namespaces + i * PROPERTIES_BINARY_NAMESPACE_WORDS;
+        Properties* parent = parents.empty() ? NULL : parents.back().first;
+        if (i > 0 && !parent)
+            break;
+
+        Properties* p = new Properties();
+        p->_namespace = PROPERTIES_BINARY_STRING(record[0]);
+        p->_id = PROPERTIES_BINARY_STRING(record[1]);
+        p->_parentID = PROPERTIES_BINARY_STRING(record[2]);
+        p->_parent = parent;
+        if (parent)
+        {
+            parent->_namespaces.push_back(p);
+            if (--parents.back().second == 0)
+                parents.pop_back();
+        }
+        else
+        {
+            root = p;
+        }
+
+        if (propertyIndex + record[4] > propertyCount || variableIndex + record[5] > variableCount)
+            break;
+        p->_properties.properties.reserve(record[4]);
+        for (unsigned int j = 0; j < record[4]; ++j, ++propertyIndex)
+        {
+            const unsigned int* prop = properties + propertyIndex * PROPERTIES_BINARY_PROPERTY_WORDS;
+            unsigned int name = prop[0] < stringCount ? prop[0] : 0;
+            if (!names[name])
+            {
+                names[name] = internName(strings + offsets[name]);
+                hashes[name] = hashName(names[name]);
+            }
+            Property property(names[name], hashes[name], PROPERTIES_BINARY_STRING(prop[1]));
+            if (prop[2] <= PROPERTIES_CACHE_VECTOR4)
+            {
+                property.cacheType = prop[2];
+                memcpy(&property.cache, prop + 3, sizeof(property.cache));
+            }
+            p->_properties.add(property);
+        }
+        for (unsigned int j = 0; j < record[5]; ++j, ++variableIndex)
+        {
+            const unsigned int* variable = variables + variableIndex * PROPERTIES_BINARY_VARIABLE_WORDS;
+            if (!p->_variables)
+                p->_variables = new std::vector<Property>();
+            p->_variables->push_back(Property(PROPERTIES_BINARY_STRING(variable[0]), PROPERTIES_BINARY_STRING(variable[1])));
+        }
+
+        if (record[3] > 0)
+            parents.push_back(std::make_pair(p, record[3]));
+        p->rewind();
+    }
+
+#undef PROPERTIES_BINARY_STRING
+
+    if (!parents.empty() || propertyIndex != propertyCount || variableIndex != variableCount)
+    {
+        GP_WARN("Binary properties are corrupt.");
+        SAFE_DELETE(root);
+        return NULL;
+    }
+    return root;
+}
+
 static bool isVariable(const char* str, char* outName, size_t outSize)
 {
+    // Most names and values are not variables, so reject them before measuring.
+    if (str[0] != '$')
+        return false;
+
     size_t len = strlen(str);
     if (len > 3 && str[0] == '$' && str[1] == '{' && str[len - 1] == '}')
     {
@@ -240,7 +727,7 @@ bool Properties::readPropertiesYAML( Stream * stream )
                     if (isVariable(name.c_str(), variable, 256))
                         processingProperties->setVariable(variable, value.c_str());
                     else
-                        processingProperties->_properties.push_back(Property(name.c_str(), value.c_str()));
+                        processingProperties->_properties.add(name.c_str(), value.c_str());
                 }
                 name.clear( );
                 state = EPSM_READY;
@@ -270,7 +757,7 @@ bool Properties::readPropertiesYAML( Stream * stream )
                 if( !sequence.empty( ) )
                 {
                     sequence.erase( sequence.size( ) - 1 );
-                    processingProperties->_properties.push_back( Property( name.c_str( ), sequence.c_str( ) ) );
+                    processingProperties->_properties.add( name.c_str( ), sequence.c_str( ) );
                     parsedAnything = true;
                 }
                 state = EPSM_READY;
@@ -423,7 +910,7 @@ void Properties::readProperties(Stream* stream)
                 else
                 {
                     // Normal name/value pair
-                    _properties.push_back(Property(name, value));
+                    _properties.add(name, value);
                 }
             }
             else
@@ -571,11 +1058,11 @@ void Properties::readProperties(Stream* stream)
                             // Store "name value" as a name/value pair, or even just "name".
                             if (value != NULL)
                             {
-                                _properties.push_back(Property(name, value));
+                                _properties.add(name, value);
                             }
                             else
                             {
-                                _properties.push_back(Property(name, ""));
+                                _properties.add(name, "");
                             }
                         }
                     }
@@ -727,7 +1214,7 @@ void Properties::mergeWith(Properties* overrides)
     while (name)
     {
         char variable[256];
-        const char * value = overrides->_propertiesItr->value.c_str();
+        const char * value = overrides->_properties.properties[overrides->_propertiesItr].value.c_str();
         if (!isVariable(value, variable, 256))
             setString(name, value);
         else
@@ -740,7 +1227,7 @@ void Properties::mergeWith(Properties* overrides)
                 for (size_t i = 0, count = current->_variables->size(); i < count; ++i)
                 {
                     Property* p = &(*current->_variables)[i];
-                    if (p->name == name)
+                    if (strcmp(p->name, name) == 0)
                     {
                         prop = p;
                         break;
@@ -763,7 +1250,7 @@ void Properties::mergeWith(Properties* overrides)
         }
         name = overrides->getNextProperty();
     }
-    this->_propertiesItr = this->_properties.end();
+    this->_propertiesItr = PROPERTIES_NO_ITERATOR;
 
     // Merge all common nested namespaces, add new ones.
     Properties* overridesNamespace = overrides->getNextNamespace();
@@ -800,10 +1287,10 @@ void Properties::mergeWith(Properties* overrides)
 
 const char* Properties::getNextProperty()
 {
-    if (_propertiesItr == _properties.end())
+    if (_propertiesItr == PROPERTIES_NO_ITERATOR)
     {
         // Restart from the beginning
-        _propertiesItr = _properties.begin();
+        _propertiesItr = 0;
     }
     else
     {
@@ -811,7 +1298,12 @@ const char* Properties::getNextProperty()
         ++_propertiesItr;
     }
 
-    return _propertiesItr == _properties.end() ? NULL : _propertiesItr->name.c_str();
+    if (_propertiesItr >= _properties.properties.size())
+    {
+        _propertiesItr = PROPERTIES_NO_ITERATOR;
+        return NULL;
+    }
+    return _properties.properties[_propertiesItr].name;
 }
 
 Properties* Properties::getNextNamespace()
@@ -837,7 +1329,7 @@ Properties* Properties::getNextNamespace()
 
 void Properties::rewind()
 {
-    _propertiesItr = _properties.end();
+    _propertiesItr = PROPERTIES_NO_ITERATOR;
     _namespacesItr = _namespaces.end();
 }
 
@@ -878,13 +1370,7 @@ bool Properties::exists(const char* name) const
     if (name == NULL)
         return false;
 
-    for (std::list<Property>::const_iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
-    {
-        if (itr->name == name)
-            return true;
-    }
-
-    return false;
+    return const_cast<PropertyTable&>(_properties).find(name) != NULL;
 }
 
 static const bool isStringNumeric(const char* str)
@@ -968,21 +1454,16 @@ const char* Properties::getString(const char* name, const char* defaultValue) co
             return getVariable(variable, defaultValue);
         }
 
-        for (std::list<Property>::const_iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
-        {
-            if (itr->name == name)
-            {
-                value = itr->value.c_str();
-                break;
-            }
-        }
+        const Property* prop = const_cast<PropertyTable&>(_properties).find(name);
+        if (prop)
+            value = prop->value.c_str();
     }
     else
     {
         // No name provided - get the value at the current iterator position
-        if (_propertiesItr != _properties.end())
+        if (_propertiesItr < _properties.properties.size())
         {
-            value = _propertiesItr->value.c_str();
+            value = _properties.properties[_propertiesItr].value.c_str();
         }
     }
 
@@ -997,26 +1478,27 @@ bool Properties::setString(const char* name, const char* value)
 {
     if (name)
     {
-        for (std::list<Property>::iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
+        Property* prop = _properties.find(name);
+        if (prop)
         {
-            if (itr->name == name)
-            {
-                // Update the first property that matches this name
-                itr->value = value ? value : "";
-                return true;
-            }
+            // Update the first property that matches this name
+            prop->value = value ? value : "";
+            prop->cacheType = PROPERTIES_CACHE_NONE;
+            return true;
         }
 
         // There is no property with this name, so add one
-        _properties.push_back(Property(name, value ? value : ""));
+        _properties.add(name, value ? value : "");
     }
     else
     {
         // If there's a current property, set its value
-        if (_propertiesItr == _properties.end())
+        if (_propertiesItr >= _properties.properties.size())
             return false;
 
-        _propertiesItr->value = value ? value : "";
+        Property& prop = _properties.properties[_propertiesItr];
+        prop.value = value ? value : "";
+        prop.cacheType = PROPERTIES_CACHE_NONE;
     }
 
     return true;
@@ -1035,6 +1517,10 @@ bool Properties::getBool(const char* name, bool defaultValue) const
 
 int Properties::getInt(const char* name) const
 {
+    const Property* prop = findCachedProperty(name);
+    if (prop && prop->cacheType == PROPERTIES_CACHE_INT)
+        return prop->cache.i;
+
     const char* valueString = getString(name);
     if (valueString)
     {
@@ -1046,6 +1532,11 @@ int Properties::getInt(const char* name) const
             GP_ERROR("Error attempting to parse property '%s' as an integer.", name);
             return 0;
         }
+        if (prop)
+        {
+            prop->cache.i = value;
+            prop->cacheType = PROPERTIES_CACHE_INT;
+        }
         return value;
     }
 
@@ -1054,6 +1545,10 @@ int Properties::getInt(const char* name) const
 
 float Properties::getFloat(const char* name) const
 {
+    const Property* prop = findCachedProperty(name);
+    if (prop && prop->cacheType == PROPERTIES_CACHE_FLOAT)
+        return prop->cache.f[0];
+
     const char* valueString = getString(name);
     if (valueString)
     {
@@ -1065,6 +1560,11 @@ float Properties::getFloat(const char* name) const
             GP_ERROR("Error attempting to parse property '%s' as a float.", name);
             return 0.0f;
         }
+        if (prop)
+        {
+            prop->cache.f[0] = value;
+            prop->cacheType = PROPERTIES_CACHE_FLOAT;
+        }
         return value;
     }
 
@@ -1073,6 +1573,10 @@ float Properties::getFloat(const char* name) const
 
 long Properties::getLong(const char* name) const
 {
+    const Property* prop = findCachedProperty(name);
+    if (prop && prop->cacheType == PROPERTIES_CACHE_LONG)
+        return prop->cache.l;
+
     const char* valueString = getString(name);
     if (valueString)
     {
@@ -1084,6 +1588,11 @@ long Properties::getLong(const char* name) const
             GP_ERROR("Error attempting to parse property '%s' as a long integer.", name);
             return 0L;
         }
+        if (prop)
+        {
+            prop->cache.l = value;
+            prop->cacheType = PROPERTIES_CACHE_LONG;
+        }
         return value;
     }
 
@@ -1120,17 +1629,74 @@ bool Properties::getMatrix(const char* name, Matrix* out) const
 
 bool Properties::getVector2(const char* name, Vector2* out) const
 {
-    return parseVector2(getString(name), out);
+    if (!out)
+        return parseVector2(getString(name), NULL);
+
+    const Property* prop = findCachedProperty(name);
+    if (prop && prop->cacheType == PROPERTIES_CACHE_VECTOR2)
+    {
+        out->set(prop->cache.f[0], prop->cache.f[1]);
+        return true;
+    }
+
+    if (!parseVector2(getString(name), out))
+        return false;
+    if (prop)
+    {
+        prop->cache.f[0] = out->x;
+        prop->cache.f[1] = out->y;
+        prop->cacheType = PROPERTIES_CACHE_VECTOR2;
+    }
+    return true;
 }
 
 bool Properties::getVector3(const char* name, Vector3* out) const
 {
-    return parseVector3(getString(name), out);
+    if (!out)
+        return parseVector3(getString(name), NULL);
+
+    const Property* prop = findCachedProperty(name);
+    if (prop && prop->cacheType == PROPERTIES_CACHE_VECTOR3)
+    {
+        out->set(prop->cache.f[0], prop->cache.f[1], prop->cache.f[2]);
+        return true;
+    }
+
+    if (!parseVector3(getString(name), out))
+        return false;
+    if (prop)
+    {
+        prop->cache.f[0] = out->x;
+        prop->cache.f[1] = out->y;
+        prop->cache.f[2] = out->z;
+        prop->cacheType = PROPERTIES_CACHE_VECTOR3;
+    }
+    return true;
 }
 
 bool Properties::getVector4(const char* name, Vector4* out) const
 {
-    return parseVector4(getString(name), out);
+    if (!out)
+        return parseVector4(getString(name), NULL);
+
+    const Property* prop = findCachedProperty(name);
+    if (prop && prop->cacheType == PROPERTIES_CACHE_VECTOR4)
+    {
+        out->set(prop->cache.f[0], prop->cache.f[1], prop->cache.f[2], prop->cache.f[3]);
+        return true;
+    }
+
+    if (!parseVector4(getString(name), out))
+        return false;
+    if (prop)
+    {
+        prop->cache.f[0] = out->x;
+        prop->cache.f[1] = out->y;
+        prop->cache.f[2] = out->z;
+        prop->cache.f[3] = out->w;
+        prop->cacheType = PROPERTIES_CACHE_VECTOR4;
+    }
+    return true;
 }
 
 bool Properties::getQuaternionFromAxisAngle(const char* name, Quaternion* out) const
@@ -1194,7 +1760,7 @@ const char* Properties::getVariable(const char* name, const char* defaultValue)
         for (size_t i = 0, count = _variables->size(); i < count; ++i)
         {
             Property& prop = (*_variables)[i];
-            if (prop.name == name)
+            if (strcmp(prop.name, name) == 0)
                 return prop.value.c_str();
         }
     }
@@ -1218,7 +1784,7 @@ void Properties::setVariable(const char* name, const char* value)
             for (size_t i = 0, count = current->_variables->size(); i < count; ++i)
             {
                 Property* p = &(*current->_variables)[i];
-                if (p->name == name)
+                if (strcmp(p->name, name) == 0)
                 {
                     prop = p;
                     break;
@@ -1242,6 +1808,24 @@ void Properties::setVariable(const char* name, const char* value)
     }
 }
 
+const Properties::Property* Properties::findCachedProperty(const char* name) const
+{
+    const Property* prop = NULL;
+    if (name)
+    {
+        if (name[0] == '$')
+            return NULL;
+        prop = const_cast<PropertyTable&>(_properties).find(name);
+    }
+    else if (_propertiesItr < _properties.properties.size())
+    {
+        prop = &_properties.properties[_propertiesItr];
+    }
+
+    // Values that refer to variables can change without the property changing.
+    return prop && prop->value.c_str()[0] != '$' ? prop : NULL;
+}
+
 Properties* Properties::clone()
 {
     Properties* p = new Properties();
@@ -1250,7 +1834,7 @@ Properties* Properties::clone()
     p->_id = _id;
     p->_parentID = _parentID;
     p->_properties = _properties;
-    p->_propertiesItr = p->_properties.end();
+    p->_propertiesItr = PROPERTIES_NO_ITERATOR;
     p->setDirectoryPath(_dirPath);
 
     for (size_t i = 0, count = _namespaces.size(); i < count; i++)
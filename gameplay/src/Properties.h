@@ -175,6 +175,43 @@ public:
      */
     static Properties* create(gameplay::Stream * stream);
 
+    /**
+     * Writes these properties and all nested namespaces to a stream in the
+     * binary properties format.
+     *
+     * Both create() functions recognize binary properties and load them
+     * without parsing: inheritance is already resolved, names are stored
+     * once in a string table and numbers and vectors are stored parsed.
+     * Files on the local file system are read through a memory mapping.
+     *
+     * Write the properties returned by create() for a whole file, so that
+     * the binary file can replace the text file.
+     *
+     * @param stream The stream to write to.
+     *
+     * @return True if the properties were written, false if there was an error.
+     * @script{ignore}
+     */
+    bool writeBinary(Stream* stream) const;
+
+    /**
+     * Converts a properties file to the binary properties format.
+     *
+     * This is the entry point for producing binary properties at build time:
+     * a build step or a development build of the game calls it for each of
+     * the shipped .material, .form, .scene and similar files, and ships the
+     * binary files under the original names. The source file may already be
+     * binary, in which case it is rewritten in the current version.
+     *
+     * @param filePath The path to the properties file to convert.
+     * @param binaryFilePath The path to write the binary properties to. It may
+     *      be the same as filePath to convert the file in place.
+     *
+     * @return True if the file was converted, false if there was an error.
+     * @script{ignore}
+     */
+    static bool convertToBinary(const char* filePath, const char* binaryFilePath);
+
     /**
      * Destructor.
      */
@@ -530,12 +567,39 @@ private:
     
     /**
      * Internal structure containing a single property.
+     *
+     * Names are interned, so equal names share one string. Numbers and vectors
+     * read from the value are cached until the value changes.
      */
     struct Property
     {
-        std::string name;
+        const char* name;
+        unsigned int hash;
         std::string value;
-        Property(const char* name, const char* value) : name(name), value(value) { }
+        mutable unsigned int cacheType;
+        mutable union
+        {
+            int i;
+            long l;
+            float f[4];
+        } cache;
+        Property(const char* name, const char* value);
+        Property(const char* internedName, unsigned int hash, const char* value);
+    };
+
+    /**
+     * The properties of a namespace in the order they were added, with a hash
+     * table of the first property of each name once there are enough of them.
+     */
+    struct PropertyTable
+    {
+        std::vector<Property> properties;
+        std::vector<unsigned int> slots;    // open addressing, 0 for empty slots, else the property index + 1
+        Property* find(const char* name);
+        void add(const char* name, const char* value);
+        void add(const Property& prop);
+        void clear();
+        void insertSlot(unsigned int index);
     };
 
     /**
@@ -576,11 +640,20 @@ private:
     // Called after create(); copies info from parents into derived namespaces.
     void resolveInheritance(const char* id = NULL);
 
+    // Gets the property whose typed value can be cached, or NULL if the name or the value is a variable.
+    const Property* findCachedProperty(const char* name) const;
+
+    // Creates properties from data in the binary format, or returns NULL if the data is not valid.
+    static Properties* createBinary(const char* data, size_t size);
+
+    // Determines if data starts with the identifier of the binary format.
+    static bool isBinary(const char* data, size_t size);
+
     std::string _namespace;
     std::string _id;
     std::string _parentID;
-    std::list<Property> _properties;
-    std::list<Property>::iterator _propertiesItr;
+    PropertyTable _properties;
+    size_t _propertiesItr;
     std::vector<Properties*> _namespaces;
     std::vector<Properties*>::const_iterator _namespacesItr;
     std::vector<Property>* _variables;
@@ -0,0 +1,256 @@
+#include "Base.h"
+#include "RenderQueue.h"
+#include "Camera.h"
+#include "Scene.h"
+#include "Node.h"
+#include "Model.h"
+#include "Terrain.h"
+#include "TerrainPatch.h"
+#include "ParticleEmitter.h"
+#include "MeshPart.h"
+#include "Technique.h"
+#include "Pass.h"
+
+// Layout of the sort key of opaque items, from the most significant bit:
+// 1 bit blended (0), 3 bits pass index, 15 bits effect, 13 bits material, 32 bits depth.
+// Blended items: 1 bit blended (1), 32 bits inverted depth, 31 bits unused.
+#define RENDER_QUEUE_BLENDED_BIT (1ULL << 63)
+#define RENDER_QUEUE_PASS_SHIFT 60
+#define RENDER_QUEUE_PASS_MASK 0x7ULL
+#define RENDER_QUEUE_EFFECT_SHIFT 45
+#define RENDER_QUEUE_EFFECT_MASK 0x7FFFULL
+#define RENDER_QUEUE_MATERIAL_SHIFT 32
+#define RENDER_QUEUE_MATERIAL_MASK 0x1FFFULL
+#define RENDER_QUEUE_BLENDED_DEPTH_SHIFT 31
+
+namespace gameplay
+{
+
+RenderQueue::Statistics RenderQueue::_statistics = { 0, 0, 0 };
+
+/**
+ * Maps a depth to bits that sort in the same order. The bit patterns of
+ * non-negative floats are ordered like the floats, so negative depths (behind
+ * the camera) are clamped to zero.
+ */
+static unsigned long long depthBits(float depth)
+{
+    if (!(depth > 0.0f))
+        depth = 0.0f;
+    unsigned int bits;
+    memcpy(&bits, &depth, sizeof(bits));
+    return bits;
+}
+
+/**
+ * Folds a pointer into a few bits. Only equal pointers need equal hashes,
+ * since the hash just groups items that share an object.
+ */
+static unsigned long long hashPointer(const void* pointer)
+{
+    size_t value = (size_t)pointer;
+    return (unsigned long long)((value >> 4) ^ (value >> 19));
+}
+
+/**
+ * Determines whether any pass of a material blends.
+ */
+static bool isBlended(Material* material)
+{
+    Technique* technique = material->getTechnique();
+    GP_ASSERT(technique);
+    for (unsigned int i = 0, count = technique->getPassCount(); i < count; ++i)
+    {
+        if (technique->getPassByIndex(i)->isBlendEnabled())
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Determines whether a drawable that is drawn whole blends, from the render
+ * state of its materials. Drawables without materials of their own (text and
+ * forms) draw through blended sprite batches.
+ */
+static bool isBlended(Drawable* drawable)
+{
+    Terrain* terrain = dynamic_cast<Terrain*>(drawable);
+    if (terrain)
+    {
+        for (unsigned int i = 0, patchCount = terrain->getPatchCount(); i < patchCount; ++i)
+        {
+            TerrainPatch* patch = terrain->getPatch(i);
+            for (unsigned int j = 0, materialCount = patch->getMaterialCount(); j < materialCount; ++j)
+            {
+                Material* material = patch->getMaterial(j);
+                if (material && isBlended(material))
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    ParticleEmitter* emitter = dynamic_cast<ParticleEmitter*>(drawable);
+    if (emitter)
+        return emitter->getBlendMode() != ParticleEmitter::BLEND_NONE;
+
+    return true;
+}
+
+RenderQueue::RenderQueue()
+    : _camera(NULL), _sorted(true)
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+}
+
+RenderQueue* RenderQueue::create()
+{
+    return new RenderQueue();
+}
+
+void RenderQueue::begin(Camera* camera)
+{
+    _camera = camera;
+    _items.clear();
+    _sorted = true;
+}
+
+void RenderQueue::add(Node* node)
+{
+    GP_ASSERT(node);
+
+    Drawable* drawable = node->getDrawable();
+    if (!drawable)
+        return;
+
+    const unsigned long long depth = depthBits(getDepth(node));
+    _sorted = false;
+
+    Model* model = dynamic_cast<Model*>(drawable);
+    if (!model)
+    {
+        // Drawables other than models are drawn whole, so opaque ones are grouped by
+        // drawable in place of the material and drawn front to back with the models.
+        unsigned long long key;
+        if (isBlended(drawable))
+            key = RENDER_QUEUE_BLENDED_BIT | (~depth & 0xFFFFFFFFULL) << RENDER_QUEUE_BLENDED_DEPTH_SHIFT;
+        else
+            key = (hashPointer(drawable) & RENDER_QUEUE_MATERIAL_MASK) << RENDER_QUEUE_MATERIAL_SHIFT | depth;
+        Item item = { key, node, NULL, NULL };
+        _items.push_back(item);
+        return;
+    }
+
+    Mesh* mesh = model->getMesh();
+    GP_ASSERT(mesh);
+    unsigned int partCount = mesh->getPartCount();
+    for (unsigned int i = 0, count = partCount > 0 ? partCount : 1; i < count; ++i)
+    {
+        // A mesh without parts is drawn whole with the shared material.
+        MeshPart* part = partCount > 0 ? mesh->getPart(i) : NULL;
+        Material* material = partCount > 0 ? model->getMaterial(i) : model->getMaterial();
+        if (!material)
+            continue;
+
+        Technique* technique = material->getTechnique();
+        GP_ASSERT(technique);
+        for (unsigned int j = 0, passCount = technique->getPassCount(); j < passCount; ++j)
+        {
+            Pass* pass = technique->getPassByIndex(j);
+            GP_ASSERT(pass);
+
+            unsigned long long key;
+            if (pass->isBlendEnabled())
+            {
+                key = RENDER_QUEUE_BLENDED_BIT | (~depth & 0xFFFFFFFFULL) << RENDER_QUEUE_BLENDED_DEPTH_SHIFT;
+            }
+            else
+            {
+                // Effects are shared per program, so the effect identifies the program.
+                unsigned long long effectHash = hashPointer(pass->getEffect());
+                unsigned long long materialHash = hashPointer(material);
+                key = (unsigned long long)std::min(j, (unsigned int)RENDER_QUEUE_PASS_MASK) << RENDER_QUEUE_PASS_SHIFT |
+                    (effectHash & RENDER_QUEUE_EFFECT_MASK) << RENDER_QUEUE_EFFECT_SHIFT |
+                    (materialHash & RENDER_QUEUE_MATERIAL_MASK) << RENDER_QUEUE_MATERIAL_SHIFT |
+                    depth;
+            }
+            Item item = { key, node, part, pass };
+            _items.push_back(item);
+        }
+    }
+}
+
+unsigned int RenderQueue::addScene(Scene* scene)
+{
+    GP_ASSERT(scene);
+
+    _visibleNodes.clear();
+    scene->findVisibleNodes(_camera, _visibleNodes);
+    for (size_t i = 0, count = _visibleNodes.size(); i < count; ++i)
+    {
+        add(_visibleNodes[i]);
+    }
+    return (unsigned int)_visibleNodes.size();
+}
+
+unsigned int RenderQueue::draw(bool wireframe)
+{
+    GP_PROFILE_SCOPE("RenderQueue::draw");
+
+    if (!_sorted)
+    {
+        // The stable sort keeps the add order of items with equal keys.
+        std::stable_sort(_items.begin(), _items.end(), [](const Item& a, const Item& b) { return a.key < b.key; });
+        _sorted = true;
+    }
+
+    for (size_t i = 0, count = _items.size(); i < count; ++i)
+    {
+        const Item& item = _items[i];
+        Drawable* drawable = item.node->getDrawable();
+        GP_ASSERT(drawable);
+        if (item.pass)
+        {
+            static_cast<Model*>(drawable)->drawPass(item.part, item.pass, wireframe);
+        }
+        else
+        {
+            drawable->draw(wireframe);
+        }
+    }
+    return (unsigned int)_items.size();
+}
+
+unsigned int RenderQueue::getItemCount() const
+{
+    return (unsigned int)_items.size();
+}
+
+const RenderQueue::Statistics& RenderQueue::getStatistics()
+{
+    return _statistics;
+}
+
+void RenderQueue::resetStatistics()
+{
+    _statistics.drawCalls = 0;
+    _statistics.programSwitches = 0;
+    _statistics.uniformUploads = 0;
+}
+
+float RenderQueue::getDepth(Node* node) const
+{
+    if (!_camera)
+        return 0.0f;
+
+    Vector3 position = node->getTranslationWorld();
+    _camera->getViewMatrix().transformPoint(&position);
+
+    // The camera looks down the negative z axis in view space.
+    return -position.z;
+}
+
+}
@@ -0,0 +1,174 @@
+#ifndef RENDERQUEUE_H_
+#define RENDERQUEUE_H_
+
+#include "Ref.h"
+
+namespace gameplay
+{
+
+class Camera;
+class Scene;
+class Node;
+class MeshPart;
+class Pass;
+
+/**
+ * Defines a queue of draw items that are sorted before they are submitted.
+ *
+ * Models are split into one item per mesh part and pass, and each item gets
+ * a 64-bit sort key. Opaque items are drawn first, grouped by pass index,
+ * effect and material and then front to back, so that consecutive draws
+ * share as much state as possible and early depth rejection works. Items
+ * whose pass enables blending are drawn afterwards, back to front.
+ * Drawables other than models are drawn as a whole, among the opaque items
+ * when none of their materials blend and among the blended items otherwise.
+ *
+ * Redundant state changes between the sorted items are skipped by the layers
+ * below: Effect::bind() does not re-bind the current program, uniforms are
+ * only uploaded when their value changes, and the fixed-function state is
+ * only restored where it differs. The number of draw calls, program switches
+ * and uniform uploads is counted in getStatistics(), whether or not the
+ * queue is used.
+ *
+ * @script{ignore}
+ */
+class RenderQueue : public Ref
+{
+    friend class Effect;
+    friend class Model;
+    friend class MeshBatch;
+
+public:
+
+    /**
+     * Counters of the work submitted to the graphics device.
+     */
+    struct Statistics
+    {
+        /**
+         * The number of draw calls issued by models and mesh batches.
+         */
+        unsigned int drawCalls;
+
+        /**
+         * The number of times a different shader program was bound.
+         */
+        unsigned int programSwitches;
+
+        /**
+         * The number of uniform values uploaded.
+         */
+        unsigned int uniformUploads;
+    };
+
+    /**
+     * Creates an empty render queue.
+     *
+     * @return The new render queue.
+     */
+    static RenderQueue* create();
+
+    /**
+     * Clears the queue and starts collecting items seen from a camera.
+     *
+     * The camera and the nodes added afterwards must stay valid until draw() returns.
+     *
+     * @param camera The camera used to compute the depth of items, or NULL to keep the order items are added in.
+     */
+    void begin(Camera* camera);
+
+    /**
+     * Adds the drawable of a node to the queue.
+     *
+     * @param node The node to add. Nodes without a drawable are ignored.
+     */
+    void add(Node* node);
+
+    /**
+     * Adds all drawable nodes of a scene that are visible from the camera passed to begin().
+     *
+     * @param scene The scene to add.
+     *
+     * @return The number of nodes added.
+     * @see Scene::findVisibleNodes
+     */
+    unsigned int addScene(Scene* scene);
+
+    /**
+     * Sorts the queued items and draws them.
+     *
+     * The queue keeps its items, so it can be drawn again until the next begin().
+     *
+     * @param wireframe True to draw models in wireframe, false otherwise.
+     *
+     * @return The number of items drawn.
+     */
+    unsigned int draw(bool wireframe = false);
+
+    /**
+     * Gets the number of items in the queue.
+     *
+     * @return The number of items.
+     */
+    unsigned int getItemCount() const;
+
+    /**
+     * Gets the counters accumulated since the last call to resetStatistics().
+     *
+     * @return The statistics.
+     */
+    static const Statistics& getStatistics();
+
+    /**
+     * Resets all counters to zero, typically at the start of each frame.
+     */
+    static void resetStatistics();
+
+private:
+
+    /**
+     * A single draw: one pass of one mesh part, or a whole drawable if the pass is NULL.
+     */
+    struct Item
+    {
+        unsigned long long key;
+        Node* node;
+        MeshPart* part;
+        Pass* pass;
+    };
+
+    /**
+     * Constructor.
+     */
+    RenderQueue();
+
+    /**
+     * Destructor.
+     */
+    ~RenderQueue();
+
+    /**
+     * Hidden copy constructor.
+     */
+    RenderQueue(const RenderQueue& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    RenderQueue& operator=(const RenderQueue&);
+
+    /**
+     * Gets the distance of a node from the camera along the view direction.
+     */
+    float getDepth(Node* node) const;
+
+    Camera* _camera;
+    std::vector<Item> _items;
+    std::vector<Node*> _visibleNodes;
+    bool _sorted;
+    static Statistics _statistics;
+};
+
+}
+
+#endif
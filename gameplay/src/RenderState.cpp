@@ -410,6 +410,7 @@ const Vector3& RenderState::autoBindingGetAmbientColor() const
 
 void RenderState::bind(Pass* pass)
 {
+    GP_PROFILE_SCOPE("RenderState::bind");
     GP_ASSERT(pass);
 
     // Get the combined modified state bits for our RenderState hierarchy.
@@ -445,6 +446,16 @@ void RenderState::bind(Pass* pass)
     }
 }
 
+bool RenderState::isBlendEnabled() const
+{
+    for (const RenderState* rs = this; rs != NULL; rs = rs->_parent)
+    {
+        if (rs->_state && (rs->_state->_bits & RS_BLEND))
+            return rs->_state->_blendEnabled;
+    }
+    return false;
+}
+
 RenderState* RenderState::getTopmost(RenderState* below)
 {
     RenderState* rs = this;
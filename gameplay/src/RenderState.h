@@ -565,6 +565,19 @@ public:
      */
     StateBlock* getStateBlock() const;
 
+    /**
+     * Determines whether blending is enabled when this render state is bound.
+     *
+     * The state blocks of this render state and its parents are searched the
+     * same way bind() applies them, so the closest block that sets the blend
+     * state wins.
+     *
+     * @return True if blending is enabled, false otherwise.
+     *
+     * @script{ignore}
+     */
+    bool isBlendEnabled() const;
+
     /**
      * Sets the node that this render state is bound to.
      *
@@ -0,0 +1,323 @@
+#include "Base.h"
+#include "ResourceLoader.h"
+#include "Game.h"
+#include "Bundle.h"
+#include "FileSystem.h"
+#include "Image.h"
+#include "Properties.h"
+#include "Texture.h"
+
+// Default time spent completing requests on the main thread per frame (in milliseconds).
+#define RESOURCE_LOADER_DEFAULT_FRAME_BUDGET 4.0f
+
+namespace gameplay
+{
+
+ResourceLoader::Request::Request(const std::function<void()>& work, const std::function<void(bool)>& complete)
+    : _work(work), _complete(complete), _completed(false), _cancelled(false)
+{
+}
+
+ResourceLoader::Request::~Request()
+{
+}
+
+bool ResourceLoader::Request::isComplete() const
+{
+    return _completed;
+}
+
+void ResourceLoader::Request::cancel()
+{
+    _cancelled = true;
+}
+
+bool ResourceLoader::Request::isCancelled() const
+{
+    return _cancelled;
+}
+
+ResourceLoader::ResourceLoader()
+    : _activeCount(0), _running(false), _frameBudget(RESOURCE_LOADER_DEFAULT_FRAME_BUDGET)
+{
+}
+
+ResourceLoader::~ResourceLoader()
+{
+}
+
+void ResourceLoader::initialize(unsigned int threadCount)
+{
+    if (threadCount == 0)
+    {
+        // Leave one hardware thread for the main thread.
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    _mutex.reset(new std::mutex());
+    _pendingCondition.reset(new std::condition_variable());
+    _loadedCondition.reset(new std::condition_variable());
+    _running = true;
+
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        _threads.push_back(new std::thread(&workerThreadProc, this));
+    }
+}
+
+void ResourceLoader::finalize()
+{
+    {
+        std::unique_lock<std::mutex> lock(*_mutex);
+        _running = false;
+    }
+    _pendingCondition->notify_all();
+
+    for (size_t i = 0, count = _threads.size(); i < count; ++i)
+    {
+        _threads[i]->join();
+        SAFE_DELETE(_threads[i]);
+    }
+    _threads.clear();
+
+    // Requests that never reached a worker are cancelled; requests that did
+    // still get their main-thread step so intermediate data is released.
+    while (!_pending.empty())
+    {
+        Request* request = _pending.front();
+        _pending.pop_front();
+        request->cancel();
+        complete(request);
+    }
+    while (!_loaded.empty())
+    {
+        Request* request = _loaded.front();
+        _loaded.pop_front();
+        request->cancel();
+        complete(request);
+    }
+}
+
+void ResourceLoader::update(float elapsedTime)
+{
+    if (_activeCount == 0)
+        return;
+
+    double endTime = Game::getPlatformTime() + _frameBudget * 0.001;
+    do
+    {
+        Request* request = NULL;
+        {
+            std::unique_lock<std::mutex> lock(*_mutex);
+            if (_loaded.empty())
+                break;
+            request = _loaded.front();
+            _loaded.pop_front();
+        }
+        complete(request);
+    }
+    while (Game::getPlatformTime() < endTime);
+}
+
+void ResourceLoader::finish()
+{
+    while (_activeCount > 0)
+    {
+        Request* request = NULL;
+        {
+            std::unique_lock<std::mutex> lock(*_mutex);
+            while (_loaded.empty())
+                _loadedCondition->wait(lock);
+            request = _loaded.front();
+            _loaded.pop_front();
+        }
+        complete(request);
+    }
+}
+
+unsigned int ResourceLoader::getPendingCount() const
+{
+    return _activeCount;
+}
+
+float ResourceLoader::getFrameBudget() const
+{
+    return _frameBudget;
+}
+
+void ResourceLoader::setFrameBudget(float budget)
+{
+    _frameBudget = budget;
+}
+
+ResourceLoader::Request* ResourceLoader::submit(const std::function<void()>& work, const std::function<void(bool)>& complete)
+{
+    GP_ASSERT(_running);
+
+    Request* request = new Request(work, complete);
+
+    // The loader keeps its own reference until the request completes.
+    request->addRef();
+    ++_activeCount;
+
+    {
+        std::unique_lock<std::mutex> lock(*_mutex);
+        _pending.push_back(request);
+    }
+    _pendingCondition->notify_one();
+
+    return request;
+}
+
+void ResourceLoader::complete(Request* request)
+{
+    GP_ASSERT(request);
+    GP_ASSERT(_activeCount > 0);
+
+    if (request->_complete)
+        request->_complete(request->_cancelled);
+
+    request->_completed = true;
+    --_activeCount;
+    SAFE_RELEASE(request);
+}
+
+void ResourceLoader::workerThreadProc(void* arg)
+{
+    ResourceLoader* loader = (ResourceLoader*)arg;
+
+    while (true)
+    {
+        Request* request = NULL;
+        {
+            std::unique_lock<std::mutex> lock(*loader->_mutex);
+            while (loader->_running && loader->_pending.empty())
+                loader->_pendingCondition->wait(lock);
+            if (!loader->_running)
+                break;
+            request = loader->_pending.front();
+            loader->_pending.pop_front();
+        }
+
+        if (!request->_cancelled && request->_work)
+            request->_work();
+
+        {
+            std::unique_lock<std::mutex> lock(*loader->_mutex);
+            loader->_loaded.push_back(request);
+        }
+        loader->_loadedCondition->notify_one();
+    }
+}
+
+ResourceLoader::Request* ResourceLoader::loadTexture(const char* path, bool generateMipmaps, const std::function<void(Texture*)>& callback)
+{
+    GP_ASSERT(path);
+
+    struct TextureLoad
+    {
+        std::string path;
+        Image* image;
+    };
+    std::shared_ptr<TextureLoad> load(new TextureLoad());
+    load->path = path;
+    load->image = NULL;
+
+    return submit([load]()
+    {
+        // Only PNG and JPEG files are decoded up front; compressed formats
+        // are uploaded straight from the file on the main thread.
+        std::string ext = FileSystem::getExtension(load->path.c_str());
+        if (ext == ".PNG" || ext == ".JPG")
+            load->image = Image::create(load->path.c_str());
+    },
+    [load, generateMipmaps, callback](bool cancelled)
+    {
+        Texture* texture = NULL;
+        if (!cancelled)
+        {
+            texture = Texture::findCached(load->path.c_str(), generateMipmaps);
+            if (!texture && load->image)
+            {
+                texture = Texture::create(load->image, generateMipmaps);
+                if (texture)
+                    texture->addToCache(load->path.c_str());
+            }
+            else if (!texture)
+            {
+                texture = Texture::create(load->path.c_str(), generateMipmaps);
+            }
+        }
+        SAFE_RELEASE(load->image);
+
+        if (callback && !cancelled)
+            callback(texture);
+        else
+            SAFE_RELEASE(texture);
+    });
+}
+
+ResourceLoader::Request* ResourceLoader::loadImage(const char* path, const std::function<void(Image*)>& callback)
+{
+    GP_ASSERT(path);
+
+    std::string imagePath(path);
+    std::shared_ptr<Image*> image(new Image*(NULL));
+
+    return submit([imagePath, image]()
+    {
+        *image = Image::create(imagePath.c_str());
+    },
+    [image, callback](bool cancelled)
+    {
+        if (callback && !cancelled)
+            callback(*image);
+        else
+            SAFE_RELEASE(*image);
+    });
+}
+
+ResourceLoader::Request* ResourceLoader::loadProperties(const char* url, const std::function<void(Properties*)>& callback)
+{
+    GP_ASSERT(url);
+
+    std::string propertiesUrl(url);
+    std::shared_ptr<Properties*> properties(new Properties*(NULL));
+
+    return submit([propertiesUrl, properties]()
+    {
+        *properties = Properties::create(propertiesUrl.c_str());
+    },
+    [properties, callback](bool cancelled)
+    {
+        if (callback && !cancelled)
+            callback(*properties);
+        else
+            SAFE_DELETE(*properties);
+    });
+}
+
+ResourceLoader::Request* ResourceLoader::loadBundle(const char* path, const std::function<void(Bundle*)>& callback)
+{
+    GP_ASSERT(path);
+
+    std::string bundlePath(path);
+    std::shared_ptr<Bundle*> bundle(new Bundle*(NULL));
+
+    // Only the file is opened on the worker. The bundle cache and the reference counts
+    // of shared bundles belong to the main thread, so the bundle is cached on completion.
+    return submit([bundlePath, bundle]()
+    {
+        *bundle = Bundle::open(bundlePath.c_str(), true);
+    },
+    [bundle, callback](bool cancelled)
+    {
+        if (callback && !cancelled)
+            callback(*bundle ? Bundle::cache(*bundle) : NULL);
+        else
+            SAFE_RELEASE(*bundle);
+    });
+}
+
+}
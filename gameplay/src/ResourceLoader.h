@@ -0,0 +1,268 @@
+#ifndef RESOURCELOADER_H_
+#define RESOURCELOADER_H_
+
+#include "Ref.h"
+
+namespace gameplay
+{
+
+class Bundle;
+class Image;
+class Properties;
+class Texture;
+
+/**
+ * Defines a class for loading game resources in the background.
+ *
+ * Each load is split into two steps. The first step (file I/O, image decoding,
+ * properties parsing and bundle reading) runs on one of the loader's worker
+ * threads. The second step, which creates any graphics objects and hands the
+ * resource to the caller, runs on the main thread from Game::frame(). The main
+ * thread only spends up to the configured time budget per frame on the second
+ * step, so a burst of finished loads is spread over several frames instead of
+ * stalling one of them.
+ *
+ * The loader is configured from the game.config file:
+ *
+ * @code
+ * resourceLoader
+ * {
+ *     threads = 2        // number of worker threads (0 uses the number of hardware threads minus one)
+ *     frameBudget = 4    // time (in milliseconds) spent on the main thread per frame
+ * }
+ * @endcode
+ *
+ * @script{ignore}
+ */
+class ResourceLoader
+{
+    friend class Game;
+
+public:
+
+    /**
+     * Defines a handle to a resource load submitted to the ResourceLoader.
+     */
+    class Request : public Ref
+    {
+        friend class ResourceLoader;
+
+    public:
+
+        /**
+         * Determines whether the request has completed, including its main-thread step.
+         *
+         * @return True if the request has completed, false otherwise.
+         */
+        bool isComplete() const;
+
+        /**
+         * Cancels the request.
+         *
+         * The completion callback of a cancelled request is never invoked and any
+         * intermediate data that was already loaded for it is released.
+         */
+        void cancel();
+
+        /**
+         * Determines whether the request was cancelled.
+         *
+         * @return True if the request was cancelled, false otherwise.
+         */
+        bool isCancelled() const;
+
+    private:
+
+        /**
+         * Constructor.
+         */
+        Request(const std::function<void()>& work, const std::function<void(bool)>& complete);
+
+        /**
+         * Destructor.
+         */
+        ~Request();
+
+        /**
+         * Hidden copy constructor.
+         */
+        Request(const Request& copy);
+
+        /**
+         * Hidden copy assignment operator.
+         */
+        Request& operator=(const Request&);
+
+        std::function<void()> _work;
+        std::function<void(bool)> _complete;
+        bool _completed;
+        std::atomic<bool> _cancelled;
+    };
+
+    /**
+     * Loads a texture in the background.
+     *
+     * The image file is read and decoded on a worker thread and the GL texture
+     * is created on the main thread. Textures already present in the texture
+     * cache are returned from the cache.
+     *
+     * The callback receives the new texture (or NULL on failure) and takes
+     * ownership of it, the same as if it was returned from Texture::create().
+     *
+     * @param path The path to the texture file.
+     * @param generateMipmaps True to generate a full mipmap chain for the texture.
+     * @param callback The function called on the main thread once the texture is loaded.
+     *
+     * @return The request handle. The caller must release it when no longer needed.
+     */
+    Request* loadTexture(const char* path, bool generateMipmaps, const std::function<void(Texture*)>& callback);
+
+    /**
+     * Loads an image in the background.
+     *
+     * The callback receives the new image (or NULL on failure) and takes
+     * ownership of it, the same as if it was returned from Image::create().
+     *
+     * @param path The path to the image file.
+     * @param callback The function called on the main thread once the image is loaded.
+     *
+     * @return The request handle. The caller must release it when no longer needed.
+     */
+    Request* loadImage(const char* path, const std::function<void(Image*)>& callback);
+
+    /**
+     * Loads a properties file in the background.
+     *
+     * The callback receives the new properties (or NULL on failure) and takes
+     * ownership of them, the same as if they were returned from Properties::create().
+     *
+     * @param url The URL of the properties to load.
+     * @param callback The function called on the main thread once the properties are loaded.
+     *
+     * @return The request handle. The caller must release it when no longer needed.
+     */
+    Request* loadProperties(const char* url, const std::function<void(Properties*)>& callback);
+
+    /**
+     * Opens a bundle in the background.
+     *
+     * The bundle file is memory-mapped and its reference table read on a worker
+     * thread, so subsequent calls to Bundle::loadScene() and friends on the
+     * main thread parse objects straight out of memory.
+     *
+     * The callback receives the new bundle (or NULL on failure) and takes
+     * ownership of it, the same as if it was returned from Bundle::create().
+     *
+     * @param path The path to the bundle file.
+     * @param callback The function called on the main thread once the bundle is opened.
+     *
+     * @return The request handle. The caller must release it when no longer needed.
+     */
+    Request* loadBundle(const char* path, const std::function<void(Bundle*)>& callback);
+
+    /**
+     * Submits a custom two-step load.
+     *
+     * @param work The function run on a worker thread. It must not call any graphics API.
+     * @param complete The function run on the main thread once work has finished. Its
+     *        argument is true if the request was cancelled, in which case it should only
+     *        release whatever work produced.
+     *
+     * @return The request handle. The caller must release it when no longer needed.
+     */
+    Request* submit(const std::function<void()>& work, const std::function<void(bool)>& complete);
+
+    /**
+     * Blocks until all submitted requests have completed, running their main-thread
+     * steps on the calling thread regardless of the frame budget.
+     *
+     * Must be called from the main thread.
+     */
+    void finish();
+
+    /**
+     * Returns the number of requests that have not completed yet.
+     *
+     * @return The number of pending requests.
+     */
+    unsigned int getPendingCount() const;
+
+    /**
+     * Gets the time budget spent on main-thread steps per frame.
+     *
+     * @return The time budget in milliseconds.
+     */
+    float getFrameBudget() const;
+
+    /**
+     * Sets the time budget spent on main-thread steps per frame.
+     *
+     * At least one finished request is always completed per frame.
+     *
+     * @param budget The time budget in milliseconds.
+     */
+    void setFrameBudget(float budget);
+
+private:
+
+    /**
+     * Constructor.
+     */
+    ResourceLoader();
+
+    /**
+     * Destructor.
+     */
+    ~ResourceLoader();
+
+    /**
+     * Hidden copy constructor.
+     */
+    ResourceLoader(const ResourceLoader& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    ResourceLoader& operator=(const ResourceLoader&);
+
+    /**
+     * Controller initialize.
+     *
+     * @param threadCount The number of worker threads (0 to pick a default).
+     */
+    void initialize(unsigned int threadCount);
+
+    /**
+     * Controller finalize.
+     */
+    void finalize();
+
+    /**
+     * Controller update. Completes finished requests within the frame budget.
+     */
+    void update(float elapsedTime);
+
+    /**
+     * Runs the main-thread step of the given finished request and releases it.
+     */
+    void complete(Request* request);
+
+    /**
+     * Worker thread entry point.
+     */
+    static void workerThreadProc(void* arg);
+
+    std::vector<std::thread*> _threads;
+    std::deque<Request*> _pending;
+    std::deque<Request*> _loaded;
+    std::unique_ptr<std::mutex> _mutex;
+    std::unique_ptr<std::condition_variable> _pendingCondition;
+    std::unique_ptr<std::condition_variable> _loadedCondition;
+    unsigned int _activeCount;
+    bool _running;
+    float _frameBudget;
+};
+
+}
+
+#endif
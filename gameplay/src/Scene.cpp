@@ -61,7 +61,8 @@ static bool endsWith(const char* str, const char* suffix, bool ignoreCase)
 
 Scene::Scene()
     : _id(""), _activeCamera(NULL), _firstNode(NULL), _lastNode(NULL), _nodeCount(0), _bindAudioListenerToCamera(true), 
-      _nextItr(NULL), _nextReset(true), _ambientColor( 0.0f, 0.0f, 0.0f )
+      _nextItr(NULL), _nextReset(true), _ambientColor( 0.0f, 0.0f, 0.0f ), _transformHierarchy(NULL),
+      _spatialIndex(NULL)
 {
     __sceneList.push_back(this);
 }
@@ -82,6 +83,8 @@ Scene::~Scene()
 
     // Remove all nodes from the scene
     removeAllNodes();
+    SAFE_DELETE(_transformHierarchy);
+    SAFE_DELETE(_spatialIndex);
 
     // Remove the scene from global list
     std::vector<Scene*>::iterator itr = std::find(__sceneList.begin(), __sceneList.end(), this);
@@ -273,6 +276,11 @@ void Scene::addNode(Node* node)
 
     ++_nodeCount;
 
+    if (_transformHierarchy)
+        _transformHierarchy->invalidate();
+    if (_spatialIndex)
+        _spatialIndex->addNode(node);
+
     // If we don't have an active camera set, then check for one and set it.
     if (_activeCamera == NULL)
     {
@@ -393,6 +401,88 @@ void Scene::update(float elapsedTime)
         if (node->isEnabled())
             node->update(elapsedTime);
     }
+
+    if (_transformHierarchy)
+        _transformHierarchy->update();
+    if (_spatialIndex)
+        _spatialIndex->update();
+}
+
+void Scene::setTransformHierarchyEnabled(bool enabled)
+{
+    if (enabled && !_transformHierarchy)
+    {
+        _transformHierarchy = new TransformHierarchy(this);
+    }
+    else if (!enabled)
+    {
+        SAFE_DELETE(_transformHierarchy);
+    }
+}
+
+TransformHierarchy* Scene::getTransformHierarchy() const
+{
+    return _transformHierarchy;
+}
+
+void Scene::setSpatialIndexEnabled(bool enabled)
+{
+    if (enabled && !_spatialIndex)
+    {
+        _spatialIndex = new SpatialIndex(this);
+        for (Node* node = _firstNode; node != NULL; node = node->_nextSibling)
+        {
+            _spatialIndex->addNode(node);
+        }
+    }
+    else if (!enabled)
+    {
+        SAFE_DELETE(_spatialIndex);
+    }
+}
+
+SpatialIndex* Scene::getSpatialIndex() const
+{
+    return _spatialIndex;
+}
+
+unsigned int Scene::findVisibleNodes(Camera* camera, std::vector<Node*>& nodes)
+{
+    if (!camera)
+        camera = _activeCamera;
+    if (!camera)
+        return 0;
+
+    const Frustum& frustum = camera->getFrustum();
+    if (_spatialIndex)
+        return _spatialIndex->findNodes(frustum, nodes);
+
+    // Without the index, test every drawable node of the scene one by one.
+    size_t start = nodes.size();
+    Node* node = _firstNode;
+    while (node)
+    {
+        if (node->getDrawable())
+        {
+            BoundingSphere sphere;
+            if (!node->computeBoundingSphere(&sphere) || sphere.intersects(frustum))
+                nodes.push_back(node);
+        }
+
+        // Depth-first walk without recursion.
+        if (node->getFirstChild())
+        {
+            node = node->getFirstChild();
+        }
+        else
+        {
+            while (node && !node->getNextSibling())
+                node = node->getParent();
+            if (node)
+                node = node->getNextSibling();
+        }
+    }
+    return (unsigned int)(nodes.size() - start);
 }
 
 void Scene::reset()
@@ -6,6 +6,8 @@
 #include "ScriptController.h"
 #include "Light.h"
 #include "Model.h"
+#include "TransformHierarchy.h"
+#include "SpatialIndex.h"
 
 namespace gameplay
 {
@@ -184,10 +186,69 @@ public:
      * are active within the scene. A Node is considered active if Node::isActive()
      * returns true.
      *
+     * If the flat transform hierarchy is enabled, the world matrices of all
+     * nodes that moved are resolved afterwards, followed by the spatial index.
+     *
      * @param elapsedTime Elapsed time in seconds.
      */
     void update(float elapsedTime);
 
+    /**
+     * Enables or disables the flat transform hierarchy of this scene.
+     *
+     * When enabled, world matrices are resolved in one linear sweep over all
+     * nodes that moved each time update() is called, instead of recursively
+     * on first access. This pays off for scenes with many nodes.
+     *
+     * @param enabled True to enable the flat transform hierarchy, false to disable it.
+     * @see TransformHierarchy
+     * @script{ignore}
+     */
+    void setTransformHierarchyEnabled(bool enabled);
+
+    /**
+     * Gets the flat transform hierarchy of this scene.
+     *
+     * @return The transform hierarchy, or NULL if it is not enabled.
+     * @script{ignore}
+     */
+    TransformHierarchy* getTransformHierarchy() const;
+
+    /**
+     * Enables or disables the spatial index of this scene.
+     *
+     * The spatial index keeps the drawable nodes of the scene in a bounding
+     * volume hierarchy that is updated incrementally as nodes move, and is
+     * used by findVisibleNodes().
+     *
+     * @param enabled True to enable the spatial index, false to disable it.
+     * @see SpatialIndex
+     * @script{ignore}
+     */
+    void setSpatialIndexEnabled(bool enabled);
+
+    /**
+     * Gets the spatial index of this scene.
+     *
+     * @return The spatial index, or NULL if it is not enabled.
+     * @script{ignore}
+     */
+    SpatialIndex* getSpatialIndex() const;
+
+    /**
+     * Finds the drawable nodes that intersect the frustum of a camera.
+     *
+     * This uses the spatial index if it is enabled. Otherwise every drawable
+     * node in the scene is tested against the frustum.
+     *
+     * @param camera The camera to cull against, or NULL to use the active camera.
+     * @param nodes The vector the visible nodes are appended to.
+     *
+     * @return The number of nodes appended.
+     * @script{ignore}
+     */
+    unsigned int findVisibleNodes(Camera* camera, std::vector<Node*>& nodes);
+
     /**
      * Visits each node in the scene and calls the specified method pointer.
      *
@@ -308,11 +369,14 @@ private:
     bool _bindAudioListenerToCamera;
     Node* _nextItr;
     bool _nextReset;
+    TransformHierarchy* _transformHierarchy;
+    SpatialIndex* _spatialIndex;
 };
 
 template <class T>
 void Scene::visit(T* instance, bool (T::*visitMethod)(Node*))
 {
+    GP_PROFILE_SCOPE("Scene::visit");
     for (Node* node = getFirstNode(); node != NULL; node = node->getNextSibling())
     {
         visitNode(node, instance, visitMethod);
@@ -322,6 +386,7 @@ void Scene::visit(T* instance, bool (T::*visitMethod)(Node*))
 template <class T, class C>
 void Scene::visit(T* instance, bool (T::*visitMethod)(Node*,C), C cookie)
 {
+    GP_PROFILE_SCOPE("Scene::visit");
     for (Node* node = getFirstNode(); node != NULL; node = node->getNextSibling())
     {
         visitNode(node, instance, visitMethod, cookie);
@@ -330,6 +395,7 @@ void Scene::visit(T* instance, bool (T::*visitMethod)(Node*,C), C cookie)
 
 inline void Scene::visit(const char* visitMethod)
 {
+    GP_PROFILE_SCOPE("Scene::visit");
     for (Node* node = getFirstNode(); node != NULL; node = node->getNextSibling())
     {
         visitNode(node, visitMethod);
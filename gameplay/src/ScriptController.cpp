@@ -694,6 +694,20 @@ static const char* lua_dofile_function =
     "    end\n"
     "end\n";
 
+// coroutine.wrap() resumes its coroutine without calling coroutine.resume(), so it is
+// replaced by a version that does.
+static const char* lua_coroutine_wrap_function =
+    "coroutine.wrap = function(f)\n"
+    "    local co = coroutine.create(f)\n"
+    "    return function(...)\n"
+    "        local results = table.pack(coroutine.resume(co, ...))\n"
+    "        if not results[1] then\n"
+    "            error(results[2], 2)\n"
+    "        end\n"
+    "        return table.unpack(results, 2, results.n)\n"
+    "    end\n"
+    "end\n";
+
 /**
  * @script{ignore}
  */
@@ -731,6 +745,20 @@ void ScriptController::initialize()
     // Append to the LUA_PATH to allow scripts to be found in the resource folder on all platforms
     appendLuaPath(_lua, FileSystem::getResourcePath());
 
+    // Register the coroutine functions.
+    lua_pushcfunction(_lua, ScriptController::wait);
+    lua_setglobal(_lua, "wait");
+    lua_pushcfunction(_lua, ScriptController::waitForEvent);
+    lua_setglobal(_lua, "waitForEvent");
+    lua_pushcfunction(_lua, ScriptController::signalEvent);
+    lua_setglobal(_lua, "signalEvent");
+    lua_getglobal(_lua, "coroutine");
+    lua_pushcfunction(_lua, ScriptController::resume);
+    lua_setfield(_lua, -2, "resume");
+    lua_pop(_lua, 1);
+    if (luaL_dostring(_lua, lua_coroutine_wrap_function))
+        GP_ERROR("Failed to load custom coroutine.wrap() function with error: '%s'.", lua_tostring(_lua, -1));
+
     // Create our own print() function that uses gameplay::print.
     if (luaL_dostring(_lua, lua_print_function))
         GP_ERROR("Failed to load custom print() function with error: '%s'.", lua_tostring(_lua, -1));
@@ -761,12 +789,15 @@ void ScriptController::initialize()
 
 void ScriptController::finalize()
 {
-    // Cleanup any outstanding time listeners
-    for (std::list<ScriptTimeListener*>::iterator itr = _timeListeners.begin(); itr != _timeListeners.end(); ++itr)
+    // Cleanup any outstanding callbacks. Cancelling a time event frees its callback.
+    _eventCallbacks.clear();
+    TimeScheduler* scheduler = Game::getInstance()->getTimeScheduler();
+    while (!_callbacks.empty())
     {
-        SAFE_DELETE(*itr);
+        ScriptCallback* callback = _callbacks.back();
+        if (!callback->handle || !scheduler->cancel(callback->handle))
+            releaseCallback(callback);
     }
-    _timeListeners.clear();
 
     if (_lua)
     {
@@ -783,6 +814,8 @@ void ScriptController::finalize()
 
 bool ScriptController::executeFunctionHelper(int resultCount, const char* func, const char* args, va_list* list, Script* script)
 {
+    GP_PROFILE_SCOPE("ScriptController::executeFunctionHelper");
+
     if (!_lua)
         return false; // handles calling this method after script is finalized
 
@@ -926,21 +959,204 @@ bool ScriptController::executeFunctionHelper(int resultCount, const char* func,
     return success;
 }
 
-void ScriptController::schedule(float timeOffset, const char* function)
+unsigned int ScriptController::schedule(float timeOffset, const char* function)
 {
-    // Get the currently execute script
+    GP_ASSERT(function);
+
+    // Look the function up in the environment of the currently executing script.
     Script* script = _envStack.empty() ? NULL : _envStack.back();
-    if (script)
+    int top = lua_gettop(_lua);
+    if (!getNestedVariable(_lua, function, script ? script->_env : 0) || !lua_isfunction(_lua, -1))
     {
-        // Increase the reference count of the script while we hold it so it doesn't
-        // get destroyed while waiting for the event to fire.
-        script->addRef();
+        lua_settop(_lua, top);
+        GP_WARN("Failed to schedule function '%s'.", function);
+        return 0;
+    }
+    int ref = luaL_ref(_lua, LUA_REGISTRYINDEX);
+    lua_settop(_lua, top);
+
+    ScriptCallback* callback = createCallback(ref, LUA_NOREF);
+    callback->handle = Game::getInstance()->getTimeScheduler()->schedule(timeOffset, &_timeListener, callback);
+    return callback->handle;
+}
+
+unsigned int ScriptController::signalEvent(const char* name)
+{
+    GP_ASSERT(name);
+
+    std::map<std::string, std::vector<ScriptCallback*> >::iterator itr = _eventCallbacks.find(name);
+    if (itr == _eventCallbacks.end())
+        return 0;
+
+    // Coroutines that wait again while they are resumed wait for the next signal.
+    std::vector<ScriptCallback*> callbacks;
+    callbacks.swap(itr->second);
+    _eventCallbacks.erase(itr);
+    for (size_t i = 0, count = callbacks.size(); i < count; ++i)
+    {
+        runCallback(callbacks[i], 0);
+        releaseCallback(callbacks[i]);
+    }
+    return (unsigned int)callbacks.size();
+}
+
+int ScriptController::wait(lua_State* state)
+{
+    float timeOffset = (float)luaL_checknumber(state, 1);
+    if (lua_pushthread(state))
+    {
+        lua_pushstring(state, "wait - Must be called from a coroutine.");
+        lua_error(state);
+    }
+
+    ScriptController* sc = Game::getInstance()->getScriptController();
+    ScriptCallback* callback = sc->createCallback(LUA_NOREF, luaL_ref(state, LUA_REGISTRYINDEX));
+    callback->handle = Game::getInstance()->getTimeScheduler()->schedule(timeOffset, &sc->_timeListener, callback);
+    return lua_yield(state, 0);
+}
+
+int ScriptController::waitForEvent(lua_State* state)
+{
+    const char* name = luaL_checkstring(state, 1);
+    std::string event = name;
+    if (lua_pushthread(state))
+    {
+        lua_pushstring(state, "waitForEvent - Must be called from a coroutine.");
+        lua_error(state);
     }
 
-    ScriptTimeListener* listener = new ScriptTimeListener(script, function);
-    _timeListeners.push_back(listener);
+    ScriptController* sc = Game::getInstance()->getScriptController();
+    ScriptCallback* callback = sc->createCallback(LUA_NOREF, luaL_ref(state, LUA_REGISTRYINDEX));
+    sc->_eventCallbacks[event].push_back(callback);
+    return lua_yield(state, 0);
+}
+
+int ScriptController::signalEvent(lua_State* state)
+{
+    const char* name = luaL_checkstring(state, 1);
+    Game::getInstance()->getScriptController()->signalEvent(name);
+    return 0;
+}
+
+int ScriptController::resume(lua_State* state)
+{
+    lua_State* thread = lua_tothread(state, 1);
+    luaL_argcheck(state, thread, 1, "coroutine expected");
+
+    int argCount = lua_gettop(state) - 1;
+    if (lua_status(thread) == LUA_OK && lua_gettop(thread) == 0)
+    {
+        lua_pushboolean(state, 0);
+        lua_pushstring(state, "cannot resume dead coroutine");
+        return 2;
+    }
+    if (!lua_checkstack(thread, argCount))
+    {
+        lua_pushboolean(state, 0);
+        lua_pushstring(state, "too many arguments to resume");
+        return 2;
+    }
+    lua_xmove(state, thread, argCount);
+
+    int status = Game::getInstance()->getScriptController()->resume(thread, state, argCount);
+    if (status == LUA_OK || status == LUA_YIELD)
+    {
+        int resultCount = lua_gettop(thread);
+        luaL_checkstack(state, resultCount + 1, "too many results to resume");
+        lua_pushboolean(state, 1);
+        lua_xmove(thread, state, resultCount);
+        return resultCount + 1;
+    }
 
-    Game::getInstance()->schedule(timeOffset, listener, NULL);
+    // Move the error message.
+    lua_pushboolean(state, 0);
+    lua_xmove(thread, state, 1);
+    return 2;
+}
+
+int ScriptController::resume(lua_State* thread, lua_State* from, int argCount)
+{
+    // The bindings read their arguments from _lua, so it is the coroutine while it runs.
+    lua_State* state = _lua;
+    _lua = thread;
+    int status = lua_resume(thread, from, argCount);
+    _lua = state;
+    return status;
+}
+
+ScriptController::ScriptCallback* ScriptController::createCallback(int function, int thread)
+{
+    ScriptCallback* callback = new ScriptCallback();
+
+    // Increase the reference count of the script while we hold it so it doesn't
+    // get destroyed while waiting for the event to fire.
+    callback->script = _envStack.empty() ? NULL : _envStack.back();
+    if (callback->script)
+        callback->script->addRef();
+    callback->function = function;
+    callback->thread = thread;
+    callback->handle = 0;
+    callback->index = (int)_callbacks.size();
+    callback->firing = false;
+    callback->cancelled = false;
+    _callbacks.push_back(callback);
+    return callback;
+}
+
+void ScriptController::runCallback(ScriptCallback* callback, long timeDiff)
+{
+    if (!_lua)
+        return;
+
+    if (callback->thread != LUA_NOREF)
+    {
+        lua_rawgeti(_lua, LUA_REGISTRYINDEX, callback->thread);
+        lua_State* thread = lua_tothread(_lua, -1);
+        lua_pop(_lua, 1);
+
+        pushScript(callback->script);
+        int status = resume(thread, _lua, 0);
+        if (status != LUA_OK && status != LUA_YIELD)
+            GP_WARN("Failed to resume coroutine with error '%s'.", lua_tostring(thread, -1));
+        popScript();
+    }
+    else
+    {
+        lua_rawgeti(_lua, LUA_REGISTRYINDEX, callback->function);
+        lua_pushinteger(_lua, timeDiff);
+
+        pushScript(callback->script);
+        if (lua_pcall(_lua, 1, 0, 0) != 0)
+        {
+            GP_WARN("Failed to call scheduled function with error '%s'.", lua_tostring(_lua, -1));
+            lua_pop(_lua, 1); // pop the error
+        }
+        popScript();
+    }
+}
+
+void ScriptController::releaseCallback(ScriptCallback* callback)
+{
+    detachCallback(callback);
+    if (_lua)
+    {
+        luaL_unref(_lua, LUA_REGISTRYINDEX, callback->function);
+        luaL_unref(_lua, LUA_REGISTRYINDEX, callback->thread);
+    }
+    SAFE_RELEASE(callback->script);
+    SAFE_DELETE(callback);
+}
+
+void ScriptController::detachCallback(ScriptCallback* callback)
+{
+    if (callback->index < 0)
+        return;
+
+    ScriptCallback* last = _callbacks.back();
+    _callbacks[callback->index] = last;
+    last->index = callback->index;
+    _callbacks.pop_back();
+    callback->index = -1;
 }
 
 void ScriptController::pushScript(Script* script)
@@ -964,30 +1180,37 @@ void ScriptController::popScript()
     SAFE_RELEASE(script);
 }
 
-ScriptController::ScriptTimeListener::ScriptTimeListener(Script* script, const char* function) : script(script), function(function)
+void ScriptController::ScriptTimeListener::timeEvent(long timeDiff, void* cookie)
 {
-}
+    ScriptController* sc = Game::getInstance()->getScriptController();
+    ScriptCallback* callback = (ScriptCallback*)cookie;
+    GP_ASSERT(callback);
 
-ScriptController::ScriptTimeListener::~ScriptTimeListener()
-{
-    // Release 
-    SAFE_RELEASE(script);
+    callback->firing = true;
+    sc->runCallback(callback, timeDiff);
+    callback->firing = false;
+
+    // One-shot events are done once they fired.
+    if (callback->cancelled || !Game::getInstance()->getTimeScheduler()->isScheduled(callback->handle))
+        sc->releaseCallback(callback);
 }
 
-void ScriptController::ScriptTimeListener::timeEvent(long timeDiff, void* cookie)
+void ScriptController::ScriptTimeListener::timeEventCancelled(void* cookie)
 {
-    // Remove ourself from the script controller's list
-    std::list<ScriptTimeListener*>& list = Game::getInstance()->getScriptController()->_timeListeners;
-    std::list<ScriptTimeListener*>::iterator itr = std::find(list.begin(), list.end(), this);
-    if (itr != list.end())
-        list.erase(itr);
-
-    // Call the script function
-    Game::getInstance()->getScriptController()->executeFunction<void>(script, function.c_str(), "l", NULL, timeDiff);
+    ScriptController* sc = Game::getInstance()->getScriptController();
+    ScriptCallback* callback = (ScriptCallback*)cookie;
+    GP_ASSERT(callback);
 
-    // Free ourself.
-    // IMPORTANT: Don't do anything else after this line!!
-    delete this;
+    if (callback->firing)
+    {
+        // Cancelled by its own function; released once the function returns.
+        callback->cancelled = true;
+        sc->detachCallback(callback);
+    }
+    else
+    {
+        sc->releaseCallback(callback);
+    }
 }
 
 // Helper macros.
@@ -542,32 +542,60 @@ public:
      */
     static void print(const char* str1, const char* str2);
 
+    /**
+     * Resumes the coroutines waiting for an event.
+     *
+     * Coroutines wait for an event by calling waitForEvent(name) from Lua. A coroutine
+     * that waits again while it is resumed waits for the next signal.
+     *
+     * @param name The name of the event.
+     *
+     * @return The number of coroutines resumed.
+     * @script{ignore}
+     */
+    unsigned int signalEvent(const char* name);
+
 private:
 
     /**
-     * Allows time listener interaction from Lua scripts.
+     * A scheduled script function, or a coroutine waiting for a time or an event.
+     *
+     * The function and the coroutine are resolved once, when they are scheduled,
+     * and kept as references in the Lua registry.
      */
-    struct ScriptTimeListener : public TimeListener
+    struct ScriptCallback
     {
-        /**
-         * Constructor.
-         */
-        ScriptTimeListener(Script* script, const char* function);
-
-        /**
-         * Destructor.
-         */
-        ~ScriptTimeListener();
+        /** Holds the script to execute the function within. */
+        Script* script;
+        /** Holds the registry reference of the function to call, or LUA_NOREF. */
+        int function;
+        /** Holds the registry reference of the coroutine to resume, or LUA_NOREF. */
+        int thread;
+        /** Holds the handle of the time event, or zero when waiting for an event. */
+        unsigned int handle;
+        /** Holds the position in the list of callbacks, or -1 once it is taken out. */
+        int index;
+        /** True while the callback runs. */
+        bool firing;
+        /** True if the time event was cancelled while the callback ran. */
+        bool cancelled;
+    };
 
+    /**
+     * Allows time listener interaction from Lua scripts. The cookie of each
+     * time event is the ScriptCallback to run.
+     */
+    struct ScriptTimeListener : public TimeListener
+    {
         /**
          * @see TimeListener#timeEvent(long, void*)
          */
         void timeEvent(long timeDiff, void* cookie);
 
-        /** Holds the script to execute the function within. */
-        Script* script;
-        /** Holds the name of the Lua script function to call back. */
-        std::string function;
+        /**
+         * @see TimeListener#timeEventCancelled(void*)
+         */
+        void timeEventCancelled(void* cookie);
     };
 
     /**
@@ -681,15 +709,105 @@ private:
      */
     static int convert(lua_State* state);
 
+    /**
+     * Suspends the running coroutine for a number of game seconds.
+     *
+     * <code>
+     * -- The signature of the lua function:
+     * -- param: timeOffset The number of game seconds to wait.
+     * function wait(timeOffset)
+     * </code>
+     *
+     * @param state The Lua state.
+     *
+     * @return The number of values being returned by this function.
+     *
+     * @script{ignore}
+     */
+    static int wait(lua_State* state);
+
+    /**
+     * Suspends the running coroutine until an event is signaled.
+     *
+     * <code>
+     * -- The signature of the lua function:
+     * -- param: name The name of the event to wait for.
+     * function waitForEvent(name)
+     * </code>
+     *
+     * @param state The Lua state.
+     *
+     * @return The number of values being returned by this function.
+     *
+     * @script{ignore}
+     */
+    static int waitForEvent(lua_State* state);
+
+    /**
+     * Resumes the coroutines waiting for an event.
+     *
+     * <code>
+     * -- The signature of the lua function:
+     * -- param: name The name of the event to signal.
+     * function signalEvent(name)
+     * </code>
+     *
+     * @param state The Lua state.
+     *
+     * @return The number of values being returned by this function.
+     *
+     * @script{ignore}
+     */
+    static int signalEvent(lua_State* state);
+
+    /**
+     * Resumes a coroutine, in place of Lua's coroutine.resume().
+     *
+     * @param state The Lua state.
+     *
+     * @return The number of values being returned by this function.
+     *
+     * @script{ignore}
+     */
+    static int resume(lua_State* state);
+
+    /**
+     * Resumes a coroutine with the bindings reading their arguments from it.
+     */
+    int resume(lua_State* thread, lua_State* from, int argCount);
+
     /**
      * Schedules a script function to execute after the given time interval.
      *
      * This function is executed in the environment of the script that calls this function.
+     * The function is looked up once, when it is scheduled.
      *
      * @param timeOffset The number of game seconds in the future to schedule the event to be fired.
      * @param function The Lua script function that will receive the event.
+     *
+     * @return The handle of the time event, or zero if the function could not be found.
+     */
+    unsigned int schedule(float timeOffset, const char* function);
+
+    /**
+     * Creates a callback in the environment of the running script.
+     */
+    ScriptCallback* createCallback(int function, int thread);
+
+    /**
+     * Calls the function or resumes the coroutine of a callback.
+     */
+    void runCallback(ScriptCallback* callback, long timeDiff);
+
+    /**
+     * Releases the Lua references of a callback and deletes it.
+     */
+    void releaseCallback(ScriptCallback* callback);
+
+    /**
+     * Takes a callback out of the list of callbacks.
      */
-    void schedule(float timeOffset, const char* function);
+    void detachCallback(ScriptCallback* callback);
 
     void pushScript(Script* script);
 
@@ -699,7 +817,9 @@ private:
     unsigned int _returnCount;
     std::map<std::string, std::vector<Script*> > _scripts;
     std::vector<Script*> _envStack;
-    std::list<ScriptTimeListener*> _timeListeners;
+    ScriptTimeListener _timeListener;
+    std::vector<ScriptCallback*> _callbacks;
+    std::map<std::string, std::vector<ScriptCallback*> > _eventCallbacks;
 };
 
 /** Template specialization. */
@@ -116,6 +116,7 @@ void Slider::setValue(float value)
     if (value != _value)
     {
         _value = value;
+        setDirty(DIRTY_GEOMETRY);
         notifyListeners(Control::Listener::VALUE_CHANGED);
     }
 
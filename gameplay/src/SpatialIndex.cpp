@@ -0,0 +1,624 @@
+#include "Base.h"
+#include "SpatialIndex.h"
+#include "Scene.h"
+#include "Node.h"
+
+// The fraction of a node's bounding radius its leaf box is enlarged by.
+#define SPATIAL_INDEX_MARGIN_SCALE 0.2f
+
+// The minimum amount a leaf box is enlarged by.
+#define SPATIAL_INDEX_MARGIN_MIN 0.01f
+
+// All six frustum planes.
+#define SPATIAL_INDEX_ALL_PLANES 63
+
+namespace gameplay
+{
+
+static float getSurfaceArea(const BoundingBox& box)
+{
+    float dx = box.max.x - box.min.x;
+    float dy = box.max.y - box.min.y;
+    float dz = box.max.z - box.min.z;
+    return dx * dy + dy * dz + dz * dx;
+}
+
+static BoundingBox mergeBoxes(const BoundingBox& a, const BoundingBox& b)
+{
+    return BoundingBox(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z),
+                       std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z));
+}
+
+static bool containsBox(const BoundingBox& outer, const BoundingBox& inner)
+{
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+           outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
+
+SpatialIndex::SpatialIndex(Scene* scene)
+    : _scene(scene), _root(-1), _freeList(-1), _nodeCount(0)
+{
+    GP_ASSERT(scene);
+}
+
+SpatialIndex::~SpatialIndex()
+{
+    for (Node* node = _scene->getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        removeNode(node);
+    }
+}
+
+void SpatialIndex::update()
+{
+    GP_PROFILE_SCOPE("SpatialIndex::update");
+
+    std::vector<int> moved;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_moved.empty())
+            return;
+        moved.swap(_moved);
+    }
+
+    for (size_t i = 0, count = moved.size(); i < count; ++i)
+    {
+        int leaf = moved[i];
+        TreeNode& treeNode = _treeNodes[leaf];
+        if (treeNode.height < 0 || !treeNode.moved)
+            continue;
+        treeNode.moved = false;
+
+        // Nodes that stay within their enlarged box only update their sphere.
+        BoundingSphere sphere;
+        if (!treeNode.unbounded && treeNode.node->computeBoundingSphere(&sphere))
+        {
+            BoundingBox box(sphere.center.x - sphere.radius, sphere.center.y - sphere.radius, sphere.center.z - sphere.radius,
+                            sphere.center.x + sphere.radius, sphere.center.y + sphere.radius, sphere.center.z + sphere.radius);
+            if (containsBox(treeNode.box, box))
+            {
+                treeNode.sphere = sphere;
+                continue;
+            }
+        }
+
+        unplaceLeaf(leaf);
+        placeLeaf(leaf);
+    }
+}
+
+unsigned int SpatialIndex::findNodes(const Frustum& frustum, std::vector<Node*>& nodes)
+{
+    GP_PROFILE_SCOPE("SpatialIndex::findNodes");
+
+    update();
+
+    size_t start = nodes.size();
+    for (size_t i = 0, count = _unbounded.size(); i < count; ++i)
+    {
+        nodes.push_back(_treeNodes[_unbounded[i]].node);
+    }
+    if (_root < 0)
+        return (unsigned int)(nodes.size() - start);
+
+    const Plane* planes[6] = { &frustum.getNear(), &frustum.getFar(), &frustum.getLeft(), &frustum.getRight(), &frustum.getBottom(), &frustum.getTop() };
+
+    _candidateSpheres.clear();
+    _candidateNodes.clear();
+    _stack.clear();
+    _stack.push_back(_root);
+    _stack.push_back(SPATIAL_INDEX_ALL_PLANES);
+    while (!_stack.empty())
+    {
+        // Each entry holds a tree node and the mask of planes it still crosses.
+        int mask = _stack.back();
+        _stack.pop_back();
+        int index = _stack.back();
+        _stack.pop_back();
+
+        const TreeNode& treeNode = _treeNodes[index];
+        const BoundingBox& box = treeNode.box;
+        bool outside = false;
+        for (int p = 0; p < 6 && !outside; ++p)
+        {
+            if (!(mask & (1 << p)))
+                continue;
+
+            const Vector3& normal = planes[p]->getNormal();
+            float distance = planes[p]->getDistance();
+
+            // The corner furthest along the plane normal decides whether the
+            // box is outside, the nearest one whether it is fully inside.
+            float farthest = normal.x * (normal.x >= 0.0f ? box.max.x : box.min.x) +
+                             normal.y * (normal.y >= 0.0f ? box.max.y : box.min.y) +
+                             normal.z * (normal.z >= 0.0f ? box.max.z : box.min.z) + distance;
+            if (farthest < 0.0f)
+            {
+                outside = true;
+                break;
+            }
+            float nearest = normal.x * (normal.x >= 0.0f ? box.min.x : box.max.x) +
+                            normal.y * (normal.y >= 0.0f ? box.min.y : box.max.y) +
+                            normal.z * (normal.z >= 0.0f ? box.min.z : box.max.z) + distance;
+            if (nearest >= 0.0f)
+                mask &= ~(1 << p);
+        }
+        if (outside)
+            continue;
+
+        if (mask == 0)
+        {
+            collectLeaves(index, nodes);
+        }
+        else if (treeNode.isLeaf())
+        {
+            _candidateSpheres.push_back(treeNode.sphere);
+            _candidateNodes.push_back(treeNode.node);
+        }
+        else
+        {
+            _stack.push_back(treeNode.child1);
+            _stack.push_back(mask);
+            _stack.push_back(treeNode.child2);
+            _stack.push_back(mask);
+        }
+    }
+
+    // Leaves of partially visible subtrees are tested together.
+    unsigned int candidateCount = (unsigned int)_candidateSpheres.size();
+    if (candidateCount > 0)
+    {
+        _candidateIndices.resize(candidateCount);
+        unsigned int visibleCount = frustum.intersects(&_candidateSpheres[0], candidateCount, &_candidateIndices[0]);
+        for (unsigned int i = 0; i < visibleCount; ++i)
+        {
+            nodes.push_back(_candidateNodes[_candidateIndices[i]]);
+        }
+    }
+
+    return (unsigned int)(nodes.size() - start);
+}
+
+unsigned int SpatialIndex::findNodes(const BoundingBox& box, std::vector<Node*>& nodes)
+{
+    update();
+
+    size_t start = nodes.size();
+    if (_root < 0)
+        return 0;
+
+    _stack.clear();
+    _stack.push_back(_root);
+    while (!_stack.empty())
+    {
+        int index = _stack.back();
+        _stack.pop_back();
+
+        const TreeNode& treeNode = _treeNodes[index];
+        if (!treeNode.box.intersects(box))
+            continue;
+
+        if (treeNode.isLeaf())
+        {
+            if (treeNode.sphere.intersects(box))
+                nodes.push_back(treeNode.node);
+        }
+        else
+        {
+            _stack.push_back(treeNode.child1);
+            _stack.push_back(treeNode.child2);
+        }
+    }
+
+    return (unsigned int)(nodes.size() - start);
+}
+
+unsigned int SpatialIndex::getNodeCount() const
+{
+    return _nodeCount;
+}
+
+unsigned int SpatialIndex::getHeight() const
+{
+    return _root >= 0 ? (unsigned int)_treeNodes[_root].height + 1 : 0;
+}
+
+void SpatialIndex::addNode(Node* node)
+{
+    GP_ASSERT(node);
+
+    refreshNode(node);
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        addNode(child);
+    }
+}
+
+void SpatialIndex::removeNode(Node* node)
+{
+    GP_ASSERT(node);
+
+    if (node->_spatialIndex == this)
+    {
+        int leaf = node->_spatialProxy;
+        unplaceLeaf(leaf);
+        freeTreeNode(leaf);
+        node->_spatialIndex = NULL;
+        node->_spatialProxy = -1;
+        --_nodeCount;
+    }
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        removeNode(child);
+    }
+}
+
+void SpatialIndex::refreshNode(Node* node)
+{
+    GP_ASSERT(node);
+
+    if (node->getDrawable() && !node->_spatialIndex)
+    {
+        int leaf = allocateTreeNode();
+        TreeNode& treeNode = _treeNodes[leaf];
+        treeNode.node = node;
+        treeNode.height = 0;
+        node->_spatialIndex = this;
+        node->_spatialProxy = leaf;
+        ++_nodeCount;
+        placeLeaf(leaf);
+    }
+    else if (!node->getDrawable() && node->_spatialIndex == this)
+    {
+        int leaf = node->_spatialProxy;
+        unplaceLeaf(leaf);
+        freeTreeNode(leaf);
+        node->_spatialIndex = NULL;
+        node->_spatialProxy = -1;
+        --_nodeCount;
+    }
+    else if (node->_spatialIndex == this)
+    {
+        setMoved(node);
+    }
+}
+
+void SpatialIndex::setMoved(Node* node)
+{
+    GP_ASSERT(node && node->_spatialIndex == this);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    TreeNode& treeNode = _treeNodes[node->_spatialProxy];
+    if (!treeNode.moved)
+    {
+        treeNode.moved = true;
+        _moved.push_back(node->_spatialProxy);
+    }
+}
+
+void SpatialIndex::placeLeaf(int leaf)
+{
+    TreeNode& treeNode = _treeNodes[leaf];
+    if (!treeNode.node->computeBoundingSphere(&treeNode.sphere))
+    {
+        treeNode.unbounded = true;
+        _unbounded.push_back(leaf);
+        return;
+    }
+
+    treeNode.unbounded = false;
+    const BoundingSphere& sphere = treeNode.sphere;
+    float extent = sphere.radius + std::max(sphere.radius * SPATIAL_INDEX_MARGIN_SCALE, SPATIAL_INDEX_MARGIN_MIN);
+    treeNode.box.set(sphere.center.x - extent, sphere.center.y - extent, sphere.center.z - extent,
+                     sphere.center.x + extent, sphere.center.y + extent, sphere.center.z + extent);
+    insertLeaf(leaf);
+}
+
+void SpatialIndex::unplaceLeaf(int leaf)
+{
+    if (_treeNodes[leaf].unbounded)
+    {
+        std::vector<int>::iterator itr = std::find(_unbounded.begin(), _unbounded.end(), leaf);
+        GP_ASSERT(itr != _unbounded.end());
+        _unbounded.erase(itr);
+    }
+    else
+    {
+        removeLeaf(leaf);
+    }
+}
+
+int SpatialIndex::allocateTreeNode()
+{
+    if (_freeList < 0)
+    {
+        // setMoved() may be called from other threads while the pool grows.
+        std::unique_lock<std::mutex> lock(_mutex);
+        TreeNode treeNode;
+        treeNode.parent = _freeList;
+        treeNode.height = -1;
+        _treeNodes.push_back(treeNode);
+        _freeList = (int)_treeNodes.size() - 1;
+    }
+
+    int index = _freeList;
+    TreeNode& treeNode = _treeNodes[index];
+    _freeList = treeNode.parent;
+    treeNode.node = NULL;
+    treeNode.parent = -1;
+    treeNode.child1 = -1;
+    treeNode.child2 = -1;
+    treeNode.height = 0;
+    treeNode.moved = false;
+    treeNode.unbounded = false;
+    return index;
+}
+
+void SpatialIndex::freeTreeNode(int index)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    TreeNode& treeNode = _treeNodes[index];
+    treeNode.node = NULL;
+    treeNode.parent = _freeList;
+    treeNode.height = -1;
+    treeNode.moved = false;
+    _freeList = index;
+}
+
+void SpatialIndex::insertLeaf(int leaf)
+{
+    if (_root < 0)
+    {
+        _root = leaf;
+        _treeNodes[leaf].parent = -1;
+        return;
+    }
+
+    // Descend towards the sibling whose box grows the least by adding the leaf.
+    BoundingBox leafBox = _treeNodes[leaf].box;
+    int index = _root;
+    while (!_treeNodes[index].isLeaf())
+    {
+        const TreeNode& treeNode = _treeNodes[index];
+        float area = getSurfaceArea(treeNode.box);
+        float combinedArea = getSurfaceArea(mergeBoxes(treeNode.box, leafBox));
+
+        // Cost of making a new parent for this node and the leaf, and the
+        // minimum cost of pushing the leaf further down the tree.
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        const TreeNode& child1 = _treeNodes[treeNode.child1];
+        float cost1 = getSurfaceArea(mergeBoxes(child1.box, leafBox)) + inheritanceCost;
+        if (!child1.isLeaf())
+            cost1 -= getSurfaceArea(child1.box);
+
+        const TreeNode& child2 = _treeNodes[treeNode.child2];
+        float cost2 = getSurfaceArea(mergeBoxes(child2.box, leafBox)) + inheritanceCost;
+        if (!child2.isLeaf())
+            cost2 -= getSurfaceArea(child2.box);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = cost1 < cost2 ? treeNode.child1 : treeNode.child2;
+    }
+
+    int sibling = index;
+    int oldParent = _treeNodes[sibling].parent;
+    int newParent = allocateTreeNode();
+    {
+        TreeNode& parent = _treeNodes[newParent];
+        parent.parent = oldParent;
+        parent.box = mergeBoxes(leafBox, _treeNodes[sibling].box);
+        parent.height = _treeNodes[sibling].height + 1;
+        parent.child1 = sibling;
+        parent.child2 = leaf;
+    }
+    if (oldParent >= 0)
+    {
+        if (_treeNodes[oldParent].child1 == sibling)
+            _treeNodes[oldParent].child1 = newParent;
+        else
+            _treeNodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        _root = newParent;
+    }
+    _treeNodes[sibling].parent = newParent;
+    _treeNodes[leaf].parent = newParent;
+
+    // Walk back up the tree fixing heights and boxes.
+    index = _treeNodes[leaf].parent;
+    while (index >= 0)
+    {
+        index = balance(index);
+
+        TreeNode& treeNode = _treeNodes[index];
+        const TreeNode& child1 = _treeNodes[treeNode.child1];
+        const TreeNode& child2 = _treeNodes[treeNode.child2];
+        treeNode.height = 1 + std::max(child1.height, child2.height);
+        treeNode.box = mergeBoxes(child1.box, child2.box);
+
+        index = treeNode.parent;
+    }
+}
+
+void SpatialIndex::removeLeaf(int leaf)
+{
+    if (leaf == _root)
+    {
+        _root = -1;
+        return;
+    }
+
+    int parent = _treeNodes[leaf].parent;
+    int grandParent = _treeNodes[parent].parent;
+    int sibling = _treeNodes[parent].child1 == leaf ? _treeNodes[parent].child2 : _treeNodes[parent].child1;
+
+    if (grandParent >= 0)
+    {
+        // Replace the parent with the sibling.
+        if (_treeNodes[grandParent].child1 == parent)
+            _treeNodes[grandParent].child1 = sibling;
+        else
+            _treeNodes[grandParent].child2 = sibling;
+        _treeNodes[sibling].parent = grandParent;
+        freeTreeNode(parent);
+
+        int index = grandParent;
+        while (index >= 0)
+        {
+            index = balance(index);
+
+            TreeNode& treeNode = _treeNodes[index];
+            const TreeNode& child1 = _treeNodes[treeNode.child1];
+            const TreeNode& child2 = _treeNodes[treeNode.child2];
+            treeNode.box = mergeBoxes(child1.box, child2.box);
+            treeNode.height = 1 + std::max(child1.height, child2.height);
+
+            index = treeNode.parent;
+        }
+    }
+    else
+    {
+        _root = sibling;
+        _treeNodes[sibling].parent = -1;
+        freeTreeNode(parent);
+    }
+    _treeNodes[leaf].parent = -1;
+}
+
+int SpatialIndex::balance(int iA)
+{
+    TreeNode* A = &_treeNodes[iA];
+    if (A->isLeaf() || A->height < 2)
+        return iA;
+
+    int iB = A->child1;
+    int iC = A->child2;
+    TreeNode* B = &_treeNodes[iB];
+    TreeNode* C = &_treeNodes[iC];
+    int balance = C->height - B->height;
+
+    // Rotate C up.
+    if (balance > 1)
+    {
+        int iF = C->child1;
+        int iG = C->child2;
+        TreeNode* F = &_treeNodes[iF];
+        TreeNode* G = &_treeNodes[iG];
+
+        // Swap A and C.
+        C->child1 = iA;
+        C->parent = A->parent;
+        A->parent = iC;
+
+        // A's old parent should point to C.
+        if (C->parent >= 0)
+        {
+            if (_treeNodes[C->parent].child1 == iA)
+                _treeNodes[C->parent].child1 = iC;
+            else
+                _treeNodes[C->parent].child2 = iC;
+        }
+        else
+        {
+            _root = iC;
+        }
+
+        // Rotate the taller of F and G up with C.
+        if (F->height > G->height)
+        {
+            C->child2 = iF;
+            A->child2 = iG;
+            G->parent = iA;
+            A->box = mergeBoxes(B->box, G->box);
+            C->box = mergeBoxes(A->box, F->box);
+            A->height = 1 + std::max(B->height, G->height);
+            C->height = 1 + std::max(A->height, F->height);
+        }
+        else
+        {
+            C->child2 = iG;
+            A->child2 = iF;
+            F->parent = iA;
+            A->box = mergeBoxes(B->box, F->box);
+            C->box = mergeBoxes(A->box, G->box);
+            A->height = 1 + std::max(B->height, F->height);
+            C->height = 1 + std::max(A->height, G->height);
+        }
+
+        return iC;
+    }
+
+    // Rotate B up.
+    if (balance < -1)
+    {
+        int iD = B->child1;
+        int iE = B->child2;
+        TreeNode* D = &_treeNodes[iD];
+        TreeNode* E = &_treeNodes[iE];
+
+        // Swap A and B.
+        B->child1 = iA;
+        B->parent = A->parent;
+        A->parent = iB;
+
+        // A's old parent should point to B.
+        if (B->parent >= 0)
+        {
+            if (_treeNodes[B->parent].child1 == iA)
+                _treeNodes[B->parent].child1 = iB;
+            else
+                _treeNodes[B->parent].child2 = iB;
+        }
+        else
+        {
+            _root = iB;
+        }
+
+        // Rotate the taller of D and E up with B.
+        if (D->height > E->height)
+        {
+            B->child2 = iD;
+            A->child1 = iE;
+            E->parent = iA;
+            A->box = mergeBoxes(C->box, E->box);
+            B->box = mergeBoxes(A->box, D->box);
+            A->height = 1 + std::max(C->height, E->height);
+            B->height = 1 + std::max(A->height, D->height);
+        }
+        else
+        {
+            B->child2 = iE;
+            A->child1 = iD;
+            D->parent = iA;
+            A->box = mergeBoxes(C->box, D->box);
+            B->box = mergeBoxes(A->box, E->box);
+            A->height = 1 + std::max(C->height, D->height);
+            B->height = 1 + std::max(A->height, E->height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+void SpatialIndex::collectLeaves(int index, std::vector<Node*>& nodes) const
+{
+    const TreeNode& treeNode = _treeNodes[index];
+    if (treeNode.isLeaf())
+    {
+        nodes.push_back(treeNode.node);
+    }
+    else
+    {
+        collectLeaves(treeNode.child1, nodes);
+        collectLeaves(treeNode.child2, nodes);
+    }
+}
+
+}
@@ -0,0 +1,204 @@
+#ifndef SPATIALINDEX_H_
+#define SPATIALINDEX_H_
+
+#include "BoundingBox.h"
+#include "BoundingSphere.h"
+#include "Frustum.h"
+
+namespace gameplay
+{
+
+class Scene;
+class Node;
+
+/**
+ * Defines a spatial index over the drawable nodes of a scene, used to find
+ * the nodes inside a view frustum without testing every node.
+ *
+ * The index is a dynamic bounding volume hierarchy. Every drawable node is a
+ * leaf holding the node's own world-space bounding sphere (not merged with
+ * its children) and a box enlarged around it. Moving a node only marks it;
+ * on the next update the node is re-inserted only if its bounds have left
+ * the enlarged box, so nodes that move a little or not at all cost nothing.
+ * The tree is kept balanced with rotations as leaves are inserted.
+ *
+ * Queries descend the tree with the frustum planes, take whole subtrees that
+ * are inside the frustum without further tests, and test the leaves of
+ * partially visible subtrees in one batched sphere test.
+ *
+ * Nodes whose drawables have no bounds (such as forms and text) are always
+ * reported as visible.
+ *
+ * @see Scene::setSpatialIndexEnabled
+ * @script{ignore}
+ */
+class SpatialIndex
+{
+    friend class Scene;
+    friend class Node;
+
+public:
+
+    /**
+     * Updates the leaves of all nodes that moved since the last update.
+     */
+    void update();
+
+    /**
+     * Finds the drawable nodes that intersect a frustum.
+     *
+     * Pending node movements are applied first.
+     *
+     * @param frustum The frustum to test against.
+     * @param nodes The vector the visible nodes are appended to.
+     *
+     * @return The number of nodes appended.
+     */
+    unsigned int findNodes(const Frustum& frustum, std::vector<Node*>& nodes);
+
+    /**
+     * Finds the drawable nodes whose bounds intersect a box.
+     *
+     * Pending node movements are applied first.
+     *
+     * @param box The box to test against.
+     * @param nodes The vector the intersecting nodes are appended to.
+     *
+     * @return The number of nodes appended.
+     */
+    unsigned int findNodes(const BoundingBox& box, std::vector<Node*>& nodes);
+
+    /**
+     * Gets the number of nodes in the index.
+     *
+     * @return The number of nodes.
+     */
+    unsigned int getNodeCount() const;
+
+    /**
+     * Gets the height of the tree, which is a measure of its balance.
+     *
+     * @return The number of levels in the tree.
+     */
+    unsigned int getHeight() const;
+
+private:
+
+    /**
+     * A node of the tree. Leaves reference scene nodes.
+     */
+    struct TreeNode
+    {
+        BoundingBox box;
+        BoundingSphere sphere;
+        Node* node;
+        int parent;
+        int child1;
+        int child2;
+        int height;
+        bool moved;
+        bool unbounded;
+
+        bool isLeaf() const { return child1 < 0; }
+    };
+
+    /**
+     * Constructor.
+     */
+    SpatialIndex(Scene* scene);
+
+    /**
+     * Destructor.
+     */
+    ~SpatialIndex();
+
+    /**
+     * Hidden copy constructor.
+     */
+    SpatialIndex(const SpatialIndex& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    SpatialIndex& operator=(const SpatialIndex&);
+
+    /**
+     * Adds a node and its descendants to the index.
+     */
+    void addNode(Node* node);
+
+    /**
+     * Removes a node and its descendants from the index.
+     */
+    void removeNode(Node* node);
+
+    /**
+     * Adds, removes or marks a single node as moved depending on whether it has a drawable.
+     */
+    void refreshNode(Node* node);
+
+    /**
+     * Marks a node as moved.
+     */
+    void setMoved(Node* node);
+
+    /**
+     * Computes the enlarged box of a leaf and puts it in the tree, or in the
+     * unbounded list if the node has no bounds.
+     */
+    void placeLeaf(int leaf);
+
+    /**
+     * Takes a leaf out of the tree or the unbounded list.
+     */
+    void unplaceLeaf(int leaf);
+
+    /**
+     * Takes a tree node from the free list, growing the pool if needed.
+     */
+    int allocateTreeNode();
+
+    /**
+     * Returns a tree node to the free list.
+     */
+    void freeTreeNode(int index);
+
+    /**
+     * Inserts a leaf next to the sibling that grows the tree the least.
+     */
+    void insertLeaf(int leaf);
+
+    /**
+     * Removes a leaf from the tree, replacing its parent with its sibling.
+     */
+    void removeLeaf(int leaf);
+
+    /**
+     * Rotates the subtree at the given tree node if it is unbalanced.
+     *
+     * @return The tree node now at the root of the subtree.
+     */
+    int balance(int index);
+
+    /**
+     * Appends the scene nodes of all leaves below a tree node.
+     */
+    void collectLeaves(int index, std::vector<Node*>& nodes) const;
+
+    Scene* _scene;
+    std::vector<TreeNode> _treeNodes;
+    int _root;
+    int _freeList;
+    unsigned int _nodeCount;
+    std::vector<int> _unbounded;
+    std::vector<int> _moved;
+    std::vector<int> _stack;
+    std::vector<BoundingSphere> _candidateSpheres;
+    std::vector<Node*> _candidateNodes;
+    std::vector<unsigned int> _candidateIndices;
+    std::mutex _mutex;
+};
+
+}
+
+#endif
@@ -27,6 +27,7 @@ class SpriteBatch
     friend class Bundle;
     friend class Font;
     friend class Text;
+    friend class Form;
 
 public:
 
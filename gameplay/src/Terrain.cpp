@@ -3,6 +3,7 @@
 #include "TerrainPatch.h"
 #include "Node.h"
 #include "FileSystem.h"
+#include "Camera.h"
 
 namespace gameplay
 {
@@ -22,6 +23,9 @@ static const unsigned int DEFAULT_TERRAIN_PATCH_SIZE = 32;
 //
 static const float DEFAULT_TERRAIN_HEIGHT_RATIO = 0.3f;
 
+// The default memory budget of a streaming terrain's patch meshes, in megabytes.
+static const float DEFAULT_TERRAIN_STREAMING_BUDGET = 64.0f;
+
 // Terrain dirty flags
 static const unsigned int DIRTY_FLAG_INVERSE_WORLD = 1;
 
@@ -29,8 +33,10 @@ static float getDefaultHeight(unsigned int width, unsigned int height);
 
 Terrain::Terrain() : Drawable(),
     _heightfield(NULL), _normalMap(NULL), _flags(FRUSTUM_CULLING | LEVEL_OF_DETAIL),
-    _dirtyFlags(DIRTY_FLAG_INVERSE_WORLD), _localScale( 0.0f, 0.0f, 0.0f )
+    _dirtyFlags(DIRTY_FLAG_INVERSE_WORLD), _localScale( 0.0f, 0.0f, 0.0f ), _streaming(false),
+    _streamingBudget((size_t)(DEFAULT_TERRAIN_STREAMING_BUDGET * 1024 * 1024)), _streamingFrame(0)
 {
+    memset(&_statistics, 0, sizeof(_statistics));
 }
 
 Terrain::~Terrain()
@@ -122,6 +128,11 @@ Terrain* Terrain::create(const char* path, Properties* properties)
             // Read normalized height values from RAW file
             heightfield = HeightField::createFromRAW(heightmap.c_str(), (unsigned int)imageSize.x, (unsigned int)imageSize.y, 0, 1);
         }
+        else if (ext == ".GPH")
+        {
+            // Map the tiled heightfield file, which is streamed
+            heightfield = HeightField::createFromTiles(heightmap.c_str());
+        }
         else
         {
             // Unsupported heightmap format
@@ -156,6 +167,11 @@ Terrain* Terrain::create(const char* path, Properties* properties)
                 SAFE_DELETE(p);
             return NULL;
         }
+        else if (ext == ".GPH")
+        {
+            // Map the tiled heightfield file, which is streamed
+            heightfield = HeightField::createFromTiles(heightmap.c_str());
+        }
         else
         {
             GP_WARN("Unsupported 'heightmap' format ('%s') in terrain definition: %s.", heightmap.c_str(), path);
@@ -211,7 +227,14 @@ Terrain* Terrain::create(const char* path, Properties* properties)
         terrainSize.set(heightfield->getColumnCount(), getDefaultHeight(heightfield->getColumnCount(), heightfield->getRowCount()), heightfield->getRowCount());
     }
 
-    if (patchSize <= 0 || patchSize > (int)heightfield->getColumnCount() || patchSize > (int)heightfield->getRowCount())
+    if (heightfield->isTiled())
+    {
+        // Patches are the tiles of a tiled heightfield, which has all of its levels by default
+        patchSize = heightfield->getTileSize();
+        if (!pTerrain->exists("detailLevels"))
+            detailLevels = heightfield->getTileLevelCount();
+    }
+    else if (patchSize <= 0 || patchSize > (int)heightfield->getColumnCount() || patchSize > (int)heightfield->getRowCount())
     {
         patchSize = std::min(heightfield->getRowCount(), std::min(heightfield->getColumnCount(), DEFAULT_TERRAIN_PATCH_SIZE));
     }
@@ -259,6 +282,24 @@ Terrain* Terrain::create(HeightField* heightfield, const Vector3& scale,
     // Store reference to bounding box (it is calculated and updated from TerrainPatch)
     BoundingBox& bounds = terrain->_boundingBox;
 
+    // Tiled heightfields have no height array, so their patch meshes are always streamed
+    terrain->_streaming = heightfield->isTiled() || (properties && properties->getBool("streaming"));
+    if (properties && properties->exists("streamingBudget"))
+        terrain->_streamingBudget = (size_t)(properties->getFloat("streamingBudget") * 1024 * 1024);
+    if (heightfield->isTiled())
+    {
+        if (patchSize != heightfield->getTileSize())
+        {
+            GP_WARN("Terrain patch size %u does not match the tile size %u of its tiled heightfield; using the tile size.", patchSize, heightfield->getTileSize());
+            patchSize = heightfield->getTileSize();
+        }
+        if (detailLevels > heightfield->getTileLevelCount())
+        {
+            GP_WARN("Terrain has more detail levels (%u) than its tiled heightfield (%u).", detailLevels, heightfield->getTileLevelCount());
+            detailLevels = heightfield->getTileLevelCount();
+        }
+    }
+
     if (normalMapPath)
     {
         terrain->_normalMap = Texture::Sampler::create(normalMapPath, true);
@@ -266,9 +307,6 @@ Terrain* Terrain::create(HeightField* heightfield, const Vector3& scale,
         GP_ASSERT( terrain->_normalMap->getTexture()->getType() == Texture::TEXTURE_2D );
     }
 
-    float halfWidth = (width - 1) * 0.5f;
-    float halfHeight = (height - 1) * 0.5f;
-
     // Compute the maximum step size, which is a function of our lowest level of detail.
     // This determines how many vertices will be skipped per triange/quad on the lowest
     // level detail terrain patch.
@@ -288,7 +326,7 @@ Terrain* Terrain::create(HeightField* heightfield, const Vector3& scale,
             x2 = std::min(x1 + patchSize, width-1);
 
             // Create this patch
-            TerrainPatch* patch = TerrainPatch::create(terrain, terrain->_patches.size(), row, column, heightfield->getArray(), width, height, x1, z1, x2, z2, -halfWidth, -halfHeight, maxStep, skirtScale);
+            TerrainPatch* patch = TerrainPatch::create(terrain, terrain->_patches.size(), row, column, heightfield, x1, z1, x2, z2, maxStep, skirtScale);
             terrain->_patches.push_back(patch);
 
             // Append the new patch's local bounds to the terrain local bounds
@@ -529,13 +567,80 @@ float Terrain::getHeight(float x, float z) const
     return height;
 }
 
+bool Terrain::isStreaming() const
+{
+    return _streaming;
+}
+
+size_t Terrain::getStreamingBudget() const
+{
+    return _streamingBudget;
+}
+
+void Terrain::setStreamingBudget(size_t budget)
+{
+    _streamingBudget = budget;
+}
+
+void Terrain::updateStreaming(Camera* camera)
+{
+    GP_ASSERT(camera);
+
+    if (!_streaming)
+        return;
+
+    ++_streamingFrame;
+    for (size_t i = 0, count = _patches.size(); i < count; ++i)
+    {
+        TerrainPatch* patch = _patches[i];
+        const BoundingBox& bounds = patch->getBoundingBox(true);
+        if (isFlagSet(FRUSTUM_CULLING) && !camera->getFrustum().intersects(bounds))
+            continue;
+
+        patch->useLevel(patch->computeLOD(camera, bounds));
+    }
+    evictLevels();
+}
+
+const Terrain::Statistics& Terrain::getStatistics() const
+{
+    return _statistics;
+}
+
+void Terrain::resetStatistics()
+{
+    _statistics.builtLevels = 0;
+    _statistics.evictedLevels = 0;
+}
+
+void Terrain::evictLevels() const
+{
+    // Levels used in this frame are at the front of the list, so stop at the first one
+    while (_statistics.residentBytes > _streamingBudget && !_residentLevels.empty())
+    {
+        TerrainPatch::Level* level = _residentLevels.back();
+        if (level->frame == _streamingFrame)
+            break;
+
+        level->patch->evictLevel(level);
+        ++_statistics.evictedLevels;
+    }
+}
+
 unsigned int Terrain::draw(bool wireframe) const
 {
+    if (_streaming)
+        ++_streamingFrame;
+
     size_t visibleCount = 0;
     for (size_t i = 0, count = _patches.size(); i < count; ++i)
     {
         visibleCount += _patches[i]->draw(wireframe);
     }
+
+    if (_streaming)
+        evictLevels();
+
     return visibleCount;
 }
 
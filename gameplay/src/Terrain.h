@@ -79,6 +79,25 @@ class TerrainAutoBindingResolver;
  * approaches. In practice, the skirts are often not noticeable at all unless the LOD variation
  * is very large and the terrain is excessively hilly on the edge of a LOD transition.
  *
+ * Very large terrains can be streamed. A streaming terrain builds the mesh of a patch's level of
+ * detail the first time it is needed to draw the patch, on a ResourceLoader thread, and only
+ * creates the vertex and index buffers on the main thread. Until then, the patch is drawn at the
+ * closest level of detail that is already in memory, if any. When the levels in memory exceed the
+ * streaming budget, the least recently drawn levels are released. Terrains created from a tiled
+ * heightfield file (.gph, see HeightField::writeTiles()) are always streamed and never read the
+ * whole heightfield into memory; their patch size is the tile size of the file. Other terrains
+ * can be streamed by setting the streaming property:
+ *
+ * @code
+ * terrain
+ * {
+ *     heightmap = res/terrain.gph
+ *     detailLevels = 4
+ *     streaming = true          // implied by a .gph heightmap
+ *     streamingBudget = 64      // memory (in megabytes) for patch meshes, default is 64
+ * }
+ * @endcode
+ *
  * @see http://gameplay3d.github.io/GamePlay/docs/file-formats.html#wiki-Terrain
  */
 class Terrain : public Ref, public Drawable, public Transform::Listener
@@ -91,6 +110,42 @@ class Terrain : public Ref, public Drawable, public Transform::Listener
 
 public:
 
+    /**
+     * Counters of the work done by a streaming terrain.
+     */
+    struct Statistics
+    {
+        /**
+         * The number of patches with at least one level of detail in memory.
+         */
+        unsigned int residentPatches;
+
+        /**
+         * The number of patch levels of detail in memory.
+         */
+        unsigned int residentLevels;
+
+        /**
+         * The size of the vertex and index data of the levels in memory, in bytes.
+         */
+        size_t residentBytes;
+
+        /**
+         * The number of levels waiting to be built.
+         */
+        unsigned int pendingLevels;
+
+        /**
+         * The number of levels built.
+         */
+        unsigned int builtLevels;
+
+        /**
+         * The number of levels released to stay within the streaming budget.
+         */
+        unsigned int evictedLevels;
+    };
+
     /**
      * Terrain flags.
      */
@@ -262,6 +317,64 @@ public:
                   const char* blendPath = NULL, int blendChannel = 0,
                   int row = -1, int column = -1);
 
+    /**
+     * Determines if this terrain streams the meshes of its patches.
+     *
+     * @return True if the terrain is streamed, false if all patch meshes were built when it was created.
+     * @script{ignore}
+     */
+    bool isStreaming() const;
+
+    /**
+     * Gets the memory budget for the patch meshes of a streaming terrain.
+     *
+     * @return The budget in bytes.
+     * @script{ignore}
+     */
+    size_t getStreamingBudget() const;
+
+    /**
+     * Sets the memory budget for the patch meshes of a streaming terrain.
+     *
+     * Levels drawn in the current frame are never released, so a budget that is too small for
+     * the view is exceeded rather than causing patches to disappear.
+     *
+     * @param budget The budget in bytes.
+     * @script{ignore}
+     */
+    void setStreamingBudget(size_t budget);
+
+    /**
+     * Streams in the levels of detail that the given camera needs, without drawing.
+     *
+     * draw() does this for the scene's active camera. Calling it directly preloads the terrain
+     * around a camera, for example before a level starts, and drives streaming without a
+     * renderer. Built levels are created by the ResourceLoader on the main thread, so they are
+     * in memory once the loader has run, e.g. after ResourceLoader::finish().
+     *
+     * @param camera The camera to stream the terrain for.
+     * @script{ignore}
+     */
+    void updateStreaming(Camera* camera);
+
+    /**
+     * Gets the streaming counters.
+     *
+     * The counters of levels built and evicted accumulate since the terrain was created or since
+     * the last call to resetStatistics().
+     *
+     * @return The statistics.
+     * @script{ignore}
+     */
+    const Statistics& getStatistics() const;
+
+    /**
+     * Resets the counters of levels built and evicted to zero.
+     *
+     * @script{ignore}
+     */
+    void resetStatistics();
+
     /**
      * @see Drawable#draw
      */
@@ -329,6 +442,11 @@ private:
      */
     BoundingBox getBoundingBox(bool worldSpace) const;
 
+    /**
+     * Releases the least recently used levels of a streaming terrain until it is within budget.
+     */
+    void evictLevels() const;
+
     std::string _materialPath;
     HeightField* _heightfield;
     Vector3 _localScale;
@@ -338,6 +456,11 @@ private:
     mutable Matrix _inverseWorldMatrix;
     mutable unsigned int _dirtyFlags;
     BoundingBox _boundingBox;
+    bool _streaming;
+    size_t _streamingBudget;
+    mutable unsigned int _streamingFrame;
+    mutable std::list<TerrainPatch::Level*> _residentLevels;  // most recently used first
+    mutable Statistics _statistics;
 };
 
 }
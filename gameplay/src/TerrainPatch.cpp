@@ -30,7 +30,8 @@ static TerrainAutoBindingResolver __autoBindingResolver;
 static int __currentPatchIndex = -1;
 
 TerrainPatch::TerrainPatch() :
-    _terrain(NULL), _row(0), _column(0), _camera(NULL), _level(0), _bits(TERRAINPATCH_DIRTY_ALL)
+    _terrain(NULL), _row(0), _column(0), _x1(0), _z1(0), _x2(0), _z2(0), _verticalSkirtSize(0),
+    _residentLevelCount(0), _camera(NULL), _level(0), _bits(TERRAINPATCH_DIRTY_ALL)
 {
 }
 
@@ -40,6 +41,16 @@ TerrainPatch::~TerrainPatch()
     {
         Level* level = _levels[i];
 
+        // A build still in progress completes without touching this patch.
+        if (level->request)
+        {
+            level->request->cancel();
+            SAFE_RELEASE(level->request);
+            --_terrain->_statistics.pendingLevels;
+        }
+        if (level->model && _terrain->_streaming)
+            evictLevel(level);
+
         SAFE_RELEASE(level->model);
         SAFE_DELETE(level);
     }
@@ -57,10 +68,8 @@ TerrainPatch::~TerrainPatch()
 }
 
 TerrainPatch* TerrainPatch::create(Terrain* terrain, unsigned int index,
-                                   unsigned int row, unsigned int column,
-                                   float* heights, unsigned int width, unsigned int height,
+                                   unsigned int row, unsigned int column, HeightField* heightfield,
                                    unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2,
-                                   float xOffset, float zOffset,
                                    unsigned int maxStep, float verticalSkirtSize)
 {
     // Create patch
@@ -69,16 +78,58 @@ TerrainPatch* TerrainPatch::create(Terrain* terrain, unsigned int index,
     patch->_index = index;
     patch->_row = row;
     patch->_column = column;
+    patch->_x1 = x1;
+    patch->_z1 = z1;
+    patch->_x2 = x2;
+    patch->_z2 = z2;
+    patch->_verticalSkirtSize = verticalSkirtSize;
+
+    if (!terrain->_streaming)
+    {
+        // Add patch lods
+        for (unsigned int step = 1; step <= maxStep; step *= 2)
+        {
+            patch->addLOD(step);
+        }
+
+        // Set our bounding box using the base LOD mesh
+        BoundingBox& bounds = patch->_boundingBox;
+        bounds.set(patch->_levels[0]->model->getMesh()->getBoundingBox());
+
+        return patch;
+    }
 
-    // Add patch lods
+    // Streamed lods are built the first time they are drawn
     for (unsigned int step = 1; step <= maxStep; step *= 2)
     {
-        patch->addLOD(heights, width, height, x1, z1, x2, z2, xOffset, zOffset, step, verticalSkirtSize);
+        Level* level = new Level();
+        level->patch = patch;
+        patch->_levels.push_back(level);
     }
 
-    // Set our bounding box using the base LOD mesh
-    BoundingBox& bounds = patch->_boundingBox;
-    bounds.set(patch->_levels[0]->model->getMesh()->getBoundingBox());
+    // Set our bounding box from the height range of the patch, without building any mesh
+    float minHeight = FLT_MAX, maxHeight = -FLT_MAX;
+    if (heightfield->isTiled())
+    {
+        heightfield->getTileBounds(z1 / heightfield->getTileSize(), x1 / heightfield->getTileSize(), &minHeight, &maxHeight);
+    }
+    else
+    {
+        const float* heights = heightfield->getArray();
+        for (unsigned int z = z1; z <= z2; ++z)
+        {
+            for (unsigned int x = x1; x <= x2; ++x)
+            {
+                minHeight = std::min(minHeight, heights[z * heightfield->getColumnCount() + x]);
+                maxHeight = std::max(maxHeight, heights[z * heightfield->getColumnCount() + x]);
+            }
+        }
+    }
+    const Vector3& scale = terrain->_localScale;
+    float xOffset = (heightfield->getColumnCount() - 1) * -0.5f;
+    float zOffset = (heightfield->getRowCount() - 1) * -0.5f;
+    patch->_boundingBox.set(Vector3((x1 + xOffset) * scale.x, minHeight * scale.y, (z1 + zOffset) * scale.z),
+                            Vector3((x2 + xOffset) * scale.x, maxHeight * scale.y, (z2 + zOffset) * scale.z));
 
     return patch;
 }
@@ -102,64 +153,91 @@ Material* TerrainPatch::getMaterial(int index) const
         {
             _level = 0;
         }
-        return _levels[_level]->model->getMaterial();
+        index = _level;
     }
-    return _levels[index]->model->getMaterial();
+    Model* model = _levels[index]->model;
+    return model ? model->getMaterial() : NULL;
 }
 
-void TerrainPatch::addLOD(float* heights, unsigned int width, unsigned int height,
-                          unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2,
-                          float xOffset, float zOffset,
-                          unsigned int step, float verticalSkirtSize)
+void TerrainPatch::addLOD(unsigned int step)
 {
-    // Allocate vertex data for this patch
-    unsigned int patchWidth;
-    unsigned int patchHeight;
-    if (step == 1)
-    {
-        patchWidth = (x2 - x1) + 1;
-        patchHeight = (z2 - z1) + 1;
-    }
-    else
-    {
-        patchWidth = (x2 - x1) / step + ((x2 - x1) %step == 0 ? 0 : 1) + 1;
-        patchHeight = (z2 - z1) / step + ((z2 - z1) % step == 0 ? 0 : 1) + 1;
-    }
+    Geometry geometry;
+    buildGeometry(&geometry, _terrain->_heightfield, _terrain->_localScale, _terrain->_normalMap == NULL,
+                  _x1, _z1, _x2, _z2, step, _verticalSkirtSize);
+    Model* model = createModel(&geometry);
+    if (!model)
+        return; // ignore this level, not enough geometry
 
+    // Add this level
+    Level* level = new Level();
+    level->model = model;
+    level->patch = this;
+    _levels.push_back(level);
+}
+
+void TerrainPatch::buildGeometry(Geometry* geometry, const HeightField* heightfield, const Vector3& scale, bool normals,
+                                 unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2,
+                                 unsigned int step, float verticalSkirtSize)
+{
+    GP_ASSERT(geometry);
+    GP_ASSERT(heightfield);
+
+    // Read the heights of this level, with a ring of neighbors for computing normals
+    unsigned int columnCount = HeightField::getSampleCount(x1, x2, step) + 1;
+    unsigned int rowCount = HeightField::getSampleCount(z1, z2, step) + 1;
+    unsigned int stride = columnCount + 2;
+    std::vector<float> heights(stride * (rowCount + 2));
+    std::vector<unsigned int> columns(columnCount + 2);
+    std::vector<unsigned int> rows(rowCount + 2);
+    heightfield->getSamples(x1, z1, x2, z2, step, &heights[0], &columns[0], &rows[0]);
+
+    // Allocate vertex data for this patch
+    unsigned int patchWidth = columnCount;
+    unsigned int patchHeight = rowCount;
     if (patchWidth < 2 || patchHeight < 2)
-        return; // ignore this level, not enough geometry
+        return; // not enough geometry
 
-    if (verticalSkirtSize > 0.0f)
+    bool skirts = verticalSkirtSize > 0.0f;
+    if (skirts)
     {
         patchWidth += 2;
         patchHeight += 2;
     }
 
+    unsigned int width = heightfield->getColumnCount();
+    unsigned int height = heightfield->getRowCount();
+    float xOffset = (width - 1) * -0.5f;
+    float zOffset = (height - 1) * -0.5f;
     unsigned int vertexCount = patchHeight * patchWidth;
-    unsigned int vertexElements = _terrain->_normalMap ? 5 : 8; //<x,y,z>[i,j,k]<u,v>
+    unsigned int vertexElements = normals ? 8 : 5; //<x,y,z>[i,j,k]<u,v>
     float* vertices = new float[vertexCount * vertexElements];
     unsigned int index = 0;
     Vector3 min(FLT_MAX, FLT_MAX, FLT_MAX);
     Vector3 max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
-    float stepXScaled = step * _terrain->_localScale.x;
-    float stepZScaled = step * _terrain->_localScale.z;
-    bool zskirt = verticalSkirtSize > 0 ? true : false;
-    for (unsigned int z = z1; ; )
+    for (unsigned int j = 0; j < patchHeight; ++j)
     {
-        bool xskirt = verticalSkirtSize > 0 ? true : false;
-        for (unsigned int x = x1; ; )
+        // Skirt rows and columns repeat the first and last samples of the patch
+        bool zskirt = skirts && (j == 0 || j == patchHeight - 1);
+        unsigned int z = skirts ? (j == 0 ? 0 : std::min(j - 1, rowCount - 1)) : j;
+        for (unsigned int i = 0; i < patchWidth; ++i)
         {
+            bool xskirt = skirts && (i == 0 || i == patchWidth - 1);
+            unsigned int x = skirts ? (i == 0 ? 0 : std::min(i - 1, columnCount - 1)) : i;
+
             GP_ASSERT(index < vertexCount);
 
             float* v = vertices + (index * vertexElements);
             index++;
 
+            // The sample and its neighbors at -1/+1 and -stride/+stride
+            const float* h = &heights[(z + 1) * stride + x + 1];
+
             // Compute position - apply the local scale of the terrain into the vertex data
-            v[0] = (x + xOffset) * _terrain->_localScale.x;
-            v[1] = computeHeight(heights, width, x, z);
+            v[0] = (columns[x + 1] + xOffset) * scale.x;
+            v[1] = h[0] * scale.y;
             if (xskirt || zskirt)
-                v[1] -= verticalSkirtSize * _terrain->_localScale.y;
-            v[2] = (z + zOffset) * _terrain->_localScale.z;
+                v[1] -= verticalSkirtSize * scale.y;
+            v[2] = (rows[z + 1] + zOffset) * scale.z;
 
             // Update bounding box min/max (don't include vertical skirt vertices in bounding box)
             if (!(xskirt || zskirt))
@@ -179,19 +257,19 @@ void TerrainPatch::addLOD(float* heights, unsigned int width, unsigned int heigh
             }
 
             // Compute normal
-            if (!_terrain->_normalMap)
+            if (normals)
             {
-                Vector3 p(v[0], computeHeight(heights, width, x, z), v[2]);
-                Vector3 w(Vector3(x>=step ? v[0]-stepXScaled : v[0], computeHeight(heights, width, x>=step ? x-step : x, z), v[2]), p);
-                Vector3 e(Vector3(x<width-step ? v[0]+stepXScaled : v[0], computeHeight(heights, width, x<width-step ? x+step : x, z), v[2]), p);
-                Vector3 s(Vector3(v[0], computeHeight(heights, width, x, z>=step ? z-step : z), z>=step ? v[2]-stepZScaled : v[2]), p);
-                Vector3 n(Vector3(v[0], computeHeight(heights, width, x, z<height-step ? z+step : z), z<height-step ? v[2]+stepZScaled : v[2]), p);
-                Vector3 normals[4];
-                Vector3::cross(n, w, &normals[0]);
-                Vector3::cross(w, s, &normals[1]);
-                Vector3::cross(e, n, &normals[2]);
-                Vector3::cross(s, e, &normals[3]);
-                Vector3 normal = -(normals[0] + normals[1] + normals[2] + normals[3]);
+                Vector3 p(v[0], h[0] * scale.y, v[2]);
+                Vector3 w(Vector3((columns[x] + xOffset) * scale.x, h[-1] * scale.y, v[2]), p);
+                Vector3 e(Vector3((columns[x + 2] + xOffset) * scale.x, h[1] * scale.y, v[2]), p);
+                Vector3 s(Vector3(v[0], h[-(int)stride] * scale.y, (rows[z] + zOffset) * scale.z), p);
+                Vector3 n(Vector3(v[0], h[stride] * scale.y, (rows[z + 2] + zOffset) * scale.z), p);
+                Vector3 faceNormals[4];
+                Vector3::cross(n, w, &faceNormals[0]);
+                Vector3::cross(w, s, &faceNormals[1]);
+                Vector3::cross(e, n, &faceNormals[2]);
+                Vector3::cross(s, e, &faceNormals[3]);
+                Vector3 normal = -(faceNormals[0] + faceNormals[1] + faceNormals[2] + faceNormals[3]);
                 normal.normalize();
                 v[3] = normal.x;
                 v[4] = normal.y;
@@ -202,74 +280,22 @@ void TerrainPatch::addLOD(float* heights, unsigned int width, unsigned int heigh
             v += 3;
 
             // Compute texture coord
-            v[0] = (float)x / (width-1);
-            v[1] = 1.0f - (float)z / (height-1);
+            v[0] = (float)columns[x + 1] / (width-1);
+            v[1] = 1.0f - (float)rows[z + 1] / (height-1);
             if (xskirt)
             {
                 float offset = verticalSkirtSize / width;
-                v[0] = x == x1 ? v[0]-offset : v[0]+offset;
+                v[0] = i == 0 ? v[0]-offset : v[0]+offset;
             }
             else if (zskirt)
             {
                 float offset = verticalSkirtSize / height;
-                v[1] = z == z1 ? v[1]-offset : v[1]+offset;
-            }
-
-            if (x == x2)
-            {
-                if ((verticalSkirtSize == 0) || xskirt)
-                    break;
-                else
-                    xskirt = true;
-            }
-            else if (xskirt)
-            {
-                xskirt = false;
-            }
-            else
-            {
-                x = std::min(x + step, x2);
+                v[1] = j == 0 ? v[1]-offset : v[1]+offset;
             }
         }
-
-        if (z == z2)
-        {
-            if ((verticalSkirtSize == 0) || zskirt)
-                break;
-            else
-                zskirt = true;
-        }
-        else if (zskirt)
-        {
-            zskirt = false;
-        }
-        else
-        {
-            z = std::min(z + step, z2);
-        }
     }
     GP_ASSERT(index == vertexCount);
 
-    Vector3 center(min + ((max - min) * 0.5f));
-
-    // Create mesh
-    VertexFormat::Element elements[3];
-    elements[0] = VertexFormat::Element(VertexFormat::POSITION, 3);
-    if (_terrain->_normalMap)
-    {
-        elements[1] = VertexFormat::Element(VertexFormat::TEXCOORD0, 2);
-    }
-    else
-    {
-        elements[1] = VertexFormat::Element(VertexFormat::NORMAL, 3);
-        elements[2] = VertexFormat::Element(VertexFormat::TEXCOORD0, 2);
-    }
-    VertexFormat format(elements, _terrain->_normalMap ? 2 : 3);
-    Mesh* mesh = Mesh::createMesh(format, vertexCount);
-    mesh->setVertexData(vertices);
-    mesh->setBoundingBox(BoundingBox(min, max));
-    mesh->setBoundingSphere(BoundingSphere(center, center.distance(max)));
-
     // Add mesh part for indices
     unsigned int indexCount =
         (patchWidth * 2) *      // # indices per row of tris
@@ -284,7 +310,6 @@ void TerrainPatch::addLOD(float* heights, unsigned int width, unsigned int heigh
         GP_ASSERT(indexCount <= USHRT_MAX);
     }
 
-    MeshPart* part = mesh->addPart(Mesh::TRIANGLE_STRIP, Mesh::INDEX16, indexCount);
     unsigned short* indices = new unsigned short[indexCount];
     index = 0;
     for (unsigned int z = 0; z < patchHeight-1; ++z)
@@ -332,19 +357,163 @@ void TerrainPatch::addLOD(float* heights, unsigned int width, unsigned int heigh
         }
     }
     GP_ASSERT(index == indexCount);
-    part->setIndexData(indices, 0, indexCount);
 
-    SAFE_DELETE_ARRAY(vertices);
-    SAFE_DELETE_ARRAY(indices);
+    geometry->vertices = vertices;
+    geometry->vertexCount = vertexCount;
+    geometry->normals = normals;
+    geometry->indices = indices;
+    geometry->indexCount = indexCount;
+    geometry->min = min;
+    geometry->max = max;
+}
+
+Model* TerrainPatch::createModel(const Geometry* geometry)
+{
+    GP_ASSERT(geometry);
+
+    if (geometry->vertexCount == 0)
+        return NULL;
+
+    Vector3 center(geometry->min + ((geometry->max - geometry->min) * 0.5f));
+
+    // Create mesh
+    VertexFormat::Element elements[3];
+    elements[0] = VertexFormat::Element(VertexFormat::POSITION, 3);
+    if (!geometry->normals)
+    {
+        elements[1] = VertexFormat::Element(VertexFormat::TEXCOORD0, 2);
+    }
+    else
+    {
+        elements[1] = VertexFormat::Element(VertexFormat::NORMAL, 3);
+        elements[2] = VertexFormat::Element(VertexFormat::TEXCOORD0, 2);
+    }
+    VertexFormat format(elements, geometry->normals ? 3 : 2);
+    Mesh* mesh = Mesh::createMesh(format, geometry->vertexCount);
+    mesh->setVertexData(geometry->vertices);
+    mesh->setBoundingBox(BoundingBox(geometry->min, geometry->max));
+    mesh->setBoundingSphere(BoundingSphere(center, center.distance(geometry->max)));
+
+    MeshPart* part = mesh->addPart(Mesh::TRIANGLE_STRIP, Mesh::INDEX16, geometry->indexCount);
+    part->setIndexData(geometry->indices, 0, geometry->indexCount);
 
     // Create model
     Model* model = Model::create(mesh);
     mesh->release();
 
-    // Add this level
-    Level* level = new Level();
-    level->model = model;
-    _levels.push_back(level);
+    return model;
+}
+
+TerrainPatch::Level* TerrainPatch::useLevel(unsigned int index)
+{
+    GP_ASSERT(index < _levels.size());
+
+    // Build the wanted level if it is not in memory yet
+    Level* level = _levels[index];
+    if (!level->model && !level->request)
+        buildLevel(index);
+
+    // Until it is built, fall back to the closest level in memory, preferring coarser levels
+    for (size_t offset = 0, count = _levels.size(); offset < count && !level->model; ++offset)
+    {
+        if (index + offset < count && _levels[index + offset]->model)
+            level = _levels[index + offset];
+        else if (offset <= index && _levels[index - offset]->model)
+            level = _levels[index - offset];
+    }
+    if (!level->model)
+        return NULL;
+
+    // Move the level to the front of the terrain's resident levels
+    std::list<Level*>& residentLevels = _terrain->_residentLevels;
+    residentLevels.splice(residentLevels.begin(), residentLevels, level->resident);
+    level->frame = _terrain->_streamingFrame;
+
+    return level;
+}
+
+void TerrainPatch::buildLevel(unsigned int index)
+{
+    Level* level = _levels[index];
+    GP_ASSERT(!level->model && !level->request);
+
+    // The heights are read and the mesh data built on a loader thread; only the
+    // vertex and index buffers are created on the main thread.
+    Geometry* geometry = new Geometry();
+    HeightField* heightfield = _terrain->_heightfield;
+    heightfield->addRef();
+    Vector3 scale = _terrain->_localScale;
+    bool normals = _terrain->_normalMap == NULL;
+    unsigned int x1 = _x1, z1 = _z1, x2 = _x2, z2 = _z2;
+    unsigned int step = 1 << index;
+    float verticalSkirtSize = _verticalSkirtSize;
+    std::function<void()> work = [=]()
+    {
+        buildGeometry(geometry, heightfield, scale, normals, x1, z1, x2, z2, step, verticalSkirtSize);
+    };
+    std::function<void(bool)> complete = [this, index, geometry, heightfield](bool cancelled)
+    {
+        if (!cancelled)
+            uploadLevel(index, geometry);
+        delete geometry;
+        heightfield->release();
+    };
+
+    ++_terrain->_statistics.pendingLevels;
+    ResourceLoader* loader = Game::getInstance()->getResourceLoader();
+    if (loader)
+    {
+        level->request = loader->submit(work, complete);
+    }
+    else
+    {
+        work();
+        complete(false);
+    }
+}
+
+void TerrainPatch::uploadLevel(unsigned int index, const Geometry* geometry)
+{
+    Level* level = _levels[index];
+    GP_ASSERT(!level->model);
+
+    SAFE_RELEASE(level->request);
+    Terrain::Statistics& statistics = _terrain->_statistics;
+    --statistics.pendingLevels;
+
+    level->model = createModel(geometry);
+    GP_ASSERT(level->model);
+    if (!level->model)
+        return;
+
+    // Patches with dirty materials create them for all of their levels when drawn
+    if (!(_bits & TERRAINPATCH_DIRTY_MATERIAL))
+        updateMaterial(level);
+
+    level->size = geometry->vertexCount * (geometry->normals ? 8 : 5) * sizeof(float) + geometry->indexCount * sizeof(unsigned short);
+    level->frame = _terrain->_streamingFrame;
+    level->resident = _terrain->_residentLevels.insert(_terrain->_residentLevels.begin(), level);
+
+    if (_residentLevelCount++ == 0)
+        ++statistics.residentPatches;
+    ++statistics.residentLevels;
+    statistics.residentBytes += level->size;
+    ++statistics.builtLevels;
+}
+
+void TerrainPatch::evictLevel(Level* level)
+{
+    GP_ASSERT(level->model);
+
+    SAFE_RELEASE(level->model);
+    _terrain->_residentLevels.erase(level->resident);
+
+    Terrain::Statistics& statistics = _terrain->_statistics;
+    if (--_residentLevelCount == 0)
+        --statistics.residentPatches;
+    --statistics.residentLevels;
+    statistics.residentBytes -= level->size;
+    level->size = 0;
 }
 
 void TerrainPatch::deleteLayer(Layer* layer)
@@ -534,27 +703,36 @@ bool TerrainPatch::updateMaterial()
 
     _bits &= ~TERRAINPATCH_DIRTY_MATERIAL;
 
-    __currentPatchIndex = _index;
-
     for (size_t i = 0, count = _levels.size(); i < count; ++i)
     {
-        Material* material = Material::create(_terrain->_materialPath.c_str(), &passCallback, this);
-        GP_ASSERT(material);
-        if (!material)
-        {
-            GP_WARN("Failed to load material for terrain patch: %s", _terrain->_materialPath.c_str());
-            __currentPatchIndex = -1;
+        // Streamed levels that are not in memory get their material when they are built
+        if (_levels[i]->model && !updateMaterial(_levels[i]))
             return false;
-        }
+    }
 
-        material->setNodeBinding(_terrain->_node);
+    return true;
+}
 
-        // Set material on this lod level
-        _levels[i]->model->setMaterial(material);
+bool TerrainPatch::updateMaterial(Level* level)
+{
+    __currentPatchIndex = _index;
 
-        material->release();
+    Material* material = Material::create(_terrain->_materialPath.c_str(), &passCallback, this);
+    GP_ASSERT(material);
+    if (!material)
+    {
+        GP_WARN("Failed to load material for terrain patch: %s", _terrain->_materialPath.c_str());
+        __currentPatchIndex = -1;
+        return false;
     }
 
+    material->setNodeBinding(_terrain->_node);
+
+    // Set material on this lod level
+    level->model->setMaterial(material);
+
+    material->release();
+
     __currentPatchIndex = -1;
 
     return true;
@@ -565,7 +743,8 @@ void TerrainPatch::updateNodeBindings()
     __currentPatchIndex = _index;
     for (size_t i = 0, count = _levels.size(); i < count; ++i)
     {
-        _levels[i]->model->getMaterial()->setNodeBinding(_terrain->_node);
+        if (_levels[i]->model)
+            _levels[i]->model->getMaterial()->setNodeBinding(_terrain->_node);
     }
     __currentPatchIndex = -1;
 }
@@ -590,8 +769,11 @@ unsigned int TerrainPatch::draw(bool wireframe)
     // Compute the LOD level from the camera's perspective
     _level = computeLOD(camera, bounds);
 
-    // Draw the model for the current LOD
-    return _levels[_level]->model->draw(wireframe);
+    // Draw the model for the current LOD, or the closest one in memory for a streaming terrain
+    Level* level = _terrain->_streaming ? useLevel(_level) : _levels[_level];
+    if (!level)
+        return 0;
+    return level->model->draw(wireframe);
 }
 
 const BoundingBox& TerrainPatch::getBoundingBox(bool worldSpace) const
@@ -689,11 +871,6 @@ void TerrainPatch::setMaterialDirty()
     _bits |= TERRAINPATCH_DIRTY_MATERIAL;
 }
 
-float TerrainPatch::computeHeight(float* heights, unsigned int width, unsigned int x, unsigned int z)
-{
-    return heights[z * width + x] * _terrain->_localScale.y;
-}
-
 TerrainPatch::Layer::Layer() :
     index(0), row(-1), column(-1), textureIndex(-1), blendIndex(-1), textureRepeat( 0.0f, 0.0f )
 {
@@ -703,10 +880,21 @@ TerrainPatch::Layer::~Layer()
 {
 }
 
-TerrainPatch::Level::Level() : model(NULL)
+TerrainPatch::Level::Level() : model(NULL), patch(NULL), request(NULL), size(0), frame(0)
 {
 }
 
+TerrainPatch::Geometry::Geometry() :
+    vertices(NULL), vertexCount(0), normals(false), indices(NULL), indexCount(0)
+{
+}
+
+TerrainPatch::Geometry::~Geometry()
+{
+    SAFE_DELETE_ARRAY(vertices);
+    SAFE_DELETE_ARRAY(indices);
+}
+
 bool TerrainPatch::LayerCompare::operator() (const Layer* lhs, const Layer* rhs) const
 {
     return (lhs->index < rhs->index);
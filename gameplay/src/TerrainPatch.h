@@ -3,12 +3,14 @@
 
 #include "Model.h"
 #include "Camera.h"
+#include "ResourceLoader.h"
 
 namespace gameplay
 {
 
 class Terrain;
 class TerrainAutoBindingResolver;
+class HeightField;
 
 /**
  * Defines a single patch for a Terrain.
@@ -32,6 +34,8 @@ public:
      * based on the scene camera.
      *
      * @param index The index for the level of detail to get the material for.
+     *
+     * @return The material, or NULL if the level of detail of a streaming terrain is not in memory.
      */
     Material* getMaterial(int index = -1) const;
 
@@ -96,24 +100,58 @@ private:
     struct Level
     {
         Model* model;
+        TerrainPatch* patch;
+        ResourceLoader::Request* request;           // build of a streamed level in progress
+        size_t size;                                // bytes of vertex and index data of a streamed level
+        unsigned int frame;                         // streaming frame the level was last used in
+        std::list<Level*>::iterator resident;       // position in the terrain's resident levels
 
         Level();
     };
 
+    /**
+     * Vertex and index data of a level, built off the main thread.
+     */
+    struct Geometry
+    {
+        Geometry();
+
+        ~Geometry();
+
+        float* vertices;
+        unsigned int vertexCount;
+        bool normals;
+        unsigned short* indices;
+        unsigned int indexCount;
+        Vector3 min;
+        Vector3 max;
+    };
+
     struct LayerCompare
     {
         bool operator() (const Layer* lhs, const Layer* rhs) const;
     };
 
     static TerrainPatch* create(Terrain* terrain, unsigned int index,
-                                unsigned int row, unsigned int column,
-                                float* heights, unsigned int width, unsigned int height,
+                                unsigned int row, unsigned int column, HeightField* heightfield,
                                 unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2,
-                                float xOffset, float zOffset, unsigned int maxStep, float verticalSkirtSize);
+                                unsigned int maxStep, float verticalSkirtSize);
 
-    void addLOD(float* heights, unsigned int width, unsigned int height,
-                unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2,
-                float xOffset, float zOffset, unsigned int step, float verticalSkirtSize);
+    void addLOD(unsigned int step);
+
+    static void buildGeometry(Geometry* geometry, const HeightField* heightfield, const Vector3& scale, bool normals,
+                              unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2,
+                              unsigned int step, float verticalSkirtSize);
+
+    static Model* createModel(const Geometry* geometry);
+
+    Level* useLevel(unsigned int index);
+
+    void buildLevel(unsigned int index);
+
+    void uploadLevel(unsigned int index, const Geometry* geometry);
+
+    void evictLevel(Level* level);
 
 
     bool setLayer(int index, const char* texturePath, const Vector2& textureRepeat, const char* blendPath, int blendChannel);
@@ -126,14 +164,14 @@ private:
 
     bool updateMaterial();
 
+    bool updateMaterial(Level* level);
+
     unsigned int computeLOD(Camera* camera, const BoundingBox& worldBounds);
 
     const Vector3& getAmbientColor() const;
 
     void setMaterialDirty();
 
-    float computeHeight(float* heights, unsigned int width, unsigned int x, unsigned int z);
-
     void updateNodeBindings();
 
     std::string passCreated(Pass* pass);
@@ -142,7 +180,13 @@ private:
     unsigned int _index;
     unsigned int _row;
     unsigned int _column;
+    unsigned int _x1;
+    unsigned int _z1;
+    unsigned int _x2;
+    unsigned int _z2;
+    float _verticalSkirtSize;
     std::vector<Level*> _levels;
+    unsigned int _residentLevelCount;
     std::set<Layer*, LayerCompare> _layers;
     std::vector<Texture::Sampler*> _samplers;
     mutable BoundingBox _boundingBox;
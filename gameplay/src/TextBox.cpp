@@ -359,6 +359,16 @@ void TextBox::controlEvent(Control::Listener::EventType evt)
     }
 }
 
+void TextBox::update(float elapsedTime)
+{
+    Label::update(elapsedTime);
+
+    // The caret moves with input that does not dirty the control, so its
+    // geometry is rebuilt every frame while it is shown.
+    if (_caretImage && (getState() == ACTIVE || hasFocus()))
+        setDirty(DIRTY_GEOMETRY);
+}
+
 void TextBox::updateState(State state)
 {
     Label::updateState(state);
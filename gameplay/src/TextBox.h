@@ -179,6 +179,11 @@ protected:
      */
     void controlEvent(Control::Listener::EventType evt);
 
+    /**
+     * @see Control::update
+     */
+    void update(float elapsedTime);
+
     /**
      * @see Control::updateState
      */
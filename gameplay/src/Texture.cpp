@@ -86,27 +86,9 @@ Texture* Texture::create(const char* path, bool generateMipmaps)
     GP_ASSERT( path );
 
     // Search texture cache first.
-    for (size_t i = 0, count = __textureCache.size(); i < count; ++i)
-    {
-        Texture* t = __textureCache[i];
-        GP_ASSERT( t );
-        if (t->_path == path)
-        {
-            // If 'generateMipmaps' is true, call Texture::generateMipamps() to force the
-            // texture to generate its mipmap chain if it hasn't already done so.
-            if (generateMipmaps)
-            {
-                t->generateMipmaps();
-            }
-
-            // Found a match.
-            t->addRef();
-
-            return t;
-        }
-    }
-
-    Texture* texture = NULL;
+    Texture* texture = findCached(path, generateMipmaps);
+    if (texture)
+        return texture;
 
     // Filter loading based on file extension.
     const char* ext = strrchr(FileSystem::resolvePath(path), '.');
@@ -139,12 +121,7 @@ Texture* Texture::create(const char* path, bool generateMipmaps)
 
     if (texture)
     {
-        texture->_path = path;
-        texture->_cached = true;
-
-        // Add to texture cache.
-        __textureCache.push_back(texture);
-
+        texture->addToCache(path);
         return texture;
     }
 
@@ -152,6 +129,45 @@ Texture* Texture::create(const char* path, bool generateMipmaps)
     return NULL;
 }
 
+Texture* Texture::findCached(const char* path, bool generateMipmaps)
+{
+    GP_ASSERT( path );
+
+    for (size_t i = 0, count = __textureCache.size(); i < count; ++i)
+    {
+        Texture* t = __textureCache[i];
+        GP_ASSERT( t );
+        if (t->_path == path)
+        {
+            // If 'generateMipmaps' is true, call Texture::generateMipamps() to force the
+            // texture to generate its mipmap chain if it hasn't already done so.
+            if (generateMipmaps)
+            {
+                t->generateMipmaps();
+            }
+
+            // Found a match.
+            t->addRef();
+
+            return t;
+        }
+    }
+
+    return NULL;
+}
+
+void Texture::addToCache(const char* path)
+{
+    GP_ASSERT( path );
+    GP_ASSERT( !_cached );
+
+    _path = path;
+    _cached = true;
+
+    // Add to texture cache.
+    __textureCache.push_back(this);
+}
+
 Texture* Texture::create(Image* image, bool generateMipmaps)
 {
     GP_ASSERT( image );
@@ -392,6 +408,28 @@ void Texture::setData(const unsigned char* data)
     GL_ASSERT( glBindTexture((GLenum)__currentTextureType[__currentTextureUnit], __currentTextureId[__currentTextureUnit]) );
 }
 
+void Texture::setData(const unsigned char* data, unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+{
+    // Don't work with any compressed or cached textures
+    GP_ASSERT( data );
+    GP_ASSERT( (!_compressed) );
+    GP_ASSERT( (!_cached) );
+    GP_ASSERT( _type == Texture::TEXTURE_2D );
+    GP_ASSERT( x + width <= _width && y + height <= _height );
+
+    GL_ASSERT( glBindTexture(GL_TEXTURE_2D, _handle) );
+    GL_ASSERT( glPixelStorei(GL_UNPACK_ALIGNMENT, 1) );
+    GL_ASSERT( glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, _internalFormat, _texelType, data) );
+
+    if (_mipmapped)
+    {
+        generateMipmaps();
+    }
+
+    // Restore the texture id
+    GL_ASSERT( glBindTexture((GLenum)__currentTextureType[__currentTextureUnit], __currentTextureId[__currentTextureUnit]) );
+}
+
 // Computes the size of a PVRTC data chunk for a mipmap level of the given size.
 static unsigned int computePVRTCDataSize(int width, int height, int bpp)
 {
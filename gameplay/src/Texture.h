@@ -15,6 +15,7 @@ class Image;
 class Texture : public Ref
 {
     friend class Sampler;
+    friend class ResourceLoader;
 
 public:
 
@@ -243,6 +244,18 @@ public:
      */
     void setData(const unsigned char* data);
 
+    /**
+     * Replaces a rectangular region of a 2D texture image.
+     *
+     * @param data Raw texture data of the region (expected to be tightly packed).
+     * @param x The left edge of the region, in texels.
+     * @param y The top edge of the region, in texels.
+     * @param width The width of the region, in texels.
+     * @param height The height of the region, in texels.
+     * @script{ignore}
+     */
+    void setData(const unsigned char* data, unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+
     /**
      * Returns the path that the texture was originally loaded from (if applicable).
      *
@@ -324,6 +337,17 @@ private:
      */
     Texture& operator=(const Texture&);
 
+    /**
+     * Returns the cached texture loaded from the given path (with its reference
+     * count incremented), or NULL if no such texture is cached.
+     */
+    static Texture* findCached(const char* path, bool generateMipmaps);
+
+    /**
+     * Adds this texture to the texture cache under the given path.
+     */
+    void addToCache(const char* path);
+
     static Texture* createCompressedPVRTC(const char* path);
 
     static Texture* createCompressedDDS(const char* path);
@@ -7,6 +7,8 @@ namespace gameplay
 /**
  * Defines a interface to be scheduled and called back at a later time using Game::schedule().
  *
+ * @see TimeScheduler
+ *
  * @script{ignore}
  */
 class TimeListener
@@ -21,6 +23,14 @@ public:
      * @param cookie The cookie data that was passed when the event was scheduled.
      */
     virtual void timeEvent(long timeDiff, void* cookie) = 0;
+
+    /**
+     * Callback method that is called when a scheduled event is cancelled before it fired,
+     * including by Game::clearSchedule().
+     *
+     * @param cookie The cookie data that was passed when the event was scheduled.
+     */
+    virtual void timeEventCancelled(void* cookie) { }
 };
 
 }
@@ -0,0 +1,286 @@
+#include "Base.h"
+#include "TimeScheduler.h"
+#include "Game.h"
+
+// Handles keep the slot of an event in the low bits and the generation of
+// the slot in the high bits, so handles of fired events are not reused
+// until the generation wraps around.
+#define TIME_SCHEDULER_INDEX_BITS 20
+#define TIME_SCHEDULER_INDEX_MASK ((1u << TIME_SCHEDULER_INDEX_BITS) - 1)
+#define TIME_SCHEDULER_GENERATION_MASK ((1u << (32 - TIME_SCHEDULER_INDEX_BITS)) - 1)
+#define TIME_SCHEDULER_DEFAULT_FRAME_BUDGET 0.0f
+
+namespace gameplay
+{
+
+TimeScheduler::TimeScheduler()
+    : _order(0), _frameBudget(TIME_SCHEDULER_DEFAULT_FRAME_BUDGET)
+{
+    resetStatistics();
+}
+
+TimeScheduler::~TimeScheduler()
+{
+}
+
+unsigned int TimeScheduler::schedule(double delay, TimeListener* listener, void* cookie, double interval)
+{
+    GP_ASSERT(interval >= 0.0);
+
+    unsigned int index;
+    if (_freeEvents.empty())
+    {
+        GP_ASSERT(_events.size() <= TIME_SCHEDULER_INDEX_MASK);
+        index = (unsigned int)_events.size();
+        Event event;
+        event.generation = 1;
+        _events.push_back(event);
+    }
+    else
+    {
+        index = _freeEvents.back();
+        _freeEvents.pop_back();
+    }
+
+    Event& event = _events[index];
+    event.time = Game::getGameTime() + (delay > 0.0 ? delay : 0.0);
+    event.interval = interval;
+    event.listener = listener;
+    event.cookie = cookie;
+    event.order = _order++;
+    event.heapIndex = (int)_heap.size();
+    _heap.push_back(index);
+    siftUp(event.heapIndex);
+
+    return event.generation << TIME_SCHEDULER_INDEX_BITS | index;
+}
+
+bool TimeScheduler::cancel(unsigned int handle)
+{
+    int index = findEvent(handle);
+    if (index < 0)
+        return false;
+
+    TimeListener* listener = _events[index].listener;
+    void* cookie = _events[index].cookie;
+    remove(index);
+    ++_statistics.cancelled;
+
+    // Notify last, since the listener may schedule again.
+    if (listener)
+        listener->timeEventCancelled(cookie);
+    return true;
+}
+
+bool TimeScheduler::reschedule(unsigned int handle, double delay)
+{
+    int index = findEvent(handle);
+    if (index < 0)
+        return false;
+
+    Event& event = _events[index];
+    event.time = Game::getGameTime() + (delay > 0.0 ? delay : 0.0);
+    event.order = _order++;
+    reorder(index);
+    return true;
+}
+
+bool TimeScheduler::isScheduled(unsigned int handle) const
+{
+    return findEvent(handle) >= 0;
+}
+
+double TimeScheduler::getTime(unsigned int handle) const
+{
+    int index = findEvent(handle);
+    return index >= 0 ? _events[index].time : 0.0;
+}
+
+void TimeScheduler::clear()
+{
+    // Take the events out first, so listeners that schedule again while
+    // being notified are not cancelled as well.
+    std::vector<Event> cancelled;
+    cancelled.reserve(_heap.size());
+    while (!_heap.empty())
+    {
+        unsigned int index = _heap.back();
+        cancelled.push_back(_events[index]);
+        remove(index);
+    }
+    _statistics.cancelled += (unsigned int)cancelled.size();
+
+    for (size_t i = 0, count = cancelled.size(); i < count; ++i)
+    {
+        if (cancelled[i].listener)
+            cancelled[i].listener->timeEventCancelled(cancelled[i].cookie);
+    }
+}
+
+unsigned int TimeScheduler::getScheduledCount() const
+{
+    return (unsigned int)_heap.size();
+}
+
+float TimeScheduler::getFrameBudget() const
+{
+    return _frameBudget;
+}
+
+void TimeScheduler::setFrameBudget(float budget)
+{
+    _frameBudget = budget;
+}
+
+const TimeScheduler::Statistics& TimeScheduler::getStatistics() const
+{
+    return _statistics;
+}
+
+void TimeScheduler::resetStatistics()
+{
+    _statistics.fired = 0;
+    _statistics.cancelled = 0;
+    _statistics.overBudget = 0;
+}
+
+void TimeScheduler::update(double time)
+{
+    if (_heap.empty())
+        return;
+
+    GP_PROFILE_SCOPE("TimeScheduler::update");
+
+    double endTime = _frameBudget > 0.0f ? Game::getPlatformTime() + _frameBudget * 0.001 : 0.0;
+    unsigned int fired = 0;
+    while (!_heap.empty())
+    {
+        unsigned int index = _heap[0];
+        Event& event = _events[index];
+        if (event.time > time)
+            break;
+
+        if (endTime > 0.0 && fired > 0 && Game::getPlatformTime() >= endTime)
+        {
+            // Leave the remaining events for the next frames.
+            ++_statistics.overBudget;
+            break;
+        }
+
+        TimeListener* listener = event.listener;
+        void* cookie = event.cookie;
+        double timeDiff = time - event.time;
+        if (event.interval > 0.0)
+        {
+            // Repeat from the scheduled time, skipping the periods that were missed.
+            event.time += event.interval;
+            if (event.time <= time)
+                event.time += (floor((time - event.time) / event.interval) + 1.0) * event.interval;
+            event.order = _order++;
+            siftDown(0);
+        }
+        else
+        {
+            remove(index);
+        }
+        ++fired;
+        ++_statistics.fired;
+
+        // Fire last, since the listener may schedule or cancel events.
+        if (listener)
+            listener->timeEvent((long)timeDiff, cookie);
+    }
+}
+
+int TimeScheduler::findEvent(unsigned int handle) const
+{
+    unsigned int index = handle & TIME_SCHEDULER_INDEX_MASK;
+    if (index >= _events.size())
+        return -1;
+
+    const Event& event = _events[index];
+    if (event.heapIndex < 0 || event.generation != handle >> TIME_SCHEDULER_INDEX_BITS)
+        return -1;
+    return (int)index;
+}
+
+void TimeScheduler::remove(unsigned int index)
+{
+    Event& event = _events[index];
+    unsigned int position = (unsigned int)event.heapIndex;
+    unsigned int last = _heap.back();
+    _heap.pop_back();
+    if (last != index)
+    {
+        _heap[position] = last;
+        _events[last].heapIndex = (int)position;
+        reorder(last);
+    }
+
+    event.heapIndex = -1;
+    event.listener = NULL;
+    event.cookie = NULL;
+    event.generation = (event.generation + 1) & TIME_SCHEDULER_GENERATION_MASK;
+    if (event.generation == 0)
+        event.generation = 1;
+    _freeEvents.push_back(index);
+}
+
+bool TimeScheduler::isEarlier(unsigned int a, unsigned int b) const
+{
+    const Event& first = _events[a];
+    const Event& second = _events[b];
+    if (first.time != second.time)
+        return first.time < second.time;
+
+    // Wrap-safe comparison of the schedule order.
+    return (int)(first.order - second.order) < 0;
+}
+
+void TimeScheduler::siftUp(unsigned int position)
+{
+    unsigned int index = _heap[position];
+    while (position > 0)
+    {
+        unsigned int parent = (position - 1) / 2;
+        if (!isEarlier(index, _heap[parent]))
+            break;
+        _heap[position] = _heap[parent];
+        _events[_heap[position]].heapIndex = (int)position;
+        position = parent;
+    }
+    _heap[position] = index;
+    _events[index].heapIndex = (int)position;
+}
+
+void TimeScheduler::siftDown(unsigned int position)
+{
+    unsigned int index = _heap[position];
+    unsigned int count = (unsigned int)_heap.size();
+    while (true)
+    {
+        unsigned int child = position * 2 + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && isEarlier(_heap[child + 1], _heap[child]))
+            ++child;
+        if (!isEarlier(_heap[child], index))
+            break;
+        _heap[position] = _heap[child];
+        _events[_heap[position]].heapIndex = (int)position;
+        position = child;
+    }
+    _heap[position] = index;
+    _events[index].heapIndex = (int)position;
+}
+
+void TimeScheduler::reorder(unsigned int index)
+{
+    unsigned int position = (unsigned int)_events[index].heapIndex;
+    if (position > 0 && isEarlier(index, _heap[(position - 1) / 2]))
+        siftUp(position);
+    else
+        siftDown(position);
+}
+
+}
@@ -0,0 +1,241 @@
+#ifndef TIMESCHEDULER_H_
+#define TIMESCHEDULER_H_
+
+#include "TimeListener.h"
+
+namespace gameplay
+{
+
+/**
+ * Defines the scheduler that fires the time events of Game::schedule().
+ *
+ * Every scheduled event gets a handle that can be used to cancel or
+ * reschedule it until it fires. Events can repeat at a fixed interval, in
+ * which case they stay scheduled until they are cancelled. A repeating event
+ * fires at most once per frame; if it falls behind, the missed periods are
+ * skipped rather than fired in a burst.
+ *
+ * Events are kept in a binary heap ordered by time, and events due at the
+ * same time fire in the order they were scheduled. Scheduling, cancelling
+ * and rescheduling take logarithmic time, and a frame only looks at the
+ * events that are due.
+ *
+ * A frame budget spreads a burst of events that are due at once over several
+ * frames. The events left over fire in the following frames, in order, with
+ * the delay reported to their listeners. The budget is configured from the
+ * game.config file:
+ *
+ * @code
+ * timeScheduler
+ * {
+ *     frameBudget = 2    // time (in milliseconds) spent firing events per frame, 0 for no limit
+ * }
+ * @endcode
+ *
+ * @script{ignore}
+ */
+class TimeScheduler
+{
+    friend class Game;
+
+public:
+
+    /**
+     * Counters of the work done by the scheduler.
+     */
+    struct Statistics
+    {
+        /**
+         * The number of events fired.
+         */
+        unsigned int fired;
+
+        /**
+         * The number of events cancelled, including those removed by clear().
+         */
+        unsigned int cancelled;
+
+        /**
+         * The number of frames that ran out of budget with due events left.
+         */
+        unsigned int overBudget;
+    };
+
+    /**
+     * Schedules a time event to be sent to a TimeListener.
+     *
+     * @param delay The number of game seconds from now to fire the event. Zero fires it in the next frame.
+     * @param listener The listener that will receive the event.
+     * @param cookie The cookie data that the time event will contain.
+     * @param interval The number of game seconds between repeats, or zero to fire the event once.
+     *
+     * @return The handle of the event, which is never zero.
+     */
+    unsigned int schedule(double delay, TimeListener* listener, void* cookie = NULL, double interval = 0.0);
+
+    /**
+     * Cancels a scheduled event.
+     *
+     * The listener is notified through TimeListener::timeEventCancelled().
+     *
+     * @param handle The handle returned by schedule().
+     *
+     * @return True if the event was cancelled, false if it has already fired or the handle is invalid.
+     */
+    bool cancel(unsigned int handle);
+
+    /**
+     * Moves a scheduled event to a new time.
+     *
+     * Repeating events keep their interval and repeat from the new time.
+     *
+     * @param handle The handle returned by schedule().
+     * @param delay The number of game seconds from now to fire the event.
+     *
+     * @return True if the event was moved, false if it has already fired or the handle is invalid.
+     */
+    bool reschedule(unsigned int handle, double delay);
+
+    /**
+     * Determines if an event is still scheduled.
+     *
+     * @param handle The handle returned by schedule().
+     *
+     * @return True if the event is waiting to fire, false otherwise.
+     */
+    bool isScheduled(unsigned int handle) const;
+
+    /**
+     * Gets the game time at which a scheduled event fires next.
+     *
+     * @param handle The handle returned by schedule().
+     *
+     * @return The game time in seconds, or zero if the event is not scheduled.
+     */
+    double getTime(unsigned int handle) const;
+
+    /**
+     * Cancels all scheduled events.
+     */
+    void clear();
+
+    /**
+     * Gets the number of scheduled events.
+     *
+     * @return The number of events waiting to fire.
+     */
+    unsigned int getScheduledCount() const;
+
+    /**
+     * Gets the time budget spent firing events per frame.
+     *
+     * @return The time budget in milliseconds, or zero if there is no limit.
+     */
+    float getFrameBudget() const;
+
+    /**
+     * Sets the time budget spent firing events per frame.
+     *
+     * At least one due event is always fired per frame.
+     *
+     * @param budget The time budget in milliseconds, or zero for no limit.
+     */
+    void setFrameBudget(float budget);
+
+    /**
+     * Gets the counters accumulated since the scheduler was created or since
+     * the last call to resetStatistics().
+     *
+     * @return The statistics.
+     */
+    const Statistics& getStatistics() const;
+
+    /**
+     * Resets all counters to zero.
+     */
+    void resetStatistics();
+
+private:
+
+    /**
+     * A scheduled event, or a free slot if the heap index is negative.
+     */
+    struct Event
+    {
+        double time;
+        double interval;
+        TimeListener* listener;
+        void* cookie;
+        unsigned int order;
+        unsigned int generation;
+        int heapIndex;
+    };
+
+    /**
+     * Constructor.
+     */
+    TimeScheduler();
+
+    /**
+     * Destructor.
+     */
+    ~TimeScheduler();
+
+    /**
+     * Hidden copy constructor.
+     */
+    TimeScheduler(const TimeScheduler& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    TimeScheduler& operator=(const TimeScheduler&);
+
+    /**
+     * Fires the events that are due.
+     *
+     * @param time The current game time.
+     */
+    void update(double time);
+
+    /**
+     * Gets the slot of a scheduled event, or -1 if the handle does not refer to one.
+     */
+    int findEvent(unsigned int handle) const;
+
+    /**
+     * Removes an event from the heap and frees its slot.
+     */
+    void remove(unsigned int index);
+
+    /**
+     * Determines if the event in one slot fires before the event in another.
+     */
+    bool isEarlier(unsigned int a, unsigned int b) const;
+
+    /**
+     * Moves the event at a heap position towards the front until the heap is ordered.
+     */
+    void siftUp(unsigned int position);
+
+    /**
+     * Moves the event at a heap position towards the back until the heap is ordered.
+     */
+    void siftDown(unsigned int position);
+
+    /**
+     * Moves an event whose time changed to its place in the heap.
+     */
+    void reorder(unsigned int index);
+
+    std::vector<Event> _events;
+    std::vector<unsigned int> _freeEvents;
+    std::vector<unsigned int> _heap;        // slots of the scheduled events, the next one due first
+    unsigned int _order;
+    float _frameBudget;
+    Statistics _statistics;
+};
+
+}
+
+#endif
@@ -48,6 +48,12 @@ Transform::Transform(const Transform& copy)
 
 Transform::~Transform()
 {
+    // Animation clips may destroy transforms whose pose is still to be written.
+    Game* game = Game::getInstance();
+    AnimationController* controller = game ? game->getAnimationController() : NULL;
+    if (controller)
+        controller->removePose(this);
+
     SAFE_DELETE(_listeners);
 }
 
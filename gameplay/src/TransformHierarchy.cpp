@@ -0,0 +1,194 @@
+#include "Base.h"
+#include "TransformHierarchy.h"
+#include "Scene.h"
+#include "Node.h"
+#include "Game.h"
+
+// The number of dirty ranges swept by a single job.
+#define TRANSFORM_HIERARCHY_GRAIN_SIZE 16
+
+namespace gameplay
+{
+
+TransformHierarchy::TransformHierarchy(Scene* scene)
+    : _scene(scene), _orderDirty(true), _parallel(false)
+{
+    GP_ASSERT(scene);
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+    for (Node* node = _scene->getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        removeNode(node);
+    }
+}
+
+void TransformHierarchy::update()
+{
+    GP_PROFILE_SCOPE("TransformHierarchy::update");
+
+    if (_orderDirty)
+        rebuild();
+
+    std::vector<Range> ranges;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        ranges.swap(_dirtyRanges);
+    }
+    if (ranges.empty())
+        return;
+
+    // Subtree ranges are either nested or disjoint, so merging overlapping
+    // ones leaves ranges that do not depend on each other.
+    std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) { return a.begin < b.begin; });
+    size_t merged = 0;
+    for (size_t i = 1, count = ranges.size(); i < count; ++i)
+    {
+        if (ranges[i].begin < ranges[merged].end)
+            ranges[merged].end = std::max(ranges[merged].end, ranges[i].end);
+        else
+            ranges[++merged] = ranges[i];
+    }
+    ranges.resize(merged + 1);
+
+    JobScheduler* scheduler = Game::getInstance()->getJobScheduler();
+    if (_parallel && scheduler && ranges.size() > 1)
+    {
+        scheduler->parallelFor((unsigned int)ranges.size(), TRANSFORM_HIERARCHY_GRAIN_SIZE, [this, &ranges](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                updateRange(ranges[i].begin, ranges[i].end);
+            }
+        }, "TransformHierarchy::update");
+    }
+    else
+    {
+        for (size_t i = 0, count = ranges.size(); i < count; ++i)
+        {
+            updateRange(ranges[i].begin, ranges[i].end);
+        }
+    }
+}
+
+unsigned int TransformHierarchy::getNodeCount() const
+{
+    return (unsigned int)_nodes.size();
+}
+
+void TransformHierarchy::setParallel(bool parallel)
+{
+    _parallel = parallel;
+}
+
+bool TransformHierarchy::isParallel() const
+{
+    return _parallel;
+}
+
+void TransformHierarchy::invalidate()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _orderDirty = true;
+    _dirtyRanges.clear();
+}
+
+void TransformHierarchy::removeNode(Node* node)
+{
+    GP_ASSERT(node);
+
+    node->_transformHierarchy = NULL;
+    node->_transformIndex = -1;
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        removeNode(child);
+    }
+    invalidate();
+}
+
+void TransformHierarchy::setDirty(Node* node)
+{
+    GP_ASSERT(node);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // Everything is swept after the order is rebuilt anyway.
+    if (_orderDirty || node->_transformIndex < 0)
+        return;
+
+    unsigned int index = (unsigned int)node->_transformIndex;
+    GP_ASSERT(index < _nodes.size() && _nodes[index] == node);
+    Range range = { index, _subtreeEnds[index] };
+    _dirtyRanges.push_back(range);
+}
+
+static void addSubtree(Node* node, int parent, std::vector<Node*>& nodes, std::vector<int>& parents)
+{
+    int index = (int)nodes.size();
+    nodes.push_back(node);
+    parents.push_back(parent);
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        addSubtree(child, index, nodes, parents);
+    }
+}
+
+void TransformHierarchy::rebuild()
+{
+    _nodes.clear();
+    _parents.clear();
+    for (Node* node = _scene->getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        addSubtree(node, -1, _nodes, _parents);
+    }
+
+    const unsigned int count = (unsigned int)_nodes.size();
+    _subtreeEnds.resize(count);
+    _worldMatrices.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        _subtreeEnds[i] = i + 1;
+        _nodes[i]->_transformHierarchy = this;
+        _nodes[i]->_transformIndex = (int)i;
+    }
+
+    // Children follow their parents, so walking backwards extends every parent
+    // range over the ranges of its children.
+    for (unsigned int i = count; i-- > 0;)
+    {
+        int parent = _parents[i];
+        if (parent >= 0 && _subtreeEnds[parent] < _subtreeEnds[i])
+            _subtreeEnds[parent] = _subtreeEnds[i];
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _orderDirty = false;
+    _dirtyRanges.clear();
+    if (count > 0)
+    {
+        Range range = { 0, count };
+        _dirtyRanges.push_back(range);
+    }
+}
+
+void TransformHierarchy::updateRange(unsigned int begin, unsigned int end)
+{
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        // Parents inside the range were resolved earlier in this loop; parents
+        // before it are outside every dirty range and already up to date.
+        int parent = _parents[i];
+        const Matrix* parentWorld = NULL;
+        if (parent >= (int)begin)
+            parentWorld = &_worldMatrices[parent];
+        else if (parent >= 0)
+            parentWorld = &_nodes[parent]->getWorldMatrix();
+
+        Node* node = _nodes[i];
+        node->updateWorldMatrix(parentWorld);
+        _worldMatrices[i] = node->_world;
+    }
+}
+
+}
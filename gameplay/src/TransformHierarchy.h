@@ -0,0 +1,138 @@
+#ifndef TRANSFORMHIERARCHY_H_
+#define TRANSFORMHIERARCHY_H_
+
+#include "Matrix.h"
+
+namespace gameplay
+{
+
+class Scene;
+class Node;
+
+/**
+ * Defines a flat representation of a scene's node hierarchy used to update
+ * world matrices in a single linear sweep.
+ *
+ * The nodes of the scene are stored in depth-first order, so every parent
+ * comes before its children and every subtree occupies a contiguous range.
+ * Moving a node marks the range of its subtree dirty, and update() resolves
+ * the world matrices of all dirty ranges front to back, reading parent
+ * world matrices from a contiguous array instead of recursing through the
+ * node tree. Disjoint ranges do not depend on each other and can be swept
+ * concurrently on the game's JobScheduler.
+ *
+ * The resolved matrices are written back into the nodes, so the Node API
+ * (Node::getWorldMatrix() and everything built on it) keeps working and
+ * still resolves nodes lazily when they are queried before the sweep.
+ *
+ * The hierarchy is rebuilt on the next update whenever nodes are added to
+ * or removed from the scene.
+ *
+ * @see Scene::setTransformHierarchyEnabled
+ * @script{ignore}
+ */
+class TransformHierarchy
+{
+    friend class Scene;
+    friend class Node;
+
+public:
+
+    /**
+     * Resolves the world matrices of all nodes that moved since the last update.
+     */
+    void update();
+
+    /**
+     * Gets the number of nodes in the hierarchy as of the last update.
+     *
+     * @return The number of nodes.
+     */
+    unsigned int getNodeCount() const;
+
+    /**
+     * Sets whether disjoint dirty ranges are swept concurrently on the JobScheduler.
+     *
+     * Node transforms must not be modified by other threads during update() when enabled.
+     *
+     * @param parallel True to sweep in parallel, false to sweep on the calling thread.
+     */
+    void setParallel(bool parallel);
+
+    /**
+     * Determines whether disjoint dirty ranges are swept concurrently.
+     *
+     * @return True if the sweep runs in parallel, false otherwise.
+     */
+    bool isParallel() const;
+
+private:
+
+    /**
+     * A contiguous range of nodes in depth-first order.
+     */
+    struct Range
+    {
+        unsigned int begin;
+        unsigned int end;
+    };
+
+    /**
+     * Constructor.
+     */
+    TransformHierarchy(Scene* scene);
+
+    /**
+     * Destructor.
+     */
+    ~TransformHierarchy();
+
+    /**
+     * Hidden copy constructor.
+     */
+    TransformHierarchy(const TransformHierarchy& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    TransformHierarchy& operator=(const TransformHierarchy&);
+
+    /**
+     * Marks the node order as out of date after nodes were added or removed.
+     */
+    void invalidate();
+
+    /**
+     * Detaches a node and its descendants from the hierarchy.
+     */
+    void removeNode(Node* node);
+
+    /**
+     * Marks the subtree of a node as dirty.
+     */
+    void setDirty(Node* node);
+
+    /**
+     * Rebuilds the node order from the scene.
+     */
+    void rebuild();
+
+    /**
+     * Resolves the world matrices of the nodes in a range.
+     */
+    void updateRange(unsigned int begin, unsigned int end);
+
+    Scene* _scene;
+    std::vector<Node*> _nodes;
+    std::vector<int> _parents;
+    std::vector<unsigned int> _subtreeEnds;
+    std::vector<Matrix> _worldMatrices;
+    std::vector<Range> _dirtyRanges;
+    std::mutex _mutex;
+    bool _orderDirty;
+    bool _parallel;
+};
+
+}
+
+#endif
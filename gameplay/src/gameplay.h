@@ -17,6 +17,10 @@
 #include "MathUtil.h"
 #include "Logger.h"
 #include "Package.h"
+#include "ResourceLoader.h"
+#include "JobScheduler.h"
+#include "TimeScheduler.h"
+#include "Profiler.h"
 
 // Math
 #include "Rectangle.h"
@@ -27,6 +31,7 @@
 #include "Matrix.h"
 #include "Matrix3.h"
 #include "Transform.h"
+#include "TransformHierarchy.h"
 #include "Ray.h"
 #include "Plane.h"
 #include "Frustum.h"
@@ -51,7 +56,9 @@
 #include "Node.h"
 #include "Joint.h"
 #include "Scene.h"
+#include "SpatialIndex.h"
 #include "Font.h"
+#include "GlyphAtlas.h"
 #include "SpriteBatch.h"
 #include "Sprite.h"
 #include "Text.h"
@@ -59,6 +66,7 @@
 #include "ParticleEmitter.h"
 #include "FrameBuffer.h"
 #include "RenderTarget.h"
+#include "RenderQueue.h"
 #include "DepthStencilTarget.h"
 #include "ScreenDisplayer.h"
 #include "HeightField.h"
@@ -232,6 +232,45 @@ static int lua_Game_clear(lua_State* state)
     return 0;
 }
 
+static int lua_Game_cancelSchedule(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                unsigned int param1 = (unsigned int)luaL_checkunsigned(state, 2);
+
+                Game* instance = getInstance(state);
+                bool result = instance->cancelSchedule(param1);
+
+                // Push the return value onto the stack.
+                lua_pushboolean(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_Game_cancelSchedule - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Game_clearSchedule(lua_State* state)
 {
     // Get the number of parameters.
@@ -2243,9 +2282,12 @@ static int lua_Game_schedule(lua_State* state)
                 const char* param2 = gameplay::ScriptUtil::getString(3, false);
 
                 Game* instance = getInstance(state);
-                instance->schedule(param1, param2);
-                
-                return 0;
+                unsigned int result = instance->schedule(param1, param2);
+
+                // Push the return value onto the stack.
+                lua_pushunsigned(state, result);
+
+                return 1;
             }
 
             lua_pushstring(state, "lua_Game_schedule - Failed to match the given parameters to a valid function signature.");
@@ -2725,6 +2767,7 @@ void luaRegister_Game()
     {
         {"canExit", lua_Game_canExit},
         {"clear", lua_Game_clear},
+        {"cancelSchedule", lua_Game_cancelSchedule},
         {"clearSchedule", lua_Game_clearSchedule},
         {"displayKeyboard", lua_Game_displayKeyboard},
         {"exit", lua_Game_exit},
@@ -1681,6 +1681,99 @@ static int lua_PhysicsController_rayTest(lua_State* state)
     return 0;
 }
 
+// Pushes a table of the hits of a batched query, with a PhysicsController::HitResult
+// for each query that hit an object and nil for each query that did not.
+static void pushHitResults(lua_State* state, unsigned int count, PhysicsCollisionObject** objects, float* fractions, Vector3* points, Vector3* normals)
+{
+    lua_createtable(state, (int)count, 0);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (objects[i])
+        {
+            PhysicsController::HitResult* hit = new PhysicsController::HitResult();
+            hit->object = objects[i];
+            hit->fraction = fractions[i];
+            hit->point = points[i];
+            hit->normal = normals[i];
+
+            gameplay::ScriptUtil::LuaObject* object = (gameplay::ScriptUtil::LuaObject*)lua_newuserdata(state, sizeof(gameplay::ScriptUtil::LuaObject));
+            object->instance = (void*)hit;
+            object->owns = true;
+            luaL_getmetatable(state, "PhysicsControllerHitResult");
+            lua_setmetatable(state, -2);
+        }
+        else
+        {
+            lua_pushnil(state);
+        }
+        lua_rawseti(state, -2, (int)i + 1);
+    }
+}
+
+static int lua_PhysicsController_rayTestBatch(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    if ((paramCount == 3 || paramCount == 4) &&
+        (lua_type(state, 1) == LUA_TUSERDATA) &&
+        lua_type(state, 2) == LUA_TTABLE &&
+        lua_type(state, 3) == LUA_TNUMBER &&
+        (paramCount == 3 || lua_type(state, 4) == LUA_TNUMBER))
+    {
+        // Validate all parameters before allocating, since lua_error() does not unwind the C++ stack.
+        lua_len(state, 2);
+        int count = luaL_checkint(state, -1);
+        lua_pop(state, 1);
+        for (int i = 0; i < count; ++i)
+        {
+            lua_rawgeti(state, 2, i + 1);
+            Ray* ray = (Ray*)gameplay::ScriptUtil::getUserDataObjectPointer(-1, "Ray");
+            lua_pop(state, 1);
+            if (!ray)
+            {
+                lua_pushstring(state, "Failed to convert parameter 1 to an array of type 'Ray'.");
+                lua_error(state);
+            }
+        }
+        float distance = (float)luaL_checknumber(state, 3);
+        int mask = paramCount == 4 ? (int)luaL_checkint(state, 4) : -1;
+        PhysicsController* instance = getInstance(state);
+
+        // Get parameter 1 off the stack.
+        std::vector<Ray> rays(count > 0 ? count : 0);
+        for (int i = 0; i < count; ++i)
+        {
+            lua_rawgeti(state, 2, i + 1);
+            rays[i] = *(Ray*)gameplay::ScriptUtil::getUserDataObjectPointer(-1, "Ray");
+            lua_pop(state, 1);
+        }
+
+        // Get parameter 2 off the stack.
+        std::vector<float> distances(rays.size(), distance);
+
+        std::vector<PhysicsCollisionObject*> objects(rays.size());
+        std::vector<float> fractions(rays.size());
+        std::vector<Vector3> points(rays.size());
+        std::vector<Vector3> normals(rays.size());
+        if (!rays.empty())
+        {
+            instance->rayTest((unsigned int)rays.size(), &rays[0], &distances[0], mask, &objects[0], &fractions[0], &points[0], &normals[0]);
+        }
+
+        // Push the return value onto the stack.
+        pushHitResults(state, (unsigned int)rays.size(), objects.empty() ? NULL : &objects[0], fractions.empty() ? NULL : &fractions[0],
+                       points.empty() ? NULL : &points[0], normals.empty() ? NULL : &normals[0]);
+
+        return 1;
+    }
+
+    lua_pushstring(state, "lua_PhysicsController_rayTestBatch - Failed to match the given parameters to a valid function signature.");
+    lua_error(state);
+    return 0;
+}
+
 static int lua_PhysicsController_removeScript(lua_State* state)
 {
     // Get the number of parameters.
@@ -2009,6 +2102,87 @@ static int lua_PhysicsController_sweepTest(lua_State* state)
     return 0;
 }
 
+static int lua_PhysicsController_sweepTestBatch(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    if ((paramCount == 3 || paramCount == 4) &&
+        (lua_type(state, 1) == LUA_TUSERDATA) &&
+        lua_type(state, 2) == LUA_TTABLE &&
+        lua_type(state, 3) == LUA_TTABLE &&
+        (paramCount == 3 || lua_type(state, 4) == LUA_TNUMBER))
+    {
+        // Validate all parameters before allocating, since lua_error() does not unwind the C++ stack.
+        lua_len(state, 2);
+        int count = luaL_checkint(state, -1);
+        lua_pop(state, 1);
+        lua_len(state, 3);
+        if (luaL_checkint(state, -1) != count)
+        {
+            lua_pushstring(state, "lua_PhysicsController_sweepTestBatch - Expected as many end positions as objects.");
+            lua_error(state);
+        }
+        lua_pop(state, 1);
+        for (int i = 0; i < count; ++i)
+        {
+            lua_rawgeti(state, 2, i + 1);
+            PhysicsCollisionObject* sweptObject = (PhysicsCollisionObject*)gameplay::ScriptUtil::getUserDataObjectPointer(-1, "PhysicsCollisionObject");
+            lua_pop(state, 1);
+            if (!sweptObject)
+            {
+                lua_pushstring(state, "Failed to convert parameter 1 to an array of type 'PhysicsCollisionObject'.");
+                lua_error(state);
+            }
+
+            lua_rawgeti(state, 3, i + 1);
+            Vector3* endPosition = (Vector3*)gameplay::ScriptUtil::getUserDataObjectPointer(-1, "Vector3");
+            lua_pop(state, 1);
+            if (!endPosition)
+            {
+                lua_pushstring(state, "Failed to convert parameter 2 to an array of type 'Vector3'.");
+                lua_error(state);
+            }
+        }
+        int mask = paramCount == 4 ? (int)luaL_checkint(state, 4) : -1;
+        PhysicsController* instance = getInstance(state);
+
+        // Get parameters 1 and 2 off the stack.
+        std::vector<PhysicsCollisionObject*> sweptObjects(count > 0 ? count : 0);
+        std::vector<Vector3> endPositions(sweptObjects.size());
+        for (int i = 0; i < count; ++i)
+        {
+            lua_rawgeti(state, 2, i + 1);
+            sweptObjects[i] = (PhysicsCollisionObject*)gameplay::ScriptUtil::getUserDataObjectPointer(-1, "PhysicsCollisionObject");
+            lua_pop(state, 1);
+
+            lua_rawgeti(state, 3, i + 1);
+            endPositions[i] = *(Vector3*)gameplay::ScriptUtil::getUserDataObjectPointer(-1, "Vector3");
+            lua_pop(state, 1);
+        }
+
+        std::vector<PhysicsCollisionObject*> objects(sweptObjects.size());
+        std::vector<float> fractions(sweptObjects.size());
+        std::vector<Vector3> points(sweptObjects.size());
+        std::vector<Vector3> normals(sweptObjects.size());
+        if (!sweptObjects.empty())
+        {
+            instance->sweepTest((unsigned int)sweptObjects.size(), &sweptObjects[0], &endPositions[0], mask, &objects[0], &fractions[0], &points[0], &normals[0]);
+        }
+
+        // Push the return value onto the stack.
+        pushHitResults(state, (unsigned int)sweptObjects.size(), objects.empty() ? NULL : &objects[0], fractions.empty() ? NULL : &fractions[0],
+                       points.empty() ? NULL : &points[0], normals.empty() ? NULL : &normals[0]);
+
+        return 1;
+    }
+
+    lua_pushstring(state, "lua_PhysicsController_sweepTestBatch - Failed to match the given parameters to a valid function signature.");
+    lua_error(state);
+    return 0;
+}
+
 // Provides support for conversion to all known relative types of PhysicsController
 static void* __convertTo(void* ptr, const char* typeName)
 {
@@ -2072,11 +2246,13 @@ void luaRegister_PhysicsController()
         {"getTypeName", lua_PhysicsController_getTypeName},
         {"hasScriptListener", lua_PhysicsController_hasScriptListener},
         {"rayTest", lua_PhysicsController_rayTest},
+        {"rayTestBatch", lua_PhysicsController_rayTestBatch},
         {"removeScript", lua_PhysicsController_removeScript},
         {"removeScriptCallback", lua_PhysicsController_removeScriptCallback},
         {"removeStatusListener", lua_PhysicsController_removeStatusListener},
         {"setGravity", lua_PhysicsController_setGravity},
         {"sweepTest", lua_PhysicsController_sweepTest},
+        {"sweepTestBatch", lua_PhysicsController_sweepTestBatch},
         {"to", lua_PhysicsController_to},
         {NULL, NULL}
     };
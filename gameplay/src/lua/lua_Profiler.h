@@ -0,0 +1,12 @@
+// Autogenerated by gameplay-luagen
+#ifndef LUA_PROFILER_H_
+#define LUA_PROFILER_H_
+
+namespace gameplay
+{
+
+void luaRegister_Profiler();
+
+}
+
+#endif
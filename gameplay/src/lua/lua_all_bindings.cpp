@@ -100,6 +100,7 @@ void lua_RegisterAllBindings()
     luaRegister_Plane();
     luaRegister_Platform();
     luaRegister_ProgressBar();
+    luaRegister_Profiler();
     luaRegister_Properties();
     luaRegister_Quaternion();
     luaRegister_RadioButton();
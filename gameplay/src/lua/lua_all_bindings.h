@@ -95,6 +95,7 @@
 #include "lua_Plane.h"
 #include "lua_Platform.h"
 #include "lua_ProgressBar.h"
+#include "lua_Profiler.h"
 #include "lua_Properties.h"
 #include "lua_Quaternion.h"
 #include "lua_RadioButton.h"
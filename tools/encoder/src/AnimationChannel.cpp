@@ -1,10 +1,169 @@
 #include "Base.h"
 #include "AnimationChannel.h"
 #include "Transform.h"
+#include "Quaternion.h"
+
+// Compression of the channel keys, written after the interpolations.
+#define ANIMATION_COMPRESSION_NONE          0
+#define ANIMATION_COMPRESSION_QUANTIZED     1
+
+// The components of a quaternion other than its largest one lie within +-1/sqrt(2).
+#define ANIMATION_QUATERNION_RANGE          0.70710678f
 
 namespace gameplay
 {
 
+/**
+ * Gets the offset of the rotation within the values of a transform property, or -1 if it has none.
+ */
+static int getRotationOffset(unsigned int attrib)
+{
+    switch (attrib)
+    {
+    case Transform::ANIMATE_ROTATE:
+    case Transform::ANIMATE_ROTATE_TRANSLATE:
+        return 0;
+    case Transform::ANIMATE_SCALE_ROTATE:
+    case Transform::ANIMATE_SCALE_ROTATE_TRANSLATE:
+        return 3;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * Interpolates between two key values the way the runtime does.
+ */
+static void interpolateKey(const float* from, const float* to, float t, size_t propSize, int rotationOffset, float* dst)
+{
+    for (size_t i = 0; i < propSize; ++i)
+    {
+        if ((int)i == rotationOffset)
+        {
+            Quaternion q;
+            Quaternion::slerp(Quaternion(from[i], from[i + 1], from[i + 2], from[i + 3]), Quaternion(to[i], to[i + 1], to[i + 2], to[i + 3]), t, &q);
+            dst[i] = q.x;
+            dst[i + 1] = q.y;
+            dst[i + 2] = q.z;
+            dst[i + 3] = q.w;
+            i += 3;
+        }
+        else
+        {
+            dst[i] = from[i] + (to[i] - from[i]) * t;
+        }
+    }
+}
+
+/**
+ * Measures how far a key value is from the original one. The error is the largest
+ * difference of the scalar components and the angle is the angle between the rotations.
+ */
+static void measureError(const float* value, const float* original, size_t propSize, int rotationOffset, float* error, float* angle)
+{
+    for (size_t i = 0; i < propSize; ++i)
+    {
+        if ((int)i == rotationOffset)
+        {
+            float dot = 0.0f;
+            float lengthA = 0.0f;
+            float lengthB = 0.0f;
+            for (size_t j = i; j < i + 4; ++j)
+            {
+                dot += value[j] * original[j];
+                lengthA += value[j] * value[j];
+                lengthB += original[j] * original[j];
+            }
+            float length = sqrt(lengthA * lengthB);
+            dot = length > 0.0f ? fabs(dot) / length : 1.0f;
+            *angle = max(*angle, 2.0f * acos(min(dot, 1.0f)));
+            i += 3;
+        }
+        else
+        {
+            *error = max(*error, fabs(value[i] - original[i]));
+        }
+    }
+}
+
+/**
+ * Quantizes a key value: scalar components to 16 bits within their range and the
+ * rotation to its three smallest components, 15 bits each, with the index of the
+ * largest component in the top bits of the first two values.
+ */
+static void encodeKey(const float* value, size_t propSize, int rotationOffset, const std::vector<float>& ranges, std::vector<unsigned short>& keys)
+{
+    for (size_t i = 0; i < propSize; ++i)
+    {
+        if ((int)i == rotationOffset)
+        {
+            float q[4];
+            float length = sqrt(value[i] * value[i] + value[i + 1] * value[i + 1] + value[i + 2] * value[i + 2] + value[i + 3] * value[i + 3]);
+            unsigned int largest = 0;
+            for (unsigned int j = 0; j < 4; ++j)
+            {
+                q[j] = length > 0.0f ? value[i + j] / length : (j == 3 ? 1.0f : 0.0f);
+                if (fabs(q[j]) > fabs(q[largest]))
+                    largest = j;
+            }
+
+            // q and -q are the same rotation, so the largest component is made positive and left out.
+            float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+            unsigned int k = 0;
+            for (unsigned int j = 0; j < 4; ++j)
+            {
+                if (j == largest)
+                    continue;
+                float x = (q[j] * sign + ANIMATION_QUATERNION_RANGE) / (2.0f * ANIMATION_QUATERNION_RANGE);
+                unsigned short bits = (unsigned short)max(0.0f, min(32767.0f, floor(x * 32767.0f + 0.5f)));
+                if (k == 0)
+                    bits |= (unsigned short)((largest >> 1) << 15);
+                else if (k == 1)
+                    bits |= (unsigned short)((largest & 1) << 15);
+                keys.push_back(bits);
+                ++k;
+            }
+            i += 3;
+        }
+        else
+        {
+            float scale = ranges[i * 2 + 1];
+            float x = scale > 0.0f ? (value[i] - ranges[i * 2]) / scale : 0.0f;
+            keys.push_back((unsigned short)max(0.0f, min(65535.0f, floor(x + 0.5f))));
+        }
+    }
+}
+
+/**
+ * Decodes a quantized key value the way the runtime does.
+ */
+static void decodeKey(const unsigned short* key, size_t propSize, int rotationOffset, const std::vector<float>& ranges, float* dst)
+{
+    for (size_t i = 0; i < propSize; ++i)
+    {
+        if ((int)i == rotationOffset)
+        {
+            unsigned int largest = ((key[0] >> 15) << 1) | (key[1] >> 15);
+            float* q = dst + i;
+            float sum = 0.0f;
+            for (unsigned int j = 0, k = 0; j < 4; ++j)
+            {
+                if (j == largest)
+                    continue;
+                q[j] = (float)(key[k++] & 0x7FFF) * (2.0f * ANIMATION_QUATERNION_RANGE / 32767.0f) - ANIMATION_QUATERNION_RANGE;
+                sum += q[j] * q[j];
+            }
+            q[largest] = sum < 1.0f ? sqrt(1.0f - sum) : 0.0f;
+            key += 3;
+            i += 3;
+        }
+        else
+        {
+            dst[i] = ranges[i * 2] + ranges[i * 2 + 1] * (float)*key++;
+        }
+    }
+}
+
 AnimationChannel::AnimationChannel(void) :
     _targetAttrib(0)
 {
@@ -33,10 +192,21 @@ void AnimationChannel::writeBinary(FILE* file)
     {
         write((unsigned int)*i, file);
     }
-    write(_keyValues, file);
+    // Quantized keys replace the key values.
+    write(_keys.empty() ? _keyValues : std::vector<float>(), file);
     write(_tangentsIn, file);
     write(_tangentsOut, file);
     write(_interpolations, file);
+    if (_keys.empty())
+    {
+        write((unsigned int)ANIMATION_COMPRESSION_NONE, file);
+    }
+    else
+    {
+        write((unsigned int)ANIMATION_COMPRESSION_QUANTIZED, file);
+        write(_ranges, file);
+        write(_keys, file);
+    }
 }
 
 void AnimationChannel::writeText(FILE* file)
@@ -49,6 +219,11 @@ void AnimationChannel::writeText(FILE* file)
     fprintfElement(file, "%f ", "tangentsIn", _tangentsIn);
     fprintfElement(file, "%f ", "tangentsOut", _tangentsOut);
     fprintfElement(file, "%u ", "interpolations", _interpolations);
+    if (!_keys.empty())
+    {
+        fprintfElement(file, "%f ", "ranges", _ranges);
+        fprintfElement(file, "%u ", "keys", _keys);
+    }
     fprintElementEnd(file);
 }
 
@@ -175,6 +350,115 @@ void AnimationChannel::removeDuplicates()
     LOG(3, "      Removed %d duplicate keyframes from channel.\n", startCount- _keytimes.size());
 }
 
+bool AnimationChannel::compress(float tolerance, unsigned int* originalSize, unsigned int* compressedSize)
+{
+    assert(originalSize && compressedSize);
+
+    const size_t propSize = Transform::getPropertySize(_targetAttrib);
+    const size_t keyCount = _keytimes.size();
+    if (propSize == 0 || keyCount == 0 || _keyValues.size() != keyCount * propSize || !_keys.empty())
+        return false;
+    for (size_t i = 0; i < _interpolations.size(); ++i)
+    {
+        if (_interpolations[i] != LINEAR)
+            return false;
+    }
+
+    const int rotationOffset = getRotationOffset(_targetAttrib);
+    const std::vector<float> times = _keytimes;
+    const std::vector<float> values = _keyValues;
+    std::vector<float> interpolated(propSize);
+
+    // Extend each segment for as long as it reproduces all key frames it spans within the tolerance.
+    std::vector<size_t> kept;
+    kept.push_back(0);
+    size_t anchor = 0;
+    for (size_t end = 2; end < keyCount; ++end)
+    {
+        float span = times[end] - times[anchor];
+        for (size_t k = anchor + 1; k < end; ++k)
+        {
+            float t = span > 0.0f ? (times[k] - times[anchor]) / span : 0.0f;
+            interpolateKey(&values[anchor * propSize], &values[end * propSize], t, propSize, rotationOffset, &interpolated[0]);
+            float error = 0.0f;
+            float angle = 0.0f;
+            measureError(&interpolated[0], &values[k * propSize], propSize, rotationOffset, &error, &angle);
+            if (error > tolerance || angle > tolerance)
+            {
+                anchor = end - 1;
+                kept.push_back(anchor);
+                break;
+            }
+        }
+    }
+    if (keyCount > 1)
+        kept.push_back(keyCount - 1);
+
+    _keytimes.clear();
+    _keyValues.clear();
+    for (size_t i = 0; i < kept.size(); ++i)
+    {
+        _keytimes.push_back(times[kept[i]]);
+        _keyValues.insert(_keyValues.end(), values.begin() + kept[i] * propSize, values.begin() + (kept[i] + 1) * propSize);
+    }
+    _tangentsIn.clear();
+    _tangentsOut.clear();
+    setInterpolation(LINEAR);
+
+    // Quantize the remaining key frames within the range of each component.
+    _ranges.assign(propSize * 2, 0.0f);
+    for (size_t i = 0; i < propSize; ++i)
+    {
+        if ((int)i == rotationOffset)
+        {
+            i += 3;
+            continue;
+        }
+        float low = _keyValues[i];
+        float high = _keyValues[i];
+        for (size_t k = 1; k < kept.size(); ++k)
+        {
+            low = min(low, _keyValues[k * propSize + i]);
+            high = max(high, _keyValues[k * propSize + i]);
+        }
+        _ranges[i * 2] = low;
+        _ranges[i * 2 + 1] = (high - low) / 65535.0f;
+    }
+    _keys.clear();
+    for (size_t k = 0; k < kept.size(); ++k)
+    {
+        encodeKey(&_keyValues[k * propSize], propSize, rotationOffset, _ranges, _keys);
+    }
+
+    // Measure the error of the decoded channel at every original key frame.
+    const size_t keyStride = _keys.size() / kept.size();
+    std::vector<float> from(propSize);
+    std::vector<float> to(propSize);
+    float maxError = 0.0f;
+    float maxAngle = 0.0f;
+    size_t segment = 0;
+    for (size_t k = 0; k < keyCount; ++k)
+    {
+        while (segment + 1 < kept.size() && kept[segment + 1] <= k)
+            ++segment;
+        size_t next = min(segment + 1, kept.size() - 1);
+        decodeKey(&_keys[segment * keyStride], propSize, rotationOffset, _ranges, &from[0]);
+        decodeKey(&_keys[next * keyStride], propSize, rotationOffset, _ranges, &to[0]);
+        float span = times[kept[next]] - times[kept[segment]];
+        float t = span > 0.0f ? (times[k] - times[kept[segment]]) / span : 0.0f;
+        interpolateKey(&from[0], &to[0], t, propSize, rotationOffset, &interpolated[0]);
+        measureError(&interpolated[0], &values[k * propSize], propSize, rotationOffset, &maxError, &maxAngle);
+    }
+
+    *originalSize = (unsigned int)(keyCount * (sizeof(float) + propSize * sizeof(float)));
+    *compressedSize = (unsigned int)(kept.size() * (sizeof(float) + keyStride * sizeof(unsigned short)) + _ranges.size() * sizeof(float));
+
+    LOG(2, "  Compressed channel %s:%s from %lu to %lu key frames and %u to %u bytes, max error %f, max rotation error %f radians.\n",
+        _targetId.c_str(), Transform::getPropertyString(_targetAttrib), keyCount, kept.size(), *originalSize, *compressedSize, maxError, maxAngle);
+
+    return true;
+}
+
 unsigned int AnimationChannel::getInterpolationType(const char* str)
 {
     unsigned int value = 0;
@@ -65,6 +65,23 @@ public:
      */
     void removeDuplicates();
 
+    /**
+     * Reduces and quantizes the key frames of a linear transform channel.
+     *
+     * Key frames that linear interpolation between the remaining key frames
+     * reproduces within the tolerance are removed. The remaining rotations are
+     * stored as their three smallest components and all other components as
+     * 16-bit values within the range of the channel.
+     *
+     * @param tolerance The largest error allowed when removing key frames, in units
+     *      for scale and translation and in radians for rotation.
+     * @param originalSize Receives the size of the key data before compression, in bytes.
+     * @param compressedSize Receives the size of the key data after compression, in bytes.
+     *
+     * @return True if the channel was compressed, false if it cannot be compressed.
+     */
+    bool compress(float tolerance, unsigned int* originalSize, unsigned int* compressedSize);
+
     /**
      * Returns the interpolation type value for the given string or zero if not valid.
      * Example: "LINEAR" returns AnimationChannel::LINEAR
@@ -95,6 +112,8 @@ private:
     std::vector<float> _tangentsIn;
     std::vector<float> _tangentsOut;
     std::vector<unsigned int> _interpolations;
+    std::vector<float> _ranges;
+    std::vector<unsigned short> _keys;
 };
 
 }
@@ -27,6 +27,8 @@ EncoderArguments::EncoderArguments(size_t argc, const char** argv) :
     _fontFormat(Font::BITMAP),
     _textOutput(false),
     _optimizeAnimations(false),
+    _compressAnimations(false),
+    _animationTolerance(0.0f),
     _animationGrouping(ANIMATIONGROUP_PROMPT),
     _outputMaterial(false),
     _generateTextureGutter(false)
@@ -286,6 +288,13 @@ void EncoderArguments::printUsage() const
         "\t\tremoving any channels that contain default/identity values\n" \
         "\t\tand removing any duplicate contiguous keyframes, which are \n" \
         "\t\tcommon when exporting baked animation data.\n" \
+    "  -ca <tolerance>\n" \
+        "\t\tCompresses node animations by removing key frames that\n" \
+        "\t\tinterpolation reproduces within the tolerance (in units for\n" \
+        "\t\tscale and translation, in radians for rotation) and storing\n" \
+        "\t\tthe remaining key frames as 16-bit values. Rotations keep\n" \
+        "\t\ttheir three smallest components. Only linear channels are\n" \
+        "\t\tcompressed. Implies -oa.\n" \
     "  -h <size> \"<node ids>\" <filename>\n" \
         "\t\tGenerates a single heightmap image using meshes from the \n" \
         "\t\tspecified nodes. \n" \
@@ -345,6 +354,16 @@ bool EncoderArguments::optimizeAnimationsEnabled() const
     return _optimizeAnimations;
 }
 
+bool EncoderArguments::compressAnimationsEnabled() const
+{
+    return _compressAnimations;
+}
+
+float EncoderArguments::getAnimationTolerance() const
+{
+    return _animationTolerance;
+}
+
 bool EncoderArguments::outputMaterialEnabled() const
 {
     return _outputMaterial;
@@ -713,6 +732,21 @@ void EncoderArguments::readOption(const std::vector<std::string>& options, size_
         }
         break;
     case 'c':
+        if (str == "-ca")
+        {
+            // Compress animations
+            (*index)++;
+            if (*index >= options.size())
+            {
+                LOG(1, "Error: missing tolerance argument for -ca.\n");
+                _parseError = true;
+                return;
+            }
+            _compressAnimations = true;
+            _optimizeAnimations = true;
+            _animationTolerance = max(0.0f, (float)atof(options[*index].c_str()));
+            break;
+        }
         (*index)++;
         if (*index >= options.size())
         {
@@ -185,6 +185,13 @@ public:
 
     bool optimizeAnimationsEnabled() const;
 
+    bool compressAnimationsEnabled() const;
+
+    /**
+     * Gets the largest error allowed when removing animation key frames.
+     */
+    float getAnimationTolerance() const;
+
     bool outputMaterialEnabled() const;
 
     bool generateTextureGutter() const;
@@ -237,6 +244,8 @@ private:
     Font::FontFormat _fontFormat;
     bool _textOutput;
     bool _optimizeAnimations;
+    bool _compressAnimations;
+    float _animationTolerance;
     AnimationGroupOption _animationGrouping;
     bool _outputMaterial;
     bool _generateTextureGutter;
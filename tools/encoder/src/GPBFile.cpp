@@ -326,6 +326,12 @@ void GPBFile::adjust()
         optimizeAnimations();
     }
 
+    if (EncoderArguments::getInstance()->compressAnimationsEnabled())
+    {
+        LOG(1, "Compressing animations.\n");
+        compressAnimations(EncoderArguments::getInstance()->getAnimationTolerance());
+    }
+
     // TODO:
     // remove ambient _lights
     // for each node
@@ -432,6 +438,43 @@ void GPBFile::optimizeAnimations()
     }
 }
 
+void GPBFile::compressAnimations(float tolerance)
+{
+    unsigned int originalSize = 0;
+    unsigned int compressedSize = 0;
+    unsigned int compressedCount = 0;
+
+    const unsigned int animationCount = _animations.getAnimationCount();
+    for (unsigned int animationIndex = 0; animationIndex < animationCount; ++animationIndex)
+    {
+        Animation* animation = _animations.getAnimation(animationIndex);
+        assert(animation);
+
+        const unsigned int channelCount = animation->getAnimationChannelCount();
+        for (unsigned int channelIndex = 0; channelIndex < channelCount; ++channelIndex)
+        {
+            AnimationChannel* channel = animation->getAnimationChannel(channelIndex);
+            assert(channel);
+
+            // Only node transforms are quantized; the runtime locates their rotation from the target attribute.
+            const Object* obj = _refTable.get(channel->getTargetId());
+            if (obj && obj->getTypeId() == Object::NODE_ID)
+            {
+                unsigned int channelOriginalSize;
+                unsigned int channelCompressedSize;
+                if (channel->compress(tolerance, &channelOriginalSize, &channelCompressedSize))
+                {
+                    originalSize += channelOriginalSize;
+                    compressedSize += channelCompressedSize;
+                    ++compressedCount;
+                }
+            }
+        }
+    }
+
+    LOG(1, "Compressed %u animation channel(s) from %u to %u bytes of key data.\n", compressedCount, originalSize, compressedSize);
+}
+
 void GPBFile::decomposeTransformAnimationChannel(Animation* animation, AnimationChannel* channel, int channelIndex)
 {
     LOG(2, "  Optimizing animaton channel %s:%d.\n", animation->getId().c_str(), channelIndex+1);
@@ -21,7 +21,7 @@ namespace gameplay
  * Increment the version number when making a change that break binary compatibility.
  * [0] is major, [1] is minor.
  */
-const unsigned char GPB_VERSION[2] = {1, 5};
+const unsigned char GPB_VERSION[2] = {1, 6};
 
 /**
  * The GamePlay Binary file class handles writing the GamePlay Binary file.
@@ -132,6 +132,13 @@ private:
      */
     void optimizeAnimations();
 
+    /**
+     * Reduces and quantizes the key frames of node animation channels.
+     *
+     * @param tolerance The largest error allowed when removing key frames.
+     */
+    void compressAnimations(float tolerance);
+
     /**
      * Decomposes an ANIMATE_SCALE_ROTATE_TRANSLATE channel into 3 new channels. (Scale, Rotate and Translate)
      * 